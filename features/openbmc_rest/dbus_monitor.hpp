@@ -7,20 +7,23 @@
 #include "openbmc_dbus_rest.hpp"
 #include "websocket.hpp"
 
-#include <systemd/sd-bus.h>
-
 #include <boost/container/flat_map.hpp>
 #include <boost/container/flat_set.hpp>
 #include <nlohmann/json.hpp>
 #include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/message.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <functional>
+#include <map>
 #include <memory>
+#include <optional>
 #include <regex>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace crow
@@ -28,41 +31,31 @@ namespace crow
 namespace dbus_monitor
 {
 
+using InterfaceSet =
+    boost::container::flat_set<std::string, std::less<>,
+                               std::vector<std::string>>;
+
 struct DbusWebsocketSession
 {
-    std::vector<std::unique_ptr<sdbusplus::bus::match_t>> matches;
-    boost::container::flat_set<std::string, std::less<>,
-                               std::vector<std::string>>
-        interfaces;
+    // Match rules this session is subscribed to
+    std::vector<std::string> rules;
+    InterfaceSet interfaces;
 };
 
-using SessionMap = boost::container::flat_map<crow::websocket::Connection*,
-                                              DbusWebsocketSession>;
-
-// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
-static SessionMap sessions;
+// A signal, decoded once no matter how many sessions receive it
+struct MonitorEvent
+{
+    nlohmann::json::object_t json;
+    // For InterfacesAdded, every interface that was added.  Each session
+    // only sees the ones it asked for.
+    std::optional<nlohmann::json::object_t> interfacesAdded;
+};
 
-inline int onPropertyUpdate(sd_bus_message* m, void* userdata,
-                            sd_bus_error* retError)
+inline std::optional<MonitorEvent> decodeSignal(sdbusplus::message_t& message)
 {
-    if (retError == nullptr || (sd_bus_error_is_set(retError) != 0))
-    {
-        BMCWEB_LOG_ERROR("Got sdbus error on match");
-        return 0;
-    }
-    crow::websocket::Connection* connection =
-        static_cast<crow::websocket::Connection*>(userdata);
-    auto thisSession = sessions.find(connection);
-    if (thisSession == sessions.end())
-    {
-        BMCWEB_LOG_ERROR("Couldn't find dbus connection {}",
-                         logPtr(connection));
-        return 0;
-    }
-    sdbusplus::message_t message(m);
-    nlohmann::json json;
-    json["event"] = message.get_member();
-    json["path"] = message.get_path();
+    MonitorEvent event;
+    event.json["event"] = message.get_member();
+    event.json["path"] = message.get_path();
     if (strcmp(message.get_member(), "PropertiesChanged") == 0)
     {
         nlohmann::json data;
@@ -70,37 +63,38 @@ inline int onPropertyUpdate(sd_bus_message* m, void* userdata,
         if (r < 0)
         {
             BMCWEB_LOG_ERROR("convertDBusToJSON failed with {}", r);
-            return 0;
+            return std::nullopt;
         }
         if (!data.is_array())
         {
             BMCWEB_LOG_ERROR("No data in PropertiesChanged signal");
-            return 0;
+            return std::nullopt;
         }
 
         // data is type sa{sv}as and is an array[3] of string, object, array
-        json["interface"] = data[0];
-        json["properties"] = data[1];
+        event.json["interface"] = data[0];
+        event.json["properties"] = data[1];
+        return event;
     }
-    else if (strcmp(message.get_member(), "InterfacesAdded") == 0)
+    if (strcmp(message.get_member(), "InterfacesAdded") == 0)
     {
         nlohmann::json data;
         int r = openbmc_mapper::convertDBusToJSON("oa{sa{sv}}", message, data);
         if (r < 0)
         {
             BMCWEB_LOG_ERROR("convertDBusToJSON failed with {}", r);
-            return 0;
+            return std::nullopt;
         }
         nlohmann::json::array_t* arr = data.get_ptr<nlohmann::json::array_t*>();
         if (arr == nullptr)
         {
             BMCWEB_LOG_ERROR("No data in InterfacesAdded signal");
-            return 0;
+            return std::nullopt;
         }
         if (arr->size() < 2)
         {
             BMCWEB_LOG_ERROR("No data in InterfacesAdded signal");
-            return 0;
+            return std::nullopt;
         }
 
         nlohmann::json::object_t* obj =
@@ -108,28 +102,194 @@ inline int onPropertyUpdate(sd_bus_message* m, void* userdata,
         if (obj == nullptr)
         {
             BMCWEB_LOG_ERROR("No data in InterfacesAdded signal");
-            return 0;
+            return std::nullopt;
         }
         // data is type oa{sa{sv}} which is an array[2] of string, object
-        for (const auto& entry : *obj)
+        event.interfacesAdded = std::move(*obj);
+        return event;
+    }
+    BMCWEB_LOG_CRITICAL("message {} was unexpected", message.get_member());
+    return std::nullopt;
+}
+
+inline websocket::TextFrame renderEvent(const MonitorEvent& event,
+                                        const InterfaceSet& interfaces)
+{
+    nlohmann::json json = event.json;
+    if (event.interfacesAdded)
+    {
+        for (const auto& entry : *event.interfacesAdded)
         {
-            auto it = thisSession->second.interfaces.find(entry.first);
-            if (it != thisSession->second.interfaces.end())
+            if (interfaces.contains(entry.first))
             {
                 json["interfaces"][entry.first] = entry.second;
             }
         }
     }
-    else
+    return std::make_shared<const std::string>(
+        json.dump(2, ' ', true, nlohmann::json::error_handler_t::replace));
+}
+
+// Tracks the monitor sessions and the match rules they subscribe to.  Each
+// distinct rule is installed on the bus once, however many sessions ask for
+// it, and removed when the last of them goes away.  A signal is decoded and
+// serialized once, then the same frame is queued on every interested
+// session.
+class MonitorRegistry
+{
+  public:
+    using SignalHandler = std::function<void(sdbusplus::message_t&)>;
+    // Installs a match rule on the bus, which stays installed until the
+    // returned handle is destroyed
+    using MatchFactory = std::function<std::shared_ptr<void>(
+        const std::string& rule, SignalHandler&& handler)>;
+
+    explicit MonitorRegistry(MatchFactory&& factoryIn) :
+        factory(std::move(factoryIn))
+    {}
+
+    static MonitorRegistry& getInstance()
+    {
+        static MonitorRegistry registry(
+            [](const std::string& rule,
+               SignalHandler&& handler) -> std::shared_ptr<void> {
+                return std::make_shared<sdbusplus::bus::match_t>(
+                    *crow::connections::systemBus, rule, std::move(handler));
+            });
+        return registry;
+    }
+
+    void openSession(websocket::Connection& conn)
     {
-        BMCWEB_LOG_CRITICAL("message {} was unexpected", message.get_member());
-        return 0;
+        sessions.try_emplace(&conn);
     }
 
-    connection->sendText(
-        json.dump(2, ' ', true, nlohmann::json::error_handler_t::replace));
-    return 0;
-}
+    DbusWebsocketSession* findSession(websocket::Connection& conn)
+    {
+        auto it = sessions.find(&conn);
+        if (it == sessions.end())
+        {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    void closeSession(websocket::Connection& conn)
+    {
+        auto it = sessions.find(&conn);
+        if (it == sessions.end())
+        {
+            return;
+        }
+        for (const std::string& rule : it->second.rules)
+        {
+            unsubscribe(conn, rule);
+        }
+        sessions.erase(it);
+    }
+
+    void subscribe(websocket::Connection& conn, const std::string& rule)
+    {
+        DbusWebsocketSession* session = findSession(conn);
+        if (session == nullptr)
+        {
+            return;
+        }
+        auto [it, inserted] = rules.try_emplace(rule);
+        if (inserted)
+        {
+            BMCWEB_LOG_DEBUG("Creating match {}", rule);
+            it->second.match =
+                factory(rule, [this, rule](sdbusplus::message_t& message) {
+                    std::optional<MonitorEvent> event = decodeSignal(message);
+                    if (event)
+                    {
+                        dispatch(rule, *event);
+                    }
+                });
+        }
+        if (it->second.subscribers.insert(&conn).second)
+        {
+            session->rules.emplace_back(rule);
+        }
+    }
+
+    void dispatch(std::string_view rule, const MonitorEvent& event)
+    {
+        auto it = rules.find(rule);
+        if (it == rules.end())
+        {
+            return;
+        }
+        // Only InterfacesAdded depends on the session, and sessions with the
+        // same interface filter share a frame
+        std::vector<std::pair<const InterfaceSet*, websocket::TextFrame>>
+            frames;
+        websocket::TextFrame shared;
+        if (!event.interfacesAdded)
+        {
+            shared = renderEvent(event, {});
+        }
+        for (websocket::Connection* conn : it->second.subscribers)
+        {
+            const DbusWebsocketSession* session = findSession(*conn);
+            if (session == nullptr)
+            {
+                continue;
+            }
+            websocket::TextFrame frame = shared;
+            if (frame == nullptr)
+            {
+                auto cached = std::ranges::find_if(
+                    frames, [session](const auto& entry) {
+                        return *entry.first == session->interfaces;
+                    });
+                if (cached != frames.end())
+                {
+                    frame = cached->second;
+                }
+                else
+                {
+                    frame = renderEvent(event, session->interfaces);
+                    frames.emplace_back(&session->interfaces, frame);
+                }
+            }
+            conn->sendTextFrame(frame);
+        }
+    }
+
+    size_t matchCount() const
+    {
+        return rules.size();
+    }
+
+  private:
+    struct Rule
+    {
+        std::shared_ptr<void> match;
+        boost::container::flat_set<websocket::Connection*> subscribers;
+    };
+
+    void unsubscribe(websocket::Connection& conn, const std::string& rule)
+    {
+        auto it = rules.find(rule);
+        if (it == rules.end())
+        {
+            return;
+        }
+        it->second.subscribers.erase(&conn);
+        if (it->second.subscribers.empty())
+        {
+            BMCWEB_LOG_DEBUG("Removing match {}", rule);
+            rules.erase(it);
+        }
+    }
+
+    MatchFactory factory;
+    boost::container::flat_map<websocket::Connection*, DbusWebsocketSession>
+        sessions;
+    std::map<std::string, Rule, std::less<>> rules;
+};
 
 inline void requestRoutes(App& app)
 {
@@ -138,19 +298,21 @@ inline void requestRoutes(App& app)
         .websocket()
         .onopen([](crow::websocket::Connection& conn) {
             BMCWEB_LOG_DEBUG("Connection {} opened", logPtr(&conn));
-            sessions.try_emplace(&conn);
+            MonitorRegistry::getInstance().openSession(conn);
         })
         .onclose([](crow::websocket::Connection& conn, const std::string&) {
-            sessions.erase(&conn);
+            MonitorRegistry::getInstance().closeSession(conn);
         })
         .onmessage([](crow::websocket::Connection& conn,
                       const std::string& data, bool) {
-            const auto sessionPair = sessions.find(&conn);
-            if (sessionPair == sessions.end())
+            MonitorRegistry& registry = MonitorRegistry::getInstance();
+            DbusWebsocketSession* session = registry.findSession(conn);
+            if (session == nullptr)
             {
                 conn.close("Internal error");
+                return;
             }
-            DbusWebsocketSession& thisSession = sessionPair->second;
+            DbusWebsocketSession& thisSession = *session;
             BMCWEB_LOG_DEBUG("Connection {} received {}", logPtr(&conn), data);
             nlohmann::json j = nlohmann::json::parse(data, nullptr, false);
             if (j.is_discarded())
@@ -221,13 +383,7 @@ inline void requestRoutes(App& app)
                 // interfaces
                 if (thisSession.interfaces.empty())
                 {
-                    BMCWEB_LOG_DEBUG("Creating match {}",
-                                     propertiesMatchString);
-
-                    thisSession.matches.emplace_back(
-                        std::make_unique<sdbusplus::bus::match_t>(
-                            *crow::connections::systemBus,
-                            propertiesMatchString, onPropertyUpdate, &conn));
+                    registry.subscribe(conn, propertiesMatchString);
                 }
                 else
                 {
@@ -246,11 +402,7 @@ inline void requestRoutes(App& app)
                         ifaceMatchString += ",arg0='";
                         ifaceMatchString += interface;
                         ifaceMatchString += "'";
-                        BMCWEB_LOG_DEBUG("Creating match {}", ifaceMatchString);
-                        thisSession.matches.emplace_back(
-                            std::make_unique<sdbusplus::bus::match_t>(
-                                *crow::connections::systemBus, ifaceMatchString,
-                                onPropertyUpdate, &conn));
+                        registry.subscribe(conn, ifaceMatchString);
                     }
                 }
                 std::string objectManagerMatchString =
@@ -260,11 +412,7 @@ inline void requestRoutes(App& app)
                      *thisPathString +
                      "',"
                      "member='InterfacesAdded'");
-                BMCWEB_LOG_DEBUG("Creating match {}", objectManagerMatchString);
-                thisSession.matches.emplace_back(
-                    std::make_unique<sdbusplus::bus::match_t>(
-                        *crow::connections::systemBus, objectManagerMatchString,
-                        onPropertyUpdate, &conn));
+                registry.subscribe(conn, objectManagerMatchString);
             }
         });
 }
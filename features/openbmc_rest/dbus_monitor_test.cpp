@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "dbus_monitor.hpp"
+#include "websocket.hpp"
+
+#include <boost/url/url_view.hpp>
+#include <nlohmann/json.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace crow::dbus_monitor
+{
+namespace
+{
+
+struct FakeConnection : public websocket::Connection
+{
+    void sendBinary(std::string_view /*msg*/) override {}
+    void sendEx(websocket::MessageType /*type*/, std::string_view /*msg*/,
+                std::function<void()>&& onDone) override
+    {
+        onDone();
+    }
+    void sendText(std::string_view /*msg*/) override {}
+    void sendTextFrame(const websocket::TextFrame& frame) override
+    {
+        frames.emplace_back(frame);
+    }
+    void close(std::string_view /*msg*/) override {}
+    void deferRead() override {}
+    void resumeRead() override {}
+    boost::urls::url_view url() override
+    {
+        return {};
+    }
+
+    std::vector<websocket::TextFrame> frames;
+};
+
+// Counts the matches installed on the fake bus
+struct FakeBus
+{
+    std::map<std::string, int> installed;
+
+    MonitorRegistry::MatchFactory factory()
+    {
+        return [this](const std::string& rule,
+                      MonitorRegistry::SignalHandler&& /*handler*/) {
+            installed[rule]++;
+            return std::shared_ptr<void>(nullptr, [this, rule](void*) {
+                installed[rule]--;
+            });
+        };
+    }
+};
+
+const std::string propertiesRule =
+    "type='signal',interface='org.freedesktop.DBus.Properties',"
+    "path_namespace='/xyz/openbmc_project/sensors',"
+    "member='PropertiesChanged'";
+
+TEST(MonitorRegistry, IdenticalRulesShareOneMatch)
+{
+    FakeBus bus;
+    MonitorRegistry registry(bus.factory());
+    std::vector<std::shared_ptr<FakeConnection>> tabs;
+    for (int i = 0; i < 10; i++)
+    {
+        tabs.emplace_back(std::make_shared<FakeConnection>());
+        registry.openSession(*tabs.back());
+        registry.subscribe(*tabs.back(), propertiesRule);
+    }
+    EXPECT_EQ(registry.matchCount(), 1U);
+    EXPECT_EQ(bus.installed[propertiesRule], 1);
+
+    MonitorEvent event;
+    event.json["event"] = "PropertiesChanged";
+    event.json["path"] = "/xyz/openbmc_project/sensors/temperature/cpu0";
+    event.json["interface"] = "xyz.openbmc_project.Sensor.Value";
+    event.json["properties"]["Value"] = 42.0;
+    registry.dispatch(propertiesRule, event);
+
+    // Every session got the same frame, serialized once
+    for (const std::shared_ptr<FakeConnection>& tab : tabs)
+    {
+        ASSERT_EQ(tab->frames.size(), 1U);
+        EXPECT_EQ(tab->frames[0], tabs[0]->frames[0]);
+    }
+    nlohmann::json sent = nlohmann::json::parse(*tabs[0]->frames[0]);
+    EXPECT_EQ(sent["properties"]["Value"], 42.0);
+
+    // The match stays until the last session goes away
+    for (size_t i = 0; i < tabs.size() - 1; i++)
+    {
+        registry.closeSession(*tabs[i]);
+    }
+    EXPECT_EQ(bus.installed[propertiesRule], 1);
+    registry.closeSession(*tabs.back());
+    EXPECT_EQ(registry.matchCount(), 0U);
+    EXPECT_EQ(bus.installed[propertiesRule], 0);
+}
+
+TEST(MonitorRegistry, InterfacesAddedIsFilteredPerSession)
+{
+    const std::string rule =
+        "type='signal',interface='org.freedesktop.DBus.ObjectManager',"
+        "path_namespace='/xyz',member='InterfacesAdded'";
+
+    FakeBus bus;
+    MonitorRegistry registry(bus.factory());
+    FakeConnection sensorsA;
+    FakeConnection sensorsB;
+    FakeConnection inventory;
+    for (FakeConnection* conn : {&sensorsA, &sensorsB, &inventory})
+    {
+        registry.openSession(*conn);
+        registry.subscribe(*conn, rule);
+    }
+    registry.findSession(sensorsA)->interfaces.insert(
+        "xyz.openbmc_project.Sensor.Value");
+    registry.findSession(sensorsB)->interfaces.insert(
+        "xyz.openbmc_project.Sensor.Value");
+    registry.findSession(inventory)->interfaces.insert(
+        "xyz.openbmc_project.Inventory.Item");
+
+    MonitorEvent event;
+    event.json["event"] = "InterfacesAdded";
+    event.json["path"] = "/xyz/openbmc_project/sensors/temperature/cpu0";
+    event.interfacesAdded.emplace();
+    (*event.interfacesAdded)["xyz.openbmc_project.Sensor.Value"]["Value"] =
+        1.0;
+    registry.dispatch(rule, event);
+
+    ASSERT_EQ(sensorsA.frames.size(), 1U);
+    ASSERT_EQ(sensorsB.frames.size(), 1U);
+    ASSERT_EQ(inventory.frames.size(), 1U);
+    EXPECT_EQ(sensorsA.frames[0], sensorsB.frames[0]);
+    EXPECT_NE(sensorsA.frames[0], inventory.frames[0]);
+
+    nlohmann::json sensors = nlohmann::json::parse(*sensorsA.frames[0]);
+    EXPECT_EQ(
+        sensors["interfaces"]["xyz.openbmc_project.Sensor.Value"]["Value"],
+        1.0);
+    nlohmann::json other = nlohmann::json::parse(*inventory.frames[0]);
+    EXPECT_FALSE(other.contains("interfaces"));
+}
+
+TEST(MonitorRegistry, UnknownSessionIsIgnored)
+{
+    FakeBus bus;
+    MonitorRegistry registry(bus.factory());
+    FakeConnection conn;
+    registry.subscribe(conn, propertiesRule);
+    EXPECT_EQ(registry.matchCount(), 0U);
+    EXPECT_EQ(registry.findSession(conn), nullptr);
+}
+
+} // namespace
+} // namespace crow::dbus_monitor
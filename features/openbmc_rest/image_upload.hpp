@@ -10,6 +10,7 @@
 #include "io_context_singleton.hpp"
 #include "logging.hpp"
 #include "ossl_random.hpp"
+#include "streamed_image.hpp"
 
 #include <boost/asio/error.hpp>
 #include <boost/asio/steady_timer.hpp>
@@ -21,7 +22,6 @@
 
 #include <algorithm>
 #include <chrono>
-#include <fstream>
 #include <functional>
 #include <memory>
 #include <ranges>
@@ -106,12 +106,26 @@ inline void uploadImageHandler(
         "member='InterfacesAdded',path='/xyz/openbmc_project/software'",
         callback);
 
+    // The route streams every body into this sink
+    std::shared_ptr<bmcweb::ImageBodySink> upload =
+        std::static_pointer_cast<bmcweb::ImageBodySink>(req.bodySink());
+    if (upload == nullptr)
+    {
+        // Buffered, for example over HTTP/2
+        upload = std::make_shared<bmcweb::ImageBodySink>();
+        upload->put(req.body());
+        upload->finish();
+    }
+
     std::string filepath("/tmp/images/" + bmcweb::getRandomUUID());
     BMCWEB_LOG_DEBUG("Writing file to {}", filepath);
-    std::ofstream out(filepath, std::ofstream::out | std::ofstream::binary |
-                                    std::ofstream::trunc);
-    out << req.body();
-    out.close();
+    if (upload->image.failed || !upload->image.copyTo(filepath))
+    {
+        fwUpdateMatcher = nullptr;
+        asyncResp->res.result(
+            boost::beast::http::status::internal_server_error);
+        return;
+    }
     timeout.async_wait(timeoutHandler);
 }
 
@@ -119,6 +133,7 @@ inline void requestRoutes(App& app)
 {
     BMCWEB_ROUTE(app, "/upload/image/<str>")
         .privileges({{"ConfigureComponents", "ConfigureManager"}})
+        .streamBody(bmcweb::makeImageBodySink)
         .methods(boost::beast::http::verb::post, boost::beast::http::verb::put)(
             [](const crow::Request& req,
                const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
@@ -126,6 +141,7 @@ inline void requestRoutes(App& app)
 
     BMCWEB_ROUTE(app, "/upload/image")
         .privileges({{"ConfigureComponents", "ConfigureManager"}})
+        .streamBody(bmcweb::makeImageBodySink)
         .methods(boost::beast::http::verb::post, boost::beast::http::verb::put)(
             [](const crow::Request& req,
                const std::shared_ptr<bmcweb::AsyncResp>& asyncResp) {
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "async_resp.hpp"
+#include "http_body.hpp"
 #include "http_connect_types.hpp"
 #include "http_request.hpp"
 #include "http_server.hpp"
@@ -16,9 +17,11 @@
 #include <systemd/sd-daemon.h>
 
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/http/message.hpp>
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <span>
@@ -53,6 +56,21 @@ class App
         router.handle(req, asyncResp);
     }
 
+    std::optional<uint64_t> getBodyStreamLimit(
+        const boost::beast::http::request_header<>& header) const
+    {
+        return router.getBodyStreamLimit(header);
+    }
+
+    void startBodyStream(
+        const std::shared_ptr<Request>& req,
+        const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+        std::move_only_function<void(std::shared_ptr<bmcweb::BodySink>)>&&
+            start)
+    {
+        router.startBodyStream(req, asyncResp, std::move(start));
+    }
+
     DynamicRule& routeDynamic(const std::string& rule)
     {
         return router.newRuleDynamic(rule);
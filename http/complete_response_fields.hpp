@@ -61,11 +61,15 @@ inline void handleEncoding(std::string_view acceptEncoding, Response& res)
     }
 }
 
-inline void completeResponseFields(
+// Serializes the JSON payload, and settles the ETag and encoding.  The
+// security headers are left to the caller.
+inline void completeResponsePayload(
     std::string_view accepts, std::string_view acceptEncoding, Response& res)
 {
-    BMCWEB_LOG_INFO("Response: {}", res.resultInt());
-    addSecurityHeaders(res);
+    BMCWEB_LOG_INFO(
+        "Response: {}, D-Bus: {} reads, {} round trips, {} coalesced, {} batched, {} writes",
+        res.resultInt(), res.dbusStats.requested, res.dbusStats.roundTrips,
+        res.dbusStats.coalesced, res.dbusStats.batched, res.dbusStats.writes);
 
     res.setResponseEtagAndHandleNotModified();
     if (res.jsonValue.is_structured())
@@ -101,4 +105,11 @@ inline void completeResponseFields(
 
     handleEncoding(acceptEncoding, res);
 }
+
+inline void completeResponseFields(
+    std::string_view accepts, std::string_view acceptEncoding, Response& res)
+{
+    addSecurityHeaders(res);
+    completeResponsePayload(accepts, acceptEncoding, res);
+}
 } // namespace crow
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "compression.hpp"
+
+#include "logging.hpp"
+
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace bmcweb
+{
+
+std::optional<std::string> gzipCompress(std::string_view data)
+{
+    if (data.size() > std::numeric_limits<uInt>::max())
+    {
+        BMCWEB_LOG_ERROR("Payload of {} bytes too large to gzip", data.size());
+        return std::nullopt;
+    }
+
+    z_stream stream{};
+    // 15 window bits, plus 16 to request a gzip header rather than zlib
+    constexpr int gzipWindowBits = 15 + 16;
+    constexpr int memLevel = 8;
+    if (deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, gzipWindowBits,
+                     memLevel, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        BMCWEB_LOG_ERROR("deflateInit2 failed");
+        return std::nullopt;
+    }
+
+    std::string out;
+    out.resize(deflateBound(&stream, static_cast<uLong>(data.size())));
+
+    // zlib doesn't modify the input, but its API isn't const correct
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    stream.next_in = const_cast<Bytef*>(
+        reinterpret_cast<const Bytef*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+
+    int ret = deflate(&stream, Z_FINISH);
+    size_t written = stream.total_out;
+    deflateEnd(&stream);
+    if (ret != Z_STREAM_END)
+    {
+        BMCWEB_LOG_ERROR("deflate failed with code {}", ret);
+        return std::nullopt;
+    }
+    out.resize(written);
+    return out;
+}
+
+std::optional<std::string> zstdCompress([[maybe_unused]] std::string_view data)
+{
+#ifdef HAVE_ZSTD
+    // The default level, which is both faster and smaller than gzip
+    constexpr int compressionLevel = 3;
+    std::string out;
+    out.resize(ZSTD_compressBound(data.size()));
+    size_t ret = ZSTD_compress(out.data(), out.size(), data.data(),
+                               data.size(), compressionLevel);
+    if (ZSTD_isError(ret) != 0)
+    {
+        BMCWEB_LOG_ERROR("Compression failed with code {}:{}", ret,
+                         ZSTD_getErrorName(ret));
+        return std::nullopt;
+    }
+    out.resize(ret);
+    return out;
+#else
+    return std::nullopt;
+#endif
+}
+
+} // namespace bmcweb
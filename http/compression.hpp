@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace bmcweb
+{
+
+// Compresses a complete payload in the gzip format.  This runs on the event
+// loop, so it uses the fastest level; the result is kept and served many
+// times, and the highest levels would stall every other connection for
+// little gain.  Returns std::nullopt on failure.
+std::optional<std::string> gzipCompress(std::string_view data);
+
+// Compresses a complete payload in the zstd format.  Returns std::nullopt on
+// failure, or if bmcweb was built without zstd support.
+std::optional<std::string> zstdCompress(std::string_view data);
+
+} // namespace bmcweb
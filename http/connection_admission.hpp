@@ -0,0 +1,347 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "io_context_singleton.hpp"
+#include "logging.hpp"
+
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/post.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <optional>
+#include <utility>
+
+namespace crow
+{
+
+// Maximum number of simultaneously open http connections
+constexpr size_t maxConnections = 200;
+
+// Maximum number of simultaneously open connections from a single client
+// address.  Chosen so that a handful of browser tabs and tools behind the
+// same NAT are still allowed, but a single client can't exhaust the global
+// limit.
+constexpr size_t maxConnectionsPerClient = 40;
+
+// Maximum number of requests that can be processed by handlers at the same
+// time.  Requests above this limit are queued per client and executed in
+// round robin order between clients.
+constexpr size_t maxInFlightRequests = 64;
+
+// Maximum number of requests a single client may have waiting for a slot.
+constexpr size_t maxQueuedRequestsPerClient = 32;
+
+// The admission counters are logged at most this often, while there are
+// connections or requests to count
+constexpr std::chrono::seconds admissionStatsLogInterval(60);
+
+struct AdmissionStats
+{
+    size_t activeConnections = 0;
+    size_t inFlightRequests = 0;
+    size_t queuedRequests = 0;
+    uint64_t acceptedConnections = 0;
+    uint64_t rejectedConnectionsGlobal = 0;
+    uint64_t rejectedConnectionsPerClient = 0;
+    uint64_t queuedRequestsTotal = 0;
+    uint64_t rejectedRequests = 0;
+    uint64_t acceptPauses = 0;
+};
+
+struct AdmissionLimits
+{
+    size_t connections = maxConnections;
+    size_t connectionsPerClient = maxConnectionsPerClient;
+    size_t inFlightRequests = maxInFlightRequests;
+    size_t queuedRequestsPerClient = maxQueuedRequestsPerClient;
+};
+
+class ConnectionAdmission;
+
+// Handle representing one slot in the admission controller.  Releases the
+// slot when destroyed.  Move only.
+template <bool IsRequest>
+class AdmissionTicket
+{
+  public:
+    AdmissionTicket() = default;
+
+    AdmissionTicket(ConnectionAdmission& ownerIn,
+                    const boost::asio::ip::address& clientIn) :
+        owner(&ownerIn), client(clientIn)
+    {}
+
+    ~AdmissionTicket()
+    {
+        release();
+    }
+
+    AdmissionTicket(const AdmissionTicket&) = delete;
+    AdmissionTicket& operator=(const AdmissionTicket&) = delete;
+
+    AdmissionTicket(AdmissionTicket&& other) noexcept :
+        owner(std::exchange(other.owner, nullptr)), client(other.client)
+    {}
+
+    AdmissionTicket& operator=(AdmissionTicket&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            owner = std::exchange(other.owner, nullptr);
+            client = other.client;
+        }
+        return *this;
+    }
+
+    explicit operator bool() const
+    {
+        return owner != nullptr;
+    }
+
+    void release();
+
+  private:
+    ConnectionAdmission* owner = nullptr;
+    boost::asio::ip::address client;
+};
+
+using ConnectionTicket = AdmissionTicket<false>;
+using RequestSlot = AdmissionTicket<true>;
+
+// Tracks open connections and in flight requests across the whole server,
+// so that a single misbehaving client can't starve everyone else of sockets
+// or handler time.
+class ConnectionAdmission
+{
+  public:
+    using RequestHandler = std::function<void(RequestSlot&&)>;
+
+    explicit ConnectionAdmission(AdmissionLimits limitsIn = {}) :
+        limits(limitsIn)
+    {}
+
+    ConnectionAdmission(const ConnectionAdmission&) = delete;
+    ConnectionAdmission& operator=(const ConnectionAdmission&) = delete;
+    ConnectionAdmission(ConnectionAdmission&&) = delete;
+    ConnectionAdmission& operator=(ConnectionAdmission&&) = delete;
+    ~ConnectionAdmission() = default;
+
+    static ConnectionAdmission& getInstance()
+    {
+        static ConnectionAdmission admission;
+        return admission;
+    }
+
+    // Attempts to admit a new connection from the given client.  Returns an
+    // empty optional if either the global or the per client limit has been
+    // reached.
+    std::optional<ConnectionTicket> admitConnection(
+        const boost::asio::ip::address& client)
+    {
+        logStatsIfDue(std::chrono::steady_clock::now());
+        if (stats.activeConnections >= limits.connections)
+        {
+            stats.rejectedConnectionsGlobal++;
+            BMCWEB_LOG_WARNING("Max connection count {} exceeded",
+                               limits.connections);
+            return std::nullopt;
+        }
+        size_t& clientCount = clientConnections[client];
+        if (clientCount >= limits.connectionsPerClient)
+        {
+            stats.rejectedConnectionsPerClient++;
+            BMCWEB_LOG_WARNING("Client {} exceeded max connection count {}",
+                               client.to_string(), limits.connectionsPerClient);
+            return std::nullopt;
+        }
+        clientCount++;
+        stats.activeConnections++;
+        stats.acceptedConnections++;
+        return ConnectionTicket(*this, client);
+    }
+
+    // Returns true if no more connections can be admitted, and accepting
+    // should be paused until a connection closes.
+    bool isSaturated() const
+    {
+        return stats.activeConnections >= limits.connections;
+    }
+
+    // Called once when a connection slot frees up after isSaturated()
+    // returned true and pauseAccept() was called.
+    void pauseAccept(std::function<void()>&& onResume)
+    {
+        stats.acceptPauses++;
+        resumeAccept = std::move(onResume);
+    }
+
+    // Runs the handler when a request slot is available.  Requests that
+    // can't be run immediately are queued per client, and queued clients are
+    // served in round robin order.  Returns false if the client already has
+    // too many queued requests, in which case the handler is not called.
+    bool submitRequest(const boost::asio::ip::address& client,
+                       RequestHandler&& handler)
+    {
+        logStatsIfDue(std::chrono::steady_clock::now());
+        if (stats.inFlightRequests < limits.inFlightRequests &&
+            queuedClients.empty())
+        {
+            stats.inFlightRequests++;
+            handler(RequestSlot(*this, client));
+            return true;
+        }
+        std::deque<RequestHandler>& queue = queuedRequests[client];
+        if (queue.size() >= limits.queuedRequestsPerClient)
+        {
+            stats.rejectedRequests++;
+            BMCWEB_LOG_WARNING("Client {} exceeded request queue size {}",
+                               client.to_string(),
+                               limits.queuedRequestsPerClient);
+            if (queue.empty())
+            {
+                queuedRequests.erase(client);
+            }
+            return false;
+        }
+        if (queue.empty())
+        {
+            queuedClients.push_back(client);
+        }
+        queue.emplace_back(std::move(handler));
+        stats.queuedRequests++;
+        stats.queuedRequestsTotal++;
+        return true;
+    }
+
+    const AdmissionStats& getStats() const
+    {
+        return stats;
+    }
+
+    // Logs the counters, unless they were logged less than
+    // admissionStatsLogInterval before now.  Returns whether they were.
+    bool logStatsIfDue(std::chrono::steady_clock::time_point now)
+    {
+        if (lastStatsLog && now - *lastStatsLog < admissionStatsLogInterval)
+        {
+            return false;
+        }
+        lastStatsLog = now;
+        BMCWEB_LOG_INFO(
+            "Admission: {} connections, {} requests in flight, {} queued. "
+            "Since start: {} connections accepted, {} refused at the global "
+            "limit, {} at the client limit, {} accept pauses, {} requests "
+            "queued, {} refused",
+            stats.activeConnections, stats.inFlightRequests,
+            stats.queuedRequests, stats.acceptedConnections,
+            stats.rejectedConnectionsGlobal, stats.rejectedConnectionsPerClient,
+            stats.acceptPauses, stats.queuedRequestsTotal,
+            stats.rejectedRequests);
+        return true;
+    }
+
+    const AdmissionLimits& getLimits() const
+    {
+        return limits;
+    }
+
+  private:
+    friend class AdmissionTicket<false>;
+    friend class AdmissionTicket<true>;
+
+    void releaseConnection(const boost::asio::ip::address& client)
+    {
+        auto it = clientConnections.find(client);
+        if (it != clientConnections.end())
+        {
+            it->second--;
+            if (it->second == 0)
+            {
+                clientConnections.erase(it);
+            }
+        }
+        stats.activeConnections--;
+
+        if (resumeAccept && !isSaturated())
+        {
+            BMCWEB_LOG_INFO("Connection slot available, resuming accept");
+            boost::asio::post(getIoContext(), std::exchange(resumeAccept, {}));
+        }
+    }
+
+    void releaseRequest()
+    {
+        stats.inFlightRequests--;
+        if (queuedClients.empty())
+        {
+            return;
+        }
+        boost::asio::ip::address client = queuedClients.front();
+        queuedClients.pop_front();
+
+        auto it = queuedRequests.find(client);
+        if (it == queuedRequests.end() || it->second.empty())
+        {
+            BMCWEB_LOG_CRITICAL("Queued client had no pending requests");
+            return;
+        }
+        RequestHandler next = std::move(it->second.front());
+        it->second.pop_front();
+        if (it->second.empty())
+        {
+            queuedRequests.erase(it);
+        }
+        else
+        {
+            // Move to the back of the line, so other clients get a turn
+            queuedClients.push_back(client);
+        }
+        stats.queuedRequests--;
+        stats.inFlightRequests++;
+
+        // Post rather than call, to avoid recursing through the completion
+        // handler of the request that just finished.
+        boost::asio::post(getIoContext(),
+                          [this, client, next{std::move(next)}]() mutable {
+                              next(RequestSlot(*this, client));
+                          });
+    }
+
+    AdmissionLimits limits;
+    AdmissionStats stats;
+    std::optional<std::chrono::steady_clock::time_point> lastStatsLog;
+
+    std::map<boost::asio::ip::address, size_t> clientConnections;
+    std::map<boost::asio::ip::address, std::deque<RequestHandler>>
+        queuedRequests;
+    std::deque<boost::asio::ip::address> queuedClients;
+
+    std::function<void()> resumeAccept;
+};
+
+template <bool IsRequest>
+inline void AdmissionTicket<IsRequest>::release()
+{
+    ConnectionAdmission* ownerPtr = std::exchange(owner, nullptr);
+    if (ownerPtr == nullptr)
+    {
+        return;
+    }
+    if constexpr (IsRequest)
+    {
+        ownerPtr->releaseRequest();
+    }
+    else
+    {
+        ownerPtr->releaseConnection(client);
+    }
+}
+
+} // namespace crow
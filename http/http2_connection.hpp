@@ -6,6 +6,7 @@
 #include "async_resp.hpp"
 #include "authentication.hpp"
 #include "complete_response_fields.hpp"
+#include "connection_admission.hpp"
 #include "forward_unauthorized.hpp"
 #include "http_body.hpp"
 #include "http_connect_types.hpp"
@@ -21,11 +22,13 @@
 #include <unistd.h>
 
 #include <boost/asio/buffer.hpp>
+#include <boost/asio/ip/address.hpp>
 #include <boost/asio/ssl/stream.hpp>
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/fields.hpp>
 #include <boost/beast/http/message.hpp>
+#include <boost/beast/http/status.hpp>
 #include <boost/beast/http/verb.hpp>
 #include <boost/optional/optional.hpp>
 #include <boost/system/error_code.hpp>
@@ -57,6 +60,8 @@ struct Http2StreamData
     std::string acceptEnc;
     Response res;
     std::optional<bmcweb::HttpBody::writer> writer;
+    // Held while the handler runs, like a request on an HTTP/1 connection
+    RequestSlot requestSlot;
 };
 
 template <typename Adaptor, typename Handler>
@@ -75,6 +80,16 @@ class HTTP2Connection :
         getCachedDateStr(getCachedDateStrF), mtlsSession(mtlsSessionIn)
     {}
 
+    void setAdmissionTicket(ConnectionTicket&& ticket)
+    {
+        admissionTicket = std::move(ticket);
+    }
+
+    void setClientIp(const boost::asio::ip::address& clientIpIn)
+    {
+        clientIp = clientIpIn;
+    }
+
     void start()
     {
         // Create the control stream
@@ -219,6 +234,8 @@ class HTTP2Connection :
             return -1;
         }
         Http2StreamData& stream = it->second;
+        // Let the next queued request run
+        stream.requestSlot.release();
         Response& res = stream.res;
         res = std::move(completedRes);
 
@@ -342,7 +359,27 @@ class HTTP2Connection :
         {
             asyncResp->res.setExpectedEtag(expectedEtag);
         }
-        handler->handle(it->second.req, asyncResp);
+        // Streams share the in flight limit and the fair queue with HTTP/1
+        // requests, so a client can't get around them by multiplexing
+        bool submitted = ConnectionAdmission::getInstance().submitRequest(
+            clientIp, [self(shared_from_this()), streamId, req = it->second.req,
+                       asyncResp](RequestSlot&& slot) {
+                auto stream = self->streams.find(streamId);
+                if (stream == self->streams.end())
+                {
+                    // Reset by the client while it was queued
+                    return;
+                }
+                stream->second.requestSlot = std::move(slot);
+                self->handler->handle(req, asyncResp);
+            });
+        if (!submitted)
+        {
+            asyncResp->res.result(
+                boost::beast::http::status::service_unavailable);
+            asyncResp->res.addHeader(boost::beast::http::field::retry_after,
+                                     "1");
+        }
         return 0;
     }
 
@@ -684,6 +721,9 @@ class HTTP2Connection :
 
     std::shared_ptr<persistent_data::UserSession> mtlsSession;
 
+    ConnectionTicket admissionTicket;
+    boost::asio::ip::address clientIp;
+
     using std::enable_shared_from_this<
         HTTP2Connection<Adaptor, Handler>>::shared_from_this;
 
@@ -24,7 +24,9 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -44,6 +46,61 @@ struct HttpBody
     static std::uint64_t size(const value_type& body);
 };
 
+// Receives a request body as it is read off the socket, for routes that
+// stream large uploads instead of buffering them in the request.  Errors are
+// kept by the sink and reported by its route handler, so that the rest of
+// the body is still read and the client gets a response.
+//
+// A sink that can't keep up, for example because it writes asynchronously,
+// calls pause() from put(), and the connection stops reading until it calls
+// resume().  The route handler isn't called while the sink is paused.
+class BodySink
+{
+  public:
+    BodySink() = default;
+    virtual ~BodySink() = default;
+
+    BodySink(const BodySink&) = delete;
+    BodySink(BodySink&&) = delete;
+    BodySink& operator=(const BodySink&) = delete;
+    BodySink& operator=(BodySink&&) = delete;
+
+    virtual void put(std::string_view data) = 0;
+    virtual void finish() = 0;
+
+    bool paused() const
+    {
+        return isPaused;
+    }
+
+    // Called by the connection while paused, with what to do on resume()
+    void whenResumed(std::function<void()>&& handler)
+    {
+        resumeHandler = std::move(handler);
+    }
+
+  protected:
+    void pause()
+    {
+        isPaused = true;
+    }
+
+    void resume()
+    {
+        isPaused = false;
+        std::function<void()> handler = std::move(resumeHandler);
+        resumeHandler = nullptr;
+        if (handler)
+        {
+            handler();
+        }
+    }
+
+  private:
+    bool isPaused = false;
+    std::function<void()> resumeHandler;
+};
+
 enum class EncodingType
 {
     Raw,
@@ -62,6 +119,11 @@ class HttpBody::value_type
     DuplicatableFileHandle fileHandle;
     std::optional<size_t> fileSize;
     std::string strBody;
+    // Bytes owned elsewhere, for example a mapped file shared between
+    // responses, sent instead of strBody without being copied
+    std::shared_ptr<const void> sharedOwner;
+    std::string_view sharedBytes;
+    std::shared_ptr<BodySink> bodySink;
 
   public:
     value_type() = default;
@@ -97,11 +159,39 @@ class HttpBody::value_type
         return strBody;
     }
 
+    // The bytes of a body held in memory
+    std::string_view bytes() const
+    {
+        if (sharedOwner != nullptr)
+        {
+            return sharedBytes;
+        }
+        return strBody;
+    }
+
+    // Sends data, which stays valid as long as owner does
+    void setSharedBytes(std::shared_ptr<const void> owner,
+                        std::string_view data)
+    {
+        sharedOwner = std::move(owner);
+        sharedBytes = data;
+    }
+
+    const std::shared_ptr<BodySink>& sink() const
+    {
+        return bodySink;
+    }
+
+    void setSink(std::shared_ptr<BodySink> sinkIn)
+    {
+        bodySink = std::move(sinkIn);
+    }
+
     std::optional<size_t> payloadSize() const
     {
         if (!fileHandle.fileHandle.is_open())
         {
-            return strBody.size();
+            return bytes().size();
         }
         if (fileSize)
         {
@@ -113,12 +203,32 @@ class HttpBody::value_type
         return fileSize;
     }
 
+    // Whether the body is a file of known size that is sent as is, without
+    // being encoded or decompressed, so it can go to the socket by
+    // sendfile(2)
+    bool isRawFile() const
+    {
+        if (!fileHandle.fileHandle.is_open() || !fileSize)
+        {
+            return false;
+        }
+        if (encodingType != EncodingType::Raw)
+        {
+            return false;
+        }
+        return compressionType != CompressionType::Zstd ||
+               clientCompressionType == CompressionType::Zstd;
+    }
+
     void clear()
     {
         strBody.clear();
         strBody.shrink_to_fit();
         fileHandle.fileHandle = boost::beast::file_posix();
         fileSize = std::nullopt;
+        sharedOwner = nullptr;
+        sharedBytes = {};
+        bodySink = nullptr;
         encodingType = EncodingType::Raw;
     }
 
@@ -217,12 +327,13 @@ class HttpBody::writer
         std::pair<const_buffers_type, bool> ret;
         if (!body.file().is_open())
         {
-            size_t remain = body.str().size() - sent;
+            std::string_view bytes = body.bytes();
+            size_t remain = bytes.size() - sent;
             size_t toReturn = std::min(maxSize, remain);
-            ret.first = const_buffers_type(&body.str()[sent], toReturn);
+            ret.first = const_buffers_type(bytes.substr(sent).data(), toReturn);
 
             sent += toReturn;
-            ret.second = sent < body.str().size();
+            ret.second = sent < bytes.size();
             BMCWEB_LOG_INFO("Returning {} bytes more={}", ret.first.size(),
                             ret.second);
             return ret;
@@ -293,7 +404,7 @@ class HttpBody::reader
     void init(const boost::optional<std::uint64_t>& contentLength,
               boost::beast::error_code& ec)
     {
-        if (contentLength)
+        if (contentLength && value.sink() == nullptr)
         {
             if (!value.file().is_open())
             {
@@ -311,14 +422,23 @@ class HttpBody::reader
         for (const auto b : boost::beast::buffers_range_ref(buffers))
         {
             const char* ptr = static_cast<const char*>(b.data());
+            if (value.sink() != nullptr)
+            {
+                value.sink()->put(std::string_view(ptr, b.size()));
+                continue;
+            }
             value.str() += std::string_view(ptr, b.size());
         }
         ec = {};
         return extra;
     }
 
-    static void finish(boost::system::error_code& ec)
+    void finish(boost::system::error_code& ec)
     {
+        if (value.sink() != nullptr)
+        {
+            value.sink()->finish();
+        }
         ec = {};
     }
 };
@@ -6,6 +6,7 @@
 #include "async_resp.hpp"
 #include "authentication.hpp"
 #include "complete_response_fields.hpp"
+#include "connection_admission.hpp"
 #include "forward_unauthorized.hpp"
 #include "http2_connection.hpp"
 #include "http_body.hpp"
@@ -15,17 +16,26 @@
 #include "http_utility.hpp"
 #include "logging.hpp"
 #include "mutual_tls.hpp"
+#include "response_header.hpp"
+#include "security_headers.hpp"
 #include "sessions.hpp"
 #include "str_utility.hpp"
 #include "utility.hpp"
 
+#include <sys/sendfile.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <boost/asio/buffer.hpp>
 #include <boost/asio/error.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/socket_base.hpp>
 #include <boost/asio/ssl/error.hpp>
 #include <boost/asio/ssl/stream.hpp>
 #include <boost/asio/ssl/stream_base.hpp>
 #include <boost/asio/ssl/verify_context.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
 #include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/core/buffers_generator.hpp>
 #include <boost/beast/core/detect_ssl.hpp>
@@ -37,13 +47,17 @@
 #include <boost/beast/http/parser.hpp>
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/http/rfc7230.hpp>
+#include <boost/beast/http/serializer.hpp>
 #include <boost/beast/http/status.hpp>
 #include <boost/beast/http/verb.hpp>
+#include <boost/beast/http/write.hpp>
 #include <boost/none.hpp>
 #include <boost/optional/optional.hpp>
 #include <boost/url/url_view.hpp>
 
+#include <array>
 #include <bit>
+#include <cerrno>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -206,16 +220,15 @@ class Connection :
         }
     }
 
+    void setAdmissionTicket(ConnectionTicket&& ticket)
+    {
+        admissionTicket = std::move(ticket);
+    }
+
     void start()
     {
         BMCWEB_LOG_DEBUG("{} Connection started, total {}", logPtr(this),
                          connectionCount);
-        if (connectionCount >= 200)
-        {
-            BMCWEB_LOG_CRITICAL("{} Max connection count exceeded.",
-                                logPtr(this));
-            return;
-        }
 
         if constexpr (BMCWEB_MUTUAL_TLS_AUTH)
         {
@@ -287,6 +300,8 @@ class Connection :
         auto http2 = std::make_shared<HTTP2Connection<Adaptor, Handler>>(
             std::move(adaptor), handler, getCachedDateStr, httpType,
             mtlsSession);
+        http2->setAdmissionTicket(std::move(admissionTicket));
+        http2->setClientIp(ip);
         if (http2settings.empty())
         {
             http2->start();
@@ -446,7 +461,18 @@ class Connection :
         {
             asyncResp->res.setExpectedEtag(expectedEtag);
         }
-        handler->handle(req, asyncResp);
+        bool submitted = ConnectionAdmission::getInstance().submitRequest(
+            ip, [self(shared_from_this()), asyncResp](RequestSlot&& slot) {
+                self->requestSlot = std::move(slot);
+                self->handler->handle(self->req, asyncResp);
+            });
+        if (!submitted)
+        {
+            asyncResp->res.result(
+                boost::beast::http::status::service_unavailable);
+            asyncResp->res.addHeader(boost::beast::http::field::retry_after,
+                                     "1");
+        }
     }
 
     void hardClose()
@@ -491,11 +517,16 @@ class Connection :
 
     void completeRequest(Response& thisRes)
     {
+        // Let the next queued request run
+        requestSlot.release();
+
         res = std::move(thisRes);
         res.keepAlive(keepAlive);
 
-        completeResponseFields(accept, acceptEncoding, res);
-        res.addHeader(boost::beast::http::field::date, getCachedDateStr());
+        // Picked from the content type the handler set, before the payload
+        // is serialized, as addSecurityHeaders() would
+        commonHeaders = getSecurityHeaderTemplate(res);
+        completeResponsePayload(accept, acceptEncoding, res);
 
         doWrite();
 
@@ -527,6 +558,12 @@ class Connection :
         authenticationEnabled = false;
     }
 
+    // Bytes of file bodies sent by sendfile(2), rather than the serializer
+    uint64_t getSendfileBytes() const
+    {
+        return sendfileBytes;
+    }
+
   private:
     uint64_t getContentLengthLimit()
     {
@@ -636,6 +673,14 @@ class Connection :
                 ip, res, method, value.base(), mtlsSession);
         }
 
+        std::optional<uint64_t> streamLimit =
+            handler->getBodyStreamLimit(value);
+        if (streamLimit && !parse.is_done())
+        {
+            startBodyStream(*streamLimit);
+            return;
+        }
+
         std::string_view expect = value[boost::beast::http::field::expect];
         if (bmcweb::asciiIEquals(expect, "100-continue"))
         {
@@ -660,6 +705,112 @@ class Connection :
         doRead();
     }
 
+    // Routes that stream their body are authorized before any of it is
+    // read, so that an upload the user may not make is refused unread
+    void startBodyStream(uint64_t bodyLimit)
+    {
+        if (!parser)
+        {
+            BMCWEB_LOG_ERROR("Parser was unexpectedly null");
+            return;
+        }
+
+        // The request as far as it has been read, to check privileges
+        std::error_code reqEc;
+        auto headerReq = std::make_shared<Request>(
+            boost::beast::http::request<bmcweb::HttpBody>(parser->get().base()),
+            reqEc);
+        using boost::beast::http::field;
+        accept = headerReq->getHeaderValue(field::accept);
+        acceptEncoding = headerReq->getHeaderValue(field::accept_encoding);
+        if (reqEc)
+        {
+            BMCWEB_LOG_DEBUG("Request failed to construct{}", reqEc.message());
+            res.result(boost::beast::http::status::bad_request);
+            refuseBodyStream();
+            return;
+        }
+
+        const boost::optional<uint64_t> contentLength =
+            parser->content_length();
+        if (contentLength && *contentLength > bodyLimit)
+        {
+            BMCWEB_LOG_DEBUG(
+                "{} Content length {} was greater than route limit {}",
+                logPtr(this), *contentLength, bodyLimit);
+            res.result(boost::beast::http::status::payload_too_large);
+            refuseBodyStream();
+            return;
+        }
+        if (authenticationEnabled && userSession == nullptr)
+        {
+            BMCWEB_LOG_WARNING("{} Authentication failed, upload refused",
+                               logPtr(this));
+            forward_unauthorized::sendUnauthorized(
+                headerReq->url().encoded_path(),
+                headerReq->getHeaderValue("X-Requested-With"),
+                headerReq->getHeaderValue("Accept"), res);
+            refuseBodyStream();
+            return;
+        }
+
+        headerReq->session = userSession;
+        headerReq->ipAddress = ip;
+
+        auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+        asyncResp->res.setCompleteRequestHandler(
+            [self(shared_from_this())](Response& thisRes) {
+                // The body is left unread, so the connection can't be reused
+                self->keepAlive = false;
+                self->completeRequest(thisRes);
+            });
+        handler->startBodyStream(
+            headerReq, asyncResp,
+            [self(shared_from_this()), asyncResp,
+             bodyLimit](std::shared_ptr<bmcweb::BodySink> sink) {
+                asyncResp->res.setCompleteRequestHandler(nullptr);
+                self->afterBodyStreamStarted(std::move(sink), bodyLimit);
+            });
+    }
+
+    // The body is left unread, so the connection can't be reused
+    void refuseBodyStream()
+    {
+        keepAlive = false;
+        completeRequest(res);
+    }
+
+    void afterBodyStreamStarted(std::shared_ptr<bmcweb::BodySink>&& sink,
+                                uint64_t bodyLimit)
+    {
+        if (!parser)
+        {
+            BMCWEB_LOG_ERROR("Parser was unexpectedly null");
+            return;
+        }
+        if (sink == nullptr)
+        {
+            // The route buffers this request after all
+            if (!handleContentLengthError())
+            {
+                return;
+            }
+            bodyLimit = getContentLengthLimit();
+        }
+        parser->get().body().setSink(std::move(sink));
+        parser->body_limit(bodyLimit);
+
+        std::string_view expect =
+            parser->get()[boost::beast::http::field::expect];
+        if (bmcweb::asciiIEquals(expect, "100-continue"))
+        {
+            res.result(boost::beast::http::status::continue_);
+            doWrite();
+            return;
+        }
+        doRead();
+    }
+
     void doReadHeaders()
     {
         BMCWEB_LOG_DEBUG("{} doReadHeaders", logPtr(this));
@@ -698,6 +849,15 @@ class Connection :
                              ec.message());
             if (ec == boost::beast::http::error::body_limit)
             {
+                if (parser && parser->get().body().sink() != nullptr)
+                {
+                    // A streamed body without a content length went over
+                    // the route limit
+                    res.result(boost::beast::http::status::payload_too_large);
+                    keepAlive = false;
+                    doWrite();
+                    return;
+                }
                 if (handleContentLengthError())
                 {
                     BMCWEB_LOG_CRITICAL("Body length limit reached, "
@@ -726,11 +886,28 @@ class Connection :
             cancelDeadlineTimer();
         }
 
+        continueBody();
+    }
+
+    void continueBody()
+    {
         if (!parser)
         {
             BMCWEB_LOG_ERROR("Parser was unexpectedly null");
             return;
         }
+        const std::shared_ptr<bmcweb::BodySink>& sink =
+            parser->get().body().sink();
+        if (sink != nullptr && sink->paused())
+        {
+            // Let the sink catch up before reading more of the body, or
+            // calling the handler
+            BMCWEB_LOG_DEBUG("{} Body sink paused", logPtr(this));
+            cancelDeadlineTimer();
+            sink->whenResumed(std::bind_front(&self_type::afterSinkResumed,
+                                              this, weak_from_this()));
+            return;
+        }
         if (!parser->is_done())
         {
             doRead();
@@ -741,6 +918,16 @@ class Connection :
         handle();
     }
 
+    void afterSinkResumed(const std::weak_ptr<self_type>& weakSelf)
+    {
+        std::shared_ptr<self_type> self = weakSelf.lock();
+        if (!self)
+        {
+            return;
+        }
+        continueBody();
+    }
+
     void doRead()
     {
         BMCWEB_LOG_DEBUG("{} doRead", logPtr(this));
@@ -774,6 +961,7 @@ class Connection :
                          bytesTransferred, ec);
 
         cancelDeadlineTimer();
+        fileSerializer.reset();
 
         if (ec == boost::system::errc::operation_would_block ||
             ec == boost::system::errc::resource_unavailable_try_again)
@@ -842,6 +1030,58 @@ class Connection :
         res.preparePayload(urlView);
 
         startDeadline();
+        std::string_view common = std::exchange(commonHeaders, {});
+        if (!res.response.body().file().is_open())
+        {
+            // Bodies held in memory are written in one go with a header
+            // rendered from the common header template
+            std::string date;
+            if (!common.empty())
+            {
+                date = getCachedDateStr();
+            }
+            renderResponseHeader(res, common, date, headerBuffer);
+            std::string_view body = res.response.body().bytes();
+            if (!res.response.has_content_length() ||
+                res.response[boost::beast::http::field::content_length] ==
+                    "0")
+            {
+                // preparePayload() drops the body of responses that can't
+                // have one
+                body = {};
+            }
+            std::array<boost::asio::const_buffer, 2> buffers{
+                boost::asio::buffer(headerBuffer), boost::asio::buffer(body)};
+            if (httpType == HttpType::HTTP)
+            {
+                boost::asio::async_write(
+                    adaptor.next_layer(), buffers,
+                    std::bind_front(&self_type::afterDoWrite, this,
+                                    shared_from_this()));
+            }
+            else
+            {
+                boost::asio::async_write(
+                    adaptor, buffers,
+                    std::bind_front(&self_type::afterDoWrite, this,
+                                    shared_from_this()));
+            }
+            return;
+        }
+
+        if (!common.empty())
+        {
+            addSecurityHeaders(res);
+            res.addHeader(boost::beast::http::field::date, getCachedDateStr());
+        }
+        if constexpr (std::is_same_v<Adaptor, boost::asio::ip::tcp::socket>)
+        {
+            if (httpType == HttpType::HTTP && res.response.body().isRawFile())
+            {
+                doWriteFile();
+                return;
+            }
+        }
         if (httpType == HttpType::HTTP)
         {
             boost::beast::async_write(
@@ -860,6 +1100,115 @@ class Connection :
         }
     }
 
+    // Files sent as is over plain HTTP go from the page cache to the socket
+    // by sendfile(2), rather than being copied through a userspace buffer.
+    // Over TLS the record encryption happens in userspace, so those are
+    // always written through the serializer.
+    void doWriteFile()
+    {
+        fileSerializer.emplace(res.response);
+        boost::beast::http::async_write_header(
+            adaptor.next_layer(), *fileSerializer,
+            std::bind_front(&self_type::afterWriteFileHeader, this,
+                            shared_from_this()));
+    }
+
+    void afterWriteFileHeader(const std::shared_ptr<self_type>& self,
+                              const boost::system::error_code& ec,
+                              std::size_t bytesTransferred)
+    {
+        if (ec)
+        {
+            afterDoWrite(self, ec, bytesTransferred);
+            return;
+        }
+        int fileFd = res.response.body().file().native_handle();
+        // The body starts at the current file position, like it would for
+        // the serializer
+        fileOffset = lseek(fileFd, 0, SEEK_CUR);
+        if (fileOffset == -1)
+        {
+            fileOffset = 0;
+        }
+        size_t fileSize = res.response.body().payloadSize().value_or(0);
+        fileEnd = fileOffset + static_cast<off_t>(fileSize);
+        boost::system::error_code nbEc;
+        adaptor.next_layer().native_non_blocking(true, nbEc);
+        if (nbEc)
+        {
+            writeFileThroughSerializer();
+            return;
+        }
+        sendFile(self, {});
+    }
+
+    void sendFile(const std::shared_ptr<self_type>& self,
+                  const boost::system::error_code& ec)
+    {
+        if (ec)
+        {
+            afterDoWrite(self, ec, 0);
+            return;
+        }
+        int socketFd = adaptor.next_layer().native_handle();
+        int fileFd = res.response.body().file().native_handle();
+        while (fileOffset < fileEnd)
+        {
+            ssize_t sent =
+                sendfile(socketFd, fileFd, &fileOffset,
+                         static_cast<size_t>(fileEnd - fileOffset));
+            if (sent > 0)
+            {
+                sendfileBytes += static_cast<uint64_t>(sent);
+                continue;
+            }
+            if (sent == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            if (sent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                adaptor.next_layer().async_wait(
+                    boost::asio::socket_base::wait_write,
+                    std::bind_front(&self_type::sendFile, this, self));
+                return;
+            }
+            if (sent == -1 && (errno == EINVAL || errno == ENOSYS))
+            {
+                // The file doesn't support sendfile, for example a file in
+                // a filesystem without page cache
+                BMCWEB_LOG_DEBUG("{} sendfile unsupported, falling back",
+                                 logPtr(this));
+                writeFileThroughSerializer();
+                return;
+            }
+            BMCWEB_LOG_WARNING("{} sendfile failed at offset {}: {}",
+                               logPtr(this), fileOffset, errno);
+            // The content length was already sent, so the response can't be
+            // completed
+            afterDoWrite(self, boost::asio::error::connection_aborted, 0);
+            return;
+        }
+        afterDoWrite(self, {}, static_cast<size_t>(fileEnd));
+    }
+
+    void writeFileThroughSerializer()
+    {
+        int fileFd = res.response.body().file().native_handle();
+        // The serializer reads the rest of the body from the file position
+        if (lseek(fileFd, fileOffset, SEEK_SET) == -1)
+        {
+            BMCWEB_LOG_ERROR("{} Failed to seek in file", logPtr(this));
+            afterDoWrite(shared_from_this(),
+                         boost::asio::error::connection_aborted, 0);
+            return;
+        }
+        boost::beast::http::async_write(
+            adaptor.next_layer(), *fileSerializer,
+            std::bind_front(&self_type::afterDoWrite, this,
+                            shared_from_this()));
+    }
+
     void cancelDeadlineTimer()
     {
         timer.cancel();
@@ -944,10 +1293,25 @@ class Connection :
     std::string acceptEncoding;
 
     Response res;
+    // Security headers of the response being completed, from
+    // getSecurityHeaderTemplate(), and the buffer its header is rendered
+    // into, kept between responses so its capacity is reused
+    std::string_view commonHeaders;
+    std::string headerBuffer;
+    // Serializer of a file response being sent by sendfile(2), and the range
+    // of the file still to send
+    std::optional<boost::beast::http::response_serializer<bmcweb::HttpBody>>
+        fileSerializer;
+    off_t fileOffset = 0;
+    off_t fileEnd = 0;
+    uint64_t sendfileBytes = 0;
 
     std::shared_ptr<persistent_data::UserSession> userSession;
     std::shared_ptr<persistent_data::UserSession> mtlsSession;
 
+    ConnectionTicket admissionTicket;
+    RequestSlot requestSlot;
+
     boost::asio::steady_timer timer;
 
     bool keepAlive = true;
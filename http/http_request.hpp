@@ -143,6 +143,13 @@ struct Request
         return req.body().str();
     }
 
+    // Set when the route streamed the body into a sink as it was read, in
+    // which case body() is empty
+    const std::shared_ptr<bmcweb::BodySink>& bodySink() const
+    {
+        return req.body().sink();
+    }
+
     bool target(std::string_view target)
     {
         req.target(target);
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #pragma once
+#include "dbus_round_trips.hpp"
 #include "http_body.hpp"
 #include "logging.hpp"
 #include "utils/hex_utils.hpp"
@@ -20,6 +21,7 @@
 #include <cstdint>
 #include <filesystem>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -48,6 +50,8 @@ struct Response
     http::response<bmcweb::HttpBody> response;
 
     nlohmann::json jsonValue;
+    // D-Bus calls made while the response was being built
+    dbus::utility::RoundTripStats dbusStats;
     using fields_type = http::header<false, http::fields>;
     fields_type& fields()
     {
@@ -77,6 +81,7 @@ struct Response
     Response() = default;
     Response(Response&& res) noexcept :
         response(std::move(res.response)), jsonValue(std::move(res.jsonValue)),
+        dbusStats(res.dbusStats),
         requestExpectedEtag(std::move(res.requestExpectedEtag)),
         currentOverrideEtag(std::move(res.currentOverrideEtag)),
         completed(res.completed)
@@ -104,6 +109,7 @@ struct Response
         }
         response = std::move(r.response);
         jsonValue = std::move(r.jsonValue);
+        dbusStats = r.dbusStats;
         requestExpectedEtag = std::move(r.requestExpectedEtag);
         currentOverrideEtag = std::move(r.currentOverrideEtag);
 
@@ -267,6 +273,13 @@ struct Response
         response.body().str() = std::move(bodyPart);
     }
 
+    // Sends bytes held elsewhere without copying them, for example a mapped
+    // file.  owner keeps them alive until the response is sent.
+    void writeShared(std::shared_ptr<const void> owner, std::string_view bytes)
+    {
+        response.body().setSharedBytes(std::move(owner), bytes);
+    }
+
     void end()
     {
         if (completed)
@@ -4,18 +4,21 @@
 
 #include "bmcweb_config.h"
 
+#include "connection_admission.hpp"
 #include "http_connect_types.hpp"
 #include "http_connection.hpp"
 #include "io_context_singleton.hpp"
 #include "logging.hpp"
 #include "ssl_key_handler.hpp"
 
+#include <boost/asio/error.hpp>
 #include <boost/asio/ip/address.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/signal_set.hpp>
 #include <boost/asio/ssl/context.hpp>
 #include <boost/asio/ssl/stream.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <boost/beast/core/stream_traits.hpp>
 
 #include <chrono>
 #include <csignal>
@@ -23,6 +26,7 @@
 #include <ctime>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -51,10 +55,10 @@ class Server
 
     void updateDateStr()
     {
-        time_t lastTimeT = time(nullptr);
+        dateTime = time(nullptr);
         tm myTm{};
 
-        gmtime_r(&lastTimeT, &myTm);
+        gmtime_r(&dateTime, &myTm);
 
         dateStr.resize(100);
         size_t dateStrSz = strftime(dateStr.data(), dateStr.size() - 1,
@@ -67,13 +71,11 @@ class Server
         loadCertificate();
         updateDateStr();
 
+        // The Date header has a resolution of one second, so it's rendered
+        // at most once a second, however many responses are sent
         getCachedDateStr = [this]() -> std::string {
-            static std::chrono::time_point<std::chrono::steady_clock>
-                lastDateUpdate = std::chrono::steady_clock::now();
-            if (std::chrono::steady_clock::now() - lastDateUpdate >=
-                std::chrono::seconds(10))
+            if (time(nullptr) != dateTime)
             {
-                lastDateUpdate = std::chrono::steady_clock::now();
                 updateDateStr();
             }
             return dateStr;
@@ -125,12 +127,51 @@ class Server
 
     using SocketPtr = std::unique_ptr<Adaptor>;
 
-    void afterAccept(SocketPtr socket, HttpType httpType,
+    static bool isResourceExhausted(const boost::system::error_code& ec)
+    {
+        return ec == boost::asio::error::no_descriptors ||
+               ec == boost::asio::error::no_buffer_space ||
+               ec == boost::asio::error::no_memory ||
+               ec == boost::system::errc::too_many_files_open_in_system;
+    }
+
+    void afterAccept(SocketPtr socket, Acceptor& accept,
                      const boost::system::error_code& ec)
     {
         if (ec)
         {
+            if (ec == boost::asio::error::operation_aborted)
+            {
+                return;
+            }
             BMCWEB_LOG_ERROR("Failed to accept socket {}", ec);
+            if (isResourceExhausted(ec))
+            {
+                // Out of file descriptors or memory.  Retrying immediately
+                // would spin, so back off until something is released.
+                delayAccept(accept);
+                return;
+            }
+            doAccept(accept);
+            return;
+        }
+
+        ConnectionAdmission& admission = ConnectionAdmission::getInstance();
+
+        boost::system::error_code endpointEc;
+        boost::asio::ip::tcp::endpoint endpoint =
+            boost::beast::get_lowest_layer(*socket).remote_endpoint(endpointEc);
+        if (endpointEc)
+        {
+            BMCWEB_LOG_ERROR("Failed to get the client's IP Address. ec : {}",
+                             endpointEc);
+        }
+        std::optional<ConnectionTicket> ticket =
+            admission.admitConnection(endpoint.address());
+        if (!ticket)
+        {
+            // Dropping the socket closes it
+            acceptNextOrPause(accept);
             return;
         }
 
@@ -145,36 +186,100 @@ class Server
                                                  *adaptorCtx);
         using ConnectionType = Connection<Adaptor, Handler>;
         auto connection = std::make_shared<ConnectionType>(
-            handler, httpType, std::move(timer), getCachedDateStr,
+            handler, accept.httpType, std::move(timer), getCachedDateStr,
             std::move(stream));
+        connection->setAdmissionTicket(std::move(*ticket));
 
         boost::asio::post(getIoContext(),
                           [connection] { connection->start(); });
 
-        doAccept();
+        acceptNextOrPause(accept);
     }
 
-    void doAccept()
+    void acceptNextOrPause(Acceptor& accept)
+    {
+        ConnectionAdmission& admission = ConnectionAdmission::getInstance();
+        if (!admission.isSaturated())
+        {
+            doAccept(accept);
+            return;
+        }
+        // Leave the remaining connections in the kernel backlog until a
+        // connection slot is freed up.
+        pausedAcceptors.push_back(&accept);
+        if (pausedAcceptors.size() == 1)
+        {
+            BMCWEB_LOG_WARNING("Connection limit reached, pausing accept");
+            admission.pauseAccept(std::bind_front(&self_t::resumeAccept, this));
+        }
+    }
+
+    void resumeAccept()
+    {
+        std::vector<Acceptor*> paused = std::exchange(pausedAcceptors, {});
+        for (Acceptor* accept : paused)
+        {
+            doAccept(*accept);
+        }
+    }
+
+    void delayAccept(Acceptor& accept)
+    {
+        pausedAcceptors.push_back(&accept);
+        // Setting the expiry cancels a wait in progress, so only the first
+        // acceptor to pause starts the timer, and the others wait on it
+        if (pausedAcceptors.size() != 1)
+        {
+            return;
+        }
+        acceptRetryTimer.expires_after(std::chrono::seconds(1));
+        acceptRetryTimer.async_wait(
+            [this](const boost::system::error_code& timerEc) {
+                if (timerEc)
+                {
+                    return;
+                }
+                resumeAccept();
+            });
+    }
+
+    // Number of acceptors with no accept outstanding
+    size_t pausedAcceptorCount() const
+    {
+        return pausedAcceptors.size();
+    }
+
+    void doAccept(Acceptor& accept)
     {
         SocketPtr socket = std::make_unique<Adaptor>(getIoContext());
         // Keep a raw pointer so when the socket is moved, the pointer is still
         // valid
         Adaptor* socketPtr = socket.get();
+        accept.acceptor.async_accept(
+            *socketPtr, std::bind_front(&self_t::afterAccept, this,
+                                        std::move(socket), std::ref(accept)));
+    }
+
+    void doAccept()
+    {
         for (Acceptor& accept : acceptors)
         {
-            accept.acceptor.async_accept(
-                *socketPtr,
-                std::bind_front(&self_t::afterAccept, this, std::move(socket),
-                                accept.httpType));
+            doAccept(accept);
         }
     }
 
   private:
     std::function<std::string()> getCachedDateStr;
     std::vector<Acceptor> acceptors;
+    // Acceptors that currently have no accept outstanding, either because
+    // the connection limit was reached or because the process ran out of
+    // resources
+    std::vector<Acceptor*> pausedAcceptors;
+    boost::asio::steady_timer acceptRetryTimer{getIoContext()};
     boost::asio::signal_set signals;
 
     std::string dateStr;
+    time_t dateTime = 0;
 
     Handler* handler;
 
@@ -3,10 +3,13 @@
 #include "mutual_tls.hpp"
 
 #include "identity.hpp"
+#include "mutual_tls_identity_cache.hpp"
 #include "mutual_tls_private.hpp"
 #include "sessions.hpp"
 
+#include <array>
 #include <bit>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -15,6 +18,7 @@
 extern "C"
 {
 #include <openssl/asn1.h>
+#include <openssl/evp.h>
 #include <openssl/obj_mac.h>
 #include <openssl/objects.h>
 #include <openssl/types.h>
@@ -30,6 +34,50 @@ extern "C"
 
 #include <memory>
 #include <string_view>
+#include <utility>
+
+namespace
+{
+// More than the distinct client certificates one BMC sees
+constexpr size_t mtlsIdentityCacheSize = 64;
+
+MtlsIdentityCache& getMtlsIdentityCache()
+{
+    static MtlsIdentityCache cache(mtlsIdentityCacheSize);
+    return cache;
+}
+} // namespace
+
+void clearMtlsIdentityCache()
+{
+    getMtlsIdentityCache().clear();
+}
+
+std::string getFingerprintFromCert(X509* cert)
+{
+    std::array<unsigned char, EVP_MAX_MD_SIZE> digest{};
+    unsigned int length = 0;
+    if (X509_digest(cert, EVP_sha256(), digest.data(), &length) != 1)
+    {
+        BMCWEB_LOG_DEBUG("TLS cannot get certificate fingerprint");
+        return "";
+    }
+    return {digest.begin(), digest.begin() + length};
+}
+
+std::optional<std::chrono::system_clock::time_point> getNotAfterFromCert(
+    X509* cert)
+{
+    int days = 0;
+    int seconds = 0;
+    if (ASN1_TIME_diff(&days, &seconds, nullptr, X509_get0_notAfter(cert)) !=
+        1)
+    {
+        return std::nullopt;
+    }
+    return std::chrono::system_clock::now() + std::chrono::days(days) +
+           std::chrono::seconds(seconds);
+}
 
 std::string getCommonNameFromCert(X509* cert)
 {
@@ -223,18 +271,52 @@ std::shared_ptr<persistent_data::UserSession> verifyMtlsUser(
 
     BMCWEB_LOG_DEBUG("Certificate verification of final depth");
 
-    if (X509_check_purpose(peerCert, X509_PURPOSE_SSL_CLIENT, 0) != 1)
+    // A user mapped from a UserPrincipalName depends on the hostname too
+    std::string hostname;
+    if (persistent_data::SessionStore::getInstance()
+            .getAuthMethodsConfig()
+            .mTLSCommonNameParsingMode ==
+        persistent_data::MTLSCommonNameParseMode::UserPrincipalName)
     {
-        BMCWEB_LOG_DEBUG(
-            "Chain does not allow certificate to be used for SSL client authentication");
-        return nullptr;
+        hostname = getHostName();
+    }
+    MtlsIdentityCache& cache = getMtlsIdentityCache();
+    std::string fingerprint = getFingerprintFromCert(peerCert);
+    std::optional<std::string> cachedUser;
+    if (!fingerprint.empty())
+    {
+        cachedUser = cache.find(fingerprint, hostname,
+                                std::chrono::system_clock::now());
     }
 
-    std::string sslUser = getUsernameFromCert(peerCert);
-    if (sslUser.empty())
+    std::string sslUser;
+    if (cachedUser)
     {
-        BMCWEB_LOG_WARNING("Failed to get user from peer certificate");
-        return nullptr;
+        BMCWEB_LOG_DEBUG("Using the user already mapped from this certificate");
+        sslUser = std::move(*cachedUser);
+    }
+    else
+    {
+        if (X509_check_purpose(peerCert, X509_PURPOSE_SSL_CLIENT, 0) != 1)
+        {
+            BMCWEB_LOG_DEBUG(
+                "Chain does not allow certificate to be used for SSL client authentication");
+            return nullptr;
+        }
+
+        sslUser = getUsernameFromCert(peerCert);
+        if (sslUser.empty())
+        {
+            BMCWEB_LOG_WARNING("Failed to get user from peer certificate");
+            return nullptr;
+        }
+
+        std::optional<std::chrono::system_clock::time_point> notAfter =
+            getNotAfterFromCert(peerCert);
+        if (!fingerprint.empty() && notAfter)
+        {
+            cache.insert(fingerprint, sslUser, std::move(hostname), *notAfter);
+        }
     }
 
     std::string unsupportedClientId;
@@ -12,3 +12,7 @@
 std::shared_ptr<persistent_data::UserSession> verifyMtlsUser(
     const boost::asio::ip::address& clientIp,
     boost::asio::ssl::verify_context& ctx);
+
+// Forgets the users mapped from client certificates, for when the truststore
+// or the user accounts change
+void clearMtlsIdentityCache();
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+// The users mapped from client certificates, by the SHA-256 fingerprint of
+// the certificate, so that clients reconnecting with the same certificate
+// don't have it parsed and mapped again.  An identity is dropped once its
+// certificate expires, and the least recently used one when the cache is
+// full.
+class MtlsIdentityCache
+{
+  public:
+    using Clock = std::chrono::system_clock;
+
+    explicit MtlsIdentityCache(size_t capacityIn) : capacity(capacityIn) {}
+
+    // The user mapped from the certificate with fingerprint, if it was mapped
+    // on the same hostname and the certificate is still valid at now
+    std::optional<std::string> find(const std::string& fingerprint,
+                                    std::string_view hostname,
+                                    Clock::time_point now)
+    {
+        auto found = index.find(fingerprint);
+        if (found == index.end())
+        {
+            return std::nullopt;
+        }
+        if (found->second->notAfter <= now ||
+            found->second->hostname != hostname)
+        {
+            identities.erase(found->second);
+            index.erase(found);
+            return std::nullopt;
+        }
+        identities.splice(identities.begin(), identities, found->second);
+        return identities.front().username;
+    }
+
+    void insert(const std::string& fingerprint, std::string username,
+                std::string hostname, Clock::time_point notAfter)
+    {
+        if (capacity == 0)
+        {
+            return;
+        }
+        auto found = index.find(fingerprint);
+        if (found != index.end())
+        {
+            identities.erase(found->second);
+            index.erase(found);
+        }
+        if (identities.size() >= capacity)
+        {
+            index.erase(identities.back().fingerprint);
+            identities.pop_back();
+        }
+        identities.emplace_front(Identity{fingerprint, std::move(username),
+                                          std::move(hostname), notAfter});
+        index.emplace(fingerprint, identities.begin());
+    }
+
+    void clear()
+    {
+        index.clear();
+        identities.clear();
+    }
+
+    size_t size() const
+    {
+        return identities.size();
+    }
+
+  private:
+    struct Identity
+    {
+        std::string fingerprint;
+        std::string username;
+        // Only set when the user came from a UserPrincipalName, which is
+        // matched against the hostname
+        std::string hostname;
+        Clock::time_point notAfter;
+    };
+
+    size_t capacity;
+    // Most recently used first
+    std::list<Identity> identities;
+    std::unordered_map<std::string, std::list<Identity>::iterator> index;
+};
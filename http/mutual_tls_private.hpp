@@ -4,9 +4,16 @@
 
 #include <openssl/crypto.h>
 
+#include <chrono>
+#include <optional>
 #include <string>
 #include <string_view>
 
+std::string getFingerprintFromCert(X509* cert);
+
+std::optional<std::chrono::system_clock::time_point> getNotAfterFromCert(
+    X509* cert);
+
 std::string getCommonNameFromCert(X509* cert);
 
 std::string getUPNFromCert(X509* peerCert, std::string_view hostname);
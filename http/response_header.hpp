@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "http_response.hpp"
+#include "security_headers.hpp"
+
+#include <boost/beast/http/field.hpp>
+#include <boost/beast/http/fields.hpp>
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace crow
+{
+
+// The header of a server sent event stream, which never varies
+constexpr std::string_view sseResponseHeader =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "\r\n";
+
+// Renders the fields addSecurityHeaders() adds to a response with the given
+// content type, and with or without a Cache-Control already set
+inline std::string renderSecurityHeaders(std::string_view contentType,
+                                         bool hasCacheControl)
+{
+    Response res;
+    if (!contentType.empty())
+    {
+        res.addHeader(boost::beast::http::field::content_type, contentType);
+    }
+    if (hasCacheControl)
+    {
+        res.addHeader(boost::beast::http::field::cache_control, "");
+    }
+    addSecurityHeaders(res);
+    res.clearHeader(boost::beast::http::field::content_type);
+    if (hasCacheControl)
+    {
+        res.clearHeader(boost::beast::http::field::cache_control);
+    }
+
+    std::string out;
+    for (const boost::beast::http::fields::value_type& field : res.fields())
+    {
+        out += field.name_string();
+        out += ": ";
+        out += field.value();
+        out += "\r\n";
+    }
+    return out;
+}
+
+// Returns the security headers of a response, rendered once per class of
+// response: JSON and other data that mustn't be cached, static assets that
+// set their own caching, and HTML pages of either kind.  The class is
+// picked from the content type and Cache-Control the handler set, the same
+// way addSecurityHeaders() picks the fields it adds.
+inline std::string_view getSecurityHeaderTemplate(const Response& res)
+{
+    static const std::array<std::string, 4> templates{
+        renderSecurityHeaders("", false),
+        renderSecurityHeaders("", true),
+        renderSecurityHeaders("text/html", false),
+        renderSecurityHeaders("text/html", true),
+    };
+    size_t index = 0;
+    if (!res.getHeaderValue(boost::beast::http::field::cache_control).empty())
+    {
+        index += 1;
+    }
+    if (res.getHeaderValue(boost::beast::http::field::content_type)
+            .starts_with("text/html"))
+    {
+        index += 2;
+    }
+    return templates[index];
+}
+
+// Renders the header of res into out, reusing its capacity.  The fields the
+// handler set are followed by commonHeaders, and by the Date if one is
+// given.
+inline void renderResponseHeader(const Response& res,
+                                 std::string_view commonHeaders,
+                                 std::string_view date, std::string& out)
+{
+    out.clear();
+    unsigned version = res.response.version();
+    unsigned status = res.resultInt();
+    out += "HTTP/";
+    out += static_cast<char>('0' + version / 10);
+    out += '.';
+    out += static_cast<char>('0' + version % 10);
+    out += ' ';
+    out += static_cast<char>('0' + status / 100 % 10);
+    out += static_cast<char>('0' + status / 10 % 10);
+    out += static_cast<char>('0' + status % 10);
+    out += ' ';
+    out += res.reason();
+    out += "\r\n";
+    for (const boost::beast::http::fields::value_type& field : res.fields())
+    {
+        out += field.name_string();
+        out += ": ";
+        out += field.value();
+        out += "\r\n";
+    }
+    out += commonHeaders;
+    if (!date.empty())
+    {
+        out += "Date: ";
+        out += date;
+        out += "\r\n";
+    }
+    out += "\r\n";
+}
+
+} // namespace crow
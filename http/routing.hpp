@@ -4,9 +4,12 @@
 
 #include "async_resp.hpp"
 #include "dbus_privileges.hpp"
+#include "dbus_round_trips.hpp"
+#include "http_body.hpp"
 #include "http_request.hpp"
 #include "http_response.hpp"
 #include "logging.hpp"
+#include "privileges.hpp"
 #include "routing/baserule.hpp"
 #include "routing/dynamicrule.hpp"
 #include "routing/taggedrule.hpp"
@@ -14,7 +17,12 @@
 #include "verb.hpp"
 
 #include <boost/beast/http/field.hpp>
+#include <boost/beast/http/message.hpp>
 #include <boost/beast/http/status.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <boost/system/result.hpp>
+#include <boost/url/parse.hpp>
+#include <boost/url/url_view.hpp>
 
 #include <algorithm>
 #include <array>
@@ -170,6 +178,8 @@ class Router
                     rule = std::move(upgraded);
                 }
                 rule->validate();
+                rule->requiredPrivileges =
+                    redfish::RequiredPrivileges(rule->privilegesSet);
                 internalAddRuleObject(rule->rule, rule.get());
             }
         }
@@ -256,6 +266,78 @@ class Router
         return findRoute;
     }
 
+    // The rule of a route that streams its body, or null for routes that
+    // buffer it
+    BaseRule* findBodyStreamRule(boost::beast::http::verb method,
+                                 std::string_view path) const
+    {
+        std::optional<HttpVerb> verb = httpVerbFromBoost(method);
+        if (!verb)
+        {
+            return nullptr;
+        }
+        size_t reqMethodIndex = static_cast<size_t>(*verb);
+        if (reqMethodIndex >= perMethods.size())
+        {
+            return nullptr;
+        }
+        FindRoute route =
+            findRouteByPerMethod(path, perMethods[reqMethodIndex]);
+        if (route.rule == nullptr || !route.rule->bodySinkFactory)
+        {
+            return nullptr;
+        }
+        return route.rule;
+    }
+
+    // Called once the headers are read.  Returns the body size limit of a
+    // route that streams its body, or nullopt if the body is buffered.
+    std::optional<uint64_t> getBodyStreamLimit(
+        const boost::beast::http::request_header<>& header) const
+    {
+        boost::system::result<boost::urls::url_view> url =
+            boost::urls::parse_origin_form(header.target());
+        if (!url)
+        {
+            return std::nullopt;
+        }
+        BaseRule* rule =
+            findBodyStreamRule(header.method(), url->encoded_path());
+        if (rule == nullptr)
+        {
+            return std::nullopt;
+        }
+        return rule->streamedBodyLimit;
+    }
+
+    // Checks that the user may call a route that streams its body before
+    // any of the body is read, then calls start with the sink to read it
+    // into.  A refused request is answered through asyncResp instead.
+    void startBodyStream(
+        const std::shared_ptr<Request>& req,
+        const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+        std::move_only_function<void(std::shared_ptr<bmcweb::BodySink>)>&&
+            start)
+    {
+        BaseRule* rule =
+            findBodyStreamRule(req->method(), req->url().encoded_path());
+        if (rule == nullptr)
+        {
+            asyncResp->res.result(boost::beast::http::status::not_found);
+            return;
+        }
+        if (req->session == nullptr)
+        {
+            // Authentication is disabled
+            start(rule->bodySinkFactory(req->fields()));
+            return;
+        }
+        validatePrivilege(req, asyncResp, *rule,
+                          [req, rule, start = std::move(start)]() mutable {
+                              start(rule->bodySinkFactory(req->fields()));
+                          });
+    }
+
     template <typename Adaptor>
     void handleUpgrade(const std::shared_ptr<Request>& req,
                        const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
@@ -348,13 +430,13 @@ class Router
 
         if (req->session == nullptr)
         {
-            rule.handle(*req, asyncResp, params);
+            callHandler(rule, *req, asyncResp, params);
             return;
         }
         validatePrivilege(
             req, asyncResp, rule,
             [req, asyncResp, &rule, params = std::move(params)]() {
-                rule.handle(*req, asyncResp, params);
+                callHandler(rule, *req, asyncResp, params);
             });
     }
 
@@ -384,6 +466,18 @@ class Router
     }
 
   private:
+    // Runs the handler with its response as the current request, so the D-Bus
+    // calls it makes are counted in the response's dbusStats
+    static void callHandler(BaseRule& rule, Request& req,
+                            const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+                            const std::vector<std::string>& params)
+    {
+        dbus::utility::RequestStatsScope scope(
+            std::shared_ptr<dbus::utility::RoundTripStats>(
+                asyncResp, &asyncResp->res.dbusStats));
+        rule.handle(req, asyncResp, params);
+    }
+
     std::array<PerMethod, static_cast<size_t>(HttpVerb::Max)> perMethods;
 
     PerMethod notFoundRoutes;
@@ -3,15 +3,19 @@
 #pragma once
 
 #include "async_resp.hpp"
+#include "http_body.hpp"
 #include "http_request.hpp"
 #include "privileges.hpp"
 #include "verb.hpp"
 
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ssl/stream.hpp>
+#include <boost/beast/http/fields.hpp>
 #include <boost/beast/http/status.hpp>
 
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <string>
@@ -67,23 +71,9 @@ class BaseRule
         return methodsBitfield;
     }
 
-    bool checkPrivileges(const redfish::Privileges& userPrivileges)
+    bool checkPrivileges(const redfish::Privileges& userPrivileges) const
     {
-        // If there are no privileges assigned, assume no privileges
-        // required
-        if (privilegesSet.empty())
-        {
-            return true;
-        }
-
-        for (const redfish::Privileges& requiredPrivileges : privilegesSet)
-        {
-            if (userPrivileges.isSupersetOf(requiredPrivileges))
-            {
-                return true;
-            }
-        }
-        return false;
+        return requiredPrivileges.isAllowed(userPrivileges);
     }
 
     size_t methodsBitfield{1 << static_cast<size_t>(HttpVerb::Get)};
@@ -96,6 +86,15 @@ class BaseRule
     bool isUpgrade = false;
 
     std::vector<redfish::Privileges> privilegesSet;
+    // privilegesSet, flattened by Router::validate
+    redfish::RequiredPrivileges requiredPrivileges;
+
+    // Creates the sink the request body is streamed into as it is read.
+    // Returning null buffers the body as usual.
+    using BodySinkFactory = std::function<std::shared_ptr<bmcweb::BodySink>(
+        const boost::beast::http::fields&)>;
+    BodySinkFactory bodySinkFactory;
+    uint64_t streamedBodyLimit = 0;
 
     std::string rule;
 
@@ -2,6 +2,9 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #pragma once
 
+#include "bmcweb_config.h"
+
+#include "baserule.hpp"
 #include "privileges.hpp"
 #include "sserule.hpp"
 #include "verb.hpp"
@@ -11,8 +14,10 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <initializer_list>
 #include <optional>
+#include <utility>
 
 namespace crow
 {
@@ -66,6 +71,21 @@ struct RuleParameterTraits
         return *self;
     }
 
+    // Streams the request body into the sink made by the factory, instead
+    // of buffering it in the request.  The user's privileges are checked
+    // before any of the body is read, and the handler finds the sink in
+    // Request::bodySink().  As the body isn't held in memory, the limit on
+    // its size is up to the route.
+    self_t& streamBody(
+        BaseRule::BodySinkFactory&& factory,
+        uint64_t maxBodySize = 1024UL * 1024UL * BMCWEB_HTTP_BODY_LIMIT)
+    {
+        self_t* self = static_cast<self_t*>(this);
+        self->bodySinkFactory = std::move(factory);
+        self->streamedBodyLimit = maxBodySize;
+        return *self;
+    }
+
     self_t& notFound()
     {
         self_t* self = static_cast<self_t*>(this);
@@ -6,13 +6,45 @@
 #include <boost/beast/http/write.hpp>
 
 #include <memory>
+#include <string>
 #include <string_view>
+#include <utility>
 
 namespace crow
 {
 
 namespace sse_socket
 {
+
+// An event already encoded in the text/event-stream wire format.  Frames are
+// immutable, so a single frame can be queued on any number of connections
+// without being copied or re-encoded.
+using SseFrame = std::shared_ptr<const std::string>;
+
+inline SseFrame makeSseFrame(std::string_view id, std::string_view msg)
+{
+    std::string rawData;
+    rawData.reserve(id.size() + msg.size() + 16);
+    if (!id.empty())
+    {
+        rawData += "id: ";
+        rawData.append(id);
+        rawData += "\n";
+    }
+
+    rawData += "data: ";
+    for (char character : msg)
+    {
+        rawData += character;
+        if (character == '\n')
+        {
+            rawData += "data: ";
+        }
+    }
+    rawData += "\n\n";
+    return std::make_shared<const std::string>(std::move(rawData));
+}
+
 struct Connection : public std::enable_shared_from_this<Connection>
 {
   public:
@@ -25,7 +57,16 @@ struct Connection : public std::enable_shared_from_this<Connection>
     virtual ~Connection() = default;
 
     virtual void close(std::string_view msg = "quit") = 0;
-    virtual void sendSseEvent(std::string_view id, std::string_view msg) = 0;
+    virtual void sendSseFrame(const SseFrame& frame) = 0;
+
+    void sendSseEvent(std::string_view id, std::string_view msg)
+    {
+        if (msg.empty())
+        {
+            return;
+        }
+        sendSseFrame(makeSseFrame(id, msg));
+    }
 };
 } // namespace sse_socket
 } // namespace crow
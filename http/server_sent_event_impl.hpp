@@ -6,26 +6,28 @@
 #include "http_request.hpp"
 #include "io_context_singleton.hpp"
 #include "logging.hpp"
+#include "response_header.hpp"
 #include "server_sent_event.hpp"
 
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/error.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
 #include <boost/beast/core/error.hpp>
-#include <boost/beast/core/multi_buffer.hpp>
-#include <boost/beast/http/field.hpp>
-#include <boost/beast/http/serializer.hpp>
-#include <boost/beast/http/write.hpp>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <cstddef>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 namespace crow
 {
@@ -33,6 +35,12 @@ namespace crow
 namespace sse_socket
 {
 
+// Number of events a client may fall behind before it is disconnected
+constexpr size_t maxQueuedFrames = 1000;
+constexpr size_t maxQueuedBytes = 10485760U; // 10MB
+
+constexpr size_t maxFramesPerWrite = 16;
+
 template <typename Adaptor>
 class ConnectionImpl : public Connection
 {
@@ -63,12 +71,8 @@ class ConnectionImpl : public Connection
     {
         BMCWEB_LOG_DEBUG("Starting SSE connection");
 
-        res.set(boost::beast::http::field::content_type, "text/event-stream");
-        boost::beast::http::response_serializer<BodyType>& serial =
-            serializer.emplace(res);
-
-        boost::beast::http::async_write_header(
-            adaptor, serial,
+        boost::asio::async_write(
+            adaptor, boost::asio::buffer(sseResponseHeader),
             std::bind_front(&ConnectionImpl::sendSSEHeaderCallback, this,
                             shared_from_this(), req.copy()));
     }
@@ -76,6 +80,15 @@ class ConnectionImpl : public Connection
     void close(const std::string_view msg) override
     {
         BMCWEB_LOG_DEBUG("Closing connection with reason {}", msg);
+        if (closed)
+        {
+            return;
+        }
+        closed = true;
+        // Frames that are part of an outstanding write must outlive it
+        queue.resize(doingWrite ? std::min(queue.size(), writeBuffers.size())
+                                : 0);
+        queuedBytes = 0;
         // send notification to handler for cleanup
         if (closeHandler)
         {
@@ -90,11 +103,10 @@ class ConnectionImpl : public Connection
                                const boost::system::error_code& ec,
                                size_t /*bytesSent*/)
     {
-        serializer.reset();
         if (ec)
         {
             BMCWEB_LOG_ERROR("Error sending header{}", ec);
-            close("async_write_header failed");
+            close("async_write failed");
             return;
         }
         BMCWEB_LOG_DEBUG("SSE header sent - Connection established");
@@ -134,18 +146,50 @@ class ConnectionImpl : public Connection
         {
             return;
         }
-        if (inputBuffer.size() == 0)
+        if (queue.empty())
         {
-            BMCWEB_LOG_DEBUG("inputBuffer is empty... Bailing out");
+            BMCWEB_LOG_DEBUG("Frame queue is empty... Bailing out");
             return;
         }
         startTimeout();
         doingWrite = true;
 
+        // Gather as many queued frames as fit into one write
+        writeBuffers.clear();
+        for (const SseFrame& frame : queue)
+        {
+            if (writeBuffers.size() == maxFramesPerWrite)
+            {
+                break;
+            }
+            std::string_view data(*frame);
+            if (writeBuffers.empty())
+            {
+                data.remove_prefix(frontOffset);
+            }
+            writeBuffers.emplace_back(data.data(), data.size());
+        }
+
         adaptor.async_write_some(
-            inputBuffer.data(),
-            std::bind_front(&ConnectionImpl::doWriteCallback, this,
-                            shared_from_this()));
+            writeBuffers, std::bind_front(&ConnectionImpl::doWriteCallback,
+                                          this, shared_from_this()));
+    }
+
+    void consume(size_t bytesTransferred)
+    {
+        queuedBytes -= std::min(bytesTransferred, queuedBytes);
+        while (!queue.empty())
+        {
+            size_t remaining = queue.front()->size() - frontOffset;
+            if (bytesTransferred < remaining)
+            {
+                frontOffset += bytesTransferred;
+                return;
+            }
+            bytesTransferred -= remaining;
+            frontOffset = 0;
+            queue.pop_front();
+        }
     }
 
     void doWriteCallback(const std::shared_ptr<Connection>& /*self*/,
@@ -154,7 +198,7 @@ class ConnectionImpl : public Connection
     {
         timer.cancel();
         doingWrite = false;
-        inputBuffer.consume(bytesTransferred);
+        consume(bytesTransferred);
 
         if (ec == boost::asio::error::eof)
         {
@@ -175,50 +219,39 @@ class ConnectionImpl : public Connection
         doWrite();
     }
 
-    void sendSseEvent(std::string_view id, std::string_view msg) override
+    void sendSseFrame(const SseFrame& frame) override
     {
-        if (msg.empty())
+        if (frame == nullptr || frame->empty())
         {
             BMCWEB_LOG_DEBUG("Empty data, bailing out.");
             return;
         }
-
-        dataFormat(id, msg);
-
-        doWrite();
-    }
-
-    void dataFormat(std::string_view id, std::string_view msg)
-    {
-        constexpr size_t bufferLimit = 10485760U; // 10MB
-        if (id.size() + msg.size() + inputBuffer.size() >= bufferLimit)
+        if (closed || lagging)
         {
-            BMCWEB_LOG_ERROR("SSE Buffer overflow while waiting for client");
-            close("Buffer overflow");
             return;
         }
-        std::string rawData;
-        if (!id.empty())
-        {
-            rawData += "id: ";
-            rawData.append(id);
-            rawData += "\n";
-        }
 
-        rawData += "data: ";
-        for (char character : msg)
+        // A client that can't keep up with the event rate gets disconnected,
+        // rather than having events pile up in memory.
+        if (queue.size() >= maxQueuedFrames ||
+            queuedBytes + frame->size() > maxQueuedBytes)
         {
-            rawData += character;
-            if (character == '\n')
-            {
-                rawData += "data: ";
-            }
+            BMCWEB_LOG_ERROR(
+                "SSE client lagging by {} events, {} bytes, disconnecting",
+                queue.size(), queuedBytes);
+            lagging = true;
+            // The caller may be iterating the subscriptions that the close
+            // handler removes, so close from a fresh stack.
+            boost::asio::post(adaptor.get_executor(),
+                              [self(shared_from_this())]() {
+                                  self->close("Client too slow");
+                              });
+            return;
         }
-        rawData += "\n\n";
+        queue.emplace_back(frame);
+        queuedBytes += frame->size();
 
-        size_t copied = boost::asio::buffer_copy(
-            inputBuffer.prepare(rawData.size()), boost::asio::buffer(rawData));
-        inputBuffer.commit(copied);
+        doWrite();
     }
 
     void startTimeout()
@@ -259,13 +292,19 @@ class ConnectionImpl : public Connection
 
   private:
     std::array<char, 1> buffer{};
-    boost::beast::multi_buffer inputBuffer;
+
+    // Frames waiting to be written.  Frames are shared with other
+    // connections, so only references and the write position within the
+    // first frame are kept per connection.
+    std::deque<SseFrame> queue;
+    size_t frontOffset = 0;
+    size_t queuedBytes = 0;
+    std::vector<boost::asio::const_buffer> writeBuffers;
+    bool closed = false;
+    bool lagging = false;
 
     Adaptor adaptor;
 
-    using BodyType = bmcweb::HttpBody;
-    boost::beast::http::response<BodyType> res;
-    std::optional<boost::beast::http::response_serializer<BodyType>> serializer;
     boost::asio::steady_timer timer;
     bool doingWrite = false;
 
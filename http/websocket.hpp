@@ -5,6 +5,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <string_view>
 
 namespace crow
@@ -18,6 +19,11 @@ enum class MessageType
     Text,
 };
 
+// A text message that is already serialized.  Frames are immutable, so a
+// single frame can be queued on any number of connections without being
+// copied.
+using TextFrame = std::shared_ptr<const std::string>;
+
 struct Connection : std::enable_shared_from_this<Connection>
 {
   public:
@@ -32,6 +38,9 @@ struct Connection : std::enable_shared_from_this<Connection>
     virtual void sendEx(MessageType type, std::string_view msg,
                         std::function<void()>&& onDone) = 0;
     virtual void sendText(std::string_view msg) = 0;
+    // Queues a shared text frame.  A connection that falls too far behind
+    // is closed, rather than buffering frames without bound.
+    virtual void sendTextFrame(const TextFrame& frame) = 0;
     virtual void close(std::string_view msg = "quit") = 0;
     virtual void deferRead() = 0;
     virtual void resumeRead() = 0;
@@ -13,6 +13,7 @@
 
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/error.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/ssl/error.hpp>
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
@@ -30,6 +31,7 @@
 #include <boost/beast/websocket/ssl.hpp>
 
 #include <cstddef>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <string>
@@ -41,6 +43,10 @@ namespace crow
 namespace websocket
 {
 
+// Number of frames a client may fall behind before it is disconnected
+constexpr size_t maxQueuedFrames = 1000;
+constexpr size_t maxQueuedBytes = 10485760U; // 10MB
+
 template <typename Adaptor>
 class ConnectionImpl : public Connection
 {
@@ -176,6 +182,31 @@ class ConnectionImpl : public Connection
         doWrite();
     }
 
+    void sendTextFrame(const TextFrame& frame) override
+    {
+        if (frame == nullptr || lagging)
+        {
+            return;
+        }
+        if (frameQueue.size() >= maxQueuedFrames ||
+            queuedBytes + frame->size() > maxQueuedBytes)
+        {
+            BMCWEB_LOG_ERROR(
+                "Websocket client lagging by {} frames, {} bytes, closing",
+                frameQueue.size(), queuedBytes);
+            lagging = true;
+            // The caller may be iterating the connections that the close
+            // handler removes, so close from a fresh stack.
+            boost::asio::post(ws.get_executor(), [self(shared_from_this())]() {
+                self->close("Client too slow");
+            });
+            return;
+        }
+        frameQueue.emplace_back(frame);
+        queuedBytes += frame->size();
+        doWrite();
+    }
+
     void close(std::string_view msg) override
     {
         ws.async_close(
@@ -280,8 +311,22 @@ class ConnectionImpl : public Connection
     void afterWrite(const std::shared_ptr<Connection>& /*self*/,
                     const boost::beast::error_code& ec, size_t bytesSent)
     {
-        doingWrite = false;
         outBuffer.consume(bytesSent);
+        writeDone(ec);
+    }
+
+    void afterFrameWrite(const std::shared_ptr<Connection>& /*self*/,
+                         const boost::beast::error_code& ec,
+                         size_t /*bytesSent*/)
+    {
+        queuedBytes -= frameQueue.front()->size();
+        frameQueue.pop_front();
+        writeDone(ec);
+    }
+
+    void writeDone(const boost::beast::error_code& ec)
+    {
+        doingWrite = false;
         if (ec)
         {
             if (ec == boost::beast::websocket::error::closed)
@@ -314,7 +359,18 @@ class ConnectionImpl : public Connection
 
         if (outBuffer.size() == 0)
         {
-            // Done for now
+            if (frameQueue.empty())
+            {
+                // Done for now
+                return;
+            }
+            // Frames are shared with other connections, so they're written
+            // from the frame itself rather than copied into outBuffer
+            doingWrite = true;
+            ws.text(true);
+            ws.async_write(boost::asio::buffer(*frameQueue.front()),
+                           std::bind_front(&self_t::afterFrameWrite, this,
+                                           shared_from_this()));
             return;
         }
         doingWrite = true;
@@ -366,6 +422,9 @@ class ConnectionImpl : public Connection
         inBuffer;
 
     boost::beast::multi_buffer outBuffer;
+    std::deque<TextFrame> frameQueue;
+    size_t queuedBytes = 0;
+    bool lagging = false;
     bool doingWrite = false;
 
     std::function<void(Connection&)> openHandler;
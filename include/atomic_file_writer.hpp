@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "logging.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+namespace bmcweb
+{
+
+// Replaces the file at path with contents.  The contents go to a temporary
+// file next to it, which is synced and renamed over the file, so that a
+// crash or power loss leaves either the old file or the new one, and never
+// a partial one.
+inline bool writeFileAtomically(const std::string& path,
+                                std::string_view contents, mode_t mode)
+{
+    std::string tmpPath = path + ".tmp";
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                  mode);
+    if (fd == -1)
+    {
+        BMCWEB_LOG_CRITICAL("Unable to create {}", tmpPath);
+        return false;
+    }
+    // Set the permissions regardless of umask
+    bool ok = fchmod(fd, mode) == 0;
+    while (ok && !contents.empty())
+    {
+        ssize_t written = write(fd, contents.data(), contents.size());
+        if (written == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            ok = false;
+            break;
+        }
+        contents.remove_prefix(static_cast<size_t>(written));
+    }
+    if (ok)
+    {
+        ok = fsync(fd) == 0;
+    }
+    close(fd);
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        BMCWEB_LOG_CRITICAL("Failed to write {}", path);
+        unlink(tmpPath.c_str());
+        return false;
+    }
+
+    // Sync the directory too, so that the rename itself is durable
+    std::filesystem::path dir = std::filesystem::path(path).parent_path();
+    if (dir.empty())
+    {
+        dir = ".";
+    }
+    int dirFd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd != -1)
+    {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    return true;
+}
+
+// Writes a file on a thread of its own, so that the caller doesn't wait on
+// the filesystem.  Only the newest contents are kept; contents queued while
+// an earlier write is still running replace those not yet started.
+class AtomicFileWriter
+{
+  public:
+    AtomicFileWriter(std::string pathIn, mode_t modeIn) :
+        path(std::move(pathIn)), mode(modeIn)
+    {}
+
+    AtomicFileWriter(const AtomicFileWriter&) = delete;
+    AtomicFileWriter(AtomicFileWriter&&) = delete;
+    AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+    AtomicFileWriter& operator=(AtomicFileWriter&&) = delete;
+
+    ~AtomicFileWriter()
+    {
+        flush();
+        {
+            std::scoped_lock guard(lock);
+            stopping = true;
+        }
+        changed.notify_all();
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    void write(std::string contents)
+    {
+        {
+            std::scoped_lock guard(lock);
+            pending = std::move(contents);
+            if (!worker.joinable())
+            {
+                worker = std::thread(&AtomicFileWriter::run, this);
+            }
+        }
+        changed.notify_all();
+    }
+
+    // Waits for the queued contents to be written
+    void flush()
+    {
+        std::unique_lock guard(lock);
+        changed.wait(guard, [this]() { return !pending && !busy; });
+    }
+
+    // Number of times the file has been written
+    size_t writes() const
+    {
+        std::scoped_lock guard(lock);
+        return writeCount;
+    }
+
+  private:
+    void run()
+    {
+        std::unique_lock guard(lock);
+        while (true)
+        {
+            changed.wait(guard, [this]() { return pending || stopping; });
+            if (!pending)
+            {
+                return;
+            }
+            std::string contents = std::move(*pending);
+            pending = std::nullopt;
+            busy = true;
+            guard.unlock();
+
+            writeFileAtomically(path, contents, mode);
+
+            guard.lock();
+            busy = false;
+            writeCount++;
+            changed.notify_all();
+        }
+    }
+
+    std::string path;
+    mode_t mode;
+
+    mutable std::mutex lock;
+    std::condition_variable changed;
+    std::optional<std::string> pending;
+    bool busy = false;
+    bool stopping = false;
+    size_t writeCount = 0;
+    std::thread worker;
+};
+
+} // namespace bmcweb
@@ -0,0 +1,337 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "dbus_round_trips.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace dbus
+{
+
+namespace utility
+{
+
+template <typename T, typename Variant>
+struct IsVariantAlternative : std::false_type
+{};
+
+template <typename T, typename... Types>
+struct IsVariantAlternative<T, std::variant<Types...>> :
+    std::bool_constant<(std::is_same_v<T, Types> || ...)>
+{};
+
+// Merges identical calls while one is in flight, so that only the first one
+// is sent on the bus, and every caller gets its result.  Only suitable for
+// calls without side effects.  Calls are only merged if no write has been
+// sent since the one in flight was, so a client that reads after its own
+// write completed always sees the write.
+template <typename Response>
+class SingleFlight
+{
+  public:
+    using Callback =
+        std::function<void(const boost::system::error_code&, const Response&)>;
+
+    explicit SingleFlight(RoundTripStats& statsIn) : stats(statsIn) {}
+
+    // Calls send, unless a call with the same key is already in flight.
+    // send is passed the handler to call with the result.
+    template <typename Sender>
+    void call(std::string&& key, Callback&& callback, Sender&& send)
+    {
+        auto it = inFlight.find(key);
+        if (it != inFlight.end() && it->second.writes == stats.writes)
+        {
+            it->second.waiters->emplace_back(std::move(callback));
+            countRoundTrips(stats, &RoundTripStats::coalesced);
+            return;
+        }
+        // A call sent before a write is left to finish for the callers that
+        // joined it, and replaced for everyone after
+        if (it == inFlight.end())
+        {
+            it = inFlight.try_emplace(std::move(key)).first;
+        }
+        std::shared_ptr<std::vector<Callback>> waiters =
+            std::make_shared<std::vector<Callback>>();
+        waiters->emplace_back(std::move(callback));
+        it->second = Flight{stats.writes, waiters};
+        countRoundTrips(stats, &RoundTripStats::roundTrips);
+        std::forward<Sender>(send)(
+            [this, key = it->first, waiters = std::move(waiters)](
+                const boost::system::error_code& ec, const Response& response) {
+                complete(key, waiters, ec, response);
+            });
+    }
+
+    size_t inFlightCount() const
+    {
+        return inFlight.size();
+    }
+
+  private:
+    struct Flight
+    {
+        // stats.writes when the call was sent
+        uint64_t writes = 0;
+        std::shared_ptr<std::vector<Callback>> waiters;
+    };
+
+    void complete(const std::string& key,
+                  const std::shared_ptr<std::vector<Callback>>& waiters,
+                  const boost::system::error_code& ec, const Response& response)
+    {
+        // Callbacks can start new calls with the same key, so detach the
+        // waiters before running them.  The key may already belong to a
+        // newer call, sent after a write.
+        auto it = inFlight.find(key);
+        if (it != inFlight.end() && it->second.waiters == waiters)
+        {
+            inFlight.erase(it);
+        }
+        std::vector<Callback> callbacks = std::move(*waiters);
+        for (Callback& callback : callbacks)
+        {
+            callback(ec, response);
+        }
+    }
+
+    RoundTripStats& stats;
+    std::map<std::string, Flight, std::less<>> inFlight;
+};
+
+// Coalesces property reads.  Reads are queued until the current event loop
+// turn finishes, then all reads of the same object and interface are served
+// by a single GetAll.  A lone read of one property is sent as a plain Get.
+// Identical Gets and GetAlls are merged while in flight.
+template <typename Variant>
+class PropertyReadCoalescer
+{
+  public:
+    using PropertiesMap = std::vector<std::pair<std::string, Variant>>;
+    using GetCallback =
+        std::function<void(const boost::system::error_code&, const Variant&)>;
+    using GetAllCallback = std::function<void(const boost::system::error_code&,
+                                              const PropertiesMap&)>;
+    using GetSender = std::function<void(
+        const std::string& service, const std::string& objectPath,
+        const std::string& interface, const std::string& propertyName,
+        GetCallback&& callback)>;
+    using GetAllSender = std::function<void(
+        const std::string& service, const std::string& objectPath,
+        const std::string& interface, GetAllCallback&& callback)>;
+
+    PropertyReadCoalescer(boost::asio::io_context& iocIn,
+                          RoundTripStats& statsIn, GetSender&& sendGetIn,
+                          GetAllSender&& sendGetAllIn) :
+        ioc(iocIn), stats(statsIn), sendGet(std::move(sendGetIn)),
+        sendGetAll(std::move(sendGetAllIn)), getFlight(statsIn),
+        getAllFlight(statsIn)
+    {}
+
+    PropertyReadCoalescer(const PropertyReadCoalescer&) = delete;
+    PropertyReadCoalescer& operator=(const PropertyReadCoalescer&) = delete;
+    PropertyReadCoalescer(PropertyReadCoalescer&&) = delete;
+    PropertyReadCoalescer& operator=(PropertyReadCoalescer&&) = delete;
+    ~PropertyReadCoalescer() = default;
+
+    void get(const std::string& service, const std::string& objectPath,
+             const std::string& interface, const std::string& propertyName,
+             GetCallback&& callback)
+    {
+        countRoundTrips(stats, &RoundTripStats::requested);
+        queue(service, objectPath, interface)
+            .reads.emplace_back(propertyName,
+                                keepRequestScope(std::move(callback)),
+                                RequestStatsScope::current());
+    }
+
+    void getAll(const std::string& service, const std::string& objectPath,
+                const std::string& interface, GetAllCallback&& callback)
+    {
+        countRoundTrips(stats, &RoundTripStats::requested);
+        queue(service, objectPath, interface)
+            .getAlls.emplace_back(keepRequestScope(std::move(callback)));
+    }
+
+    // Sends the queued reads now, rather than at the end of the turn.  Done
+    // before a write is sent, so reads requested before the write are sent
+    // before it too.
+    void flush()
+    {
+        std::map<std::string, Pending, std::less<>> batch =
+            std::exchange(pending, {});
+        for (auto& [key, reads] : batch)
+        {
+            if (reads.getAlls.empty() && isSingleProperty(reads))
+            {
+                for (Read& read : reads.reads)
+                {
+                    get(reads, read);
+                }
+                continue;
+            }
+            for (const Read& read : reads.reads)
+            {
+                RequestStatsScope scope(read.requestStats);
+                countRoundTrips(stats, &RoundTripStats::batched);
+            }
+            // The call is counted against whoever queued the first read
+            RequestStatsScope scope(reads.requestStats);
+            std::string service = reads.service;
+            std::string objectPath = reads.objectPath;
+            std::string interface = reads.interface;
+            getAllFlight.call(
+                std::string(key),
+                [this, reads = std::move(reads)](
+                    const boost::system::error_code& ec,
+                    const PropertiesMap& properties) mutable {
+                    dispatch(reads, ec, properties);
+                },
+                [this, service = std::move(service),
+                 objectPath = std::move(objectPath),
+                 interface = std::move(interface)](GetAllCallback&& done) {
+                    sendGetAll(service, objectPath, interface, std::move(done));
+                });
+        }
+    }
+
+  private:
+    struct Read
+    {
+        std::string propertyName;
+        GetCallback callback;
+        std::weak_ptr<RoundTripStats> requestStats;
+    };
+
+    struct Pending
+    {
+        std::string service;
+        std::string objectPath;
+        std::string interface;
+        std::vector<Read> reads;
+        std::vector<GetAllCallback> getAlls;
+        std::weak_ptr<RoundTripStats> requestStats;
+    };
+
+    static std::string makeKey(std::string_view service,
+                               std::string_view objectPath,
+                               std::string_view interface)
+    {
+        // Spaces can't appear in bus names, paths or interfaces
+        std::string key;
+        key.reserve(service.size() + objectPath.size() + interface.size() + 2);
+        key += service;
+        key += ' ';
+        key += objectPath;
+        key += ' ';
+        key += interface;
+        return key;
+    }
+
+    Pending& queue(const std::string& service, const std::string& objectPath,
+                   const std::string& interface)
+    {
+        if (pending.empty())
+        {
+            boost::asio::post(ioc, [this]() { flush(); });
+        }
+        auto [it, inserted] =
+            pending.try_emplace(makeKey(service, objectPath, interface));
+        if (inserted)
+        {
+            it->second.service = service;
+            it->second.objectPath = objectPath;
+            it->second.interface = interface;
+            it->second.requestStats = RequestStatsScope::current();
+        }
+        return it->second;
+    }
+
+    static bool isSingleProperty(const Pending& reads)
+    {
+        for (const Read& read : reads.reads)
+        {
+            if (read.propertyName != reads.reads.front().propertyName)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void get(const Pending& reads, Read& read)
+    {
+        RequestStatsScope scope(read.requestStats);
+        std::string key =
+            makeKey(reads.service, reads.objectPath, reads.interface);
+        key += ' ';
+        key += read.propertyName;
+        getFlight.call(std::move(key), std::move(read.callback),
+                       [this, &reads, &read](GetCallback&& done) {
+                           sendGet(reads.service, reads.objectPath,
+                                   reads.interface, read.propertyName,
+                                   std::move(done));
+                       });
+    }
+
+    void dispatch(Pending& reads, const boost::system::error_code& ec,
+                  const PropertiesMap& properties)
+    {
+        for (GetAllCallback& callback : reads.getAlls)
+        {
+            callback(ec, properties);
+        }
+        for (Read& read : reads.reads)
+        {
+            const Variant* value = nullptr;
+            if (!ec)
+            {
+                for (const auto& [name, property] : properties)
+                {
+                    if (name == read.propertyName)
+                    {
+                        value = &property;
+                        break;
+                    }
+                }
+            }
+            if (value == nullptr)
+            {
+                // GetAll can fail where Get wouldn't, for example when
+                // another property of the interface has a type that can't be
+                // unpacked.  Retry alone, so the caller sees the same result
+                // and error code it would have without batching.
+                get(reads, read);
+                continue;
+            }
+            read.callback(ec, *value);
+        }
+    }
+
+    boost::asio::io_context& ioc;
+    RoundTripStats& stats;
+    GetSender sendGet;
+    GetAllSender sendGetAll;
+    SingleFlight<Variant> getFlight;
+    SingleFlight<PropertiesMap> getAllFlight;
+    std::map<std::string, Pending, std::less<>> pending;
+};
+
+} // namespace utility
+} // namespace dbus
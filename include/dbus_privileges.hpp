@@ -67,6 +67,7 @@ inline bool populateUserInfo(
     {
         session.userGroups.swap(*userGroups);
     }
+    redfish::setUserPrivileges(session);
 
     return true;
 }
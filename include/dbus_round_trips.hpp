@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+namespace dbus
+{
+
+namespace utility
+{
+
+// Counters of D-Bus reads, so the effect of coalescing can be measured.
+struct RoundTripStats
+{
+    // Reads requested by handlers
+    uint64_t requested = 0;
+    // Method calls actually sent on the bus
+    uint64_t roundTrips = 0;
+    // Reads that joined an identical call that was already in flight
+    uint64_t coalesced = 0;
+    // Property reads that were served by a GetAll shared with other reads
+    uint64_t batched = 0;
+    // Writes and method calls sent.  A read never joins a call that was sent
+    // before one of these, as it could return what the write replaced.
+    uint64_t writes = 0;
+};
+
+// Whether a method only returns state, so calling it neither needs the queued
+// reads sent first nor stops later reads from joining calls in flight.  Any
+// method not listed is assumed to change something, and counted as a write.
+inline bool isReadOnlyMethod(std::string_view interface,
+                             std::string_view method)
+{
+    struct Method
+    {
+        std::string_view interface;
+        std::string_view name;
+    };
+    static constexpr std::array<Method, 15> readOnlyMethods{{
+        {"org.freedesktop.DBus.Properties", "Get"},
+        {"org.freedesktop.DBus.Properties", "GetAll"},
+        {"org.freedesktop.DBus.ObjectManager", "GetManagedObjects"},
+        {"org.freedesktop.DBus.Introspectable", "Introspect"},
+        {"org.freedesktop.DBus.Peer", "Ping"},
+        {"xyz.openbmc_project.ObjectMapper", "GetObject"},
+        {"xyz.openbmc_project.ObjectMapper", "GetSubTree"},
+        {"xyz.openbmc_project.ObjectMapper", "GetSubTreePaths"},
+        {"xyz.openbmc_project.ObjectMapper", "GetAncestors"},
+        {"xyz.openbmc_project.ObjectMapper", "GetAssociatedSubTree"},
+        {"xyz.openbmc_project.ObjectMapper", "GetAssociatedSubTreePaths"},
+        {"xyz.openbmc_project.State.Boot.PostCode", "GetPostCodes"},
+        {"xyz.openbmc_project.State.Boot.PostCode",
+         "GetPostCodesWithTimeStamp"},
+        {"xyz.openbmc_project.Logging.Entry", "GetEntry"},
+        {"xyz.openbmc_project.Dump.Entry", "GetFileHandle"},
+    }};
+    return std::ranges::any_of(readOnlyMethods, [&](const Method& known) {
+        return known.interface == interface && known.name == method;
+    });
+}
+
+// Marks the request whose handler or callback is running, so the D-Bus calls
+// made from it are counted against that request as well.  Scopes nest; the
+// previous one is restored when this one ends.
+class RequestStatsScope
+{
+  public:
+    explicit RequestStatsScope(std::weak_ptr<RoundTripStats> stats) :
+        previous(std::exchange(current(), std::move(stats)))
+    {}
+
+    RequestStatsScope(const RequestStatsScope&) = delete;
+    RequestStatsScope& operator=(const RequestStatsScope&) = delete;
+    RequestStatsScope(RequestStatsScope&&) = delete;
+    RequestStatsScope& operator=(RequestStatsScope&&) = delete;
+
+    ~RequestStatsScope()
+    {
+        current() = std::move(previous);
+    }
+
+    static std::weak_ptr<RoundTripStats>& current()
+    {
+        static std::weak_ptr<RoundTripStats> stats;
+        return stats;
+    }
+
+  private:
+    std::weak_ptr<RoundTripStats> previous;
+};
+
+// Adds to one of the process wide counters, and to the same counter of the
+// current request, if there is one
+inline void countRoundTrips(RoundTripStats& stats,
+                            uint64_t RoundTripStats::* counter,
+                            uint64_t count = 1)
+{
+    stats.*counter += count;
+    std::shared_ptr<RoundTripStats> request =
+        RequestStatsScope::current().lock();
+    if (request)
+    {
+        (*request).*counter += count;
+    }
+}
+
+// Wraps a D-Bus callback so it runs in the scope of the request that made the
+// call, and the calls it makes in turn are counted against that request too.
+template <typename... Args>
+std::function<void(Args...)> keepRequestScope(
+    std::function<void(Args...)>&& callback)
+{
+    std::weak_ptr<RoundTripStats> stats = RequestStatsScope::current();
+    if (stats.expired())
+    {
+        return std::move(callback);
+    }
+    return [stats = std::move(stats),
+            callback = std::move(callback)](Args... args) {
+        RequestStatsScope scope(stats);
+        callback(args...);
+    };
+}
+
+} // namespace utility
+} // namespace dbus
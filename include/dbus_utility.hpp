@@ -5,8 +5,11 @@
 
 #include "async_resp.hpp"
 #include "boost_formatters.hpp"
+#include "dbus_coalescer.hpp"
+#include "dbus_round_trips.hpp"
 #include "dbus_singleton.hpp"
 
+#include <boost/system/errc.hpp>
 #include <boost/system/error_code.hpp>
 #include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/asio/property.hpp>
@@ -89,6 +92,19 @@ using MapperEndPoints = std::vector<std::string>;
 
 void escapePathForDbus(std::string& path);
 
+// Process wide counters of D-Bus reads and the round trips they cost
+RoundTripStats& getRoundTripStats();
+
+PropertyReadCoalescer<DbusVariantType>& getPropertyReadCoalescer();
+
+// Sends the reads that are queued, and stops later reads from joining calls
+// that are in flight.  Called before anything that can change state is sent.
+void beforeWrite();
+
+// Counts a method call about to be sent, as a write unless isReadOnlyMethod()
+// knows it only reads
+void beforeMethodCall(std::string_view interface, std::string_view method);
+
 void logError(const boost::system::error_code& ec);
 
 void getAllProperties(const std::string& service, const std::string& objectPath,
@@ -102,6 +118,7 @@ void async_method_call(MessageHandler&& handler, const std::string& service,
                        const std::string& objpath, const std::string& interf,
                        const std::string& method, const InputArgs&... a)
 {
+    beforeMethodCall(interf, method);
     crow::connections::systemBus->async_method_call(
         std::forward<MessageHandler>(handler), service, objpath, interf, method,
         a...);
@@ -114,20 +131,57 @@ void async_method_call(const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
                        const std::string& objpath, const std::string& interf,
                        const std::string& method, const InputArgs&... a)
 {
+    beforeMethodCall(interf, method);
     crow::connections::systemBus->async_method_call(
         std::forward<MessageHandler>(handler), service, objpath, interf, method,
         a...);
 }
 
+template <typename... Args>
+void setProperty(sdbusplus::asio::connection& conn, Args&&... args)
+{
+    beforeWrite();
+    sdbusplus::asio::setProperty(conn, std::forward<Args>(args)...);
+}
+
 template <typename PropertyType>
 void getProperty(const std::string& service, const std::string& objectPath,
                  const std::string& interface, const std::string& propertyName,
                  std::function<void(const boost::system::error_code&,
                                     const PropertyType&)>&& callback)
 {
-    sdbusplus::asio::getProperty<PropertyType>(
-        *crow::connections::systemBus, service, objectPath, interface,
-        propertyName, std::move(callback));
+    if constexpr (IsVariantAlternative<PropertyType, DbusVariantType>::value)
+    {
+        getPropertyReadCoalescer().get(
+            service, objectPath, interface, propertyName,
+            [callback = std::move(callback)](
+                const boost::system::error_code& ec,
+                const DbusVariantType& value) {
+                if (ec)
+                {
+                    callback(ec, PropertyType{});
+                    return;
+                }
+                const PropertyType* typed = std::get_if<PropertyType>(&value);
+                if (typed == nullptr)
+                {
+                    callback(boost::system::errc::make_error_code(
+                                 boost::system::errc::invalid_argument),
+                             PropertyType{});
+                    return;
+                }
+                callback(ec, *typed);
+            });
+    }
+    else
+    {
+        // Can't be unpacked from a GetAll, so read it on its own
+        countRoundTrips(getRoundTripStats(), &RoundTripStats::requested);
+        countRoundTrips(getRoundTripStats(), &RoundTripStats::roundTrips);
+        sdbusplus::asio::getProperty<PropertyType>(
+            *crow::connections::systemBus, service, objectPath, interface,
+            propertyName, keepRequestScope(std::move(callback)));
+    }
 }
 
 template <typename PropertyType>
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+
+namespace bmcweb
+{
+
+// Watches a single directory with inotify, and calls onChange whenever a
+// file in it is created, removed, renamed or rewritten.  Used to invalidate
+// caches of files that are normally static, but can be replaced at runtime
+// (for example by a firmware update or a developer copying files over).
+// If the directory itself is removed or replaced, the watch is set up again
+// on whatever is at the path, once there is something there.
+class DirectoryWatcher
+{
+  public:
+    DirectoryWatcher(boost::asio::io_context& ioc,
+                     const std::filesystem::path& directory,
+                     std::function<void()>&& onChangeIn);
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+    DirectoryWatcher(DirectoryWatcher&&) = delete;
+    DirectoryWatcher& operator=(DirectoryWatcher&&) = delete;
+    ~DirectoryWatcher() = default;
+
+    // Returns false if the directory isn't being watched, either because
+    // inotify couldn't be set up at all, or because the directory is gone and
+    // hasn't come back yet.
+    bool isWatching() const
+    {
+        return watchDesc >= 0;
+    }
+
+  private:
+    bool addWatch();
+    void rearmWatch();
+    void onRearmTimer(const boost::system::error_code& ec);
+    void readEvents();
+    void onINotify(const boost::system::error_code& ec,
+                   std::size_t bytesTransferred);
+
+    std::filesystem::path directory;
+    std::function<void()> onChange;
+    int watchDesc = -1;
+    std::array<char, 1024> readBuffer{};
+    boost::asio::steady_timer rearmTimer;
+    // Explicitly the last item so it is canceled before the buffer goes out
+    // of scope.
+    boost::asio::posix::stream_descriptor inotifyConn;
+};
+
+} // namespace bmcweb
@@ -40,3 +40,31 @@ struct TemporaryFileHandle
         std::filesystem::remove(path);
     }
 };
+
+struct TemporaryDirectoryHandle
+{
+    std::filesystem::path path;
+
+    // Creates an empty temporary directory, removes it and everything in it
+    // on destruction.
+    TemporaryDirectoryHandle()
+    {
+        std::string stringPath =
+            (std::filesystem::temp_directory_path() /
+             "bmcweb_test_dir_XXXXXXXXXXX")
+                .string();
+        EXPECT_NE(mkdtemp(stringPath.data()), nullptr);
+        path = stringPath;
+    }
+
+    TemporaryDirectoryHandle(const TemporaryDirectoryHandle&) = delete;
+    TemporaryDirectoryHandle(TemporaryDirectoryHandle&&) = delete;
+    TemporaryDirectoryHandle& operator=(const TemporaryDirectoryHandle&) =
+        delete;
+    TemporaryDirectoryHandle& operator=(TemporaryDirectoryHandle&&) = delete;
+
+    ~TemporaryDirectoryHandle()
+    {
+        std::filesystem::remove_all(path);
+    }
+};
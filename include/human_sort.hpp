@@ -2,9 +2,15 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #pragma once
 
+#include <algorithm>
 #include <charconv>
+#include <cstddef>
 #include <iterator>
+#include <ranges>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace details
 {
@@ -109,3 +115,135 @@ struct AlphanumLess
         return alphanumComp(left, right) < 0;
     }
 };
+
+// Appends a key for str to key, that sorts the same as str does under
+// alphanumComp, when keys are compared byte by byte as std::string does.
+// Each digit run becomes a marker, its length without leading zeros, and the
+// digits, so numbers compare by value however long they are.  Every other
+// character becomes a byte, or a marker and a byte, above the digit marker,
+// in the order alphanumComp puts them.
+inline void appendNaturalSortKey(std::string& key, std::string_view str)
+{
+    constexpr char numberMarker = 1;
+    // Bytes above 0x7f, which sort before ASCII where char is signed, and
+    // after it where it isn't
+    constexpr char negativeCharMarker = 2;
+    constexpr char asciiOffset = 3;
+    constexpr char highCharMarker = '\xff';
+
+    std::string_view::const_iterator it = str.begin();
+    while (it != str.end())
+    {
+        if (!details::simpleIsDigit(*it))
+        {
+            const int c = *it;
+            if (c < 0)
+            {
+                key += negativeCharMarker;
+                key += static_cast<char>(c + 0x80);
+            }
+            else if (c < 0x80)
+            {
+                key += static_cast<char>(c + asciiOffset);
+            }
+            else
+            {
+                key += highCharMarker;
+                key += static_cast<char>(c - 0x80);
+            }
+            it++;
+            continue;
+        }
+        while (it != str.end() && *it == '0')
+        {
+            it++;
+        }
+        std::string_view::const_iterator digits = it;
+        while (it != str.end() && details::simpleIsDigit(*it))
+        {
+            it++;
+        }
+        size_t length = static_cast<size_t>(std::distance(digits, it));
+        key += numberMarker;
+        key += static_cast<char>((length >> 8) & 0xff);
+        key += static_cast<char>(length & 0xff);
+        key.append(digits, it);
+    }
+}
+
+inline std::string naturalSortKey(std::string_view str)
+{
+    std::string key;
+    key.reserve(str.size() + 4);
+    appendNaturalSortKey(key, str);
+    return key;
+}
+
+// Sorts range by the keys appendKey appends for its elements, compared as
+// strings.  Each key is computed once, rather than on every comparison, into
+// one buffer shared by all of them.  Only small references to the keys are
+// moved while sorting, then each element is moved into place once.
+// Elements with equal keys keep their order.
+template <typename Range, typename AppendKey>
+void sortByKey(Range& range, AppendKey&& appendKey)
+{
+    using Value = std::ranges::range_value_t<Range>;
+    struct Keyed
+    {
+        size_t begin;
+        size_t size;
+        size_t index;
+    };
+
+    const size_t count = std::ranges::size(range);
+    std::string keys;
+    std::vector<Keyed> keyed;
+    keyed.reserve(count);
+    for (const Value& value : range)
+    {
+        size_t begin = keys.size();
+        appendKey(keys, value);
+        keyed.emplace_back(begin, keys.size() - begin, keyed.size());
+    }
+    std::ranges::sort(keyed, [&keys](const Keyed& left, const Keyed& right) {
+        int cmp = std::string_view(keys).substr(left.begin, left.size).compare(
+            std::string_view(keys).substr(right.begin, right.size));
+        if (cmp != 0)
+        {
+            return cmp < 0;
+        }
+        return left.index < right.index;
+    });
+
+    // Position i takes the element at keyed[i].index.  Follow each cycle of
+    // that permutation, so every element is moved once, and one per cycle is
+    // held aside.
+    auto elements = std::ranges::begin(range);
+    for (size_t start = 0; start < count; start++)
+    {
+        if (keyed[start].index == start)
+        {
+            continue;
+        }
+        Value held = std::move(elements[start]);
+        size_t to = start;
+        while (keyed[to].index != start)
+        {
+            size_t from = keyed[to].index;
+            elements[to] = std::move(elements[from]);
+            keyed[to].index = to;
+            to = from;
+        }
+        elements[to] = std::move(held);
+        keyed[to].index = to;
+    }
+}
+
+// Sorts a range of strings in the order of AlphanumLess
+template <typename Range>
+void naturalSort(Range& range)
+{
+    sortByKey(range, [](std::string& key, std::string_view value) {
+        appendNaturalSortKey(key, value);
+    });
+}
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "logging.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace bmcweb
+{
+
+// A read only mapping of a whole file.  The pages are faulted in from the
+// page cache as they are first used.  They stay valid while the mapping is
+// held if the file is removed, or replaced by renaming a new file over it,
+// as the mapping keeps the old inode.  Truncating or rewriting the file in
+// place changes the mapped bytes, and reading past a truncated end raises
+// SIGBUS, so mapped files must only ever be replaced by rename.
+class MappedFile
+{
+  public:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    ~MappedFile()
+    {
+        if (data != MAP_FAILED)
+        {
+            munmap(data, size);
+        }
+    }
+
+    // Returns null if the file can't be mapped, or is empty
+    static std::shared_ptr<const MappedFile> map(
+        const std::filesystem::path& path)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+        {
+            BMCWEB_LOG_WARNING("Failed to open {}", path.string());
+            return nullptr;
+        }
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            close(fd);
+            return nullptr;
+        }
+        size_t fileSize = static_cast<size_t>(st.st_size);
+        void* mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping holds its own reference to the file
+        close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            BMCWEB_LOG_WARNING("Failed to map {}", path.string());
+            return nullptr;
+        }
+        // Start reading the file in the background, so that the first request
+        // doesn't wait on the disk
+        madvise(mapped, fileSize, MADV_WILLNEED);
+        return std::shared_ptr<const MappedFile>(
+            new MappedFile(mapped, fileSize));
+    }
+
+    std::string_view bytes() const
+    {
+        return {static_cast<const char*>(data), size};
+    }
+
+  private:
+    MappedFile(void* dataIn, size_t sizeIn) : data(dataIn), size(sizeIn) {}
+
+    void* data = MAP_FAILED;
+    size_t size = 0;
+};
+
+} // namespace bmcweb
@@ -9,9 +9,11 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <functional>
 #include <ranges>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 enum class ParserError
@@ -27,7 +29,8 @@ enum class ParserError
     ERROR_HEADER_ENDING,
     ERROR_UNEXPECTED_END_OF_HEADER,
     ERROR_UNEXPECTED_END_OF_INPUT,
-    ERROR_OUT_OF_RANGE
+    ERROR_OUT_OF_RANGE,
+    ERROR_PART_REJECTED
 };
 
 enum class State
@@ -61,12 +64,33 @@ struct FormPart
 class MultipartParser
 {
   public:
+    // Called with the content of a part as it is parsed, possibly in several
+    // pieces.  Returning false aborts the parse.  Without a handler, the
+    // content is collected in FormPart::content.
+    using PartDataHandler =
+        std::function<bool(FormPart& part, std::string_view data)>;
+
     MultipartParser() = default;
 
     [[nodiscard]] ParserError parse(const crow::Request& req)
     {
-        std::string_view contentType = req.getHeaderValue("content-type");
+        ParserError ec = begin(req.getHeaderValue("content-type"));
+        if (ec != ParserError::PARSER_SUCCESS)
+        {
+            return ec;
+        }
+        ec = feed(req.body());
+        if (ec != ParserError::PARSER_SUCCESS)
+        {
+            return ec;
+        }
+        return finish();
+    }
 
+    // Starts an incremental parse of a body of the given content type.  The
+    // body is then passed to feed() in as many pieces as it arrives in.
+    [[nodiscard]] ParserError begin(std::string_view contentType)
+    {
         const std::string boundaryFormat = "multipart/form-data; boundary=";
         if (!contentType.starts_with(boundaryFormat))
         {
@@ -80,11 +104,25 @@ class MultipartParser
         indexBoundary();
         lookbehind.resize(boundary.size() + 8);
         state = State::START;
+        return ParserError::PARSER_SUCCESS;
+    }
+
+    void setPartDataHandler(PartDataHandler&& handler)
+    {
+        partDataHandler = std::move(handler);
+    }
 
-        const std::string& buffer = req.body();
+    [[nodiscard]] ParserError feed(std::string_view buffer)
+    {
         size_t len = buffer.size();
         char cl = 0;
 
+        // Marks point into the current buffer, so anything spanning the end
+        // of the previous one has already been saved
+        headerFieldMark = 0;
+        headerValueMark = 0;
+        partDataMark = 0;
+
         for (size_t i = 0; i < len; i++)
         {
             char c = buffer[i];
@@ -170,10 +208,11 @@ class MultipartParser
                 case State::HEADER_VALUE:
                     if (c == cr)
                     {
-                        std::string_view value(&buffer[headerValueMark],
-                                               i - headerValueMark);
+                        currentHeaderValue.append(&buffer[headerValueMark],
+                                                  i - headerValueMark);
                         mime_fields.rbegin()->fields.set(currentHeaderName,
-                                                         value);
+                                                         currentHeaderValue);
+                        currentHeaderValue.clear();
                         state = State::HEADER_VALUE_ALMOST_DONE;
                     }
                     break;
@@ -204,6 +243,10 @@ class MultipartParser
                     if (index == 0)
                     {
                         skipNonBoundary(buffer, boundary.size() - 1, i);
+                        if (i >= len)
+                        {
+                            break;
+                        }
                         c = buffer[i];
                     }
                     if (auto ec = processPartData(buffer, i, c);
@@ -220,6 +263,30 @@ class MultipartParser
             }
         }
 
+        // Save whatever the next buffer will need from this one
+        if (state == State::HEADER_FIELD)
+        {
+            currentHeaderName.append(buffer.substr(headerFieldMark));
+        }
+        else if (state == State::HEADER_VALUE)
+        {
+            currentHeaderValue.append(buffer.substr(headerValueMark));
+        }
+        else if (state == State::PART_DATA && index == 0 && partDataMark < len)
+        {
+            // Data that might start a boundary is held in the lookbehind
+            if (!addPartData(buffer.substr(partDataMark)))
+            {
+                return ParserError::ERROR_PART_REJECTED;
+            }
+        }
+
+        return ParserError::PARSER_SUCCESS;
+    }
+
+    // Checks that the whole body was parsed
+    [[nodiscard]] ParserError finish() const
+    {
         if (state != State::END)
         {
             return ParserError::ERROR_UNEXPECTED_END_OF_INPUT;
@@ -227,6 +294,7 @@ class MultipartParser
 
         return ParserError::PARSER_SUCCESS;
     }
+
     std::vector<FormPart> mime_fields;
     std::string boundary;
 
@@ -250,7 +318,22 @@ class MultipartParser
         return boundaryIndex[static_cast<unsigned char>(c)];
     }
 
-    void skipNonBoundary(const std::string& buffer, size_t boundaryEnd,
+    bool addPartData(std::string_view data)
+    {
+        if (data.empty())
+        {
+            return true;
+        }
+        FormPart& part = *mime_fields.rbegin();
+        if (partDataHandler)
+        {
+            return partDataHandler(part, data);
+        }
+        part.content += data;
+        return true;
+    }
+
+    void skipNonBoundary(std::string_view buffer, size_t boundaryEnd,
                          size_t& i)
     {
         // boyer-moore derived algorithm to safely skip non-boundary data
@@ -264,7 +347,7 @@ class MultipartParser
         }
     }
 
-    ParserError processPartData(const std::string& buffer, size_t& i, char c)
+    ParserError processPartData(std::string_view buffer, size_t& i, char c)
     {
         size_t prevIndex = index;
 
@@ -274,10 +357,11 @@ class MultipartParser
             {
                 if (index == 0)
                 {
-                    const char* start = &buffer[partDataMark];
-                    size_t size = i - partDataMark;
-                    mime_fields.rbegin()->content +=
-                        std::string_view(start, size);
+                    if (!addPartData(
+                            buffer.substr(partDataMark, i - partDataMark)))
+                    {
+                        return ParserError::ERROR_PART_REJECTED;
+                    }
                 }
                 index++;
             }
@@ -345,8 +429,10 @@ class MultipartParser
         {
             // if our boundary turned out to be rubbish, the captured
             // lookbehind belongs to partData
-
-            mime_fields.rbegin()->content += lookbehind.substr(0, prevIndex);
+            if (!addPartData(std::string_view(lookbehind).substr(0, prevIndex)))
+            {
+                return ParserError::ERROR_PART_REJECTED;
+            }
             partDataMark = i;
 
             // reconsider the current character even so it interrupted
@@ -365,6 +451,8 @@ class MultipartParser
     static constexpr char hyphen = '-';
     static constexpr char colon = ':';
 
+    PartDataHandler partDataHandler;
+
     std::array<bool, 256> boundaryIndex{};
     std::string lookbehind;
     State state{State::START};
@@ -2,13 +2,18 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #pragma once
 
+#include "atomic_file_writer.hpp"
 #include "event_service_store.hpp"
+#include "io_context_singleton.hpp"
 #include "logging.hpp"
 #include "ossl_random.hpp"
 #include "sessions.hpp"
 // NOLINTNEXTLINE(misc-include-cleaner)
 #include "utility.hpp"
 
+#include <sys/stat.h>
+
+#include <boost/asio/steady_timer.hpp>
 #include <boost/beast/core/file_base.hpp>
 #include <boost/beast/core/file_posix.hpp>
 #include <boost/beast/http/fields.hpp>
@@ -18,6 +23,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -51,14 +57,18 @@ class ConfigFile
 
     ConfigFile()
     {
+        createStateDirectory();
         readData();
+        SessionStore::getInstance().setWriteHandler(
+            std::bind_front(&ConfigFile::markDirty, this));
     }
 
     ~ConfigFile()
     {
+        SessionStore::getInstance().setWriteHandler(nullptr);
         // Make sure we aren't writing stale sessions
         persistent_data::SessionStore::getInstance().applySessionTimeouts();
-        if (persistent_data::SessionStore::getInstance().needsWrite())
+        if (dirty || persistent_data::SessionStore::getInstance().needsWrite())
         {
             writeData();
         }
@@ -277,44 +287,49 @@ class ConfigFile
         }
     }
 
-    void writeData()
+    // Schedules a write of the file.  Changes made within writeDelay of the
+    // first are written together, and the file is written on the writer's
+    // thread, so neither the caller nor the event loop waits on the disk.
+    void markDirty()
     {
-        const std::string& fname = filename();
-        std::filesystem::path path(fname);
-        path = path.parent_path();
-        if (!path.empty())
-        {
-            std::error_code ecDir;
-            std::filesystem::create_directories(path, ecDir);
-            if (ecDir)
-            {
-                BMCWEB_LOG_CRITICAL("Can't create persistent folders {}",
-                                    ecDir.message());
-                return;
-            }
-        }
-        boost::beast::file_posix persistentFile;
-        boost::system::error_code ec;
-        persistentFile.open(fname.c_str(), boost::beast::file_mode::write, ec);
-        if (ec)
+        if (dirty)
         {
-            BMCWEB_LOG_CRITICAL("Unable to store persistent data to file {}",
-                                ec.message());
             return;
         }
-
-        // set the permission of the file to 640
-        std::filesystem::perms permission =
-            std::filesystem::perms::owner_read |
-            std::filesystem::perms::owner_write |
-            std::filesystem::perms::group_read;
-        std::filesystem::permissions(fname, permission, ec);
-        if (ec)
+        dirty = true;
+        if (!writeTimer)
         {
-            BMCWEB_LOG_CRITICAL("Failed to set filesystem permissions {}",
-                                ec.message());
-            return;
+            writeTimer.emplace(getIoContext());
         }
+        writeTimer->expires_after(writeDelay);
+        writeTimer->async_wait([this](const boost::system::error_code& ec) {
+            if (ec || !dirty)
+            {
+                return;
+            }
+            writer.write(takeSnapshot());
+        });
+    }
+
+    // Writes the file now, and waits for it to be on disk
+    void writeData()
+    {
+        writer.write(takeSnapshot());
+        writer.flush();
+    }
+
+    // Serializes the persisted state and marks it clean, so that only
+    // changes made after this point cause another write
+    std::string takeSnapshot()
+    {
+        std::string data = serialize();
+        dirty = false;
+        SessionStore::getInstance().markWritten();
+        return data;
+    }
+
+    std::string serialize() const
+    {
         const AuthConfigMethods& c =
             SessionStore::getInstance().getAuthMethodsConfig();
         const auto& eventServiceConfig =
@@ -415,17 +430,38 @@ class ConfigFile
 
             subscriptions.emplace_back(std::move(subscription));
         }
-        std::string out = nlohmann::json(data).dump(
+        return nlohmann::json(data).dump(
             -1, ' ', true, nlohmann::json::error_handler_t::replace);
-        persistentFile.write(out.data(), out.size(), ec);
-        if (ec)
-        {
-            BMCWEB_LOG_ERROR("Failed to write file {}", ec.message());
-        }
     }
 
     std::string systemUuid;
     std::string serviceIdentification;
+
+  private:
+    static void createStateDirectory()
+    {
+        std::filesystem::path path(filename());
+        path = path.parent_path();
+        if (path.empty())
+        {
+            return;
+        }
+        std::error_code ecDir;
+        std::filesystem::create_directories(path, ecDir);
+        if (ecDir)
+        {
+            BMCWEB_LOG_CRITICAL("Can't create persistent folders {}",
+                                ecDir.message());
+        }
+    }
+
+    // How long changes are collected before the file is written
+    static constexpr std::chrono::milliseconds writeDelay{500};
+
+    // The file is readable by its owner and group only
+    bmcweb::AtomicFileWriter writer{filename(), S_IRUSR | S_IWUSR | S_IRGRP};
+    std::optional<boost::asio::steady_timer> writeTimer;
+    bool dirty = false;
 };
 
 inline ConfigFile& getConfig()
@@ -11,6 +11,7 @@
 #include <boost/asio/ip/address.hpp>
 #include <nlohmann/json.hpp>
 
+#include <bitset>
 #include <chrono>
 #include <csignal>
 #include <cstddef>
@@ -21,6 +22,7 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace persistent_data
@@ -54,6 +56,9 @@ struct UserSession
     bool isConfigureSelfOnly = false;
     std::string userRole;
     std::vector<std::string> userGroups;
+    // The bits of the redfish::Privileges that userRole and userGroups give,
+    // set by redfish::setUserPrivileges whenever they are read
+    std::bitset<32> privilegeBits;
 
     // There are two sources of truth for isConfigureSelfOnly:
     //  1. When pamAuthenticateUser() returns PAM_NEW_AUTHTOK_REQD.
@@ -294,8 +299,11 @@ class SessionStore
             {}});
         auto it = authTokens.emplace(sessionToken, session);
         // Only need to write to disk if session isn't about to be destroyed.
-        needWrite = sessionType != SessionType::Basic &&
-                    sessionType != SessionType::MutualTLS;
+        if (sessionType != SessionType::Basic &&
+            sessionType != SessionType::MutualTLS)
+        {
+            markNeedsWrite();
+        }
         return it.first->second;
     }
 
@@ -335,7 +343,7 @@ class SessionStore
     void removeSession(const std::shared_ptr<UserSession>& session)
     {
         authTokens.erase(session->sessionToken);
-        needWrite = true;
+        markNeedsWrite();
     }
 
     std::vector<std::string> getAllUniqueIds()
@@ -379,34 +387,44 @@ class SessionStore
 
     void removeSessionsByUsername(std::string_view username)
     {
-        std::erase_if(authTokens, [username](const auto& value) {
-            if (value.second == nullptr)
-            {
-                return false;
-            }
-            return value.second->username == username;
-        });
+        size_t removed =
+            std::erase_if(authTokens, [username](const auto& value) {
+                if (value.second == nullptr)
+                {
+                    return false;
+                }
+                return value.second->username == username;
+            });
+        if (removed != 0)
+        {
+            markNeedsWrite();
+        }
     }
 
     void removeSessionsByUsernameExceptSession(
         std::string_view username, const std::shared_ptr<UserSession>& session)
     {
-        std::erase_if(authTokens, [username, session](const auto& value) {
-            if (value.second == nullptr)
-            {
-                return false;
-            }
+        size_t removed =
+            std::erase_if(authTokens, [username, session](const auto& value) {
+                if (value.second == nullptr)
+                {
+                    return false;
+                }
 
-            return value.second->username == username &&
-                   value.second->uniqueId != session->uniqueId;
-        });
+                return value.second->username == username &&
+                       value.second->uniqueId != session->uniqueId;
+            });
+        if (removed != 0)
+        {
+            markNeedsWrite();
+        }
     }
 
     void updateAuthMethodsConfig(const AuthConfigMethods& config)
     {
         bool isTLSchanged = (authMethodsConfig.tls != config.tls);
         authMethodsConfig = config;
-        needWrite = true;
+        markNeedsWrite();
         if (isTLSchanged)
         {
             // recreate socket connections with new settings
@@ -424,6 +442,28 @@ class SessionStore
     {
         return needWrite;
     }
+
+    // Called whenever something that is persisted changes, so that the
+    // change can be written out
+    void setWriteHandler(std::function<void()>&& handler)
+    {
+        writeHandler = std::move(handler);
+    }
+
+    void markNeedsWrite()
+    {
+        needWrite = true;
+        if (writeHandler)
+        {
+            writeHandler();
+        }
+    }
+
+    // Called once the persisted state has been captured for writing
+    void markWritten()
+    {
+        needWrite = false;
+    }
     int64_t getTimeoutInSeconds() const
     {
         return std::chrono::seconds(timeoutInSeconds).count();
@@ -432,7 +472,7 @@ class SessionStore
     void updateSessionTimeout(std::chrono::seconds newTimeoutInSeconds)
     {
         timeoutInSeconds = newTimeoutInSeconds;
-        needWrite = true;
+        markNeedsWrite();
     }
 
     static SessionStore& getInstance()
@@ -455,7 +495,7 @@ class SessionStore
                 {
                     authTokensIt = authTokens.erase(authTokensIt);
 
-                    needWrite = true;
+                    markNeedsWrite();
                 }
                 else
                 {
@@ -477,6 +517,7 @@ class SessionStore
 
     std::chrono::time_point<std::chrono::steady_clock> lastTimeoutUpdate;
     bool needWrite{false};
+    std::function<void()> writeHandler;
     std::chrono::seconds timeoutInSeconds;
     AuthConfigMethods authMethodsConfig;
 
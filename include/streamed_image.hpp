@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "http_body.hpp"
+#include "logging.hpp"
+
+#include <fcntl.h>
+#include <openssl/evp.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <boost/beast/http/field.hpp>
+#include <boost/beast/http/fields.hpp>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <format>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace bmcweb
+{
+
+struct MemoryFileDescriptor
+{
+    int fd = -1;
+
+    explicit MemoryFileDescriptor(const std::string& filename) :
+        fd(memfd_create(filename.c_str(), 0))
+    {}
+
+    MemoryFileDescriptor(const MemoryFileDescriptor&) = default;
+    MemoryFileDescriptor(MemoryFileDescriptor&& other) noexcept : fd(other.fd)
+    {
+        other.fd = -1;
+    }
+    MemoryFileDescriptor& operator=(const MemoryFileDescriptor&) = delete;
+    MemoryFileDescriptor& operator=(MemoryFileDescriptor&&) = default;
+
+    ~MemoryFileDescriptor()
+    {
+        if (fd != -1)
+        {
+            close(fd);
+        }
+    }
+
+    bool rewind() const
+    {
+        if (lseek(fd, 0, SEEK_SET) == -1)
+        {
+            BMCWEB_LOG_ERROR("Failed to seek to beginning of image memfd");
+            return false;
+        }
+        return true;
+    }
+};
+
+// A firmware image received in a request body.  It is written to a memfd
+// as it arrives, and hashed on the way, so that bmcweb never holds the image
+// in memory.
+class StreamedImage
+{
+  public:
+    StreamedImage() :
+        memfd("update-image"), context(EVP_MD_CTX_new(), &EVP_MD_CTX_free)
+    {
+        if (memfd.fd == -1 || context == nullptr ||
+            EVP_DigestInit_ex(context.get(), EVP_sha256(), nullptr) != 1)
+        {
+            BMCWEB_LOG_ERROR("Failed to create image memfd");
+            failed = true;
+        }
+    }
+
+    bool write(std::string_view data)
+    {
+        if (failed)
+        {
+            return false;
+        }
+        if (EVP_DigestUpdate(context.get(), data.data(), data.size()) != 1)
+        {
+            BMCWEB_LOG_ERROR("Failed to hash image");
+            failed = true;
+            return false;
+        }
+        size += data.size();
+        while (!data.empty())
+        {
+            ssize_t written = ::write(memfd.fd, data.data(), data.size());
+            if (written == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                BMCWEB_LOG_ERROR("Failed to write to image memfd");
+                failed = true;
+                return false;
+            }
+            data.remove_prefix(static_cast<size_t>(written));
+        }
+        return true;
+    }
+
+    // Completes the digest, and rewinds the memfd for the update service
+    bool finish()
+    {
+        if (failed)
+        {
+            return false;
+        }
+        std::array<unsigned char, EVP_MAX_MD_SIZE> hash{};
+        unsigned int hashSize = 0;
+        if (EVP_DigestFinal_ex(context.get(), hash.data(), &hashSize) != 1 ||
+            !memfd.rewind())
+        {
+            failed = true;
+            return false;
+        }
+        digest.clear();
+        for (unsigned char byte : std::span(hash.data(), hashSize))
+        {
+            digest += std::format("{:02x}", byte);
+        }
+        return true;
+    }
+
+    // Copies the image to a file in the kernel, for updaters that pick
+    // images up from a directory
+    bool copyTo(const std::string& path) const
+    {
+        int out = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                       S_IRUSR | S_IRGRP);
+        if (out == -1)
+        {
+            BMCWEB_LOG_ERROR("Failed to create {}", path);
+            return false;
+        }
+        // set the permission of the file to 440, regardless of umask
+        fchmod(out, S_IRUSR | S_IRGRP);
+
+        bool ok = true;
+        off_t offset = 0;
+        while (static_cast<size_t>(offset) < size)
+        {
+            ssize_t copied = sendfile(out, memfd.fd, &offset,
+                                      size - static_cast<size_t>(offset));
+            if (copied == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            if (copied <= 0)
+            {
+                BMCWEB_LOG_ERROR("Failed to write {}", path);
+                ok = false;
+                break;
+            }
+        }
+        close(out);
+        return ok;
+    }
+
+    MemoryFileDescriptor memfd;
+    size_t size = 0;
+    // Hex SHA-256 of the image, once finished
+    std::string digest;
+    bool failed = false;
+
+  private:
+    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> context;
+};
+
+// Streams a raw image body into a StreamedImage
+class ImageBodySink : public BodySink
+{
+  public:
+    void put(std::string_view data) override
+    {
+        image.write(data);
+    }
+
+    void finish() override
+    {
+        image.finish();
+    }
+
+    StreamedImage image;
+};
+
+inline std::shared_ptr<BodySink> makeImageBodySink(
+    const boost::beast::http::fields& /*headers*/)
+{
+    return std::make_shared<ImageBodySink>();
+}
+
+} // namespace bmcweb
@@ -2,25 +2,36 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #pragma once
 
+#include "bmcweb_config.h"
+
 #include "app.hpp"
 #include "async_resp.hpp"
+#include "compression.hpp"
 #include "forward_unauthorized.hpp"
 #include "http_body.hpp"
 #include "http_request.hpp"
 #include "http_response.hpp"
+#include "http_utility.hpp"
 #include "logging.hpp"
+#include "mapped_file.hpp"
 #include "str_utility.hpp"
 #include "webroutes.hpp"
 
+#include <openssl/evp.h>
+
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/status.hpp>
 #include <boost/container/flat_set.hpp>
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <format>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <system_error>
@@ -71,44 +82,258 @@ struct StaticFile
     std::string etag;
     bmcweb::CompressionType onDiskComp = bmcweb::CompressionType::Raw;
     bool renamed = false;
+    // Set when the file is held in the StaticAssetCache
+    std::shared_ptr<const bmcweb::MappedFile> mapped;
 };
 
-inline void handleStaticAsset(
+// Keeps static files mapped in memory, up to a total size, so that loading
+// the web UI doesn't open or read any files.  Files are taken in the order
+// they're added, until the budget runs out, and the rest are served from
+// disk.
+class StaticAssetCache
+{
+  public:
+    explicit StaticAssetCache(size_t capacityIn) : capacity(capacityIn) {}
+
+    // Returns null if the file doesn't fit
+    std::shared_ptr<const bmcweb::MappedFile> load(
+        const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        uintmax_t fileSize = std::filesystem::file_size(path, ec);
+        if (ec || fileSize > capacity - used)
+        {
+            return nullptr;
+        }
+        std::shared_ptr<const bmcweb::MappedFile> mapped =
+            bmcweb::MappedFile::map(path);
+        if (mapped != nullptr)
+        {
+            used += mapped->bytes().size();
+        }
+        return mapped;
+    }
+
+    size_t size() const
+    {
+        return used;
+    }
+
+  private:
+    size_t capacity;
+    size_t used = 0;
+};
+
+// A document generated at runtime and held in memory, along with its
+// compressed variants, so that it can be served like a static file without
+// being regenerated or recompressed per request.
+struct StaticPayload
+{
+    struct Variant
+    {
+        // Empty for the uncompressed variant
+        std::string_view contentEncoding;
+        std::string etag;
+        std::string body;
+    };
+
+    std::string_view contentType;
+    Variant identity;
+    std::optional<Variant> gzip;
+    std::optional<Variant> zstd;
+};
+
+// Builds the ETag of one variant of the content identified by tag.  There
+// is no ETag when tag is empty.
+inline std::string makeVariantEtag(std::string_view tag,
+                                   std::string_view suffix)
+{
+    if (tag.empty())
+    {
+        return "";
+    }
+    return std::format("\"{}{}\"", tag, suffix);
+}
+
+// tag identifies this version of the content, and is used to build the
+// ETags of all variants.
+inline std::shared_ptr<const StaticPayload> makeStaticPayload(
+    std::string&& body, std::string_view contentType, std::string_view tag)
+{
+    // Each encoding gets its own strong ETag, as they aren't byte for byte
+    // identical.
+    std::shared_ptr<StaticPayload> payload = std::make_shared<StaticPayload>();
+    payload->contentType = contentType;
+
+    std::optional<std::string> gzip = bmcweb::gzipCompress(body);
+    if (gzip && gzip->size() < body.size())
+    {
+        payload->gzip.emplace("gzip", makeVariantEtag(tag, "-gzip"),
+                              std::move(*gzip));
+    }
+    std::optional<std::string> zstd = bmcweb::zstdCompress(body);
+    if (zstd && zstd->size() < body.size())
+    {
+        payload->zstd.emplace("zstd", makeVariantEtag(tag, "-zstd"),
+                              std::move(*zstd));
+    }
+    payload->identity.etag = makeVariantEtag(tag, "");
+    payload->identity.body = std::move(body);
+    return payload;
+}
+
+// Hex SHA-256 of the content.  Two different bodies can't realistically
+// share it, so it's safe to use as a strong ETag.  Empty if hashing failed.
+inline std::string sha256Hex(std::string_view body)
+{
+    std::array<unsigned char, EVP_MAX_MD_SIZE> hash{};
+    unsigned int hashSize = 0;
+    if (EVP_Digest(body.data(), body.size(), hash.data(), &hashSize,
+                   EVP_sha256(), nullptr) != 1)
+    {
+        BMCWEB_LOG_ERROR("Failed to hash static payload");
+        return "";
+    }
+    std::string hex;
+    for (unsigned char byte : std::span(hash.data(), hashSize))
+    {
+        hex += std::format("{:02x}", byte);
+    }
+    return hex;
+}
+
+// Tags the content with its SHA-256, so the ETags change whenever it does
+inline std::shared_ptr<const StaticPayload> makeStaticPayload(
+    std::string&& body, std::string_view contentType)
+{
+    std::string hash = sha256Hex(body);
+    return makeStaticPayload(std::move(body), contentType, hash);
+}
+
+// Adds the headers common to all static content and handles If-None-Match.
+// Returns true if the client already has the content, in which case no
+// body should be sent.
+inline bool addStaticHeaders(
     const crow::Request& req,
-    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp, const StaticFile& file)
+    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+    std::string_view contentType, std::string_view contentEncoding,
+    std::string_view etag, bool immutable)
 {
-    if (!file.contentType.empty())
+    if (!contentType.empty())
     {
         asyncResp->res.addHeader(boost::beast::http::field::content_type,
-                                 file.contentType);
+                                 contentType);
     }
 
-    if (!file.contentEncoding.empty())
+    if (!contentEncoding.empty())
     {
         asyncResp->res.addHeader(boost::beast::http::field::content_encoding,
-                                 file.contentEncoding);
+                                 contentEncoding);
     }
 
-    if (!file.etag.empty())
+    if (etag.empty())
     {
-        asyncResp->res.addHeader(boost::beast::http::field::etag, file.etag);
-        // Don't cache paths that don't have the etag in them, like
-        // index, which gets transformed to /
-        if (!file.renamed)
-        {
-            // Anything with a hash can be cached forever and is
-            // immutable
-            asyncResp->res.addHeader(boost::beast::http::field::cache_control,
-                                     "max-age=31556926, immutable");
-        }
+        return false;
+    }
+    asyncResp->res.addHeader(boost::beast::http::field::etag, etag);
+    if (immutable)
+    {
+        // Anything with a hash can be cached forever and is
+        // immutable
+        asyncResp->res.addHeader(boost::beast::http::field::cache_control,
+                                 "max-age=31556926, immutable");
+    }
 
-        std::string_view cachedEtag =
-            req.getHeaderValue(boost::beast::http::field::if_none_match);
-        if (cachedEtag == file.etag)
-        {
-            asyncResp->res.result(boost::beast::http::status::not_modified);
-            return;
-        }
+    std::string_view cachedEtag =
+        req.getHeaderValue(boost::beast::http::field::if_none_match);
+    if (cachedEtag == etag)
+    {
+        asyncResp->res.result(boost::beast::http::status::not_modified);
+        return true;
+    }
+    return false;
+}
+
+// Serves a StaticPayload, picking the smallest variant the client accepts.
+// The body is sent from the payload, which the response keeps alive.
+inline void handleStaticPayload(
+    const crow::Request& req,
+    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+    const std::shared_ptr<const StaticPayload>& sharedPayload)
+{
+    const StaticPayload& payload = *sharedPayload;
+    using http_helpers::Encoding;
+    std::array<Encoding, 3> available{};
+    size_t availableCount = 0;
+    if (payload.zstd)
+    {
+        available[availableCount++] = Encoding::ZSTD;
+    }
+    if (payload.gzip)
+    {
+        available[availableCount++] = Encoding::GZIP;
+    }
+    available[availableCount++] = Encoding::UnencodedBytes;
+
+    Encoding encoding = http_helpers::getPreferredEncoding(
+        req.getHeaderValue(boost::beast::http::field::accept_encoding),
+        std::span(available.data(), availableCount));
+
+    const StaticPayload::Variant* variant = &payload.identity;
+    if (encoding == Encoding::ZSTD && payload.zstd)
+    {
+        variant = &*payload.zstd;
+    }
+    else if (encoding == Encoding::GZIP && payload.gzip)
+    {
+        variant = &*payload.gzip;
+    }
+
+    if (payload.gzip || payload.zstd)
+    {
+        asyncResp->res.addHeader(boost::beast::http::field::vary,
+                                 "Accept-Encoding");
+    }
+    if (addStaticHeaders(req, asyncResp, payload.contentType,
+                         variant->contentEncoding, variant->etag, false))
+    {
+        return;
+    }
+    asyncResp->res.writeShared(sharedPayload, variant->body);
+}
+
+// Files stored with zstd are decompressed from disk for clients that don't
+// accept it, every other file is sent as stored
+inline bool canSendAsStored(const crow::Request& req, const StaticFile& file)
+{
+    if (file.onDiskComp != bmcweb::CompressionType::Zstd)
+    {
+        return true;
+    }
+    std::array<http_helpers::Encoding, 1> allowed{
+        http_helpers::Encoding::ZSTD};
+    return http_helpers::getPreferredEncoding(
+               req.getHeaderValue(boost::beast::http::field::accept_encoding),
+               allowed) == http_helpers::Encoding::ZSTD;
+}
+
+inline void handleStaticAsset(
+    const crow::Request& req,
+    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp, const StaticFile& file)
+{
+    // Don't cache paths that don't have the etag in them, like
+    // index, which gets transformed to /
+    if (addStaticHeaders(req, asyncResp, file.contentType,
+                         file.contentEncoding, file.etag, !file.renamed))
+    {
+        return;
+    }
+
+    if (file.mapped != nullptr && canSendAsStored(req, file))
+    {
+        asyncResp->res.response.body().compressionType = file.onDiskComp;
+        asyncResp->res.writeShared(file.mapped, file.mapped->bytes());
+        return;
     }
 
     if (asyncResp->res.openFile(file.absolutePath, bmcweb::EncodingType::Raw,
@@ -161,7 +386,8 @@ inline std::string_view getFiletypeForExtension(std::string_view extension)
     return contentType->second;
 }
 
-inline void addFile(App& app, const std::filesystem::directory_entry& dir)
+inline void addFile(App& app, const std::filesystem::directory_entry& dir,
+                    StaticAssetCache& cache)
 {
     StaticFile file;
     file.absolutePath = dir.path();
@@ -213,6 +439,7 @@ inline void addFile(App& app, const std::filesystem::directory_entry& dir)
         return;
     }
     file.contentType = getFiletypeForExtension(extension);
+    file.mapped = cache.load(file.absolutePath);
 
     if (webpath == "/")
     {
@@ -247,6 +474,7 @@ inline void requestRoutes(App& app)
         std::filesystem::begin(dirIter), std::filesystem::end(dirIter));
     std::sort(paths.rbegin(), paths.rend());
 
+    StaticAssetCache cache(1024UL * 1024UL * BMCWEB_STATIC_ASSET_CACHE_SIZE);
     for (const std::filesystem::directory_entry& dir : paths)
     {
         if (std::filesystem::is_directory(dir))
@@ -260,9 +488,11 @@ inline void requestRoutes(App& app)
         }
         else if (std::filesystem::is_regular_file(dir))
         {
-            addFile(app, dir);
+            addFile(app, dir, cache);
         }
     }
+    BMCWEB_LOG_INFO("Holding {} bytes of static files in memory",
+                    cache.size());
 }
 } // namespace webassets
 } // namespace crow
@@ -0,0 +1,424 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "dbus_singleton.hpp"
+#include "dbus_utility.hpp"
+#include "logging.hpp"
+#include "utils/dbus_utils.hpp"
+
+#include <boost/system/errc.hpp>
+#include <boost/system/error_code.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/message/native_types.hpp>
+#include <sdbusplus/unpack_properties.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace redfish
+{
+namespace certs
+{
+constexpr const char* certInstallIntf = "xyz.openbmc_project.Certs.Install";
+constexpr const char* certReplaceIntf = "xyz.openbmc_project.Certs.Replace";
+constexpr const char* objDeleteIntf = "xyz.openbmc_project.Object.Delete";
+constexpr const char* certPropIntf = "xyz.openbmc_project.Certs.Certificate";
+constexpr const char* httpsServiceName =
+    "xyz.openbmc_project.Certs.Manager.Server.Https";
+constexpr const char* ldapServiceName =
+    "xyz.openbmc_project.Certs.Manager.Client.Ldap";
+constexpr const char* authorityServiceName =
+    "xyz.openbmc_project.Certs.Manager.Authority.Truststore";
+constexpr const char* baseObjectPath = "/xyz/openbmc_project/certs";
+constexpr const char* httpsObjectPath =
+    "/xyz/openbmc_project/certs/server/https";
+constexpr const char* ldapObjectPath = "/xyz/openbmc_project/certs/client/ldap";
+constexpr const char* authorityObjectPath =
+    "/xyz/openbmc_project/certs/authority/truststore";
+} // namespace certs
+
+// The properties of a certificate that its Certificate resource is built
+// from.  The certificate manager parses the PEM on every property read, so
+// these are kept once read.
+struct CertificateProperties
+{
+    std::optional<std::string> certificateString;
+    std::optional<std::vector<std::string>> keyUsage;
+    std::optional<std::string> issuer;
+    std::optional<std::string> subject;
+    std::optional<uint64_t> validNotAfter;
+    std::optional<uint64_t> validNotBefore;
+};
+
+// Reads the properties of the Certs.Certificate interface, returning false
+// if any has an unexpected type
+inline bool readCertificateProperties(
+    const dbus::utility::DBusPropertiesMap& properties,
+    CertificateProperties& certificate)
+{
+    const std::string* certificateString = nullptr;
+    const std::vector<std::string>* keyUsage = nullptr;
+    const std::string* issuer = nullptr;
+    const std::string* subject = nullptr;
+    const uint64_t* validNotAfter = nullptr;
+    const uint64_t* validNotBefore = nullptr;
+
+    const bool success = sdbusplus::unpackPropertiesNoThrow(
+        dbus_utils::UnpackErrorPrinter(), properties, "CertificateString",
+        certificateString, "KeyUsage", keyUsage, "Issuer", issuer, "Subject",
+        subject, "ValidNotAfter", validNotAfter, "ValidNotBefore",
+        validNotBefore);
+    if (!success)
+    {
+        return false;
+    }
+
+    auto copy = [](const auto* value) {
+        using Value = std::remove_cvref_t<decltype(*value)>;
+        return value == nullptr ? std::nullopt : std::optional<Value>(*value);
+    };
+    certificate.certificateString = copy(certificateString);
+    certificate.keyUsage = copy(keyUsage);
+    certificate.issuer = copy(issuer);
+    certificate.subject = copy(subject);
+    certificate.validNotAfter = copy(validNotAfter);
+    certificate.validNotBefore = copy(validNotBefore);
+    return true;
+}
+
+// The certificates under /xyz/openbmc_project/certs, and the properties of
+// those that have been read.  The paths are found with GetSubTreePaths when
+// first needed, and properties with GetAll, after which both are kept up to
+// date from the signals of the certificate managers, so that listing and
+// reading certificates doesn't call the mapper or the managers again.
+class CertificateCache
+{
+  public:
+    using PathsHandler = std::function<void(const boost::system::error_code&,
+                                            const std::set<std::string>&)>;
+    using PropertiesHandler = std::function<void(
+        const boost::system::error_code&, const CertificateProperties&)>;
+
+    // Calls handler with the paths of every certificate
+    void getPaths(PathsHandler&& handler)
+    {
+        if (pathsState == State::Loaded)
+        {
+            handler(boost::system::error_code(), paths);
+            return;
+        }
+        pathsWaiting.emplace_back(std::move(handler));
+        if (pathsState == State::Loading)
+        {
+            return;
+        }
+        pathsState = State::Loading;
+        watch();
+        constexpr std::array<std::string_view, 1> interfaces = {
+            certs::certPropIntf};
+        dbus::utility::getSubTreePaths(
+            certs::baseObjectPath, 0, interfaces,
+            [this](const boost::system::error_code& ec,
+                   const dbus::utility::MapperGetSubTreePathsResponse& found) {
+                afterGetPaths(ec, found);
+            });
+    }
+
+    // Calls handler with the properties of the certificate at path, read
+    // from service
+    void getProperties(const std::string& service, const std::string& path,
+                       PropertiesHandler&& handler)
+    {
+        Entry& entry = entries[path];
+        if (entry.properties)
+        {
+            handler(boost::system::error_code(), *entry.properties);
+            return;
+        }
+        entry.waiting.emplace_back(std::move(handler));
+        if (entry.waiting.size() > 1)
+        {
+            return;
+        }
+        watch();
+        dbus::utility::getAllProperties(
+            service, path, certs::certPropIntf,
+            [this, path](const boost::system::error_code& ec,
+                         const dbus::utility::DBusPropertiesMap& properties) {
+                afterGetProperties(path, ec, properties);
+            });
+    }
+
+    void afterGetPaths(
+        const boost::system::error_code& ec,
+        const dbus::utility::MapperGetSubTreePathsResponse& found)
+    {
+        boost::system::error_code result;
+        std::set<std::string> read;
+        // The mapper returns an io_error when nothing matches
+        if (ec && ec != boost::system::errc::io_error)
+        {
+            BMCWEB_LOG_ERROR("Certificate collection query failed: {}", ec);
+            result = ec;
+        }
+        else if (!ec)
+        {
+            read.insert(found.begin(), found.end());
+        }
+        std::vector<PathsHandler> handlers = std::move(pathsWaiting);
+        pathsWaiting.clear();
+        for (PathsHandler& waiter : handlers)
+        {
+            waiter(result, read);
+        }
+        // A read that was going on when a certificate came or went is only
+        // good for the requests that were waiting on it
+        if (result || pathsStale)
+        {
+            pathsStale = false;
+            pathsState = State::Unloaded;
+            return;
+        }
+        paths = std::move(read);
+        pathsState = State::Loaded;
+    }
+
+    void afterGetProperties(const std::string& path,
+                            const boost::system::error_code& ec,
+                            const dbus::utility::DBusPropertiesMap& properties)
+    {
+        auto entry = entries.find(path);
+        if (entry == entries.end())
+        {
+            return;
+        }
+        std::vector<PropertiesHandler> handlers =
+            std::move(entry->second.waiting);
+        entry->second.waiting.clear();
+        bool stale = entry->second.stale;
+        entry->second.stale = false;
+
+        CertificateProperties certificate;
+        boost::system::error_code result = ec;
+        if (ec)
+        {
+            BMCWEB_LOG_ERROR("DBUS response error: {}", ec);
+        }
+        else if (!readCertificateProperties(properties, certificate))
+        {
+            result = boost::system::errc::make_error_code(
+                boost::system::errc::bad_message);
+        }
+        // Errors aren't kept, and neither are properties that changed while
+        // they were being read
+        if (result || stale)
+        {
+            entries.erase(entry);
+        }
+        else
+        {
+            entry->second.properties = certificate;
+        }
+        for (PropertiesHandler& waiter : handlers)
+        {
+            waiter(result, certificate);
+        }
+    }
+
+    void onInterfacesAdded(const std::string& path,
+                           const dbus::utility::DBusInterfacesMap& interfaces)
+    {
+        for (const auto& [interface, properties] : interfaces)
+        {
+            if (interface != certs::certPropIntf)
+            {
+                continue;
+            }
+            invalidate(path);
+            pathsChanged();
+            if (pathsState == State::Loaded)
+            {
+                paths.emplace(path);
+            }
+            // The signal carries every property, which saves reading them
+            // when the new certificate is first requested
+            CertificateProperties certificate;
+            if (readCertificateProperties(properties, certificate))
+            {
+                Entry& entry = entries[path];
+                if (entry.waiting.empty())
+                {
+                    entry.properties = std::move(certificate);
+                }
+            }
+        }
+    }
+
+    void onInterfacesRemoved(const std::string& path,
+                             std::span<const std::string> interfaces)
+    {
+        if (std::ranges::find(interfaces, certs::certPropIntf) ==
+            interfaces.end())
+        {
+            return;
+        }
+        invalidate(path);
+        pathsChanged();
+        paths.erase(path);
+    }
+
+    void onPropertiesChanged(const std::string& path,
+                             std::string_view interface)
+    {
+        if (interface == certs::certPropIntf)
+        {
+            invalidate(path);
+        }
+    }
+
+    // Forgets the properties of the certificate at path, to be read again
+    // by the next request
+    void invalidate(const std::string& path)
+    {
+        auto entry = entries.find(path);
+        if (entry == entries.end())
+        {
+            return;
+        }
+        if (entry->second.waiting.empty())
+        {
+            entries.erase(entry);
+            return;
+        }
+        entry->second.stale = true;
+    }
+
+    // Forgets every certificate, for when a certificate manager restarts
+    void reset()
+    {
+        paths.clear();
+        pathsChanged();
+        if (pathsState == State::Loaded)
+        {
+            pathsState = State::Unloaded;
+        }
+        std::erase_if(entries, [](const auto& entry) {
+            return entry.second.waiting.empty();
+        });
+        for (auto& entry : entries)
+        {
+            entry.second.stale = true;
+        }
+    }
+
+    // Whether the properties of the certificate at path are held
+    bool hasProperties(const std::string& path) const
+    {
+        auto entry = entries.find(path);
+        return entry != entries.end() && entry->second.properties;
+    }
+
+  private:
+    enum class State
+    {
+        Unloaded,
+        Loading,
+        Loaded,
+    };
+
+    struct Entry
+    {
+        std::optional<CertificateProperties> properties;
+        std::vector<PropertiesHandler> waiting;
+        bool stale = false;
+    };
+
+    void pathsChanged()
+    {
+        if (pathsState == State::Loading)
+        {
+            pathsStale = true;
+        }
+    }
+
+    void watch()
+    {
+        if (addedMatch != nullptr)
+        {
+            return;
+        }
+        namespace rules = sdbusplus::bus::match::rules;
+        std::string prefix = std::string(certs::baseObjectPath) + "/";
+        addedMatch = std::make_unique<sdbusplus::bus::match_t>(
+            *crow::connections::systemBus,
+            rules::interfacesAdded() + rules::argNpath(0, prefix),
+            [this](sdbusplus::message_t& msg) {
+                sdbusplus::message::object_path path;
+                dbus::utility::DBusInterfacesMap interfaces;
+                msg.read(path, interfaces);
+                onInterfacesAdded(path.str, interfaces);
+            });
+        removedMatch = std::make_unique<sdbusplus::bus::match_t>(
+            *crow::connections::systemBus,
+            rules::interfacesRemoved() + rules::argNpath(0, prefix),
+            [this](sdbusplus::message_t& msg) {
+                sdbusplus::message::object_path path;
+                std::vector<std::string> interfaces;
+                msg.read(path, interfaces);
+                onInterfacesRemoved(path.str, interfaces);
+            });
+        changedMatch = std::make_unique<sdbusplus::bus::match_t>(
+            *crow::connections::systemBus,
+            rules::type::signal() +
+                rules::interface("org.freedesktop.DBus.Properties") +
+                rules::member("PropertiesChanged") +
+                rules::path_namespace(certs::baseObjectPath) +
+                rules::argN(0, certs::certPropIntf),
+            [this](sdbusplus::message_t& msg) {
+                onPropertiesChanged(msg.get_path(), certs::certPropIntf);
+            });
+        for (const char* service :
+             {certs::httpsServiceName, certs::ldapServiceName,
+              certs::authorityServiceName})
+        {
+            restartedMatches.emplace_back(
+                std::make_unique<sdbusplus::bus::match_t>(
+                    *crow::connections::systemBus,
+                    rules::nameOwnerChanged(service),
+                    [this](sdbusplus::message_t& /*msg*/) { reset(); }));
+        }
+    }
+
+    State pathsState = State::Unloaded;
+    bool pathsStale = false;
+    std::set<std::string> paths;
+    std::vector<PathsHandler> pathsWaiting;
+    std::map<std::string, Entry, std::less<>> entries;
+
+    std::unique_ptr<sdbusplus::bus::match_t> addedMatch;
+    std::unique_ptr<sdbusplus::bus::match_t> removedMatch;
+    std::unique_ptr<sdbusplus::bus::match_t> changedMatch;
+    std::vector<std::unique_ptr<sdbusplus::bus::match_t>> restartedMatches;
+};
+
+inline CertificateCache& getCertificateCache()
+{
+    static CertificateCache cache;
+    return cache;
+}
+
+} // namespace redfish
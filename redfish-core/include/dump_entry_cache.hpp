@@ -0,0 +1,404 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "dbus_singleton.hpp"
+#include "dbus_utility.hpp"
+#include "generated/enums/log_entry.hpp"
+#include "human_sort.hpp"
+#include "logging.hpp"
+
+#include <boost/system/error_code.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/message/native_types.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace redfish
+{
+
+constexpr const char* dumpManagerService = "xyz.openbmc_project.Dump.Manager";
+
+// The properties of a dump entry that its LogEntry is built from, gathered
+// from the interfaces of the D-Bus entry object
+struct DumpEntry
+{
+    std::string status;
+    uint64_t size = 0;
+    uint64_t timestampUs = 0;
+    std::string originatorId;
+    log_entry::OriginatorTypes originatorType =
+        log_entry::OriginatorTypes::Internal;
+    // Set if one of the properties had an unexpected type
+    bool malformed = false;
+
+    // Entries still being collected aren't shown until they complete
+    bool completed() const
+    {
+        return status.empty() ||
+               status ==
+                   "xyz.openbmc_project.Common.Progress.OperationStatus.Completed";
+    }
+};
+
+inline log_entry::OriginatorTypes mapDbusOriginatorTypeToRedfish(
+    const std::string& originatorType)
+{
+    if (originatorType ==
+        "xyz.openbmc_project.Common.OriginatedBy.OriginatorTypes.Client")
+    {
+        return log_entry::OriginatorTypes::Client;
+    }
+    if (originatorType ==
+        "xyz.openbmc_project.Common.OriginatedBy.OriginatorTypes.Internal")
+    {
+        return log_entry::OriginatorTypes::Internal;
+    }
+    if (originatorType ==
+        "xyz.openbmc_project.Common.OriginatedBy.OriginatorTypes.SupportingService")
+    {
+        return log_entry::OriginatorTypes::SupportingService;
+    }
+    return log_entry::OriginatorTypes::Invalid;
+}
+
+// Whether an interface of a dump entry carries properties of DumpEntry
+inline bool isDumpEntryInterface(std::string_view interface)
+{
+    return interface == "xyz.openbmc_project.Common.Progress" ||
+           interface == "xyz.openbmc_project.Dump.Entry" ||
+           interface == "xyz.openbmc_project.Time.EpochTime" ||
+           interface == "xyz.openbmc_project.Common.OriginatedBy";
+}
+
+// Applies the properties of one or more interfaces of a dump entry.  The
+// names don't overlap between the interfaces, so a GetAll of every
+// interface can be applied in one go.
+inline void updateDumpEntry(const dbus::utility::DBusPropertiesMap& properties,
+                            DumpEntry& entry)
+{
+    for (const auto& [name, value] : properties)
+    {
+        if (name == "Status")
+        {
+            const std::string* status = std::get_if<std::string>(&value);
+            if (status == nullptr)
+            {
+                entry.malformed = true;
+                continue;
+            }
+            entry.status = *status;
+        }
+        else if (name == "Size")
+        {
+            const uint64_t* size = std::get_if<uint64_t>(&value);
+            if (size == nullptr)
+            {
+                entry.malformed = true;
+                continue;
+            }
+            entry.size = *size;
+        }
+        else if (name == "Elapsed")
+        {
+            const uint64_t* usecsTimeStamp = std::get_if<uint64_t>(&value);
+            if (usecsTimeStamp == nullptr)
+            {
+                entry.malformed = true;
+                continue;
+            }
+            entry.timestampUs = *usecsTimeStamp;
+        }
+        else if (name == "OriginatorId")
+        {
+            const std::string* id = std::get_if<std::string>(&value);
+            if (id == nullptr)
+            {
+                entry.malformed = true;
+                continue;
+            }
+            entry.originatorId = *id;
+        }
+        else if (name == "OriginatorType")
+        {
+            const std::string* type = std::get_if<std::string>(&value);
+            if (type == nullptr)
+            {
+                entry.malformed = true;
+                continue;
+            }
+            entry.originatorType = mapDbusOriginatorTypeToRedfish(*type);
+            if (entry.originatorType == log_entry::OriginatorTypes::Invalid)
+            {
+                entry.malformed = true;
+            }
+        }
+    }
+}
+
+// The entries of one type of dump, by Id, kept up to date from the signals
+// of the dump manager.  The entries are read with
+// GetManagedObjects when they're first needed, after which collection
+// requests don't need to call the dump manager at all.
+class DumpEntryCache
+{
+  public:
+    // Keyed by the exact Id, so Ids that AlphanumLess considers equal, such
+    // as "01" and "1", are still separate entries
+    using Entries = std::map<std::string, DumpEntry, std::less<>>;
+    using SortedEntries = std::vector<const Entries::value_type*>;
+    using Handler =
+        std::function<void(const boost::system::error_code&, const Entries&)>;
+
+    // entryRoot is the D-Bus path the entries of this type are under, for
+    // example /xyz/openbmc_project/dump/bmc/entry
+    explicit DumpEntryCache(std::string entryRoot) :
+        entryPrefix(std::move(entryRoot) + "/")
+    {}
+
+    // Lists entries in the order they are shown in, the natural order of
+    // their Ids, so "2" comes before "10".  Ids with the same natural sort
+    // key stay in the order of the map.
+    static SortedEntries sorted(const Entries& entries)
+    {
+        SortedEntries list;
+        list.reserve(entries.size());
+        for (const Entries::value_type& entry : entries)
+        {
+            list.emplace_back(&entry);
+        }
+        sortByKey(list,
+                  [](std::string& key, const Entries::value_type* entry) {
+                      appendNaturalSortKey(key, entry->first);
+                  });
+        return list;
+    }
+
+    // Calls handler with the entries, once they've been read
+    void get(Handler&& handler)
+    {
+        if (state == State::Loaded)
+        {
+            handler(boost::system::error_code(), entries);
+            return;
+        }
+        waiting.emplace_back(std::move(handler));
+        if (state == State::Loading)
+        {
+            return;
+        }
+        state = State::Loading;
+        // The matches go in before the entries are read.  Signals the dump
+        // manager sends before its reply are already reflected in it, and
+        // are dropped while loading.
+        watch();
+        sdbusplus::message::object_path path("/xyz/openbmc_project/dump");
+        dbus::utility::getManagedObjects(
+            dumpManagerService, path,
+            [this](const boost::system::error_code& ec,
+                   const dbus::utility::ManagedObjectType& objects) {
+                if (ec)
+                {
+                    BMCWEB_LOG_ERROR("DumpEntry resp_handler got error {}",
+                                     ec);
+                    reset();
+                }
+                else
+                {
+                    load(objects);
+                }
+                std::vector<Handler> handlers = std::move(waiting);
+                waiting.clear();
+                for (Handler& waiter : handlers)
+                {
+                    waiter(ec, entries);
+                }
+            });
+    }
+
+    void load(const dbus::utility::ManagedObjectType& objects)
+    {
+        entries.clear();
+        for (const auto& [path, interfaces] : objects)
+        {
+            addEntry(path, interfaces);
+        }
+        state = State::Loaded;
+    }
+
+    void onInterfacesAdded(const sdbusplus::message::object_path& path,
+                           const dbus::utility::DBusInterfacesMap& interfaces)
+    {
+        if (state == State::Loaded)
+        {
+            addEntry(path, interfaces);
+        }
+    }
+
+    void onInterfacesRemoved(const sdbusplus::message::object_path& path,
+                             const std::vector<std::string>& interfaces)
+    {
+        if (state != State::Loaded)
+        {
+            return;
+        }
+        // Entries are only ever removed as a whole, with Dump.Entry
+        if (std::ranges::find(interfaces, "xyz.openbmc_project.Dump.Entry") ==
+            interfaces.end())
+        {
+            return;
+        }
+        std::string id = entryId(path);
+        if (!id.empty())
+        {
+            entries.erase(id);
+        }
+    }
+
+    void onPropertiesChanged(
+        const sdbusplus::message::object_path& path,
+        const std::string& interface,
+        const dbus::utility::DBusPropertiesMap& properties)
+    {
+        if (state != State::Loaded || !isDumpEntryInterface(interface))
+        {
+            return;
+        }
+        auto entry = entries.find(entryId(path));
+        if (entry != entries.end())
+        {
+            updateDumpEntry(properties, entry->second);
+        }
+    }
+
+    // Forgets the entries, to be read again by the next request, for when
+    // the dump manager restarts
+    void reset()
+    {
+        entries.clear();
+        state = State::Unloaded;
+    }
+
+  private:
+    enum class State
+    {
+        Unloaded,
+        Loading,
+        Loaded,
+    };
+
+    // The Id of the entry at path, or empty if it isn't one of this type
+    std::string entryId(const sdbusplus::message::object_path& path) const
+    {
+        if (!path.str.starts_with(entryPrefix))
+        {
+            return "";
+        }
+        return path.filename();
+    }
+
+    void addEntry(const sdbusplus::message::object_path& path,
+                  const dbus::utility::DBusInterfacesMap& interfaces)
+    {
+        std::string id = entryId(path);
+        if (id.empty())
+        {
+            return;
+        }
+        DumpEntry& entry = entries[id];
+        for (const auto& [interface, properties] : interfaces)
+        {
+            if (isDumpEntryInterface(interface))
+            {
+                updateDumpEntry(properties, entry);
+            }
+        }
+    }
+
+    void watch()
+    {
+        if (added != nullptr)
+        {
+            return;
+        }
+        namespace rules = sdbusplus::bus::match::rules;
+        added = std::make_unique<sdbusplus::bus::match_t>(
+            *crow::connections::systemBus,
+            rules::interfacesAdded() + rules::sender(dumpManagerService) +
+                rules::argNpath(0, entryPrefix),
+            [this](sdbusplus::message_t& msg) {
+                sdbusplus::message::object_path path;
+                dbus::utility::DBusInterfacesMap interfaces;
+                msg.read(path, interfaces);
+                onInterfacesAdded(path, interfaces);
+            });
+        removed = std::make_unique<sdbusplus::bus::match_t>(
+            *crow::connections::systemBus,
+            rules::interfacesRemoved() + rules::sender(dumpManagerService) +
+                rules::argNpath(0, entryPrefix),
+            [this](sdbusplus::message_t& msg) {
+                sdbusplus::message::object_path path;
+                std::vector<std::string> interfaces;
+                msg.read(path, interfaces);
+                onInterfacesRemoved(path, interfaces);
+            });
+        changed = std::make_unique<sdbusplus::bus::match_t>(
+            *crow::connections::systemBus,
+            rules::type::signal() + rules::sender(dumpManagerService) +
+                rules::member("PropertiesChanged") +
+                rules::interface("org.freedesktop.DBus.Properties") +
+                rules::path_namespace(
+                    entryPrefix.substr(0, entryPrefix.size() - 1)),
+            [this](sdbusplus::message_t& msg) {
+                std::string interface;
+                dbus::utility::DBusPropertiesMap properties;
+                msg.read(interface, properties);
+                onPropertiesChanged(msg.get_path(), interface, properties);
+            });
+        restarted = std::make_unique<sdbusplus::bus::match_t>(
+            *crow::connections::systemBus,
+            rules::nameOwnerChanged(dumpManagerService),
+            [this](sdbusplus::message_t& /*msg*/) {
+                if (state == State::Loaded)
+                {
+                    reset();
+                }
+            });
+    }
+
+    std::string entryPrefix;
+    Entries entries;
+    State state = State::Unloaded;
+    std::vector<Handler> waiting;
+
+    std::unique_ptr<sdbusplus::bus::match_t> added;
+    std::unique_ptr<sdbusplus::bus::match_t> removed;
+    std::unique_ptr<sdbusplus::bus::match_t> changed;
+    std::unique_ptr<sdbusplus::bus::match_t> restarted;
+};
+
+// Returns the cache of a type of dump, BMC, FaultLog or System, for the
+// entries under dumpPath
+inline DumpEntryCache& getDumpEntryCache(const std::string& dumpPath)
+{
+    static std::map<std::string, std::unique_ptr<DumpEntryCache>, std::less<>>
+        caches;
+    std::unique_ptr<DumpEntryCache>& cache = caches[dumpPath];
+    if (cache == nullptr)
+    {
+        cache = std::make_unique<DumpEntryCache>(dumpPath + "/entry");
+    }
+    return *cache;
+}
+
+} // namespace redfish
@@ -7,8 +7,8 @@
 #include "dbus_log_watcher.hpp"
 #include "error_messages.hpp"
 #include "event_logs_object_type.hpp"
-#include "event_matches_filter.hpp"
 #include "event_service_store.hpp"
+#include "event_subscription_index.hpp"
 #include "filesystem_log_watcher.hpp"
 #include "io_context_singleton.hpp"
 #include "logging.hpp"
@@ -23,10 +23,12 @@
 #include <boost/circular_buffer/base.hpp>
 #include <boost/container/flat_map.hpp>
 #include <boost/system/result.hpp>
+#include <boost/url/format.hpp>
 #include <boost/url/parse.hpp>
 #include <boost/url/url_view_base.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <ctime>
@@ -60,12 +62,21 @@ class EventServiceManager
     boost::container::flat_map<std::string, std::shared_ptr<Subscription>>
         subscriptionsMap;
 
+    // Routes events to the subscriptions whose filters accept them.  Slots
+    // in the index refer to indexedSubscriptions.
+    EventSubscriptionIndex subscriptionIndex;
+    std::vector<std::shared_ptr<Subscription>> indexedSubscriptions;
+
     uint64_t eventId{1};
 
     struct Event
     {
         uint64_t id;
         nlohmann::json::object_t message;
+        // Encoded form of message, built the first time the event is replayed
+        // to an SSE client and shared by all later replays.
+        std::string serialized = {};
+        crow::sse_socket::SseFrame frame = nullptr;
     };
 
     constexpr static size_t maxMessages = 200;
@@ -135,6 +146,7 @@ class EventServiceManager
                 subValue->scheduleNextHeartbeatEvent();
             }
         }
+        rebuildSubscriptionIndex();
     }
 
     void updateSubscriptionData() const
@@ -146,7 +158,7 @@ class EventServiceManager
         persistent_data::EventServiceStore::getInstance()
             .eventServiceConfig.retryTimeoutInterval = retryTimeoutInterval;
 
-        persistent_data::getConfig().writeData();
+        persistent_data::getConfig().markDirty();
     }
 
     void setEventServiceConfig(const persistent_data::EventServiceConfig& cfg)
@@ -294,6 +306,35 @@ class EventServiceManager
         }
     }
 
+    // Rebuilds the event routing index.  Must be called whenever a
+    // subscription is added or removed.
+    void rebuildSubscriptionIndex()
+    {
+        subscriptionIndex.clear();
+        indexedSubscriptions.clear();
+        indexedSubscriptions.reserve(subscriptionsMap.size());
+        for (const auto& it : subscriptionsMap)
+        {
+            indexedSubscriptions.emplace_back(it.second);
+            subscriptionIndex.add(*it.second->userSub);
+        }
+    }
+
+    // Returns the subscriptions in the given index slots.  The subscriptions
+    // are copied out, so that sending to them can't be affected by the
+    // index being rebuilt.
+    std::vector<std::shared_ptr<Subscription>> getIndexedSubscriptions(
+        const std::vector<size_t>& slots) const
+    {
+        std::vector<std::shared_ptr<Subscription>> subs;
+        subs.reserve(slots.size());
+        for (size_t slot : slots)
+        {
+            subs.emplace_back(indexedSubscriptions[slot]);
+        }
+        return subs;
+    }
+
     std::shared_ptr<Subscription> getSubscription(const std::string& id)
     {
         auto obj = subscriptionsMap.find(id);
@@ -343,6 +384,7 @@ class EventServiceManager
         persistent_data::EventServiceStore::getInstance()
             .subscriptionsConfigMap.emplace(id, subValue->userSub);
 
+        rebuildSubscriptionIndex();
         updateNoOfSubscribersCount();
 
         // Update retry configuration.
@@ -381,17 +423,18 @@ class EventServiceManager
                 // Skip the last event the user already has
                 lastEvent++;
 
-                for (boost::circular_buffer<Event>::const_iterator event =
-                         lastEvent;
+                for (boost::circular_buffer<Event>::iterator event = lastEvent;
                      event != messages.end(); event++)
                 {
-                    std::string strMsg =
-                        nlohmann::json(event->message)
-                            .dump(2, ' ', true,
-                                  nlohmann::json::error_handler_t::replace);
-
-                    subValue->sendEventToSubscriber(event->id,
-                                                    std::move(strMsg));
+                    if (event->serialized.empty())
+                    {
+                        event->serialized =
+                            nlohmann::json(event->message)
+                                .dump(2, ' ', true,
+                                      nlohmann::json::error_handler_t::replace);
+                    }
+                    subValue->sendSharedEventToSubscriber(
+                        event->id, event->serialized, event->frame);
                 }
             }
         }
@@ -424,6 +467,7 @@ class EventServiceManager
             return false;
         }
         subscriptionsMap.erase(obj);
+        rebuildSubscriptionIndex();
         auto& event = persistent_data::EventServiceStore::getInstance();
         auto persistentObj = event.subscriptionsConfigMap.find(id);
         if (persistentObj == event.subscriptionsConfigMap.end())
@@ -449,7 +493,8 @@ class EventServiceManager
             {
                 persistent_data::EventServiceStore::getInstance()
                     .subscriptionsConfigMap.erase(entry->userSub->id);
-                it = subscriptionsMap.erase(it);
+                subscriptionsMap.erase(it);
+                rebuildSubscriptionIndex();
                 return;
             }
             it++;
@@ -541,10 +586,11 @@ class EventServiceManager
             2, ' ', true, nlohmann::json::error_handler_t::replace);
 
         messages.push_back(Event(eventId, msg));
+        crow::sse_socket::SseFrame frame;
         for (const auto& it : subscriptionsMap)
         {
             std::shared_ptr<Subscription> entry = it.second;
-            if (!entry->sendEventToSubscriber(eventId, std::string(strMsg)))
+            if (!entry->sendSharedEventToSubscriber(eventId, strMsg, frame))
             {
                 return false;
             }
@@ -557,10 +603,26 @@ class EventServiceManager
     {
         EventServiceManager& mgr = EventServiceManager::getInstance();
         mgr.eventId++;
-        for (const auto& it : mgr.subscriptionsMap)
+
+        // Log entries carry no OriginOfCondition or resource type, so only
+        // the MessageId can select subscribers
+        std::vector<size_t> slots;
+        std::vector<size_t> recordSlots;
+        for (const EventLogObjectsType& record : eventRecords)
         {
-            Subscription& entry = *it.second;
-            entry.filterAndSendEventLogs(mgr.eventId, eventRecords);
+            nlohmann::json::object_t routing;
+            routing["MessageId"] = record.messageId;
+            mgr.subscriptionIndex.match(routing, "", recordSlots);
+            slots.insert(slots.end(), recordSlots.begin(), recordSlots.end());
+        }
+        std::ranges::sort(slots);
+        auto [first, last] = std::ranges::unique(slots);
+        slots.erase(first, last);
+
+        for (const std::shared_ptr<Subscription>& entry :
+             mgr.getIndexedSubscriptions(slots))
+        {
+            entry->filterAndSendEventLogs(mgr.eventId, eventRecords);
         }
     }
 
@@ -570,10 +632,15 @@ class EventServiceManager
         EventServiceManager& mgr = EventServiceManager::getInstance();
         mgr.eventId++;
 
-        for (const auto& it : mgr.subscriptionsMap)
+        boost::urls::url mrdUri = boost::urls::format(
+            "/redfish/v1/TelemetryService/MetricReportDefinitions/{}",
+            reportId);
+        std::vector<size_t> slots;
+        mgr.subscriptionIndex.matchMetricReport(mrdUri.buffer(), slots);
+        for (const std::shared_ptr<Subscription>& entry :
+             mgr.getIndexedSubscriptions(slots))
         {
-            Subscription& entry = *it.second;
-            entry.filterAndSendReports(mgr.eventId, reportId, var);
+            entry->filterAndSendReports(mgr.eventId, reportId, var);
         }
     }
 
@@ -596,29 +663,37 @@ class EventServiceManager
 
         messages.push_back(Event(eventId, eventMessage));
 
-        for (auto& it : subscriptionsMap)
+        // The payload doesn't depend on the subscriber, so it's serialized
+        // once, on the first match, and shared by all matching subscribers.
+        std::string strMsg;
+        crow::sse_socket::SseFrame frame;
+        std::vector<size_t> slots;
+        subscriptionIndex.match(eventMessage, resourceType, slots);
+        for (const std::shared_ptr<Subscription>& entry :
+             getIndexedSubscriptions(slots))
         {
-            std::shared_ptr<Subscription>& entry = it.second;
-            if (!eventMatchesFilter(*entry->userSub, eventMessage,
-                                    resourceType))
+            if (entry->filter && !entry->filter->matches(eventMessage))
             {
-                BMCWEB_LOG_DEBUG("Filter didn't match");
+                BMCWEB_LOG_DEBUG("$filter didn't match");
                 continue;
             }
 
-            nlohmann::json::array_t eventRecord;
-            eventRecord.emplace_back(eventMessage);
+            if (strMsg.empty())
+            {
+                nlohmann::json::array_t eventRecord;
+                eventRecord.emplace_back(eventMessage);
 
-            nlohmann::json msgJson;
+                nlohmann::json msgJson;
 
-            msgJson["@odata.type"] = "#Event.v1_4_0.Event";
-            msgJson["Name"] = "Event Log";
-            msgJson["Id"] = eventId;
-            msgJson["Events"] = std::move(eventRecord);
+                msgJson["@odata.type"] = "#Event.v1_4_0.Event";
+                msgJson["Name"] = "Event Log";
+                msgJson["Id"] = eventId;
+                msgJson["Events"] = std::move(eventRecord);
 
-            std::string strMsg = msgJson.dump(
-                2, ' ', true, nlohmann::json::error_handler_t::replace);
-            entry->sendEventToSubscriber(eventId, std::move(strMsg));
+                strMsg = msgJson.dump(
+                    2, ' ', true, nlohmann::json::error_handler_t::replace);
+            }
+            entry->sendSharedEventToSubscriber(eventId, strMsg, frame);
         }
     }
 };
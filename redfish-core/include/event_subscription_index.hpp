@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "event_matches_filter.hpp"
+#include "event_service_store.hpp"
+
+#include <boost/container/flat_map.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace redfish
+{
+
+// Inverted index over the event filters of all subscriptions
+// (ResourceTypes, RegistryPrefixes, MessageIds, OriginResources and
+// MetricReportDefinitions), so that dispatching an event only touches the
+// subscriptions that can match it, rather than checking every filter of
+// every subscription.
+//
+// Subscriptions are identified by their slot, which is the order in which
+// they were added.  The index is rebuilt whenever the set of subscriptions
+// changes.
+class EventSubscriptionIndex
+{
+  public:
+    void clear()
+    {
+        entries.clear();
+        unfiltered.clear();
+        byMessageId.clear();
+        byOrigin.clear();
+        byResourceType.clear();
+        byRegistry.clear();
+        allReports.clear();
+        byReportDefinition.clear();
+    }
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+    void add(const persistent_data::UserSubscription& sub)
+    {
+        size_t slot = entries.size();
+        Entry& entry = entries.emplace_back();
+        entry.registryMsgIds = sortedUnique(sub.registryMsgIds);
+        entry.originResources = sortedUnique(sub.originResources);
+        entry.resourceTypes = sortedUnique(sub.resourceTypes);
+        entry.registryPrefixes = sortedUnique(sub.registryPrefixes);
+
+        // Each subscription is indexed under its most selective filter
+        // only, and the others are checked when it is a candidate.  Values
+        // within a filter are unique, and an event has a single value for
+        // each, so a subscription can be a candidate at most once.
+        if (!entry.registryMsgIds.empty())
+        {
+            addKeys(byMessageId, entry.registryMsgIds, slot);
+        }
+        else if (!entry.originResources.empty())
+        {
+            addKeys(byOrigin, entry.originResources, slot);
+        }
+        else if (!entry.resourceTypes.empty())
+        {
+            addKeys(byResourceType, entry.resourceTypes, slot);
+        }
+        else if (!entry.registryPrefixes.empty())
+        {
+            addKeys(byRegistry, entry.registryPrefixes, slot);
+        }
+        else
+        {
+            unfiltered.emplace_back(slot);
+        }
+
+        std::vector<std::string> reports =
+            sortedUnique(sub.metricReportDefinitions);
+        if (reports.empty())
+        {
+            allReports.emplace_back(slot);
+        }
+        else
+        {
+            addKeys(byReportDefinition, reports, slot);
+        }
+    }
+
+    // Fills out with the slots of the subscriptions whose filters accept
+    // the event, in slot order.  Equivalent to calling eventMatchesFilter()
+    // for every subscription.
+    void match(const nlohmann::json::object_t& eventMessage,
+               std::string_view resourceType, std::vector<size_t>& out) const
+    {
+        out.clear();
+
+        const std::string* messageId = getString(eventMessage, "MessageId");
+        const std::string* origin =
+            getString(eventMessage, "OriginOfCondition");
+        std::string_view originValue;
+        if (origin != nullptr)
+        {
+            originValue = *origin;
+        }
+
+        std::string registry;
+        std::string messageKey;
+        std::string registryMsgId;
+        if (messageId != nullptr)
+        {
+            getRegistryAndMessageKey(*messageId, registry, messageKey);
+            registryMsgId = registry;
+            registryMsgId += '.';
+            registryMsgId += messageKey;
+        }
+
+        auto addCandidates = [this, &out, messageId, origin, originValue,
+                              &registry, &registryMsgId,
+                              resourceType](const std::vector<size_t>& slots) {
+            for (size_t slot : slots)
+            {
+                const Entry& entry = entries[slot];
+                if (filterAccepts(entry.registryMsgIds, messageId != nullptr,
+                                  registryMsgId) &&
+                    filterAccepts(entry.originResources, origin != nullptr,
+                                  originValue) &&
+                    filterAccepts(entry.resourceTypes, true, resourceType) &&
+                    filterAccepts(entry.registryPrefixes, messageId != nullptr,
+                                  registry))
+                {
+                    out.emplace_back(slot);
+                }
+            }
+        };
+
+        addCandidates(unfiltered);
+        if (messageId != nullptr)
+        {
+            addCandidates(findSlots(byMessageId, registryMsgId));
+            addCandidates(findSlots(byRegistry, registry));
+        }
+        if (origin != nullptr)
+        {
+            addCandidates(findSlots(byOrigin, originValue));
+        }
+        addCandidates(findSlots(byResourceType, resourceType));
+
+        std::ranges::sort(out);
+    }
+
+    // Fills out with the slots of the subscriptions whose
+    // MetricReportDefinitions accept the given report definition URI, in
+    // slot order.
+    void matchMetricReport(std::string_view reportDefinition,
+                           std::vector<size_t>& out) const
+    {
+        out = allReports;
+        const std::vector<size_t>& slots =
+            findSlots(byReportDefinition, reportDefinition);
+        out.insert(out.end(), slots.begin(), slots.end());
+        std::ranges::sort(out);
+    }
+
+  private:
+    using KeyMap = boost::container::flat_map<std::string, std::vector<size_t>,
+                                              std::less<>>;
+
+    struct Entry
+    {
+        // Sorted, so candidates can be checked with a binary search.  Empty
+        // means the filter accepts everything.
+        std::vector<std::string> registryMsgIds;
+        std::vector<std::string> originResources;
+        std::vector<std::string> resourceTypes;
+        std::vector<std::string> registryPrefixes;
+    };
+
+    static std::vector<std::string> sortedUnique(
+        const std::vector<std::string>& values)
+    {
+        std::vector<std::string> out = values;
+        std::ranges::sort(out);
+        auto [first, last] = std::ranges::unique(out);
+        out.erase(first, last);
+        return out;
+    }
+
+    static void addKeys(KeyMap& map, const std::vector<std::string>& keys,
+                        size_t slot)
+    {
+        for (const std::string& key : keys)
+        {
+            map[key].emplace_back(slot);
+        }
+    }
+
+    static const std::vector<size_t>& findSlots(const KeyMap& map,
+                                                std::string_view key)
+    {
+        static const std::vector<size_t> empty;
+        KeyMap::const_iterator it = map.find(key);
+        if (it == map.end())
+        {
+            return empty;
+        }
+        return it->second;
+    }
+
+    static const std::string* getString(const nlohmann::json::object_t& obj,
+                                        const char* key)
+    {
+        nlohmann::json::object_t::const_iterator it = obj.find(key);
+        if (it == obj.end())
+        {
+            return nullptr;
+        }
+        return it->second.get_ptr<const std::string*>();
+    }
+
+    // present is false when the event doesn't carry the property at all, in
+    // which case only an empty filter accepts it
+    static bool filterAccepts(const std::vector<std::string>& filter,
+                              bool present, std::string_view value)
+    {
+        if (filter.empty())
+        {
+            return true;
+        }
+        if (!present)
+        {
+            return false;
+        }
+        return std::ranges::binary_search(filter, value, std::less<>());
+    }
+
+    std::vector<Entry> entries;
+
+    // Subscriptions with no event filters at all
+    std::vector<size_t> unfiltered;
+    KeyMap byMessageId;
+    KeyMap byOrigin;
+    KeyMap byResourceType;
+    KeyMap byRegistry;
+
+    // Subscriptions with no MetricReportDefinitions filter
+    std::vector<size_t> allReports;
+    KeyMap byReportDefinition;
+};
+
+} // namespace redfish
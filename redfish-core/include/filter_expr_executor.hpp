@@ -6,9 +6,81 @@
 
 #include <nlohmann/json.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace redfish
 {
 
+// A $filter expression compiled into a flat program, so it can be evaluated
+// against many members without walking the AST.  Key paths are pre-split,
+// literals are pre-parsed (including as dates), and the operands of and/or
+// are ordered so that the cheapest ones are evaluated first.
+class CompiledFilter
+{
+  public:
+    explicit CompiledFilter(const filter_ast::LogicalAnd& filter);
+
+    bool matches(const nlohmann::json& member) const;
+    bool matches(const nlohmann::json::object_t& member) const;
+
+    struct Operand
+    {
+        enum class Kind
+        {
+            Key,
+            Int,
+            Double,
+            String,
+        };
+        Kind kind = Kind::Key;
+        // Key path split on '/'
+        std::vector<std::string> path;
+        // Whether the key holds an Edm.DateTimeOffset
+        bool isDateTimeKey = false;
+        int64_t intValue = 0;
+        double doubleValue = 0.0;
+        std::string stringValue;
+        // stringValue parsed as a date, in microseconds since epoch
+        int64_t dateValue = 0;
+    };
+
+    struct Comparison
+    {
+        Operand left;
+        filter_ast::ComparisonOpEnum token =
+            filter_ast::ComparisonOpEnum::Invalid;
+        Operand right;
+    };
+
+    enum class OpCode : uint8_t
+    {
+        // Set the result to the value of comparisons[arg]
+        Compare,
+        // Invert the result
+        Not,
+        // Skip to instruction arg if the result is false
+        JumpIfFalse,
+        // Skip to instruction arg if the result is true
+        JumpIfTrue,
+    };
+
+    struct Instruction
+    {
+        OpCode op = OpCode::Compare;
+        size_t arg = 0;
+    };
+
+  private:
+    bool compare(const Comparison& cmp,
+                 const nlohmann::json::object_t& member) const;
+
+    std::vector<Comparison> comparisons;
+    std::vector<Instruction> program;
+};
+
 bool memberMatches(const nlohmann::json& member,
                    const filter_ast::LogicalAnd& filterParam);
 
@@ -8,14 +8,18 @@
 
 #include <boost/beast/http/verb.hpp>
 #include <boost/container/flat_map.hpp>
+#include <boost/container/small_vector.hpp>
 #include <boost/container/vector.hpp>
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <cstddef>
 #include <initializer_list>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -74,6 +78,16 @@ class Privileges
      */
     Privileges() = default;
 
+    /**
+     * @brief Constructs object with the privileges of the given bits active
+     *
+     * @param[in] p  Bits of the privileges, as returned by getBitset
+     *
+     */
+    explicit Privileges(const std::bitset<maxPrivilegeCount>& p) :
+        privilegeBitset{p}
+    {}
+
     /**
      * @brief Constructs object with given privileges active
      *
@@ -197,20 +211,42 @@ class Privileges
         return Privileges{privilegeBitset & p.privilegeBitset};
     }
 
+    /**
+     * @brief Returns the bits of the active privileges
+     *
+     * @return               The bitset, one bit per privilege name
+     *
+     */
+    const std::bitset<maxPrivilegeCount>& getBitset() const
+    {
+        return privilegeBitset;
+    }
+
   private:
-    explicit Privileges(const std::bitset<maxPrivilegeCount>& p) :
-        privilegeBitset{p}
-    {}
     std::bitset<maxPrivilegeCount> privilegeBitset = 0;
 };
 
-inline Privileges getUserPrivileges(const persistent_data::UserSession& session)
+static_assert(
+    std::is_same_v<decltype(persistent_data::UserSession::privilegeBits),
+                   std::bitset<maxPrivilegeCount>>,
+    "Session privileges must hold every privilege");
+
+/**
+ * @brief Works out the privileges of a user from their role and groups
+ *
+ * @param[in] userRole    Role of the user, as named by the user manager
+ * @param[in] userGroups  Groups the user is a member of
+ *
+ * @return                The privileges the user has
+ */
+inline Privileges getRolePrivileges(std::string_view userRole,
+                                    std::span<const std::string> userGroups)
 {
     // default to no access
     Privileges privs;
 
     // Check if user is member of hostconsole group
-    for (const auto& userGroup : session.userGroups)
+    for (const auto& userGroup : userGroups)
     {
         if (userGroup == "hostconsole")
         {
@@ -220,7 +256,7 @@ inline Privileges getUserPrivileges(const persistent_data::UserSession& session)
         }
     }
 
-    if (session.userRole == "priv-admin")
+    if (userRole == "priv-admin")
     {
         // Redfish privilege : Administrator
         privs.setSinglePrivilege("Login");
@@ -229,14 +265,14 @@ inline Privileges getUserPrivileges(const persistent_data::UserSession& session)
         privs.setSinglePrivilege("ConfigureUsers");
         privs.setSinglePrivilege("ConfigureComponents");
     }
-    else if (session.userRole == "priv-operator")
+    else if (userRole == "priv-operator")
     {
         // Redfish privilege : Operator
         privs.setSinglePrivilege("Login");
         privs.setSinglePrivilege("ConfigureSelf");
         privs.setSinglePrivilege("ConfigureComponents");
     }
-    else if (session.userRole == "priv-user")
+    else if (userRole == "priv-user")
     {
         // Redfish privilege : Readonly
         privs.setSinglePrivilege("Login");
@@ -246,6 +282,24 @@ inline Privileges getUserPrivileges(const persistent_data::UserSession& session)
     return privs;
 }
 
+/**
+ * @brief Works out the privileges of a session from its role and groups, and
+ * keeps them in the session.  This is done each time the role and groups are
+ * read, so that requests don't have to.
+ *
+ * @param[in] session  Session to set the privileges of
+ */
+inline void setUserPrivileges(persistent_data::UserSession& session)
+{
+    session.privilegeBits =
+        getRolePrivileges(session.userRole, session.userGroups).getBitset();
+}
+
+inline Privileges getUserPrivileges(const persistent_data::UserSession& session)
+{
+    return Privileges{session.privilegeBits};
+}
+
 /**
  * @brief The OperationMap represents the privileges required for a
  * single entity (URI).  It maps from the allowable verbs to the
@@ -261,6 +315,75 @@ inline Privileges getUserPrivileges(const persistent_data::UserSession& session)
 using OperationMap = boost::container::flat_map<boost::beast::http::verb,
                                                 std::vector<Privileges>>;
 
+/**
+ * @brief The privileges required for a route, flattened from the sets given
+ * to it when the routes are validated.  A user is allowed if they have every
+ * privilege of any one set.  Sets that need every privilege of another set
+ * can never be the one that allows a user, so they are dropped, and checking
+ * a user is one AND and compare for each set that is left.
+ **/
+class RequiredPrivileges
+{
+  public:
+    /**
+     * @brief Constructs object that allows no user
+     *
+     */
+    RequiredPrivileges() = default;
+
+    /**
+     * @brief Constructs object from the privilege sets of a route
+     *
+     * @param[in] privilegesSet  Sets of privileges, any one of which is enough
+     *
+     */
+    explicit RequiredPrivileges(std::span<const Privileges> privilegesSet)
+    {
+        // If there are no privileges assigned, there are no privileges
+        // required
+        if (privilegesSet.empty())
+        {
+            sets.emplace_back();
+            return;
+        }
+        for (const Privileges& required : privilegesSet)
+        {
+            if (std::ranges::any_of(sets, [&required](const Privileges& kept) {
+                    return required.isSupersetOf(kept);
+                }))
+            {
+                continue;
+            }
+            sets.erase(std::remove_if(sets.begin(), sets.end(),
+                                      [&required](const Privileges& kept) {
+                                          return kept.isSupersetOf(required);
+                                      }),
+                       sets.end());
+            sets.emplace_back(required);
+        }
+    }
+
+    /**
+     * @brief Checks if a user is allowed
+     *
+     * @param[in] userPrivileges  Privileges the user has
+     *
+     * @return                    True if allowed, false otherwise
+     *
+     */
+    bool isAllowed(const Privileges& userPrivileges) const
+    {
+        return std::ranges::any_of(
+            sets, [&userPrivileges](const Privileges& required) {
+                return userPrivileges.isSupersetOf(required);
+            });
+    }
+
+  private:
+    // Privilege registry entries have at most three sets
+    boost::container::small_vector<Privileges, 3> sets;
+};
+
 /* @brief Checks if user is allowed to call an operation
  *
  * @param[in] operationPrivilegesRequired   Privileges required
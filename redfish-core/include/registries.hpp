@@ -7,6 +7,7 @@
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
 #include <array>
 #include <charconv>
 #include <cstddef>
@@ -56,21 +57,34 @@ struct RegistryEntry
 };
 using RegistryEntryRef = std::reference_wrapper<RegistryEntry>;
 
-auto allRegistries() -> std::map<std::string, RegistryEntry>&;
+auto allRegistries() -> std::map<std::string, RegistryEntry, std::less<>>&;
 
-auto getRegistryFromPrefix(const std::string& registryName)
+auto getRegistryFromPrefix(std::string_view registryName)
     -> std::optional<RegistryEntryRef>;
 
-auto getRegistryMessagesFromPrefix(const std::string& registryName)
+auto getRegistryMessagesFromPrefix(std::string_view registryName)
     -> MessageEntries;
 
+// Message lookups binary search the registry, so the generated entries must
+// be sorted by key.
+constexpr bool isSortedByKey(MessageEntries entries)
+{
+    return std::ranges::is_sorted(entries, {}, [](const MessageEntry& entry) {
+        return std::string_view(entry.first);
+    });
+}
+
 template <typename T>
 void registerRegistry()
 {
+    static_assert(isSortedByKey(T::registry),
+                  "Registry entries must be sorted, rerun parse_registries.py");
     allRegistries().emplace(T::header.registryPrefix,
                             RegistryEntry{T::header, T::url, T::registry});
 }
 
+// Fills in the %N placeholders of msg with messageArgs.  Returns an empty
+// string if msg is malformed or refers to an argument that doesn't exist.
 inline std::string fillMessageArgs(
     const std::span<const std::string_view> messageArgs, std::string_view msg)
 {
@@ -88,7 +102,7 @@ inline std::string fillMessageArgs(
         ret += msg.substr(0, stringIndex);
         msg.remove_prefix(stringIndex + 1);
         size_t number = 0;
-        auto it = std::from_chars(&*msg.begin(), &*msg.end(), number);
+        auto it = std::from_chars(msg.data(), msg.data() + msg.size(), number);
         if (it.ec != std::errc())
         {
             return "";
@@ -145,7 +159,7 @@ inline nlohmann::json::object_t getLogFromRegistry(
 
 const Message* getMessage(std::string_view messageID);
 
-const Message* getMessageFromRegistry(const std::string& messageKey,
+const Message* getMessageFromRegistry(std::string_view messageKey,
                                       std::span<const MessageEntry> registry);
 
 } // namespace redfish::registries
@@ -5,7 +5,7 @@
 
 #include "event_logs_object_type.hpp"
 #include "event_service_store.hpp"
-#include "filter_expr_parser_ast.hpp"
+#include "filter_expr_executor.hpp"
 #include "http_client.hpp"
 #include "http_response.hpp"
 #include "server_sent_event.hpp"
@@ -69,6 +69,12 @@ class Subscription : public std::enable_shared_from_this<Subscription>
 
     bool sendEventToSubscriber(uint64_t eventId, std::string&& msg);
 
+    // Sends a payload that is identical for every subscriber.  frame is
+    // filled in by the first SSE subscriber it is sent to, and reused by the
+    // others.
+    bool sendSharedEventToSubscriber(uint64_t eventId, const std::string& msg,
+                                     crow::sse_socket::SseFrame& frame);
+
     void filterAndSendEventLogs(
         uint64_t eventId, const std::vector<EventLogObjectsType>& eventRecords);
 
@@ -96,7 +102,7 @@ class Subscription : public std::enable_shared_from_this<Subscription>
     std::optional<crow::HttpClient> client;
 
   public:
-    std::optional<filter_ast::LogicalAnd> filter;
+    std::optional<CompiledFilter> filter;
 };
 
 } // namespace redfish
@@ -15,12 +15,10 @@
 #include <boost/system/error_code.hpp>
 #include <sdbusplus/message/native_types.hpp>
 
-#include <algorithm>
 #include <array>
 #include <functional>
 #include <memory>
 #include <optional>
-#include <ranges>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -58,7 +56,7 @@ inline void afterGetChassisAssembly(
     }
 
     std::vector<std::string> sortedAssemblyList = subtreePaths;
-    std::ranges::sort(sortedAssemblyList, AlphanumLess<std::string>());
+    naturalSort(sortedAssemblyList);
 
     callback(ec, sortedAssemblyList);
 }
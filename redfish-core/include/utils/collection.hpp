@@ -3,25 +3,19 @@
 #pragma once
 
 #include "async_resp.hpp"
-#include "dbus_utility.hpp"
 #include "error_messages.hpp"
-#include "http/utility.hpp"
-#include "human_sort.hpp"
 #include "logging.hpp"
+#include "utils/collection_cache.hpp"
 
+#include <boost/system/error_code.hpp>
 #include <boost/url/url.hpp>
 #include <nlohmann/json.hpp>
-#include <sdbusplus/message/native_types.hpp>
 
-#include <algorithm>
 #include <functional>
 #include <memory>
-#include <ranges>
 #include <span>
 #include <string>
 #include <string_view>
-#include <utility>
-#include <vector>
 
 namespace redfish
 {
@@ -30,10 +24,8 @@ namespace collection_util
 
 inline void handleCollectionMembers(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-    const boost::urls::url& collectionPath,
     const nlohmann::json::json_pointer& jsonKeyName,
-    const boost::system::error_code& ec,
-    const dbus::utility::MapperGetSubTreePathsResponse& objects)
+    const boost::system::error_code& ec, const nlohmann::json& members)
 {
     if (jsonKeyName.empty())
     {
@@ -46,49 +38,19 @@ inline void handleCollectionMembers(
     jsonCountKeyName.pop_back();
     jsonCountKeyName /= back + "@odata.count";
 
-    if (ec == boost::system::errc::io_error)
-    {
-        asyncResp->res.jsonValue[jsonKeyName] = nlohmann::json::array();
-        asyncResp->res.jsonValue[jsonCountKeyName] = 0;
-        return;
-    }
-
     if (ec)
     {
-        BMCWEB_LOG_DEBUG("DBUS response error {}", ec.value());
         messages::internalError(asyncResp->res);
         return;
     }
 
-    std::vector<std::string> pathNames;
-    for (const auto& object : objects)
-    {
-        sdbusplus::message::object_path path(object);
-        std::string leaf = path.filename();
-        if (leaf.empty())
-        {
-            continue;
-        }
-        pathNames.push_back(leaf);
-    }
-    std::ranges::sort(pathNames, AlphanumLess<std::string>());
-
-    nlohmann::json& members = asyncResp->res.jsonValue[jsonKeyName];
-    members = nlohmann::json::array();
-    for (const std::string& leaf : pathNames)
-    {
-        boost::urls::url url = collectionPath;
-        crow::utility::appendUrlPieces(url, leaf);
-        nlohmann::json::object_t member;
-        member["@odata.id"] = std::move(url);
-        members.emplace_back(std::move(member));
-    }
+    asyncResp->res.jsonValue[jsonKeyName] = members;
     asyncResp->res.jsonValue[jsonCountKeyName] = members.size();
 }
 
 /**
  * @brief Populate the collection members from a GetSubTreePaths search of
- *        inventory
+ *        inventory, cached and kept up to date from D-Bus signals
  *
  * @param[i,o] asyncResp  Async response object
  * @param[i]   collectionPath  Redfish collection path which is used for the
@@ -107,10 +69,8 @@ inline void getCollectionToKey(
     const nlohmann::json::json_pointer& jsonKeyName)
 {
     BMCWEB_LOG_DEBUG("Get collection members for: {}", collectionPath.buffer());
-    dbus::utility::getSubTreePaths(
-        subtree, 0, interfaces,
-        std::bind_front(handleCollectionMembers, asyncResp, collectionPath,
-                        jsonKeyName));
+    getCollectionMembersCache(collectionPath, interfaces, subtree)
+        .get(std::bind_front(handleCollectionMembers, asyncResp, jsonKeyName));
 }
 inline void getCollectionMembers(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
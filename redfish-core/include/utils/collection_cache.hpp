@@ -0,0 +1,418 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "dbus_singleton.hpp"
+#include "dbus_utility.hpp"
+#include "http/utility.hpp"
+#include "human_sort.hpp"
+#include "logging.hpp"
+
+#include <boost/system/error_code.hpp>
+#include <boost/url/url.hpp>
+#include <nlohmann/json.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/message/native_types.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace redfish
+{
+namespace collection_util
+{
+
+// The members of a collection: the leaf names of the objects under a subtree
+// that implement any of the collection's interfaces.  They're found with
+// GetSubTreePaths when first needed, then kept up to date, and in order,
+// from InterfacesAdded and InterfacesRemoved, so that collection requests
+// copy the Members array without calling the mapper or sorting.
+class CollectionMembers
+{
+  public:
+    using Handler = std::function<void(const boost::system::error_code&,
+                                       const nlohmann::json& members)>;
+
+    CollectionMembers(boost::urls::url collectionPathIn, std::string subtreeIn,
+                      std::span<const std::string_view> interfacesIn) :
+        collectionPath(std::move(collectionPathIn)),
+        subtree(std::move(subtreeIn)),
+        interfaces(interfacesIn.begin(), interfacesIn.end())
+    {}
+
+    // Calls handler with the Members array, once the members have been read
+    void get(Handler&& handler)
+    {
+        if (state == State::Loaded)
+        {
+            handler(boost::system::error_code(), members());
+            return;
+        }
+        waiting.emplace_back(std::move(handler));
+        if (state == State::Loading)
+        {
+            return;
+        }
+        state = State::Loading;
+        // The matches go in before the members are read.  The mapper can
+        // answer from before a signal it hasn't handled yet, so signals
+        // received while loading are applied to the reply.
+        watch();
+        std::vector<std::string_view> interfaceViews(interfaces.begin(),
+                                                     interfaces.end());
+        dbus::utility::getSubTreePaths(
+            subtree, 0, interfaceViews,
+            [this](const boost::system::error_code& ec,
+                   const dbus::utility::MapperGetSubTreePathsResponse& paths) {
+                afterLoad(ec, paths);
+            });
+    }
+
+    void load(const dbus::utility::MapperGetSubTreePathsResponse& paths)
+    {
+        objects.clear();
+        leaves.clear();
+        rendered = std::nullopt;
+        for (const std::string& path : paths)
+        {
+            add(path);
+        }
+        state = State::Loaded;
+        std::vector<Change> changes = std::move(pending);
+        pending.clear();
+        for (const Change& queued : changes)
+        {
+            if (queued.added)
+            {
+                add(queued.path);
+            }
+            else
+            {
+                remove(queued.path);
+            }
+        }
+    }
+
+    void afterLoad(const boost::system::error_code& ec,
+                   const dbus::utility::MapperGetSubTreePathsResponse& paths)
+    {
+        boost::system::error_code result;
+        // The mapper returns an io_error when nothing matches
+        if (ec == boost::system::errc::io_error)
+        {
+            load({});
+        }
+        else if (ec)
+        {
+            BMCWEB_LOG_DEBUG("DBUS response error {}", ec.value());
+            result = ec;
+        }
+        else
+        {
+            load(paths);
+        }
+        std::vector<Handler> handlers = std::move(waiting);
+        waiting.clear();
+        nlohmann::json empty = nlohmann::json::array();
+        for (Handler& waiter : handlers)
+        {
+            waiter(result, result ? empty : members());
+        }
+        // A reply to a read that was going on when the cache was reset is
+        // only good for the requests that were waiting on it
+        if (result || stale)
+        {
+            stale = false;
+            state = State::Unloaded;
+            reset();
+        }
+    }
+
+    void onInterfacesAdded(const std::string& path,
+                           std::span<const std::string> added)
+    {
+        if (isMember(path, added))
+        {
+            change(path, true);
+        }
+    }
+
+    void onInterfacesRemoved(const std::string& path,
+                             std::span<const std::string> removed)
+    {
+        if (isMember(path, removed))
+        {
+            change(path, false);
+        }
+    }
+
+    // Forgets the members, to be read again by the next request
+    void reset()
+    {
+        objects.clear();
+        leaves.clear();
+        pending.clear();
+        rendered = std::nullopt;
+        if (state == State::Loading)
+        {
+            stale = true;
+            return;
+        }
+        state = State::Unloaded;
+    }
+
+    // The Members array, rendered once per change to the members
+    const nlohmann::json& members()
+    {
+        if (!rendered)
+        {
+            nlohmann::json::array_t array;
+            array.reserve(leaves.size());
+            for (const auto& leaf : leaves)
+            {
+                boost::urls::url url = collectionPath;
+                crow::utility::appendUrlPieces(url, leaf.first.second);
+                nlohmann::json::object_t member;
+                member["@odata.id"] = std::move(url);
+                array.emplace_back(std::move(member));
+            }
+            rendered = std::move(array);
+        }
+        return *rendered;
+    }
+
+  private:
+    enum class State
+    {
+        Unloaded,
+        Loading,
+        Loaded,
+    };
+
+    // Leaves are kept by their natural sort key, computed once per leaf,
+    // then the leaf itself, so that leaves that only differ in leading zeros
+    // are kept apart
+    using LeafKey = std::pair<std::string, std::string>;
+
+    static LeafKey leafKey(const std::string& path)
+    {
+        std::string leaf = sdbusplus::message::object_path(path).filename();
+        std::string key = naturalSortKey(leaf);
+        return {std::move(key), std::move(leaf)};
+    }
+
+    struct Change
+    {
+        std::string path;
+        bool added;
+    };
+
+    bool isMember(std::string_view path,
+                  std::span<const std::string> objectInterfaces) const
+    {
+        if (subtree != "/" && (!path.starts_with(subtree) ||
+                               !path.substr(subtree.size()).starts_with('/')))
+        {
+            return false;
+        }
+        return std::ranges::any_of(
+            objectInterfaces, [this](const std::string& interface) {
+                return std::ranges::find(interfaces, interface) !=
+                       interfaces.end();
+            });
+    }
+
+    void change(const std::string& path, bool added)
+    {
+        if (state == State::Loading)
+        {
+            pending.emplace_back(Change{path, added});
+        }
+        else if (state == State::Loaded)
+        {
+            if (added)
+            {
+                add(path);
+            }
+            else
+            {
+                remove(path);
+            }
+        }
+    }
+
+    void add(const std::string& path)
+    {
+        LeafKey leaf = leafKey(path);
+        if (leaf.second.empty() || !objects.emplace(path).second)
+        {
+            return;
+        }
+        // More than one object can have the same leaf, which is listed once
+        leaves[std::move(leaf)]++;
+        rendered = std::nullopt;
+    }
+
+    void remove(const std::string& path)
+    {
+        if (objects.erase(path) == 0)
+        {
+            return;
+        }
+        auto leaf = leaves.find(leafKey(path));
+        if (leaf != leaves.end() && --leaf->second == 0)
+        {
+            leaves.erase(leaf);
+        }
+        rendered = std::nullopt;
+    }
+
+    void watch()
+    {
+        if (addedMatch != nullptr)
+        {
+            return;
+        }
+        namespace rules = sdbusplus::bus::match::rules;
+        std::string prefix = subtree;
+        if (!prefix.ends_with('/'))
+        {
+            prefix += '/';
+        }
+        addedMatch = std::make_unique<sdbusplus::bus::match_t>(
+            *crow::connections::systemBus,
+            rules::interfacesAdded() + rules::argNpath(0, prefix),
+            [this](sdbusplus::message_t& msg) {
+                sdbusplus::message::object_path path;
+                dbus::utility::DBusInterfacesMap objectInterfaces;
+                msg.read(path, objectInterfaces);
+                std::vector<std::string> names;
+                names.reserve(objectInterfaces.size());
+                for (const auto& interface : objectInterfaces)
+                {
+                    names.emplace_back(interface.first);
+                }
+                onInterfacesAdded(path.str, names);
+            });
+        removedMatch = std::make_unique<sdbusplus::bus::match_t>(
+            *crow::connections::systemBus,
+            rules::interfacesRemoved() + rules::argNpath(0, prefix),
+            [this](sdbusplus::message_t& msg) {
+                sdbusplus::message::object_path path;
+                std::vector<std::string> names;
+                msg.read(path, names);
+                onInterfacesRemoved(path.str, names);
+            });
+    }
+
+    boost::urls::url collectionPath;
+    std::string subtree;
+    std::vector<std::string> interfaces;
+
+    State state = State::Unloaded;
+    std::vector<Handler> waiting;
+    std::vector<Change> pending;
+    bool stale = false;
+
+    // Object paths, and the number of them with each leaf
+    std::unordered_set<std::string> objects;
+    std::map<LeafKey, size_t> leaves;
+    std::optional<nlohmann::json> rendered;
+
+    std::unique_ptr<sdbusplus::bus::match_t> addedMatch;
+    std::unique_ptr<sdbusplus::bus::match_t> removedMatch;
+};
+
+// The cached members of every collection, by collection path, subtree and
+// interfaces.  Objects can also appear or disappear without signals, when
+// a service starts or exits, so every cache is read again after the mapper
+// has introspected a new service, or a service has left the bus.
+class CollectionMembersCaches
+{
+  public:
+    CollectionMembers& get(const boost::urls::url& collectionPath,
+                           std::span<const std::string_view> interfaces,
+                           const std::string& subtree)
+    {
+        std::string key(collectionPath.buffer());
+        key += '\n';
+        key += subtree;
+        for (std::string_view interface : interfaces)
+        {
+            key += '\n';
+            key += interface;
+        }
+        std::unique_ptr<CollectionMembers>& cache = caches[key];
+        if (cache == nullptr)
+        {
+            cache = std::make_unique<CollectionMembers>(collectionPath,
+                                                        subtree, interfaces);
+            watch();
+        }
+        return *cache;
+    }
+
+    void resetAll()
+    {
+        for (auto& cache : caches)
+        {
+            cache.second->reset();
+        }
+    }
+
+  private:
+    void watch()
+    {
+        if (introspected != nullptr)
+        {
+            return;
+        }
+        namespace rules = sdbusplus::bus::match::rules;
+        introspected = std::make_unique<sdbusplus::bus::match_t>(
+            *crow::connections::systemBus,
+            rules::type::signal() +
+                rules::sender("xyz.openbmc_project.ObjectMapper") +
+                rules::interface("xyz.openbmc_project.ObjectMapper.Private") +
+                rules::member("IntrospectionComplete"),
+            [this](sdbusplus::message_t& /*msg*/) { resetAll(); });
+        ownerLost = std::make_unique<sdbusplus::bus::match_t>(
+            *crow::connections::systemBus,
+            rules::nameOwnerChanged() + rules::argN(2, ""),
+            [this](sdbusplus::message_t& msg) {
+                std::string name;
+                msg.read(name);
+                // Unique names come and go with every client
+                if (!name.starts_with(':'))
+                {
+                    resetAll();
+                }
+            });
+    }
+
+    std::map<std::string, std::unique_ptr<CollectionMembers>, std::less<>>
+        caches;
+    std::unique_ptr<sdbusplus::bus::match_t> introspected;
+    std::unique_ptr<sdbusplus::bus::match_t> ownerLost;
+};
+
+inline CollectionMembers& getCollectionMembersCache(
+    const boost::urls::url& collectionPath,
+    std::span<const std::string_view> interfaces, const std::string& subtree)
+{
+    static CollectionMembersCaches caches;
+    return caches.get(collectionPath, interfaces, subtree);
+}
+
+} // namespace collection_util
+} // namespace redfish
@@ -4,10 +4,10 @@
 
 #include "async_resp.hpp"
 #include "dbus_singleton.hpp"
+#include "dbus_utility.hpp"
 #include "logging.hpp"
 
 #include <nlohmann/json.hpp>
-#include <sdbusplus/asio/property.hpp>
 #include <sdbusplus/exception.hpp>
 #include <sdbusplus/message.hpp>
 #include <sdbusplus/message/native_types.hpp>
@@ -61,7 +61,7 @@ void setDbusProperty(
     std::string interfaceStr(interface);
     std::string dbusPropertyStr(dbusProperty);
 
-    sdbusplus::asio::setProperty(
+    dbus::utility::setProperty(
         *crow::connections::systemBus, processNameStr, path.str, interfaceStr,
         dbusPropertyStr, prop,
         [asyncResp, redfishPropertyNameStr = std::string{redfishPropertyName},
@@ -84,7 +84,7 @@ void setDbusPropertyAction(
     std::string interfaceStr(interface);
     std::string dbusPropertyStr(dbusProperty);
 
-    sdbusplus::asio::setProperty(
+    dbus::utility::setProperty(
         *crow::connections::systemBus, processNameStr, path.str, interfaceStr,
         dbusPropertyStr, prop,
         [asyncResp,
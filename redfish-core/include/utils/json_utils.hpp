@@ -19,6 +19,7 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <limits>
 #include <map>
 #include <optional>
@@ -512,86 +513,123 @@ struct PerUnpack
     bool complete = false;
 };
 
+namespace details
+{
+// Whether key, from offset, names member or something under it, returning
+// the length of the key from offset when it does
+inline std::optional<size_t> keyMemberLength(std::string_view key,
+                                             size_t offset,
+                                             std::string_view member)
+{
+    if (key.size() - offset < member.size() ||
+        key.compare(offset, member.size(), member) != 0)
+    {
+        return std::nullopt;
+    }
+    size_t length = key.size() - offset;
+    if (length != member.size() && key[offset + member.size()] != '/')
+    {
+        return std::nullopt;
+    }
+    return length;
+}
+} // namespace details
+
+// Unpacks the members of obj into the keys of toUnpack, whose first offset
+// characters name obj.  Keys are matched without splitting them, and the keys
+// of a nested object are moved, in order, to the front of toUnpack, to be
+// read from there without copying them.
 inline bool readJsonHelperObject(nlohmann::json::object_t& obj,
                                  crow::Response& res,
-                                 std::span<PerUnpack> toUnpack)
+                                 std::span<PerUnpack*> toUnpack, size_t offset)
 {
     bool result = true;
     for (auto& item : obj)
     {
-        size_t unpackIndex = 0;
-        for (; unpackIndex < toUnpack.size(); unpackIndex++)
+        auto match = toUnpack.begin();
+        size_t length = 0;
+        for (; match != toUnpack.end(); match++)
         {
-            PerUnpack& unpackSpec = toUnpack[unpackIndex];
-            std::string_view key = unpackSpec.key;
-            size_t keysplitIndex = key.find('/');
-            std::string_view leftover;
-            if (keysplitIndex != std::string_view::npos)
+            if ((*match)->complete)
             {
-                leftover = key.substr(keysplitIndex + 1);
-                key = key.substr(0, keysplitIndex);
+                continue;
             }
-
-            if (key != item.first || unpackSpec.complete)
+            std::optional<size_t> matched =
+                details::keyMemberLength((*match)->key, offset, item.first);
+            if (matched)
             {
-                continue;
+                length = *matched;
+                break;
             }
+        }
 
-            // Sublevel key
-            if (!leftover.empty())
+        if (match == toUnpack.end())
+        {
+            messages::propertyUnknown(res, item.first);
+            result = false;
+            continue;
+        }
+
+        PerUnpack& unpackSpec = **match;
+        std::string_view key = unpackSpec.key.substr(offset);
+
+        // Sublevel key
+        if (length != item.first.size())
+        {
+            // Include the slash in the key so we can compare later
+            key = key.substr(0, item.first.size() + 1);
+            nlohmann::json::object_t* j =
+                item.second.get_ptr<nlohmann::json::object_t*>();
+            if (j == nullptr)
             {
-                // Include the slash in the key so we can compare later
-                key = unpackSpec.key.substr(0, keysplitIndex + 1);
-                nlohmann::json::object_t j;
-                result = details::unpackValue<nlohmann::json::object_t>(
-                             item.second, key, res, j) &&
-                         result;
-                if (!result)
-                {
-                    return result;
-                }
+                messages::propertyValueTypeError(res, item.second, key);
+                result = false;
+            }
+            if (!result)
+            {
+                return result;
+            }
 
-                std::vector<PerUnpack> nextLevel;
-                for (PerUnpack& p : toUnpack)
+            auto nextEnd = toUnpack.begin();
+            for (auto p = toUnpack.begin(); p != toUnpack.end(); p++)
+            {
+                if (!(*p)->key.substr(offset).starts_with(key))
                 {
-                    if (!p.key.starts_with(key))
-                    {
-                        continue;
-                    }
-                    std::string_view thisLeftover = p.key.substr(key.size());
-                    nextLevel.push_back({thisLeftover, p.value, false});
-                    p.complete = true;
+                    continue;
                 }
-
-                result = readJsonHelperObject(j, res, nextLevel) && result;
-                break;
+                (*p)->complete = false;
+                std::rotate(nextEnd, p, std::next(p));
+                nextEnd++;
             }
+            std::span<PerUnpack*> nextLevel(toUnpack.begin(), nextEnd);
 
-            result =
-                std::visit(
-                    [&item, &unpackSpec, &res](auto& val) {
-                        using ContainedT =
-                            std::remove_pointer_t<std::decay_t<decltype(val)>>;
-                        return details::unpackValue<ContainedT>(
-                            item.second, unpackSpec.key, res, *val);
-                    },
-                    unpackSpec.value) &&
-                result;
-
-            unpackSpec.complete = true;
-            break;
+            result = readJsonHelperObject(*j, res, nextLevel,
+                                          offset + key.size()) &&
+                     result;
+            for (PerUnpack* p : nextLevel)
+            {
+                p->complete = true;
+            }
+            continue;
         }
 
-        if (unpackIndex == toUnpack.size())
-        {
-            messages::propertyUnknown(res, item.first);
-            result = false;
-        }
+        result =
+            std::visit(
+                [&item, key, &res](auto& val) {
+                    using ContainedT =
+                        std::remove_pointer_t<std::decay_t<decltype(val)>>;
+                    return details::unpackValue<ContainedT>(item.second, key,
+                                                            res, *val);
+                },
+                unpackSpec.value) &&
+            result;
+
+        unpackSpec.complete = true;
     }
 
-    for (PerUnpack& perUnpack : toUnpack)
+    for (PerUnpack* perUnpack : toUnpack)
     {
-        if (!perUnpack.complete)
+        if (!perUnpack->complete)
         {
             bool isOptional = std::visit(
                 [](auto& val) {
@@ -599,12 +637,12 @@ inline bool readJsonHelperObject(nlohmann::json::object_t& obj,
                         std::remove_pointer_t<std::decay_t<decltype(val)>>;
                     return details::IsOptional<ContainedType>::value;
                 },
-                perUnpack.value);
+                perUnpack->value);
             if (isOptional)
             {
                 continue;
             }
-            messages::propertyMissing(res, perUnpack.key);
+            messages::propertyMissing(res, perUnpack->key.substr(offset));
             result = false;
         }
     }
@@ -636,7 +674,10 @@ bool readJsonObject(nlohmann::json::object_t& jsonRequest, crow::Response& res,
     std::array<PerUnpack, n / 2> toUnpack2;
     packVariant(toUnpack2, key, std::forward<FirstType>(first),
                 std::forward<UnpackTypes&&>(in)...);
-    return readJsonHelperObject(jsonRequest, res, toUnpack2);
+    std::array<PerUnpack*, n / 2> keys{};
+    std::ranges::transform(toUnpack2, keys.begin(),
+                           [](PerUnpack& unpack) { return &unpack; });
+    return readJsonHelperObject(jsonRequest, res, keys, 0);
 }
 
 template <typename FirstType, typename... UnpackTypes>
@@ -906,13 +947,78 @@ struct ODataObjectLess
     }
 };
 
+// Appends a key for element to sortKey, that sorts the same as element does
+// under objectKeyCmp, when keys are compared as strings.  The first byte puts
+// elements that aren't objects, don't have |key|, or don't have a string in
+// it, before the others, in the order objectKeyCmp does.  For @odata.id the
+// natural sort keys of the path segments follow, each ending with a byte
+// below any a key uses, so shorter segments and paths sort first.
+inline void appendObjectSortKey(std::string& sortKey, std::string_view key,
+                                const nlohmann::json& element)
+{
+    const nlohmann::json::object_t* object =
+        element.get_ptr<const nlohmann::json::object_t*>();
+    if (object == nullptr)
+    {
+        sortKey += '\0';
+        return;
+    }
+    nlohmann::json::object_t::const_iterator it = object->find(key);
+    if (it == object->end())
+    {
+        sortKey += '\1';
+        return;
+    }
+    const std::string* value = it->second.get_ptr<const std::string*>();
+    if (value == nullptr)
+    {
+        sortKey += '\2';
+        return;
+    }
+    if (key != "@odata.id")
+    {
+        sortKey += '\3';
+        appendNaturalSortKey(sortKey, *value);
+        return;
+    }
+    boost::system::result<boost::urls::url_view> url =
+        boost::urls::parse_relative_ref(*value);
+    if (!url)
+    {
+        sortKey += '\3';
+        return;
+    }
+    sortKey += '\4';
+    bool first = true;
+    for (const std::string& segment : url->segments())
+    {
+        if (!first)
+        {
+            sortKey += '\0';
+        }
+        first = false;
+        appendNaturalSortKey(sortKey, segment);
+    }
+}
+
+inline std::string objectSortKey(std::string_view key,
+                                 const nlohmann::json& element)
+{
+    std::string sortKey;
+    appendObjectSortKey(sortKey, key, element);
+    return sortKey;
+}
+
 // Sort the JSON array by |element[key]|.
 // Elements without |key| or type of |element[key]| is not string are smaller
 // those whose |element[key]| is string.
 inline void sortJsonArrayByKey(nlohmann::json::array_t& array,
                                std::string_view key)
 {
-    std::ranges::sort(array, ODataObjectLess(key));
+    sortByKey(array,
+              [key](std::string& sortKey, const nlohmann::json& element) {
+                  appendObjectSortKey(sortKey, key, element);
+              });
 }
 
 // Sort the JSON array by |element[key]|.
@@ -920,7 +1026,7 @@ inline void sortJsonArrayByKey(nlohmann::json::array_t& array,
 // those whose |element[key]| is string.
 inline void sortJsonArrayByOData(nlohmann::json::array_t& array)
 {
-    std::ranges::sort(array, ODataObjectLess("@odata.id"));
+    sortJsonArrayByKey(array, "@odata.id");
 }
 
 // Returns the estimated size of the JSON value
@@ -40,7 +40,7 @@ inline void setServiceIdentification(
 
     persistent_data::ConfigFile& config = persistent_data::getConfig();
     config.serviceIdentification = serviceIdentification;
-    config.writeData();
+    config.markDirty();
     messages::success(asyncResp->res);
 }
 
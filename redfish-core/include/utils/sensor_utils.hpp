@@ -16,6 +16,8 @@
 
 #include <asm-generic/errno.h>
 
+#include <boost/container/flat_map.hpp>
+#include <boost/system/error_code.hpp>
 #include <boost/url/format.hpp>
 #include <nlohmann/json.hpp>
 #include <sdbusplus/message/native_types.hpp>
@@ -880,6 +882,182 @@ inline void getAllSensorObjects(
         });
 }
 
+// Properties of one interface of a sensor
+struct SensorProperties
+{
+    std::string service;
+    std::string path;
+    dbus::utility::DBusPropertiesMap properties;
+};
+
+using SensorPropertiesList = std::vector<SensorProperties>;
+
+/**
+ * @brief Groups sensor paths by the service that owns them
+ *
+ * @param[in] sensors List of service and sensor path pairs
+ *
+ * @return Sorted sensor paths for each service
+ */
+inline boost::container::flat_map<std::string, std::vector<std::string>>
+    groupSensorsByService(const SensorServicePathList& sensors)
+{
+    boost::container::flat_map<std::string, std::vector<std::string>>
+        byService;
+    for (const auto& [service, sensorPath] : sensors)
+    {
+        byService[service].emplace_back(sensorPath);
+    }
+    for (auto& [service, paths] : byService)
+    {
+        std::ranges::sort(paths);
+        auto [first, last] = std::ranges::unique(paths);
+        paths.erase(first, last);
+    }
+    return byService;
+}
+
+/**
+ * @brief Picks the requested sensors out of a GetManagedObjects response
+ *
+ * @param[in] objects GetManagedObjects response of one service
+ * @param[in] service Service the response came from
+ * @param[in] paths Sorted sensor paths to look for
+ * @param[in] interface Interface whose properties are wanted
+ * @param[out] sensorProperties Properties of each sensor that was found
+ * @param[out] missing Paths that weren't in the response
+ */
+inline void extractSensorProperties(
+    const dbus::utility::ManagedObjectType& objects, const std::string& service,
+    std::span<const std::string> paths, std::string_view interface,
+    SensorPropertiesList& sensorProperties, std::vector<std::string>& missing)
+{
+    std::vector<bool> found(paths.size(), false);
+    for (const auto& [objectPath, interfaces] : objects)
+    {
+        const std::string& pathStr = objectPath.str;
+        auto it = std::ranges::lower_bound(paths, pathStr);
+        if (it == paths.end() || *it != pathStr)
+        {
+            continue;
+        }
+        for (const auto& [interfaceName, properties] : interfaces)
+        {
+            if (interfaceName == interface)
+            {
+                found[static_cast<size_t>(it - paths.begin())] = true;
+                sensorProperties.emplace_back(service, pathStr, properties);
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        if (!found[i])
+        {
+            missing.emplace_back(paths[i]);
+        }
+    }
+}
+
+/**
+ * @brief Reads the properties of many sensors with one GetManagedObjects per
+ * service, rather than one GetAll per sensor
+ *
+ * Sensors that a service doesn't report through its object manager at
+ * /xyz/openbmc_project/sensors are read individually instead.  After all
+ * reads complete the <callback> is called with the properties that could be
+ * read, and the last error returned by any of the individual reads.
+ *
+ * @param[in] sensors List of sensors to read
+ * @param[in] interface Interface whose properties are read
+ * @param[in] callback Callback to handle the sensor properties
+ */
+inline void getSensorPropertiesByService(
+    const SensorServicePathList& sensors, const std::string& interface,
+    std::function<void(const boost::system::error_code& ec,
+                       SensorPropertiesList& sensorProperties)>&& callback)
+{
+    struct BatchRead
+    {
+        SensorPropertiesList sensorProperties;
+        boost::system::error_code ec;
+        size_t remaining = 0;
+        std::function<void(const boost::system::error_code&,
+                           SensorPropertiesList&)>
+            callback;
+
+        void done()
+        {
+            remaining--;
+            if (remaining == 0)
+            {
+                callback(ec, sensorProperties);
+            }
+        }
+    };
+
+    boost::container::flat_map<std::string, std::vector<std::string>>
+        byService = groupSensorsByService(sensors);
+    if (byService.empty())
+    {
+        SensorPropertiesList empty;
+        callback(boost::system::error_code(), empty);
+        return;
+    }
+
+    std::shared_ptr<BatchRead> batch = std::make_shared<BatchRead>();
+    batch->remaining = byService.size();
+    batch->callback = std::move(callback);
+
+    const sdbusplus::message::object_path sensorsPath(
+        "/xyz/openbmc_project/sensors");
+    for (auto& [service, paths] : byService)
+    {
+        BMCWEB_LOG_DEBUG("Reading {} sensors from {}", paths.size(), service);
+        dbus::utility::getManagedObjects(
+            service, sensorsPath,
+            [batch, service, paths = std::move(paths), interface](
+                const boost::system::error_code& ec,
+                const dbus::utility::ManagedObjectType& objects) {
+                std::vector<std::string> missing;
+                if (ec)
+                {
+                    BMCWEB_LOG_DEBUG("GetManagedObjects failed on {}: {}",
+                                     service, ec);
+                    missing = paths;
+                }
+                else
+                {
+                    extractSensorProperties(objects, service, paths, interface,
+                                            batch->sensorProperties, missing);
+                }
+
+                batch->remaining += missing.size();
+                for (const std::string& sensorPath : missing)
+                {
+                    dbus::utility::getAllProperties(
+                        service, sensorPath, interface,
+                        [batch, service, sensorPath](
+                            const boost::system::error_code& ec1,
+                            const dbus::utility::DBusPropertiesMap& values) {
+                            if (ec1)
+                            {
+                                batch->ec = ec1;
+                            }
+                            else
+                            {
+                                batch->sensorProperties.emplace_back(
+                                    service, sensorPath, values);
+                            }
+                            batch->done();
+                        });
+                }
+                batch->done();
+            });
+    }
+}
+
 enum class SensorPurpose
 {
     totalPower,
@@ -972,49 +1150,49 @@ inline void getSensorsByPurpose(
         const boost::system::error_code& ec,
         const std::shared_ptr<SensorServicePathList>& sensorMatches)>& callback)
 {
-    /* Keeps track of number of asynchronous calls made. Once all handlers have
-     * been called the callback function is called with the results.
-     */
-    std::shared_ptr<int> remainingSensorsToVist =
-        std::make_shared<int>(sensorListIn.size());
+    BMCWEB_LOG_DEBUG("getSensorsByPurpose enter {}", sensorListIn.size());
+
+    getSensorPropertiesByService(
+        sensorListIn, "xyz.openbmc_project.Sensor.Purpose",
+        [asyncResp, sensorPurpose, sensorMatches,
+         callback](const boost::system::error_code& ec,
+                   SensorPropertiesList& sensorProperties) {
+            /* Holds last unrecoverable error returned by any of the reads.
+             * The callback is sent the error to handle.
+             */
+            std::shared_ptr<boost::system::error_code> asyncErrors =
+                std::make_shared<boost::system::error_code>();
+            if (ec && (ec != boost::system::errc::io_error) &&
+                (ec.value() != EBADR))
+            {
+                BMCWEB_LOG_DEBUG("D-Bus response error : {}", ec);
+                *asyncErrors = ec;
+            }
 
-    /* Holds last unrecoverable error returned by any of the asynchronous
-     * handlers. Once all handlers have been called the callback will be sent
-     * the error to handle.
-     */
-    std::shared_ptr<boost::system::error_code> asyncErrors =
-        std::make_shared<boost::system::error_code>();
-
-    BMCWEB_LOG_DEBUG("getSensorsByPurpose enter {}", *remainingSensorsToVist);
-
-    for (const auto& [serviceName, sensorPath] : sensorListIn)
-    {
-        dbus::utility::getProperty<std::vector<std::string>>(
-            serviceName, sensorPath, "xyz.openbmc_project.Sensor.Purpose",
-            "Purpose",
-            [asyncResp, serviceName, sensorPath, sensorPurpose, sensorMatches,
-             callback, remainingSensorsToVist,
-             asyncErrors](const boost::system::error_code& ec,
-                          const std::vector<std::string>& purposeList) {
-                // Keep track of sensor visited
-                (*remainingSensorsToVist)--;
-                BMCWEB_LOG_DEBUG("Visited {}. Remaining sensors {}", sensorPath,
-                                 *remainingSensorsToVist);
-
-                checkSensorPurpose(serviceName, sensorPath, sensorPurpose,
-                                   sensorMatches, asyncErrors, ec, purposeList);
-
-                // All sensors have been visited
-                if (*remainingSensorsToVist == 0)
+            for (const SensorProperties& sensor : sensorProperties)
+            {
+                for (const auto& [name, value] : sensor.properties)
                 {
-                    BMCWEB_LOG_DEBUG(
-                        "getSensorsByPurpose, exit found {} matches",
-                        sensorMatches->size());
-                    callback(*asyncErrors, sensorMatches);
-                    return;
+                    if (name != "Purpose")
+                    {
+                        continue;
+                    }
+                    const std::vector<std::string>* purposeList =
+                        std::get_if<std::vector<std::string>>(&value);
+                    if (purposeList != nullptr)
+                    {
+                        checkSensorPurpose(sensor.service, sensor.path,
+                                           sensorPurpose, sensorMatches,
+                                           asyncErrors, {}, *purposeList);
+                    }
+                    break;
                 }
-            });
-    }
+            }
+
+            BMCWEB_LOG_DEBUG("getSensorsByPurpose, exit found {} matches",
+                             sensorMatches->size());
+            callback(*asyncErrors, sensorMatches);
+        });
 }
 
 } // namespace sensor_utils
@@ -82,7 +82,7 @@ inline void handleSystemCollectionMembers(
         }
         pathNames.emplace_back(leaf);
     }
-    std::ranges::sort(pathNames, AlphanumLess<std::string>());
+    naturalSort(pathNames);
 
     for (const std::string& systemName : pathNames)
     {
@@ -15,6 +15,7 @@
 #include "http_request.hpp"
 #include "http_response.hpp"
 #include "logging.hpp"
+#include "mutual_tls.hpp"
 #include "pam_authenticate.hpp"
 #include "persistent_data.hpp"
 #include "privileges.hpp"
@@ -944,8 +945,8 @@ inline void handleAuthMethodsPatch(
 
     persistent_data::SessionStore::getInstance().updateAuthMethodsConfig(
         authMethodsConfig);
-    // Save configuration immediately
-    persistent_data::getConfig().writeData();
+    // Save configuration
+    persistent_data::getConfig().markDirty();
 
     messages::success(asyncResp->res);
 }
@@ -1519,6 +1520,7 @@ inline void handleCertificateMappingAttributePatch(
     persistent_data::AuthConfigMethods& authMethodsConfig =
         persistent_data::SessionStore::getInstance().getAuthMethodsConfig();
     authMethodsConfig.mTLSCommonNameParsingMode = parseMode;
+    clearMtlsIdentityCache();
 }
 
 inline void handleRespondToUnauthenticatedClientsPatch(
@@ -1547,7 +1549,7 @@ inline void handleRespondToUnauthenticatedClientsPatch(
     authMethodsConfig.tlsStrict = !respondToUnauthenticatedClients;
 
     // Write settings to disk
-    persistent_data::getConfig().writeData();
+    persistent_data::getConfig().markDirty();
 
     // Trigger a reload, to apply the new settings to new connections
     app.loadCertificate();
@@ -2194,6 +2196,7 @@ inline void handleAccountDelete(
                 return;
             }
 
+            clearMtlsIdentityCache();
             messages::accountRemoved(asyncResp->res);
         },
         "xyz.openbmc_project.User.Manager", userPath,
@@ -2294,6 +2297,7 @@ inline void handleAccountPatch(
                 return;
             }
 
+            clearMtlsIdentityCache();
             updateUserProperties(asyncResp, newUser, password, enabled, roleId,
                                  locked, accountTypes, userSelf, session);
         },
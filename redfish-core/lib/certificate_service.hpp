@@ -6,6 +6,7 @@
 
 #include "app.hpp"
 #include "async_resp.hpp"
+#include "certificate_cache.hpp"
 #include "dbus_singleton.hpp"
 #include "dbus_utility.hpp"
 #include "error_messages.hpp"
@@ -14,11 +15,11 @@
 #include "http_response.hpp"
 #include "io_context_singleton.hpp"
 #include "logging.hpp"
+#include "mutual_tls.hpp"
 #include "privileges.hpp"
 #include "query.hpp"
 #include "registries/privilege_registry.hpp"
 #include "utility.hpp"
-#include "utils/dbus_utils.hpp"
 #include "utils/json_utils.hpp"
 #include "utils/time_utils.hpp"
 
@@ -29,6 +30,8 @@
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/status.hpp>
 #include <boost/beast/http/verb.hpp>
+#include <boost/system/errc.hpp>
+#include <boost/system/error_code.hpp>
 #include <boost/system/result.hpp>
 #include <boost/url/format.hpp>
 #include <boost/url/parse.hpp>
@@ -37,7 +40,6 @@
 #include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/message.hpp>
 #include <sdbusplus/message/native_types.hpp>
-#include <sdbusplus/unpack_properties.hpp>
 
 #include <array>
 #include <chrono>
@@ -51,6 +53,7 @@
 #include <iterator>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
 #include <string_view>
 #include <system_error>
@@ -59,26 +62,6 @@
 
 namespace redfish
 {
-namespace certs
-{
-constexpr const char* certInstallIntf = "xyz.openbmc_project.Certs.Install";
-constexpr const char* certReplaceIntf = "xyz.openbmc_project.Certs.Replace";
-constexpr const char* objDeleteIntf = "xyz.openbmc_project.Object.Delete";
-constexpr const char* certPropIntf = "xyz.openbmc_project.Certs.Certificate";
-constexpr const char* httpsServiceName =
-    "xyz.openbmc_project.Certs.Manager.Server.Https";
-constexpr const char* ldapServiceName =
-    "xyz.openbmc_project.Certs.Manager.Client.Ldap";
-constexpr const char* authorityServiceName =
-    "xyz.openbmc_project.Certs.Manager.Authority.Truststore";
-constexpr const char* baseObjectPath = "/xyz/openbmc_project/certs";
-constexpr const char* httpsObjectPath =
-    "/xyz/openbmc_project/certs/server/https";
-constexpr const char* ldapObjectPath = "/xyz/openbmc_project/certs/client/ldap";
-constexpr const char* authorityObjectPath =
-    "/xyz/openbmc_project/certs/authority/truststore";
-} // namespace certs
-
 /**
  * The Certificate schema defines a Certificate Service which represents the
  * actions available to manage certificates and links to where certificates
@@ -255,30 +238,33 @@ inline void getCertificateList(
     const std::string& basePath, const nlohmann::json::json_pointer& listPtr,
     const nlohmann::json::json_pointer& countPtr)
 {
-    constexpr std::array<std::string_view, 1> interfaces = {
-        certs::certPropIntf};
-    dbus::utility::getSubTreePaths(
-        basePath, 0, interfaces,
-        [asyncResp, listPtr, countPtr](
-            const boost::system::error_code& ec,
-            const dbus::utility::MapperGetSubTreePathsResponse& certPaths) {
+    getCertificateCache().getPaths(
+        [asyncResp, basePath, listPtr,
+         countPtr](const boost::system::error_code& ec,
+                   const std::set<std::string>& certPaths) {
             if (ec)
             {
-                BMCWEB_LOG_ERROR("Certificate collection query failed: {}", ec);
                 messages::internalError(asyncResp->res);
                 return;
             }
 
+            std::string prefix = basePath;
+            if (!prefix.ends_with('/'))
+            {
+                prefix += '/';
+            }
             nlohmann::json& links = asyncResp->res.jsonValue[listPtr];
             links = nlohmann::json::array();
-            for (const auto& certPath : certPaths)
+            for (auto certPath = certPaths.lower_bound(prefix);
+                 certPath != certPaths.end() && certPath->starts_with(prefix);
+                 certPath++)
             {
-                sdbusplus::message::object_path objPath(certPath);
+                sdbusplus::message::object_path objPath(*certPath);
                 std::string certId = objPath.filename();
                 if (certId.empty())
                 {
                     BMCWEB_LOG_ERROR("Invalid certificate objPath {}",
-                                     certPath);
+                                     *certPath);
                     continue;
                 }
 
@@ -334,35 +320,20 @@ inline void getCertificateProperties(
 {
     BMCWEB_LOG_DEBUG("getCertificateProperties Path={} certId={} certURl={}",
                      objectPath, certId, certURL);
-    dbus::utility::getAllProperties(
-        service, objectPath, certs::certPropIntf,
+    getCertificateCache().getProperties(
+        service, objectPath,
         [asyncResp, certURL, certId,
          name](const boost::system::error_code& ec,
-               const dbus::utility::DBusPropertiesMap& properties) {
-            if (ec)
+               const CertificateProperties& certificate) {
+            if (ec == boost::system::errc::bad_message)
             {
-                BMCWEB_LOG_ERROR("DBUS response error: {}", ec);
-                messages::resourceNotFound(asyncResp->res, "Certificate",
-                                           certId);
+                messages::internalError(asyncResp->res);
                 return;
             }
-
-            const std::string* certificateString = nullptr;
-            const std::vector<std::string>* keyUsage = nullptr;
-            const std::string* issuer = nullptr;
-            const std::string* subject = nullptr;
-            const uint64_t* validNotAfter = nullptr;
-            const uint64_t* validNotBefore = nullptr;
-
-            const bool success = sdbusplus::unpackPropertiesNoThrow(
-                dbus_utils::UnpackErrorPrinter(), properties,
-                "CertificateString", certificateString, "KeyUsage", keyUsage,
-                "Issuer", issuer, "Subject", subject, "ValidNotAfter",
-                validNotAfter, "ValidNotBefore", validNotBefore);
-
-            if (!success)
+            if (ec)
             {
-                messages::internalError(asyncResp->res);
+                messages::resourceNotFound(asyncResp->res, "Certificate",
+                                           certId);
                 return;
             }
 
@@ -375,39 +346,41 @@ inline void getCertificateProperties(
             asyncResp->res.jsonValue["CertificateString"] = "";
             asyncResp->res.jsonValue["KeyUsage"] = nlohmann::json::array();
 
-            if (certificateString != nullptr)
+            if (certificate.certificateString)
             {
                 asyncResp->res.jsonValue["CertificateString"] =
-                    *certificateString;
+                    *certificate.certificateString;
             }
 
-            if (keyUsage != nullptr)
+            if (certificate.keyUsage)
             {
-                asyncResp->res.jsonValue["KeyUsage"] = *keyUsage;
+                asyncResp->res.jsonValue["KeyUsage"] = *certificate.keyUsage;
             }
 
-            if (issuer != nullptr)
+            if (certificate.issuer)
             {
                 updateCertIssuerOrSubject(asyncResp->res.jsonValue["Issuer"],
-                                          *issuer);
+                                          *certificate.issuer);
             }
 
-            if (subject != nullptr)
+            if (certificate.subject)
             {
                 updateCertIssuerOrSubject(asyncResp->res.jsonValue["Subject"],
-                                          *subject);
+                                          *certificate.subject);
             }
 
-            if (validNotAfter != nullptr)
+            if (certificate.validNotAfter)
             {
                 asyncResp->res.jsonValue["ValidNotAfter"] =
-                    redfish::time_utils::getDateTimeUint(*validNotAfter);
+                    redfish::time_utils::getDateTimeUint(
+                        *certificate.validNotAfter);
             }
 
-            if (validNotBefore != nullptr)
+            if (certificate.validNotBefore)
             {
                 asyncResp->res.jsonValue["ValidNotBefore"] =
-                    redfish::time_utils::getDateTimeUint(*validNotBefore);
+                    redfish::time_utils::getDateTimeUint(
+                        *certificate.validNotBefore);
             }
 
             asyncResp->res.addHeader(
@@ -423,13 +396,20 @@ inline void deleteCertificate(
 {
     dbus::utility::async_method_call(
         asyncResp,
-        [asyncResp,
+        [asyncResp, service, objectPath,
          id{objectPath.filename()}](const boost::system::error_code& ec) {
             if (ec)
             {
                 messages::resourceNotFound(asyncResp->res, "Certificate", id);
                 return;
             }
+            // Stop listing the certificate without waiting for the signal
+            std::array<std::string, 1> removed{certs::certPropIntf};
+            getCertificateCache().onInterfacesRemoved(objectPath.str, removed);
+            if (service == certs::authorityServiceName)
+            {
+                clearMtlsIdentityCache();
+            }
             BMCWEB_LOG_INFO("Certificate deleted");
             asyncResp->res.result(boost::beast::http::status::no_content);
         },
@@ -628,6 +608,13 @@ inline void handleReplaceCertificateAction(
                 }
                 return;
             }
+            // The PropertiesChanged signal for the new certificate may not
+            // have arrived yet
+            getCertificateCache().invalidate(objectPath.str);
+            if (service == certs::authorityServiceName)
+            {
+                clearMtlsIdentityCache();
+            }
             getCertificateProperties(asyncResp, objectPath, service, id, url,
                                      name);
             BMCWEB_LOG_DEBUG("HTTPS certificate install file={}",
@@ -1275,6 +1262,7 @@ inline void handleTrustStoreCertificateCollectionPost(
                 return;
             }
 
+            clearMtlsIdentityCache();
             sdbusplus::message::object_path path(objectPath);
             std::string certId = path.filename();
             const boost::urls::url certURL = boost::urls::format(
@@ -4,7 +4,6 @@
 
 #include "app.hpp"
 #include "async_resp.hpp"
-#include "dbus_singleton.hpp"
 #include "dbus_utility.hpp"
 #include "error_messages.hpp"
 #include "http_request.hpp"
@@ -18,7 +17,6 @@
 #include <boost/beast/http/verb.hpp>
 #include <boost/url/format.hpp>
 #include <nlohmann/json.hpp>
-#include <sdbusplus/asio/property.hpp>
 
 #include <array>
 #include <functional>
@@ -94,9 +92,8 @@ inline void handleTotalPowerList(
 
     const std::string& serviceName = (*sensorList)[0].first;
     const std::string& sensorPath = (*sensorList)[0].second;
-    sdbusplus::asio::getAllProperties(
-        *crow::connections::systemBus, serviceName, sensorPath,
-        "xyz.openbmc_project.Sensor.Value",
+    dbus::utility::getAllProperties(
+        serviceName, sensorPath, "xyz.openbmc_project.Sensor.Value",
         [asyncResp, chassisId,
          sensorPath](const boost::system::error_code& ec1,
                      const dbus::utility::DBusPropertiesMap& propertiesList) {
@@ -1218,7 +1218,7 @@ void getEthernetIfaceList(CallbackFunc&& callback)
                 }
             }
 
-            std::ranges::sort(ifaceList, AlphanumLess<std::string>());
+            naturalSort(ifaceList);
 
             // Finally make a callback with useful data
             callback(true, ifaceList);
@@ -63,6 +63,12 @@ inline void createSubscription(crow::sse_socket::Connection& conn,
         return;
     }
 
+    if (filter)
+    {
+        // Compiled once here, and evaluated for every event sent
+        subValue->filter.emplace(*filter);
+    }
+
     // GET on this URI means, Its SSE subscriptionType.
     subValue->userSub->subscriptionType = redfish::subscriptionTypeSSE;
 
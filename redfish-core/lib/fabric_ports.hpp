@@ -385,7 +385,7 @@ inline void doHandleFabricPortCollectionGet(
         }
     }
 
-    std::ranges::sort(portIdNames, AlphanumLess<std::string>());
+    naturalSort(portIdNames);
 
     nlohmann::json& members = asyncResp->res.jsonValue["Members"];
     for (const std::string& portId : portIdNames)
@@ -128,7 +128,7 @@ inline void setIndicatorLedState(
         return;
     }
 
-    sdbusplus::asio::setProperty(
+    dbus::utility::setProperty(
         *crow::connections::systemBus, "xyz.openbmc_project.LED.GroupManager",
         "/xyz/openbmc_project/led/groups/enclosure_identify_blink",
         "xyz.openbmc_project.Led.Group", "Asserted", ledBlinkng,
@@ -223,7 +223,7 @@ inline void setSystemLocationIndicatorActive(
 {
     BMCWEB_LOG_DEBUG("Set LocationIndicatorActive");
 
-    sdbusplus::asio::setProperty(
+    dbus::utility::setProperty(
         *crow::connections::systemBus, "xyz.openbmc_project.LED.GroupManager",
         "/xyz/openbmc_project/led/groups/enclosure_identify_blink",
         "xyz.openbmc_project.Led.Group", "Asserted", ledState,
@@ -9,13 +9,13 @@
 #include "async_resp.hpp"
 #include "dbus_singleton.hpp"
 #include "dbus_utility.hpp"
+#include "dump_entry_cache.hpp"
 #include "error_messages.hpp"
 #include "generated/enums/log_entry.hpp"
 #include "generated/enums/log_service.hpp"
 #include "http_body.hpp"
 #include "http_request.hpp"
 #include "http_response.hpp"
-#include "human_sort.hpp"
 #include "logging.hpp"
 #include "query.hpp"
 #include "registries/privilege_registry.hpp"
@@ -26,6 +26,7 @@
 #include "utils/etag_utils.hpp"
 #include "utils/json_utils.hpp"
 #include "utils/log_services_utils.hpp"
+#include "utils/query_param.hpp"
 #include "utils/time_utils.hpp"
 
 #include <asm-generic/errno.h>
@@ -45,7 +46,9 @@
 
 #include <algorithm>
 #include <array>
+#include <cctype>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <format>
@@ -90,127 +93,6 @@ inline std::string getDumpPath(std::string_view dumpType)
     return dbusDumpPath;
 }
 
-inline log_entry::OriginatorTypes mapDbusOriginatorTypeToRedfish(
-    const std::string& originatorType)
-{
-    if (originatorType ==
-        "xyz.openbmc_project.Common.OriginatedBy.OriginatorTypes.Client")
-    {
-        return log_entry::OriginatorTypes::Client;
-    }
-    if (originatorType ==
-        "xyz.openbmc_project.Common.OriginatedBy.OriginatorTypes.Internal")
-    {
-        return log_entry::OriginatorTypes::Internal;
-    }
-    if (originatorType ==
-        "xyz.openbmc_project.Common.OriginatedBy.OriginatorTypes.SupportingService")
-    {
-        return log_entry::OriginatorTypes::SupportingService;
-    }
-    return log_entry::OriginatorTypes::Invalid;
-}
-
-inline void parseDumpEntryFromDbusObject(
-    const dbus::utility::ManagedObjectType::value_type& object,
-    std::string& dumpStatus, uint64_t& size, uint64_t& timestampUs,
-    std::string& originatorId, log_entry::OriginatorTypes& originatorType,
-    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp)
-{
-    for (const auto& interfaceMap : object.second)
-    {
-        if (interfaceMap.first == "xyz.openbmc_project.Common.Progress")
-        {
-            for (const auto& propertyMap : interfaceMap.second)
-            {
-                if (propertyMap.first == "Status")
-                {
-                    const auto* status =
-                        std::get_if<std::string>(&propertyMap.second);
-                    if (status == nullptr)
-                    {
-                        messages::internalError(asyncResp->res);
-                        break;
-                    }
-                    dumpStatus = *status;
-                }
-            }
-        }
-        else if (interfaceMap.first == "xyz.openbmc_project.Dump.Entry")
-        {
-            for (const auto& propertyMap : interfaceMap.second)
-            {
-                if (propertyMap.first == "Size")
-                {
-                    const auto* sizePtr =
-                        std::get_if<uint64_t>(&propertyMap.second);
-                    if (sizePtr == nullptr)
-                    {
-                        messages::internalError(asyncResp->res);
-                        break;
-                    }
-                    size = *sizePtr;
-                    break;
-                }
-            }
-        }
-        else if (interfaceMap.first == "xyz.openbmc_project.Time.EpochTime")
-        {
-            for (const auto& propertyMap : interfaceMap.second)
-            {
-                if (propertyMap.first == "Elapsed")
-                {
-                    const uint64_t* usecsTimeStamp =
-                        std::get_if<uint64_t>(&propertyMap.second);
-                    if (usecsTimeStamp == nullptr)
-                    {
-                        messages::internalError(asyncResp->res);
-                        break;
-                    }
-                    timestampUs = *usecsTimeStamp;
-                    break;
-                }
-            }
-        }
-        else if (interfaceMap.first ==
-                 "xyz.openbmc_project.Common.OriginatedBy")
-        {
-            for (const auto& propertyMap : interfaceMap.second)
-            {
-                if (propertyMap.first == "OriginatorId")
-                {
-                    const std::string* id =
-                        std::get_if<std::string>(&propertyMap.second);
-                    if (id == nullptr)
-                    {
-                        messages::internalError(asyncResp->res);
-                        break;
-                    }
-                    originatorId = *id;
-                }
-
-                if (propertyMap.first == "OriginatorType")
-                {
-                    const std::string* type =
-                        std::get_if<std::string>(&propertyMap.second);
-                    if (type == nullptr)
-                    {
-                        messages::internalError(asyncResp->res);
-                        break;
-                    }
-
-                    originatorType = mapDbusOriginatorTypeToRedfish(*type);
-                    if (originatorType == log_entry::OriginatorTypes::Invalid)
-                    {
-                        messages::internalError(asyncResp->res);
-                        break;
-                    }
-                }
-            }
-        }
-    }
-}
-
 static std::string getDumpEntriesPath(const std::string& dumpType)
 {
     std::string entriesPath;
@@ -243,9 +125,44 @@ static std::string getDumpEntriesPath(const std::string& dumpType)
     return entriesPath;
 }
 
+// Fills the LogEntry of a dump entry
+inline void fillDumpEntry(const DumpEntry& entry, const std::string& entryID,
+                          const std::string& dumpType,
+                          const std::string& entriesPath,
+                          nlohmann::json::object_t& thisEntry)
+{
+    thisEntry["@odata.type"] = "#LogEntry.v1_11_0.LogEntry";
+    thisEntry["@odata.id"] = entriesPath + entryID;
+    thisEntry["Id"] = entryID;
+    thisEntry["EntryType"] = "Event";
+    thisEntry["Name"] = dumpType + " Dump Entry";
+    thisEntry["Created"] =
+        redfish::time_utils::getDateTimeUintUs(entry.timestampUs);
+
+    if (!entry.originatorId.empty())
+    {
+        thisEntry["Originator"] = entry.originatorId;
+        thisEntry["OriginatorType"] = entry.originatorType;
+    }
+
+    if (dumpType == "BMC")
+    {
+        thisEntry["DiagnosticDataType"] = "Manager";
+        thisEntry["AdditionalDataURI"] = entriesPath + entryID + "/attachment";
+        thisEntry["AdditionalDataSizeBytes"] = entry.size;
+    }
+    else if (dumpType == "System")
+    {
+        thisEntry["DiagnosticDataType"] = "OEM";
+        thisEntry["OEMDiagnosticDataType"] = "System";
+        thisEntry["AdditionalDataURI"] = entriesPath + entryID + "/attachment";
+        thisEntry["AdditionalDataSizeBytes"] = entry.size;
+    }
+}
+
 inline void getDumpEntryCollection(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-    const std::string& dumpType)
+    const std::string& dumpType, size_t skip, size_t top)
 {
     std::string entriesPath = getDumpEntriesPath(dumpType);
     if (entriesPath.empty())
@@ -254,15 +171,12 @@ inline void getDumpEntryCollection(
         return;
     }
 
-    sdbusplus::message::object_path path("/xyz/openbmc_project/dump");
-    dbus::utility::getManagedObjects(
-        "xyz.openbmc_project.Dump.Manager", path,
-        [asyncResp, entriesPath,
-         dumpType](const boost::system::error_code& ec,
-                   const dbus::utility::ManagedObjectType& objects) {
+    getDumpEntryCache(getDumpPath(dumpType))
+        .get([asyncResp, entriesPath, dumpType, skip,
+              top](const boost::system::error_code& ec,
+                   const DumpEntryCache::Entries& entries) {
             if (ec)
             {
-                BMCWEB_LOG_ERROR("DumpEntry resp_handler got error {}", ec);
                 messages::internalError(asyncResp->res);
                 return;
             }
@@ -276,86 +190,43 @@ inline void getDumpEntryCollection(
 
             asyncResp->res.jsonValue["@odata.type"] =
                 "#LogEntryCollection.LogEntryCollection";
-            asyncResp->res.jsonValue["@odata.id"] = std::move(odataIdStr);
+            asyncResp->res.jsonValue["@odata.id"] = odataIdStr;
             asyncResp->res.jsonValue["Name"] = dumpType + " Dump Entries";
             asyncResp->res.jsonValue["Description"] =
                 "Collection of " + dumpType + " Dump Entries";
 
+            // Only the requested page is rendered
             nlohmann::json::array_t entriesArray;
-            std::string dumpEntryPath = getDumpPath(dumpType) + "/entry/";
-
-            dbus::utility::ManagedObjectType resp(objects);
-            std::ranges::sort(resp, [](const auto& l, const auto& r) {
-                return AlphanumLess<std::string>()(l.first.filename(),
-                                                   r.first.filename());
-            });
-
-            for (auto& object : resp)
+            size_t count = 0;
+            for (const auto* sortedEntry : DumpEntryCache::sorted(entries))
             {
-                if (object.first.str.find(dumpEntryPath) == std::string::npos)
-                {
-                    continue;
-                }
-                uint64_t timestampUs = 0;
-                uint64_t size = 0;
-                std::string dumpStatus;
-                std::string originatorId;
-                log_entry::OriginatorTypes originatorType =
-                    log_entry::OriginatorTypes::Internal;
-                nlohmann::json::object_t thisEntry;
-
-                std::string entryID = object.first.filename();
-                if (entryID.empty())
-                {
-                    continue;
-                }
-
-                parseDumpEntryFromDbusObject(object, dumpStatus, size,
-                                             timestampUs, originatorId,
-                                             originatorType, asyncResp);
-
-                if (dumpStatus !=
-                        "xyz.openbmc_project.Common.Progress.OperationStatus.Completed" &&
-                    !dumpStatus.empty())
+                const auto& [entryID, entry] = *sortedEntry;
+                if (!entry.completed())
                 {
                     // Dump status is not Complete, no need to enumerate
                     continue;
                 }
-
-                thisEntry["@odata.type"] = "#LogEntry.v1_11_0.LogEntry";
-                thisEntry["@odata.id"] = entriesPath + entryID;
-                thisEntry["Id"] = entryID;
-                thisEntry["EntryType"] = "Event";
-                thisEntry["Name"] = dumpType + " Dump Entry";
-                thisEntry["Created"] =
-                    redfish::time_utils::getDateTimeUintUs(timestampUs);
-
-                if (!originatorId.empty())
-                {
-                    thisEntry["Originator"] = originatorId;
-                    thisEntry["OriginatorType"] = originatorType;
-                }
-
-                if (dumpType == "BMC")
+                count++;
+                if (count <= skip || count > skip + top)
                 {
-                    thisEntry["DiagnosticDataType"] = "Manager";
-                    thisEntry["AdditionalDataURI"] =
-                        entriesPath + entryID + "/attachment";
-                    thisEntry["AdditionalDataSizeBytes"] = size;
+                    continue;
                 }
-                else if (dumpType == "System")
+                if (entry.malformed)
                 {
-                    thisEntry["DiagnosticDataType"] = "OEM";
-                    thisEntry["OEMDiagnosticDataType"] = "System";
-                    thisEntry["AdditionalDataURI"] =
-                        entriesPath + entryID + "/attachment";
-                    thisEntry["AdditionalDataSizeBytes"] = size;
+                    messages::internalError(asyncResp->res);
                 }
+                nlohmann::json::object_t thisEntry;
+                fillDumpEntry(entry, entryID, dumpType, entriesPath,
+                              thisEntry);
                 entriesArray.emplace_back(std::move(thisEntry));
             }
-            asyncResp->res.jsonValue["Members@odata.count"] =
-                entriesArray.size();
+            asyncResp->res.jsonValue["Members@odata.count"] = count;
             asyncResp->res.jsonValue["Members"] = std::move(entriesArray);
+            if (skip + top < count)
+            {
+                asyncResp->res.jsonValue["Members@odata.nextLink"] =
+                    std::format("{}?$skip={}", odataIdStr, skip + top);
+            }
         });
 }
 
@@ -370,91 +241,59 @@ inline void getDumpEntryById(
         return;
     }
 
-    sdbusplus::message::object_path path("/xyz/openbmc_project/dump");
-    dbus::utility::getManagedObjects(
-        "xyz.openbmc_project.Dump.Manager", path,
+    // Ids are used as is in the object path, so anything that isn't a valid
+    // path element can't name an entry
+    if (entryID.empty() ||
+        !std::ranges::all_of(entryID, [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) != 0 ||
+                   c == '_';
+        }))
+    {
+        messages::resourceNotFound(asyncResp->res, dumpType + " dump",
+                                   entryID);
+        return;
+    }
+
+    // An empty interface name gets the properties of every interface of the
+    // entry
+    dbus::utility::getAllProperties(
+        dumpManagerService, getDumpPath(dumpType) + "/entry/" + entryID, "",
         [asyncResp, entryID, dumpType,
          entriesPath](const boost::system::error_code& ec,
-                      const dbus::utility::ManagedObjectType& resp) {
+                      const dbus::utility::DBusPropertiesMap& properties) {
             if (ec)
             {
-                BMCWEB_LOG_ERROR("DumpEntry resp_handler got error {}", ec);
-                messages::internalError(asyncResp->res);
-                return;
-            }
-
-            bool foundDumpEntry = false;
-            std::string dumpEntryPath = getDumpPath(dumpType) + "/entry/";
-
-            for (const auto& objectPath : resp)
-            {
-                if (objectPath.first.str != dumpEntryPath + entryID)
+                if (ec.value() == EBADR)
                 {
-                    continue;
-                }
-
-                foundDumpEntry = true;
-                uint64_t timestampUs = 0;
-                uint64_t size = 0;
-                std::string dumpStatus;
-                std::string originatorId;
-                log_entry::OriginatorTypes originatorType =
-                    log_entry::OriginatorTypes::Internal;
-
-                parseDumpEntryFromDbusObject(objectPath, dumpStatus, size,
-                                             timestampUs, originatorId,
-                                             originatorType, asyncResp);
-
-                if (dumpStatus !=
-                        "xyz.openbmc_project.Common.Progress.OperationStatus.Completed" &&
-                    !dumpStatus.empty())
-                {
-                    // Dump status is not Complete
-                    // return not found until status is changed to Completed
+                    BMCWEB_LOG_WARNING("Can't find Dump Entry {}", entryID);
                     messages::resourceNotFound(asyncResp->res,
                                                dumpType + " dump", entryID);
                     return;
                 }
+                BMCWEB_LOG_ERROR("DumpEntry resp_handler got error {}", ec);
+                messages::internalError(asyncResp->res);
+                return;
+            }
 
-                asyncResp->res.jsonValue["@odata.type"] =
-                    "#LogEntry.v1_11_0.LogEntry";
-                asyncResp->res.jsonValue["@odata.id"] = entriesPath + entryID;
-                asyncResp->res.jsonValue["Id"] = entryID;
-                asyncResp->res.jsonValue["EntryType"] = "Event";
-                asyncResp->res.jsonValue["Name"] = dumpType + " Dump Entry";
-                asyncResp->res.jsonValue["Created"] =
-                    redfish::time_utils::getDateTimeUintUs(timestampUs);
-
-                if (!originatorId.empty())
-                {
-                    asyncResp->res.jsonValue["Originator"] = originatorId;
-                    asyncResp->res.jsonValue["OriginatorType"] = originatorType;
-                }
-
-                if (dumpType == "BMC")
-                {
-                    asyncResp->res.jsonValue["DiagnosticDataType"] = "Manager";
-                    asyncResp->res.jsonValue["AdditionalDataURI"] =
-                        entriesPath + entryID + "/attachment";
-                    asyncResp->res.jsonValue["AdditionalDataSizeBytes"] = size;
-                }
-                else if (dumpType == "System")
-                {
-                    asyncResp->res.jsonValue["DiagnosticDataType"] = "OEM";
-                    asyncResp->res.jsonValue["OEMDiagnosticDataType"] =
-                        "System";
-                    asyncResp->res.jsonValue["AdditionalDataURI"] =
-                        entriesPath + entryID + "/attachment";
-                    asyncResp->res.jsonValue["AdditionalDataSizeBytes"] = size;
-                }
+            DumpEntry entry;
+            updateDumpEntry(properties, entry);
+            if (entry.malformed)
+            {
+                messages::internalError(asyncResp->res);
             }
-            if (!foundDumpEntry)
+
+            if (!entry.completed())
             {
-                BMCWEB_LOG_WARNING("Can't find Dump Entry {}", entryID);
+                // Dump status is not Complete
+                // return not found until status is changed to Completed
                 messages::resourceNotFound(asyncResp->res, dumpType + " dump",
                                            entryID);
                 return;
             }
+
+            nlohmann::json::object_t thisEntry;
+            fillDumpEntry(entry, entryID, dumpType, entriesPath, thisEntry);
+            asyncResp->res.jsonValue.update(thisEntry);
         });
 }
 
@@ -693,9 +532,7 @@ inline void createDumpTaskCallback(
                     taskData->state = "Completed";
                     return task::completed;
                 },
-                "type='signal',interface='org.freedesktop.DBus.Properties',"
-                "member='PropertiesChanged',path='" +
-                    createdObjPath.str + "'");
+                task::propertiesChangedOf(createdObjPath));
 
             // The task timer is set to max time limit within which the
             // requested dump will be collected.
@@ -1289,7 +1126,13 @@ inline void handleLogServicesDumpEntriesCollectionGet(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
     const std::string& managerId)
 {
-    if (!redfish::setUpRedfishRoute(app, req, asyncResp))
+    query_param::QueryCapabilities capabilities = {
+        .canDelegateTop = true,
+        .canDelegateSkip = true,
+    };
+    query_param::Query delegatedQuery;
+    if (!redfish::setUpRedfishRouteWithDelegation(app, req, asyncResp,
+                                                  delegatedQuery, capabilities))
     {
         return;
     }
@@ -1299,7 +1142,9 @@ inline void handleLogServicesDumpEntriesCollectionGet(
         messages::resourceNotFound(asyncResp->res, "Manager", managerId);
         return;
     }
-    getDumpEntryCollection(asyncResp, dumpType);
+    getDumpEntryCollection(
+        asyncResp, dumpType, delegatedQuery.skip.value_or(0),
+        delegatedQuery.top.value_or(query_param::Query::maxTop));
 }
 
 inline void handleLogServicesDumpEntriesCollectionComputerSystemGet(
@@ -1307,7 +1152,13 @@ inline void handleLogServicesDumpEntriesCollectionComputerSystemGet(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
     const std::string& chassisId)
 {
-    if (!redfish::setUpRedfishRoute(app, req, asyncResp))
+    query_param::QueryCapabilities capabilities = {
+        .canDelegateTop = true,
+        .canDelegateSkip = true,
+    };
+    query_param::Query delegatedQuery;
+    if (!redfish::setUpRedfishRouteWithDelegation(app, req, asyncResp,
+                                                  delegatedQuery, capabilities))
     {
         return;
     }
@@ -1316,7 +1167,9 @@ inline void handleLogServicesDumpEntriesCollectionComputerSystemGet(
         messages::resourceNotFound(asyncResp->res, "ComputerSystem", chassisId);
         return;
     }
-    getDumpEntryCollection(asyncResp, "System");
+    getDumpEntryCollection(
+        asyncResp, "System", delegatedQuery.skip.value_or(0),
+        delegatedQuery.top.value_or(query_param::Query::maxTop));
 }
 
 inline void handleLogServicesDumpEntryGet(
@@ -2109,26 +1962,15 @@ inline void requestRoutesCrashdumpCollect(App& app)
 
                 std::string iface;
                 std::string method;
-                std::string taskMatchStr;
                 if (oemDiagType == OEMDiagnosticType::onDemand)
                 {
                     iface = crashdumpOnDemandInterface;
                     method = "GenerateOnDemandLog";
-                    taskMatchStr =
-                        "type='signal',"
-                        "interface='org.freedesktop.DBus.Properties',"
-                        "member='PropertiesChanged',"
-                        "arg0namespace='com.intel.crashdump'";
                 }
                 else if (oemDiagType == OEMDiagnosticType::telemetry)
                 {
                     iface = crashdumpTelemetryInterface;
                     method = "GenerateTelemetryLog";
-                    taskMatchStr =
-                        "type='signal',"
-                        "interface='org.freedesktop.DBus.Properties',"
-                        "member='PropertiesChanged',"
-                        "arg0namespace='com.intel.crashdump'";
                 }
                 else
                 {
@@ -2141,9 +1983,9 @@ inline void requestRoutesCrashdumpCollect(App& app)
                 }
 
                 auto collectCrashdumpCallback =
-                    [asyncResp, payload(task::Payload(req)),
-                     taskMatchStr](const boost::system::error_code& ec,
-                                   const std::string&) mutable {
+                    [asyncResp, payload(task::Payload(req))](
+                        const boost::system::error_code& ec,
+                        const std::string&) mutable {
                         if (ec)
                         {
                             if (ec.value() ==
@@ -2179,7 +2021,9 @@ inline void requestRoutesCrashdumpCollect(App& app)
                                     }
                                     return task::completed;
                                 },
-                                taskMatchStr);
+                                // Any change to the crashdump properties
+                                task::TaskMatch{"/", "",
+                                                "com.intel.crashdump"});
 
                         task->startTimer(std::chrono::minutes(5));
                         task->payload.emplace(std::move(payload));
@@ -4,22 +4,32 @@
 
 #include "app.hpp"
 #include "async_resp.hpp"
+#include "directory_watcher.hpp"
 #include "http_request.hpp"
+#include "io_context_singleton.hpp"
 #include "logging.hpp"
+#include "webassets.hpp"
 
 #include <tinyxml2.h>
 
-#include <boost/beast/http/field.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/beast/http/status.hpp>
 #include <boost/beast/http/verb.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <format>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <system_error>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace redfish
 {
@@ -71,25 +81,20 @@ inline std::string getMetadataPieceForFile(
     return xml;
 }
 
-inline void handleMetadataGet(
-    App& /*app*/, const crow::Request& /*req*/,
-    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp)
+// Builds the $metadata service document from the CSDL files in the schema
+// directory.  Files are processed in name order, so the document (and its
+// ETag) only changes when the schemas do.
+inline std::optional<std::string> buildMetadataDocument(
+    const std::filesystem::path& schema)
 {
-    std::filesystem::path schema("/usr/share/www/redfish/v1/schema");
     std::error_code ec;
     auto iter = std::filesystem::directory_iterator(schema, ec);
     if (ec)
     {
         BMCWEB_LOG_ERROR("Failed to open XML folder {}", schema.string());
-        asyncResp->res.result(
-            boost::beast::http::status::internal_server_error);
-        return;
+        return std::nullopt;
     }
-    std::string xml;
-
-    xml += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-    xml +=
-        "<edmx:Edmx xmlns:edmx=\"http://docs.oasis-open.org/odata/ns/edmx\" Version=\"4.0\">\n";
+    std::vector<std::filesystem::path> files;
     for (const auto& dirEntry : iter)
     {
         std::string path = dirEntry.path().filename();
@@ -97,12 +102,21 @@ inline void handleMetadataGet(
         {
             continue;
         }
-        std::string metadataPiece = getMetadataPieceForFile(dirEntry.path());
+        files.emplace_back(dirEntry.path());
+    }
+    std::ranges::sort(files);
+
+    std::string xml;
+
+    xml += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    xml +=
+        "<edmx:Edmx xmlns:edmx=\"http://docs.oasis-open.org/odata/ns/edmx\" Version=\"4.0\">\n";
+    for (const std::filesystem::path& file : files)
+    {
+        std::string metadataPiece = getMetadataPieceForFile(file);
         if (metadataPiece.empty())
         {
-            asyncResp->res.result(
-                boost::beast::http::status::internal_server_error);
-            return;
+            return std::nullopt;
         }
         xml += metadataPiece;
     }
@@ -114,10 +128,153 @@ inline void handleMetadataGet(
     xml += "        </Schema>\n";
     xml += "    </edmx:DataServices>\n";
     xml += "</edmx:Edmx>\n";
+    return xml;
+}
+
+// Parses the CSDL files and compresses the result, which is slow enough that
+// it's done on a thread of its own.  Returns nullptr if there is no document.
+inline std::shared_ptr<const crow::webassets::StaticPayload>
+    buildMetadataPayload(const std::filesystem::path& schema)
+{
+    std::optional<std::string> xml = buildMetadataDocument(schema);
+    if (!xml)
+    {
+        return nullptr;
+    }
+    return crow::webassets::makeStaticPayload(std::move(*xml),
+                                              "application/xml");
+}
+
+// Building $metadata means parsing every CSDL file, which is far too slow to
+// do per request, or on the io_context at all.  The document only changes
+// when the schema files do, so it's built on a worker thread on first use,
+// kept along with its compressed variants, and marked stale whenever the
+// schema directory changes.  A stale document is still served while the new
+// one is built.
+class MetadataCache
+{
+  public:
+    using Callback = std::function<void(
+        const std::shared_ptr<const crow::webassets::StaticPayload>&)>;
+
+    MetadataCache(boost::asio::io_context& iocIn,
+                  const std::filesystem::path& schemaDirIn) :
+        ioc(iocIn), schemaDir(schemaDirIn),
+        watcher(ioc, schemaDir, [this]() { invalidate(); })
+    {}
 
-    asyncResp->res.addHeader(boost::beast::http::field::content_type,
-                             "application/xml");
-    asyncResp->res.write(std::move(xml));
+    MetadataCache(const MetadataCache&) = delete;
+    MetadataCache& operator=(const MetadataCache&) = delete;
+    MetadataCache(MetadataCache&&) = delete;
+    MetadataCache& operator=(MetadataCache&&) = delete;
+
+    ~MetadataCache()
+    {
+        if (builder.joinable())
+        {
+            builder.join();
+        }
+    }
+
+    static MetadataCache& getInstance()
+    {
+        static MetadataCache cache(getIoContext(),
+                                   "/usr/share/www/redfish/v1/schema");
+        return cache;
+    }
+
+    // Calls callback with the document, right away if there is one, even a
+    // stale one, or once it's built otherwise.  The document is nullptr if it
+    // couldn't be built.
+    void get(Callback&& callback)
+    {
+        if (stale)
+        {
+            startBuild();
+        }
+        if (payload != nullptr)
+        {
+            callback(payload);
+            return;
+        }
+        waiting.emplace_back(std::move(callback));
+    }
+
+    void invalidate()
+    {
+        BMCWEB_LOG_DEBUG("Schema directory changed, $metadata is stale");
+        stale = true;
+    }
+
+  private:
+    void startBuild()
+    {
+        if (building)
+        {
+            // Changes made since it started are picked up by the next one
+            return;
+        }
+        building = true;
+        stale = false;
+        if (builder.joinable())
+        {
+            builder.join();
+        }
+        // Keeps the io_context running until the result is posted to it
+        builder = std::thread(
+            [this, work(boost::asio::make_work_guard(ioc))]() {
+                std::shared_ptr<const crow::webassets::StaticPayload> built =
+                    buildMetadataPayload(schemaDir);
+                boost::asio::post(ioc, [this, result(std::move(built))]() {
+                    onBuilt(result);
+                });
+            });
+    }
+
+    void onBuilt(
+        const std::shared_ptr<const crow::webassets::StaticPayload>& built)
+    {
+        building = false;
+        payload = built;
+        if (payload == nullptr)
+        {
+            // Try again on the next request, as every request did before
+            stale = true;
+        }
+        std::vector<Callback> callbacks = std::exchange(waiting, {});
+        for (Callback& callback : callbacks)
+        {
+            callback(payload);
+        }
+    }
+
+    boost::asio::io_context& ioc;
+    std::filesystem::path schemaDir;
+    std::shared_ptr<const crow::webassets::StaticPayload> payload;
+    // Nothing has been built yet, or the schemas changed since
+    bool stale = true;
+    bool building = false;
+    std::vector<Callback> waiting;
+    std::thread builder;
+    bmcweb::DirectoryWatcher watcher;
+};
+
+inline void handleMetadataGet(
+    App& /*app*/, const crow::Request& req,
+    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp)
+{
+    MetadataCache::getInstance().get(
+        [reqCopy(crow::Request(req)), asyncResp](
+            const std::shared_ptr<const crow::webassets::StaticPayload>&
+                payload) {
+            if (payload == nullptr)
+            {
+                asyncResp->res.result(
+                    boost::beast::http::status::internal_server_error);
+                return;
+            }
+            crow::webassets::handleStaticPayload(reqCopy, asyncResp, payload);
+        });
 }
 
 inline void requestRoutesMetadata(App& app)
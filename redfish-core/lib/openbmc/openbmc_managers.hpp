@@ -21,7 +21,6 @@
 #include <boost/url/format.hpp>
 #include <boost/url/url.hpp>
 #include <nlohmann/json.hpp>
-#include <sdbusplus/asio/property.hpp>
 #include <sdbusplus/message/native_types.hpp>
 #include <sdbusplus/unpack_properties.hpp>
 
@@ -1279,7 +1278,7 @@ struct SetPIDValues : std::enable_shared_from_this<SetPIDValues>
                 return;
             }
             currentProfile = *profile;
-            sdbusplus::asio::setProperty(
+            dbus::utility::setProperty(
                 *crow::connections::systemBus, profileConnection, profilePath,
                 thermalModeIface, "Current", *profile,
                 [response](const boost::system::error_code& ec) {
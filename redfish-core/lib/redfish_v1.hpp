@@ -4,28 +4,36 @@
 
 #include "app.hpp"
 #include "async_resp.hpp"
+#include "directory_watcher.hpp"
 #include "error_messages.hpp"
 #include "http_request.hpp"
 #include "http_response.hpp"
 #include "human_sort.hpp"
+#include "io_context_singleton.hpp"
 #include "logging.hpp"
 #include "query.hpp"
 #include "registries/privilege_registry.hpp"
-#include "str_utility.hpp"
+#include "webassets.hpp"
 
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/status.hpp>
 #include <boost/beast/http/verb.hpp>
+#include <boost/container/flat_map.hpp>
 #include <boost/url/format.hpp>
+#include <nlohmann/json.hpp>
 
-#include <algorithm>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <format>
+#include <fstream>
 #include <functional>
+#include <ios>
+#include <iterator>
 #include <memory>
-#include <ranges>
 #include <string>
+#include <string_view>
 #include <system_error>
 #include <utility>
 #include <vector>
@@ -88,162 +96,368 @@ inline void redfish405(App& app, const crow::Request& req,
     }
 }
 
-inline void jsonSchemaIndexGet(
-    App& app, const crow::Request& req,
-    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp)
+// Total size of the schema files, and their compressed variants, that are
+// kept in memory
+constexpr size_t jsonSchemaCacheSize = 4UL * 1024UL * 1024UL;
+
+// Index of the files in the JsonSchemas directory, so that collection and
+// member GETs don't need to list the directory.  Built on construction, and
+// rebuilt on the next lookup after the directory changes.  File contents
+// (and their compressed variants) are loaded on first use, and kept until
+// the file changes, or until they're the least recently used when the
+// cache is full.
+class JsonSchemaIndex
 {
-    if (!redfish::setUpRedfishRoute(app, req, asyncResp))
+  public:
+    struct File
     {
-        return;
+        std::filesystem::path path;
+        // Derived from the size and modification time, so it changes
+        // whenever the file is replaced.
+        std::string tag;
+        std::shared_ptr<const crow::webassets::StaticPayload> payload;
+        uint64_t lastUsed = 0;
+    };
+
+    explicit JsonSchemaIndex(const std::filesystem::path& directoryIn,
+                             size_t capacityIn = jsonSchemaCacheSize) :
+        directory(directoryIn), capacity(capacityIn),
+        watcher(getIoContext(), directory, [this]() { invalidate(); })
+    {
+        rebuild();
     }
-    nlohmann::json& json = asyncResp->res.jsonValue;
-    json["@odata.id"] = "/redfish/v1/JsonSchemas";
-    json["@odata.type"] = "#JsonSchemaFileCollection.JsonSchemaFileCollection";
-    json["Name"] = "JsonSchemaFile Collection";
-    json["Description"] = "Collection of JsonSchemaFiles";
 
-    std::error_code ec;
-    std::filesystem::directory_iterator dirList(
-        "/usr/share/www/redfish/v1/JsonSchemas", ec);
-    if (ec)
+    static JsonSchemaIndex& getInstance()
     {
-        messages::internalError(asyncResp->res);
-        return;
+        static JsonSchemaIndex index("/usr/share/www/redfish/v1/JsonSchemas");
+        return index;
     }
 
-    std::vector<std::string> schemaNames;
-    for (const std::filesystem::path& file : dirList)
+    // Returns nullptr if the directory couldn't be read
+    const nlohmann::json::array_t* getMembers()
     {
-        std::string filename = file.filename();
-        std::vector<std::string> split;
-        bmcweb::split(split, filename, '.');
-        if (split.empty())
+        refresh();
+        if (!valid)
         {
-            continue;
+            return nullptr;
         }
-        schemaNames.emplace_back(split[0]);
+        return &members;
     }
-    std::ranges::sort(schemaNames, AlphanumLess<std::string>());
 
-    nlohmann::json::array_t members;
-    for (const std::string& schema : schemaNames)
+    // Returns the name of the file describing the schema, or nullptr if
+    // there is none
+    const std::string* findSchemaFile(std::string_view schema)
     {
-        nlohmann::json::object_t member;
-        member["@odata.id"] =
-            boost::urls::format("/redfish/v1/JsonSchemas/{}", schema);
-        members.emplace_back(std::move(member));
+        refresh();
+        auto it = schemas.find(schema);
+        if (it == schemas.end())
+        {
+            return nullptr;
+        }
+        return &it->second;
     }
-    json["Members@odata.count"] = members.size();
-    json["Members"] = std::move(members);
-}
 
-inline void jsonSchemaGet(App& app, const crow::Request& req,
-                          const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-                          const std::string& schema)
-{
-    if (!redfish::setUpRedfishRoute(app, req, asyncResp))
+    bool hasFile(std::string_view filename)
     {
-        return;
+        refresh();
+        return files.contains(filename);
     }
 
-    std::error_code ec;
-    std::filesystem::directory_iterator dirList(
-        "/usr/share/www/redfish/v1/JsonSchemas", ec);
-    if (ec)
+    // Returns nullptr if the file isn't in the index or couldn't be read
+    std::shared_ptr<const crow::webassets::StaticPayload> getFile(
+        std::string_view filename)
     {
-        messages::resourceNotFound(asyncResp->res, "JsonSchemaFile", schema);
-        return;
+        refresh();
+        auto it = files.find(filename);
+        if (it == files.end())
+        {
+            return nullptr;
+        }
+        File& file = it->second;
+        file.lastUsed = ++useCount;
+        if (file.payload != nullptr)
+        {
+            return file.payload;
+        }
+        std::ifstream stream(file.path, std::ios::binary);
+        if (!stream)
+        {
+            BMCWEB_LOG_ERROR("Failed to open {}", file.path.string());
+            return nullptr;
+        }
+        std::string body{std::istreambuf_iterator<char>(stream),
+                         std::istreambuf_iterator<char>()};
+        std::shared_ptr<const crow::webassets::StaticPayload> payload =
+            crow::webassets::makeStaticPayload(std::move(body),
+                                               "application/json", file.tag);
+        // Files too large for the cache are served without being kept
+        size_t size = payloadSize(*payload);
+        if (size <= capacity)
+        {
+            evictUntilFits(size);
+            file.payload = payload;
+            used += size;
+        }
+        return payload;
     }
-    for (const std::filesystem::path& file : dirList)
+
+    // Bytes of file contents currently held
+    size_t size() const
     {
-        std::string filename = file.filename();
-        std::vector<std::string> split;
-        bmcweb::split(split, filename, '.');
-        if (split.empty())
+        return used;
+    }
+
+    void invalidate()
+    {
+        BMCWEB_LOG_DEBUG("JsonSchemas directory changed");
+        stale = true;
+    }
+
+  private:
+    static size_t payloadSize(const crow::webassets::StaticPayload& payload)
+    {
+        size_t size = payload.identity.body.size();
+        if (payload.gzip)
         {
-            continue;
+            size += payload.gzip->body.size();
         }
-        BMCWEB_LOG_DEBUG("Checking {}", split[0]);
-        if (split[0] != schema)
+        if (payload.zstd)
         {
-            continue;
+            size += payload.zstd->body.size();
         }
+        return size;
+    }
 
-        nlohmann::json& json = asyncResp->res.jsonValue;
-        json["@odata.id"] =
-            boost::urls::format("/redfish/v1/JsonSchemas/{}", schema);
-        json["@odata.type"] = "#JsonSchemaFile.v1_0_2.JsonSchemaFile";
-        json["Name"] = schema + " Schema File";
-        json["Description"] = schema + " Schema File Location";
-        json["Id"] = schema;
-        std::string schemaName = std::format("#{}.{}", schema, schema);
-        json["Schema"] = std::move(schemaName);
-        constexpr std::array<std::string_view, 1> languages{"en"};
-        json["Languages"] = languages;
-        json["Languages@odata.count"] = languages.size();
-
-        nlohmann::json::array_t locationArray;
-        nlohmann::json::object_t locationEntry;
-        locationEntry["Language"] = "en";
-
-        locationEntry["PublicationUri"] = boost::urls::format(
-            "http://redfish.dmtf.org/schemas/v1/{}", filename);
-        locationEntry["Uri"] = boost::urls::format(
-            "/redfish/v1/JsonSchemas/{}/{}", schema, filename);
-
-        locationArray.emplace_back(locationEntry);
-
-        json["Location"] = std::move(locationArray);
-        json["Location@odata.count"] = 1;
-        return;
+    void evictUntilFits(size_t size)
+    {
+        while (used + size > capacity)
+        {
+            auto oldest = files.end();
+            for (auto it = files.begin(); it != files.end(); it++)
+            {
+                if (it->second.payload != nullptr &&
+                    (oldest == files.end() ||
+                     it->second.lastUsed < oldest->second.lastUsed))
+                {
+                    oldest = it;
+                }
+            }
+            if (oldest == files.end())
+            {
+                return;
+            }
+            used -= payloadSize(*oldest->second.payload);
+            oldest->second.payload = nullptr;
+        }
     }
-    messages::resourceNotFound(asyncResp->res, "JsonSchemaFile", schema);
-}
 
-inline void jsonSchemaGetFile(
-    const crow::Request& /*req*/,
-    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-    const std::string& schema, const std::string& schemaFile)
+    void refresh()
+    {
+        if (stale)
+        {
+            rebuild();
+        }
+    }
+
+    void rebuild()
+    {
+        stale = false;
+        valid = false;
+        used = 0;
+        members.clear();
+        schemas.clear();
+
+        Files oldFiles = std::exchange(files, {});
+
+        std::error_code ec;
+        std::filesystem::directory_iterator dirList(directory, ec);
+        if (ec)
+        {
+            BMCWEB_LOG_ERROR("Failed to open {}", directory.string());
+            return;
+        }
+        for (const std::filesystem::directory_entry& entry : dirList)
+        {
+            if (!entry.is_regular_file(ec))
+            {
+                continue;
+            }
+            std::string filename = entry.path().filename();
+            uintmax_t size = entry.file_size(ec);
+            if (ec)
+            {
+                continue;
+            }
+            std::filesystem::file_time_type modified =
+                entry.last_write_time(ec);
+            if (ec)
+            {
+                continue;
+            }
+            File file{entry.path(),
+                      std::format("{:x}-{:x}", size,
+                                  modified.time_since_epoch().count()),
+                      nullptr};
+
+            // Keep the loaded contents of files that haven't changed
+            auto old = oldFiles.find(filename);
+            if (old != oldFiles.end() && old->second.tag == file.tag)
+            {
+                file.payload = std::move(old->second.payload);
+                file.lastUsed = old->second.lastUsed;
+                if (file.payload != nullptr)
+                {
+                    used += payloadSize(*file.payload);
+                }
+            }
+            files.emplace(std::move(filename), std::move(file));
+        }
+
+        // Files are sorted, so each schema maps to its first file
+        for (const auto& [filename, file] : files)
+        {
+            std::string_view schema = filename;
+            schema = schema.substr(0, schema.find('.'));
+            if (schema.empty())
+            {
+                continue;
+            }
+            schemas.try_emplace(std::string(schema), filename);
+        }
+
+        std::vector<std::string_view> names;
+        names.reserve(schemas.size());
+        for (const auto& [schema, filename] : schemas)
+        {
+            names.emplace_back(schema);
+        }
+        naturalSort(names);
+        members.reserve(names.size());
+        for (std::string_view schema : names)
+        {
+            nlohmann::json::object_t member;
+            member["@odata.id"] =
+                boost::urls::format("/redfish/v1/JsonSchemas/{}", schema);
+            members.emplace_back(std::move(member));
+        }
+        valid = true;
+    }
+
+    using Files = boost::container::flat_map<std::string, File, std::less<>>;
+
+    std::filesystem::path directory;
+    size_t capacity;
+    size_t used = 0;
+    uint64_t useCount = 0;
+    bool valid = false;
+    bool stale = false;
+    Files files;
+    // Schema name to the name of its file
+    boost::container::flat_map<std::string, std::string, std::less<>> schemas;
+    nlohmann::json::array_t members;
+    bmcweb::DirectoryWatcher watcher;
+};
+
+inline void jsonSchemaIndexGet(
+    App& app, const crow::Request& req,
+    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp)
 {
-    // Sanity check the filename
-    if (schemaFile.find_first_not_of(
-            "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-.") !=
-        std::string::npos)
+    if (!redfish::setUpRedfishRoute(app, req, asyncResp))
     {
-        messages::resourceNotFound(asyncResp->res, "JsonSchemaFile", schema);
         return;
     }
-    // Schema path should look like /redfish/v1/JsonSchemas/Foo/Foo.x.json
-    // Make sure the two paths match.
-    if (!schemaFile.starts_with(schema))
+    const nlohmann::json::array_t* members =
+        JsonSchemaIndex::getInstance().getMembers();
+    if (members == nullptr)
     {
-        messages::resourceNotFound(asyncResp->res, "JsonSchemaFile", schema);
+        messages::internalError(asyncResp->res);
         return;
     }
-    std::filesystem::path filepath("/usr/share/www/redfish/v1/JsonSchemas");
-    filepath /= schemaFile;
-    if (filepath.is_relative())
+    nlohmann::json& json = asyncResp->res.jsonValue;
+    json["@odata.id"] = "/redfish/v1/JsonSchemas";
+    json["@odata.type"] = "#JsonSchemaFileCollection.JsonSchemaFileCollection";
+    json["Name"] = "JsonSchemaFile Collection";
+    json["Description"] = "Collection of JsonSchemaFiles";
+    json["Members@odata.count"] = members->size();
+    json["Members"] = *members;
+}
+
+inline void jsonSchemaGet(App& app, const crow::Request& req,
+                          const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+                          const std::string& schema)
+{
+    if (!redfish::setUpRedfishRoute(app, req, asyncResp))
+    {
+        return;
+    }
+
+    const std::string* filename =
+        JsonSchemaIndex::getInstance().findSchemaFile(schema);
+    if (filename == nullptr)
     {
         messages::resourceNotFound(asyncResp->res, "JsonSchemaFile", schema);
         return;
     }
 
-    crow::OpenCode ec = asyncResp->res.openFile(filepath);
-    if (ec == crow::OpenCode::FileDoesNotExist)
+    nlohmann::json& json = asyncResp->res.jsonValue;
+    json["@odata.id"] =
+        boost::urls::format("/redfish/v1/JsonSchemas/{}", schema);
+    json["@odata.type"] = "#JsonSchemaFile.v1_0_2.JsonSchemaFile";
+    json["Name"] = schema + " Schema File";
+    json["Description"] = schema + " Schema File Location";
+    json["Id"] = schema;
+    std::string schemaName = std::format("#{}.{}", schema, schema);
+    json["Schema"] = std::move(schemaName);
+    constexpr std::array<std::string_view, 1> languages{"en"};
+    json["Languages"] = languages;
+    json["Languages@odata.count"] = languages.size();
+
+    nlohmann::json::array_t locationArray;
+    nlohmann::json::object_t locationEntry;
+    locationEntry["Language"] = "en";
+
+    locationEntry["PublicationUri"] = boost::urls::format(
+        "http://redfish.dmtf.org/schemas/v1/{}", *filename);
+    locationEntry["Uri"] = boost::urls::format("/redfish/v1/JsonSchemas/{}/{}",
+                                               schema, *filename);
+
+    locationArray.emplace_back(locationEntry);
+
+    json["Location"] = std::move(locationArray);
+    json["Location@odata.count"] = 1;
+}
+
+inline void jsonSchemaGetFile(
+    const crow::Request& req,
+    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+    const std::string& schema, const std::string& schemaFile)
+{
+    // Schema path should look like /redfish/v1/JsonSchemas/Foo/Foo.x.json
+    // Make sure the two paths match.  Only files that were listed in the
+    // directory can be served, so the name needs no further checking.
+    JsonSchemaIndex& index = JsonSchemaIndex::getInstance();
+    if (!schemaFile.starts_with(schema) || !index.hasFile(schemaFile))
     {
         messages::resourceNotFound(asyncResp->res, "JsonSchemaFile", schema);
         return;
     }
-    if (ec == crow::OpenCode::InternalError)
+
+    std::shared_ptr<const crow::webassets::StaticPayload> payload =
+        index.getFile(schemaFile);
+    if (payload == nullptr)
     {
         BMCWEB_LOG_DEBUG("failed to read file");
         messages::internalError(asyncResp->res);
         return;
     }
+    crow::webassets::handleStaticPayload(req, asyncResp, payload);
 }
 
 inline void requestRoutesRedfish(App& app)
 {
+    // Build the schema index at startup rather than on the first request
+    JsonSchemaIndex::getInstance();
+
     BMCWEB_ROUTE(app, "/redfish/")
         .methods(boost::beast::http::verb::get)(
             std::bind_front(redfishGet, std::ref(app)));
@@ -733,7 +733,7 @@ inline void afterChassisDriveCollectionSubtreeGet(
                     leafNames.push_back(drivePath.filename());
                 }
 
-                std::ranges::sort(leafNames, AlphanumLess<std::string>());
+                naturalSort(leafNames);
 
                 for (const auto& leafName : leafNames)
                 {
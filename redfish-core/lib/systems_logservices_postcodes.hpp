@@ -28,6 +28,7 @@
 #include <boost/beast/http/status.hpp>
 #include <boost/beast/http/verb.hpp>
 #include <boost/container/flat_map.hpp>
+#include <boost/system/error_code.hpp>
 #include <boost/url/format.hpp>
 
 #include <algorithm>
@@ -40,6 +41,8 @@
 #include <iomanip>
 #include <ios>
 #include <memory>
+#include <optional>
+#include <span>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -376,84 +379,327 @@ inline void getPostCodeForEntry(
         bootIndex);
 }
 
-inline void getPostCodeForBoot(
-    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-    const uint16_t bootIndex, const uint16_t bootCount,
-    const uint64_t entryCount, size_t skip, size_t top)
+using PostCodes = boost::container::flat_map<
+    uint64_t, std::tuple<std::vector<uint8_t>, std::vector<uint8_t>>>;
+
+// The most GetPostCodesWithTimeStamp calls one collection request makes at
+// once, so that a deep page doesn't queue every retained boot cycle on the
+// post code manager at the same time
+constexpr size_t maxParallelPostCodeReads = 4;
+
+// Entry counts of the boot cycles before the current one.  Those logs are
+// complete, but boot cycles are numbered from the current one, so every
+// boot renumbers them.  The counts are only kept for the boot they were
+// read in, identified by CurrentBootCycleCount and the time of its first
+// POST code.
+struct PostCodeCountCache
 {
-    dbus::utility::async_method_call(
-        asyncResp,
-        [asyncResp, bootIndex, bootCount, entryCount, skip,
-         top](const boost::system::error_code& ec,
-              const boost::container::flat_map<
-                  uint64_t, std::tuple<std::vector<uint8_t>,
-                                       std::vector<uint8_t>>>& postcode) {
-            if (ec)
+    uint16_t bootCount = 0;
+    uint64_t currentBootStart = 0;
+    // Indexed by boot cycle.  The current boot cycle, 1, is still growing,
+    // and is never cached.
+    std::vector<std::optional<uint64_t>> counts;
+
+    // Drops the counts if they were read during a different boot.  A boot
+    // that has no POST codes yet can't be told apart from the one before
+    // it, so nothing is cached until it has one.
+    void validate(uint16_t bootCountIn, uint64_t currentBootStartIn)
+    {
+        if (bootCountIn == bootCount && currentBootStartIn != 0 &&
+            currentBootStartIn == currentBootStart)
+        {
+            return;
+        }
+        bootCount = bootCountIn;
+        currentBootStart = currentBootStartIn;
+        counts.clear();
+        if (currentBootStart != 0)
+        {
+            counts.resize(static_cast<size_t>(bootCount) + 1);
+        }
+    }
+};
+
+inline PostCodeCountCache& getPostCodeCountCache()
+{
+    static PostCodeCountCache cache;
+    return cache;
+}
+
+/**
+ * @brief Finds the boot cycles that hold a page of the collection
+ *
+ * @param[in] counts  Entry count of each boot cycle, indexed from 1
+ * @param[in] skip    Entries before the page
+ * @param[in] top     Entries in the page
+ *
+ * @return The boot cycles with entries in the page, in collection order
+ */
+inline std::vector<uint16_t> getPostCodeBootsInPage(
+    std::span<const uint64_t> counts, size_t skip, size_t top)
+{
+    std::vector<uint16_t> boots;
+    uint64_t entryCount = 0;
+    for (size_t bootIndex = 1; bootIndex < counts.size(); bootIndex++)
+    {
+        uint64_t endCount = entryCount + counts[bootIndex];
+        if (counts[bootIndex] != 0 && skip < endCount &&
+            (top + skip) > entryCount)
+        {
+            boots.emplace_back(static_cast<uint16_t>(bootIndex));
+        }
+        entryCount = endCount;
+    }
+    return boots;
+}
+
+// Reads one page of the PostCodes collection.  Only the boot cycles that
+// overlap the page are fetched, along with the counts of the others that
+// aren't cached yet, with up to maxParallelPostCodeReads calls in flight.
+class PostCodePageReader :
+    public std::enable_shared_from_this<PostCodePageReader>
+{
+  public:
+    using PostCodesCallback =
+        std::function<void(const boost::system::error_code&, const PostCodes&)>;
+    // Sends one GetPostCodesWithTimeStamp call for a boot cycle
+    using PostCodesReader =
+        std::function<void(uint16_t bootIndex, PostCodesCallback&& callback)>;
+
+    PostCodePageReader(const std::shared_ptr<bmcweb::AsyncResp>& asyncRespIn,
+                       uint16_t bootCount, size_t skipIn, size_t topIn,
+                       PostCodesReader&& readPostCodesIn = readFromDbus) :
+        asyncResp(asyncRespIn),
+        counts(static_cast<size_t>(std::max<uint16_t>(bootCount, 1)) + 1),
+        skip(skipIn), top(topIn), readPostCodes(std::move(readPostCodesIn))
+    {}
+
+    void start()
+    {
+        // The current boot cycle is read every time, both because it may
+        // still be growing, and because it tells whether the cache is valid
+        readBoots({1}, true,
+                  std::bind_front(&PostCodePageReader::afterCurrentBoot,
+                                  shared_from_this()));
+    }
+
+  private:
+    static void readFromDbus(uint16_t bootIndex, PostCodesCallback&& callback)
+    {
+        dbus::utility::async_method_call(
+            [callback = std::move(callback)](
+                const boost::system::error_code& ec,
+                const PostCodes& postcode) { callback(ec, postcode); },
+            "xyz.openbmc_project.State.Boot.PostCode0",
+            "/xyz/openbmc_project/State/Boot/PostCode0",
+            "xyz.openbmc_project.State.Boot.PostCode",
+            "GetPostCodesWithTimeStamp", bootIndex);
+    }
+
+    uint16_t lastBoot() const
+    {
+        return static_cast<uint16_t>(counts.size() - 1);
+    }
+
+    void afterCurrentBoot()
+    {
+        const PostCodes& currentBoot = pages[1];
+        if (!currentBoot.empty())
+        {
+            currentBootStart = currentBoot.begin()->first;
+        }
+        PostCodeCountCache& cache = getPostCodeCountCache();
+        cache.validate(lastBoot(), currentBootStart);
+
+        std::vector<uint16_t> uncounted;
+        for (uint16_t bootIndex = 2; bootIndex <= lastBoot(); bootIndex++)
+        {
+            if (bootIndex < cache.counts.size() && cache.counts[bootIndex])
             {
-                BMCWEB_LOG_DEBUG("DBUS POST CODE PostCode response error");
-                messages::internalError(asyncResp->res);
-                return;
+                counts[bootIndex] = *cache.counts[bootIndex];
+                continue;
             }
+            uncounted.emplace_back(bootIndex);
+        }
+        readBoots(std::move(uncounted), false,
+                  std::bind_front(&PostCodePageReader::afterCounts,
+                                  shared_from_this()));
+    }
 
-            uint64_t endCount = entryCount;
-            if (!postcode.empty())
+    void afterCounts()
+    {
+        // Another request may have seen a new boot in the meantime
+        PostCodeCountCache& cache = getPostCodeCountCache();
+        if (currentBootStart != 0 &&
+            cache.currentBootStart == currentBootStart &&
+            cache.counts.size() == counts.size())
+        {
+            for (uint16_t bootIndex = 2; bootIndex <= lastBoot(); bootIndex++)
             {
-                endCount = entryCount + postcode.size();
-                if (skip < endCount && (top + skip) > entryCount)
-                {
-                    uint64_t thisBootSkip =
-                        std::max(static_cast<uint64_t>(skip), entryCount) -
-                        entryCount;
-                    uint64_t thisBootTop =
-                        std::min(static_cast<uint64_t>(top + skip), endCount) -
-                        entryCount;
-
-                    fillPostCodeEntry(asyncResp, postcode, bootIndex, 0,
-                                      thisBootSkip, thisBootTop);
-                }
-                asyncResp->res.jsonValue["Members@odata.count"] = endCount;
+                cache.counts[bootIndex] = counts[bootIndex];
             }
+        }
 
-            // continue to previous bootIndex
-            if (bootIndex < bootCount)
+        std::vector<uint16_t> unread;
+        for (uint16_t bootIndex : getPostCodeBootsInPage(counts, skip, top))
+        {
+            if (!pages.contains(bootIndex))
             {
-                getPostCodeForBoot(asyncResp,
-                                   static_cast<uint16_t>(bootIndex + 1),
-                                   bootCount, endCount, skip, top);
+                unread.emplace_back(bootIndex);
             }
-            else if (skip + top < endCount)
+        }
+        readBoots(std::move(unread), true,
+                  std::bind_front(&PostCodePageReader::fillPage,
+                                  shared_from_this()));
+    }
+
+    void fillPage()
+    {
+        uint64_t entryCount = 0;
+        for (uint16_t bootIndex = 1; bootIndex <= lastBoot(); bootIndex++)
+        {
+            uint64_t endCount = entryCount + counts[bootIndex];
+            auto page = pages.find(bootIndex);
+            if (page != pages.end() && skip < endCount &&
+                (top + skip) > entryCount)
             {
-                asyncResp->res.jsonValue["Members@odata.nextLink"] =
-                    std::format(
-                        "/redfish/v1/Systems/{}/LogServices/PostCodes/Entries?$skip=",
-                        BMCWEB_REDFISH_SYSTEM_URI_NAME) +
-                    std::to_string(skip + top);
+                uint64_t thisBootSkip =
+                    std::max(static_cast<uint64_t>(skip), entryCount) -
+                    entryCount;
+                uint64_t thisBootTop =
+                    std::min(static_cast<uint64_t>(top + skip), endCount) -
+                    entryCount;
+
+                fillPostCodeEntry(asyncResp, page->second, bootIndex, 0,
+                                  thisBootSkip, thisBootTop);
             }
-        },
-        "xyz.openbmc_project.State.Boot.PostCode0",
-        "/xyz/openbmc_project/State/Boot/PostCode0",
-        "xyz.openbmc_project.State.Boot.PostCode", "GetPostCodesWithTimeStamp",
-        bootIndex);
-}
+            entryCount = endCount;
+        }
+        asyncResp->res.jsonValue["Members@odata.count"] = entryCount;
+        if (skip + top < entryCount)
+        {
+            asyncResp->res.jsonValue["Members@odata.nextLink"] =
+                std::format(
+                    "/redfish/v1/Systems/{}/LogServices/PostCodes/Entries?$skip=",
+                    BMCWEB_REDFISH_SYSTEM_URI_NAME) +
+                std::to_string(skip + top);
+        }
+    }
+
+    // Reads the POST codes of boots, counting each, and keeping the codes
+    // themselves if keepCodes is set, then calls then
+    void readBoots(std::vector<uint16_t>&& boots, bool keepCodes,
+                   std::function<void()>&& then)
+    {
+        queue = std::move(boots);
+        nextRead = 0;
+        keep = keepCodes;
+        afterReads = std::move(then);
+        if (queue.empty())
+        {
+            runAfterReads();
+            return;
+        }
+        while (inFlight < maxParallelPostCodeReads && nextRead < queue.size())
+        {
+            readNext();
+        }
+    }
+
+    void readNext()
+    {
+        uint16_t bootIndex = queue[nextRead];
+        nextRead++;
+        inFlight++;
+        readPostCodes(bootIndex, [self = shared_from_this(), bootIndex](
+                                     const boost::system::error_code& ec,
+                                     const PostCodes& postcode) {
+            self->afterRead(bootIndex, ec, postcode);
+        });
+    }
+
+    void afterRead(uint16_t bootIndex, const boost::system::error_code& ec,
+                   const PostCodes& postcode)
+    {
+        inFlight--;
+        if (ec && !failed)
+        {
+            BMCWEB_LOG_DEBUG("DBUS POST CODE PostCode response error");
+            messages::internalError(asyncResp->res);
+            failed = true;
+        }
+        if (failed)
+        {
+            // The continuation holds this reader, and with it the response,
+            // so it's dropped once the last read in flight has returned
+            if (inFlight == 0)
+            {
+                queue.clear();
+                afterReads = nullptr;
+            }
+            return;
+        }
+        counts[bootIndex] = postcode.size();
+        if (keep)
+        {
+            pages.insert_or_assign(bootIndex, postcode);
+        }
+        if (nextRead < queue.size())
+        {
+            readNext();
+            return;
+        }
+        if (inFlight == 0)
+        {
+            runAfterReads();
+        }
+    }
+
+    void runAfterReads()
+    {
+        std::function<void()> then = std::move(afterReads);
+        afterReads = nullptr;
+        then();
+    }
+
+    std::shared_ptr<bmcweb::AsyncResp> asyncResp;
+    // Entry count of each boot cycle, indexed from 1
+    std::vector<uint64_t> counts;
+    // The codes of the boot cycles that were kept
+    boost::container::flat_map<uint16_t, PostCodes> pages;
+    // Time of the first POST code of the current boot cycle, if it has one
+    uint64_t currentBootStart = 0;
+    size_t skip;
+    size_t top;
+
+    std::vector<uint16_t> queue;
+    size_t nextRead = 0;
+    size_t inFlight = 0;
+    bool keep = false;
+    bool failed = false;
+    std::function<void()> afterReads;
+    PostCodesReader readPostCodes;
+};
 
 inline void getCurrentBootNumber(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp, size_t skip,
     size_t top)
 {
-    uint64_t entryCount = 0;
     dbus::utility::getProperty<uint16_t>(
         "xyz.openbmc_project.State.Boot.PostCode0",
         "/xyz/openbmc_project/State/Boot/PostCode0",
         "xyz.openbmc_project.State.Boot.PostCode", "CurrentBootCycleCount",
-        [asyncResp, entryCount, skip,
-         top](const boost::system::error_code& ec, const uint16_t bootCount) {
+        [asyncResp, skip, top](const boost::system::error_code& ec,
+                               const uint16_t bootCount) {
             if (ec)
             {
                 BMCWEB_LOG_DEBUG("DBUS response error {}", ec);
                 messages::internalError(asyncResp->res);
                 return;
             }
-            getPostCodeForBoot(asyncResp, 1, bootCount, entryCount, skip, top);
+            std::make_shared<PostCodePageReader>(asyncResp, bootCount, skip,
+                                                 top)
+                ->start();
         });
 }
 
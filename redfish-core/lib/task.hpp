@@ -20,8 +20,9 @@
 #include "utils/etag_utils.hpp"
 #include "utils/time_utils.hpp"
 
+#include <systemd/sd-bus.h>
+
 #include <boost/asio/error.hpp>
-#include <boost/asio/post.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/status.hpp>
@@ -32,9 +33,11 @@
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/message.hpp>
+#include <sdbusplus/message/native_types.hpp>
 
 #include <algorithm>
 #include <array>
+#include <charconv>
 #include <chrono>
 #include <cstddef>
 #include <ctime>
@@ -45,7 +48,10 @@
 #include <ranges>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace redfish
 {
@@ -56,6 +62,9 @@ constexpr size_t maxTaskCount = 100; // arbitrary limit
 
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 static std::deque<std::shared_ptr<struct TaskData>> tasks;
+// The same tasks, by index
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static std::unordered_map<size_t, std::shared_ptr<TaskData>> taskIndex;
 
 constexpr bool completed = true;
 
@@ -102,14 +111,255 @@ struct Payload
     nlohmann::json jsonBody;
 };
 
+// The PropertiesChanged signals a task waits on
+struct TaskMatch
+{
+    // Tasks following objects under the same namespace share a bus match
+    std::string pathNamespace;
+    // The object followed, or empty for every object in the namespace
+    std::string path;
+    // Only signals for interfaces under this namespace, if not empty
+    std::string interfaceNamespace;
+};
+
+// The PropertiesChanged signals of the object at path
+inline TaskMatch propertiesChangedOf(
+    const sdbusplus::message::object_path& path)
+{
+    return {path.parent_path().str, path.str, ""};
+}
+
+inline std::string taskMatchRule(const TaskMatch& match)
+{
+    std::string rule =
+        "type='signal',interface='org.freedesktop.DBus.Properties',"
+        "member='PropertiesChanged',path_namespace='";
+    rule += match.pathNamespace;
+    rule += "'";
+    if (!match.interfaceNamespace.empty())
+    {
+        rule += ",arg0namespace='";
+        rule += match.interfaceNamespace;
+        rule += "'";
+    }
+    return rule;
+}
+
+// Routes the signals tasks wait on.  Rather than a bus match per task, there
+// is one per namespace and interface, shared by the tasks following objects
+// in it, so the number of matches stays bounded however many tasks run.
+// Each signal goes to the tasks following the object it came from.
+class TaskMatchDispatcher
+{
+  public:
+    using Handler = std::function<void(sdbusplus::message_t&)>;
+    // Installs the bus match for a rule
+    using Watcher = std::function<std::unique_ptr<sdbusplus::bus::match_t>(
+        const std::string& rule, Handler&& handler)>;
+
+    explicit TaskMatchDispatcher(Watcher&& watcherIn) :
+        watcher(std::move(watcherIn))
+    {}
+
+    // Calls handler with the signals of match until it's removed, with the
+    // id returned
+    size_t add(const TaskMatch& match, Handler&& handler)
+    {
+        std::string rule = taskMatchRule(match);
+        size_t id = lastId++;
+        auto [watch, inserted] = watches.try_emplace(rule);
+        if (inserted)
+        {
+            watch->second.match =
+                watcher(rule, [this, rule](sdbusplus::message_t& msg) {
+                    dispatch(rule, msg.get_path(), msg);
+                });
+        }
+        if (match.path.empty())
+        {
+            watch->second.all.emplace_back(id);
+        }
+        else
+        {
+            watch->second.byPath[match.path].emplace_back(id);
+        }
+        handlers.try_emplace(id, std::move(rule), match.path,
+                             std::move(handler));
+        return id;
+    }
+
+    void remove(size_t id)
+    {
+        auto registration = handlers.find(id);
+        if (registration == handlers.end())
+        {
+            return;
+        }
+        const Registration& reg = registration->second;
+        auto watch = watches.find(reg.rule);
+        if (watch != watches.end())
+        {
+            if (reg.path.empty())
+            {
+                std::erase(watch->second.all, id);
+            }
+            else
+            {
+                auto followers = watch->second.byPath.find(reg.path);
+                if (followers != watch->second.byPath.end())
+                {
+                    std::erase(followers->second, id);
+                    if (followers->second.empty())
+                    {
+                        watch->second.byPath.erase(followers);
+                    }
+                }
+            }
+            // A match can't be destroyed from its own callback, so one
+            // emptied while dispatching goes once the dispatch is done
+            if (watch->second.empty() && dispatching == 0)
+            {
+                watches.erase(watch);
+            }
+        }
+        handlers.erase(registration);
+    }
+
+    void dispatch(const std::string& rule, const std::string& path,
+                  sdbusplus::message_t& msg)
+    {
+        auto watch = watches.find(rule);
+        if (watch == watches.end())
+        {
+            return;
+        }
+        std::vector<size_t> ids = watch->second.all;
+        auto followers = watch->second.byPath.find(path);
+        if (followers != watch->second.byPath.end())
+        {
+            ids.insert(ids.end(), followers->second.begin(),
+                       followers->second.end());
+        }
+
+        dispatching++;
+        bool first = true;
+        for (size_t id : ids)
+        {
+            auto registration = handlers.find(id);
+            if (registration == handlers.end())
+            {
+                continue; // removed by an earlier handler
+            }
+            // Each handler reads the message from the start, as it would
+            // with a match of its own
+            if (!first && msg.get() != nullptr)
+            {
+                sd_bus_message_rewind(msg.get(), 1);
+            }
+            first = false;
+            // The handler may remove itself
+            Handler handler = registration->second.handler;
+            handler(msg);
+        }
+        dispatching--;
+
+        if (dispatching == 0)
+        {
+            std::erase_if(watches,
+                          [](const auto& item) { return item.second.empty(); });
+        }
+    }
+
+    // Number of bus matches installed
+    size_t matchCount() const
+    {
+        return watches.size();
+    }
+
+  private:
+    struct Watch
+    {
+        std::unique_ptr<sdbusplus::bus::match_t> match;
+        std::unordered_map<std::string, std::vector<size_t>> byPath;
+        std::vector<size_t> all;
+
+        bool empty() const
+        {
+            return byPath.empty() && all.empty();
+        }
+    };
+
+    struct Registration
+    {
+        Registration(std::string ruleIn, std::string pathIn,
+                     Handler&& handlerIn) :
+            rule(std::move(ruleIn)), path(std::move(pathIn)),
+            handler(std::move(handlerIn))
+        {}
+
+        std::string rule;
+        std::string path;
+        Handler handler;
+    };
+
+    Watcher watcher;
+    std::unordered_map<std::string, Watch> watches;
+    std::unordered_map<size_t, Registration> handlers;
+    size_t lastId = 0;
+    size_t dispatching = 0;
+};
+
+inline TaskMatchDispatcher& getTaskMatchDispatcher()
+{
+    static TaskMatchDispatcher dispatcher(
+        [](const std::string& rule, TaskMatchDispatcher::Handler&& handler) {
+            return std::make_unique<sdbusplus::bus::match_t>(
+                static_cast<sdbusplus::bus_t&>(*crow::connections::systemBus),
+                rule, std::move(handler));
+        });
+    return dispatcher;
+}
+
+// The index a task Id names, only in the form the Id is given out in
+inline std::optional<size_t> parseTaskIndex(std::string_view id)
+{
+    if (id.size() > 1 && id.front() == '0')
+    {
+        return std::nullopt;
+    }
+    size_t index = 0;
+    const char* end = id.data() + id.size();
+    auto [ptr, ec] = std::from_chars(id.data(), end, index);
+    if (ec != std::errc() || ptr != end)
+    {
+        return std::nullopt;
+    }
+    return index;
+}
+
+inline std::shared_ptr<TaskData> findTask(std::string_view id)
+{
+    std::optional<size_t> index = parseTaskIndex(id);
+    if (!index)
+    {
+        return nullptr;
+    }
+    auto task = taskIndex.find(*index);
+    if (task == taskIndex.end())
+    {
+        return nullptr;
+    }
+    return task->second;
+}
+
 struct TaskData : std::enable_shared_from_this<TaskData>
 {
   private:
     TaskData(
         std::function<bool(boost::system::error_code, sdbusplus::message_t&,
                            const std::shared_ptr<TaskData>&)>&& handler,
-        const std::string& matchIn, size_t idx) :
-        callback(std::move(handler)), matchStr(matchIn), index(idx),
+        TaskMatch&& matchIn, size_t idx) :
+        callback(std::move(handler)), match(std::move(matchIn)), index(idx),
         startTime(std::chrono::system_clock::to_time_t(
             std::chrono::system_clock::now())),
         status("OK"), state("Running"), messages(nlohmann::json::array()),
@@ -123,7 +373,7 @@ struct TaskData : std::enable_shared_from_this<TaskData>
     static std::shared_ptr<TaskData>& createTask(
         std::function<bool(boost::system::error_code, sdbusplus::message_t&,
                            const std::shared_ptr<TaskData>&)>&& handler,
-        const std::string& match)
+        TaskMatch&& match)
     {
         static size_t lastTask = 0;
         struct MakeSharedHelper : public TaskData
@@ -132,8 +382,8 @@ struct TaskData : std::enable_shared_from_this<TaskData>
                 std::function<bool(boost::system::error_code,
                                    sdbusplus::message_t&,
                                    const std::shared_ptr<TaskData>&)>&& handler,
-                const std::string& match2, size_t idx) :
-                TaskData(std::move(handler), match2, idx)
+                TaskMatch&& match2, size_t idx) :
+                TaskData(std::move(handler), std::move(match2), idx)
             {}
         };
 
@@ -143,12 +393,16 @@ struct TaskData : std::enable_shared_from_this<TaskData>
 
             // destroy all references
             (*last)->timer.cancel();
-            (*last)->match.reset();
+            (*last)->stopWatching();
+            taskIndex.erase((*last)->index);
             tasks.erase(last);
         }
 
-        return tasks.emplace_back(std::make_shared<MakeSharedHelper>(
-            std::move(handler), match, lastTask++));
+        std::shared_ptr<TaskData>& task =
+            tasks.emplace_back(std::make_shared<MakeSharedHelper>(
+                std::move(handler), std::move(match), lastTask++));
+        taskIndex.emplace(task->index, task);
+        return task;
     }
 
     /**
@@ -240,7 +494,7 @@ struct TaskData : std::enable_shared_from_this<TaskData>
                     // change ec to error as timer expired
                     ec = boost::asio::error::operation_aborted;
                 }
-                self->match.reset();
+                self->stopWatching();
                 sdbusplus::message_t msg;
                 self->finishTask();
                 self->state = "Cancelled";
@@ -312,15 +566,24 @@ struct TaskData : std::enable_shared_from_this<TaskData>
                                                      "Task");
     }
 
+    // Stops delivering signals to the task
+    void stopWatching()
+    {
+        if (watchId)
+        {
+            getTaskMatchDispatcher().remove(*watchId);
+            watchId = std::nullopt;
+        }
+    }
+
     void startTimer(const std::chrono::seconds& timeout)
     {
-        if (match)
+        if (watchId)
         {
             return;
         }
-        match = std::make_unique<sdbusplus::bus::match_t>(
-            static_cast<sdbusplus::bus_t&>(*crow::connections::systemBus),
-            matchStr,
+        watchId = getTaskMatchDispatcher().add(
+            match,
             [self = shared_from_this()](sdbusplus::message_t& message) {
                 boost::system::error_code ec;
 
@@ -334,10 +597,7 @@ struct TaskData : std::enable_shared_from_this<TaskData>
                     // Send event
                     sendTaskEvent(self->state, self->index);
 
-                    // reset the match after the callback was successful
-                    boost::asio::post(
-                        crow::connections::systemBus->get_io_context(),
-                        [self] { self->match.reset(); });
+                    self->stopWatching();
                     return;
                 }
             });
@@ -351,14 +611,14 @@ struct TaskData : std::enable_shared_from_this<TaskData>
     std::function<bool(boost::system::error_code, sdbusplus::message_t&,
                        const std::shared_ptr<TaskData>&)>
         callback;
-    std::string matchStr;
+    TaskMatch match;
     size_t index;
     time_t startTime;
     std::string status;
     std::string state;
     nlohmann::json messages;
     boost::asio::steady_timer timer;
-    std::unique_ptr<sdbusplus::bus::match_t> match;
+    std::optional<size_t> watchId;
     std::optional<time_t> endTime;
     std::optional<Payload> payload;
     bool gave204 = false;
@@ -379,26 +639,14 @@ inline void requestRoutesTaskMonitor(App& app)
                 {
                     return;
                 }
-                auto find = std::ranges::find_if(
-                    task::tasks,
-                    [&strParam](const std::shared_ptr<task::TaskData>& task) {
-                        if (!task)
-                        {
-                            return false;
-                        }
-
-                        // we compare against the string version as on failure
-                        // strtoul returns 0
-                        return std::to_string(task->index) == strParam;
-                    });
-
-                if (find == task::tasks.end())
+                std::shared_ptr<task::TaskData> ptr =
+                    task::findTask(strParam);
+                if (ptr == nullptr)
                 {
                     messages::resourceNotFound(asyncResp->res, "Task",
                                                strParam);
                     return;
                 }
-                std::shared_ptr<task::TaskData>& ptr = *find;
                 // monitor expires after 204
                 if (ptr->gave204)
                 {
@@ -422,28 +670,15 @@ inline void requestRoutesTask(App& app)
                 {
                     return;
                 }
-                auto find = std::ranges::find_if(
-                    task::tasks,
-                    [&strParam](const std::shared_ptr<task::TaskData>& task) {
-                        if (!task)
-                        {
-                            return false;
-                        }
-
-                        // we compare against the string version as on failure
-                        // strtoul returns 0
-                        return std::to_string(task->index) == strParam;
-                    });
-
-                if (find == task::tasks.end())
+                std::shared_ptr<task::TaskData> ptr =
+                    task::findTask(strParam);
+                if (ptr == nullptr)
                 {
                     messages::resourceNotFound(asyncResp->res, "Task",
                                                strParam);
                     return;
                 }
 
-                const std::shared_ptr<task::TaskData>& ptr = *find;
-
                 asyncResp->res.jsonValue["@odata.type"] = "#Task.v1_4_3.Task";
                 asyncResp->res.jsonValue["Id"] = strParam;
                 asyncResp->res.jsonValue["Name"] = "Task " + strParam;
@@ -4,8 +4,6 @@
 
 #include "app.hpp"
 #include "async_resp.hpp"
-#include "dbus_singleton.hpp"
-#include "dbus_utility.hpp"
 #include "error_messages.hpp"
 #include "http_request.hpp"
 #include "logging.hpp"
@@ -33,49 +31,42 @@
 
 namespace redfish
 {
-inline void afterGetTemperatureValue(
+inline void afterGetTemperatureValues(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-    const std::string& chassisId, const std::string& path,
-    const boost::system::error_code& ec,
-    const dbus::utility::DBusPropertiesMap& valuesDict)
+    const std::string& chassisId, const boost::system::error_code& ec,
+    sensor_utils::SensorPropertiesList& sensorProperties)
 {
-    if (ec)
+    if (ec && ec.value() != EBADR)
     {
-        if (ec.value() != EBADR)
-        {
-            BMCWEB_LOG_ERROR("DBUS response error for getAllProperties {}",
-                             ec.value());
-            messages::internalError(asyncResp->res);
-        }
+        BMCWEB_LOG_ERROR("DBUS response error for getAllProperties {}",
+                         ec.value());
+        messages::internalError(asyncResp->res);
         return;
     }
 
-    nlohmann::json item = nlohmann::json::object();
-
-    /* Don't return an error for a failure to fill in properties from any of
-     * the sensors in the list. Just skip it.
-     */
-    if (sensor_utils::objectExcerptToJson(
-            path, chassisId, sensor_utils::ChassisSubNode::thermalMetricsNode,
-            "temperature", valuesDict, item))
+    nlohmann::json::array_t temperatureArray;
+    temperatureArray.reserve(sensorProperties.size());
+    for (const sensor_utils::SensorProperties& sensor : sensorProperties)
     {
-        nlohmann::json& temperatureReadings =
-            asyncResp->res.jsonValue["TemperatureReadingsCelsius"];
-        nlohmann::json::array_t* temperatureArray =
-            temperatureReadings.get_ptr<nlohmann::json::array_t*>();
-        if (temperatureArray == nullptr)
+        nlohmann::json item = nlohmann::json::object();
+
+        /* Don't return an error for a failure to fill in properties from any
+         * of the sensors in the list. Just skip it.
+         */
+        if (sensor_utils::objectExcerptToJson(
+                sensor.path, chassisId,
+                sensor_utils::ChassisSubNode::thermalMetricsNode,
+                "temperature", sensor.properties, item))
         {
-            BMCWEB_LOG_ERROR("Missing TemperatureReadingsCelsius Json array");
-            messages::internalError(asyncResp->res);
-            return;
+            temperatureArray.emplace_back(std::move(item));
         }
-
-        temperatureArray->emplace_back(std::move(item));
-        asyncResp->res.jsonValue["TemperatureReadingsCelsius@odata.count"] =
-            temperatureArray->size();
-
-        json_util::sortJsonArrayByKey(*temperatureArray, "DataSourceUri");
     }
+    json_util::sortJsonArrayByKey(temperatureArray, "DataSourceUri");
+
+    asyncResp->res.jsonValue["TemperatureReadingsCelsius@odata.count"] =
+        temperatureArray.size();
+    asyncResp->res.jsonValue["TemperatureReadingsCelsius"] =
+        std::move(temperatureArray);
 }
 
 inline void handleTemperatureReadingsCelsius(
@@ -94,22 +85,10 @@ inline void handleTemperatureReadingsCelsius(
         return;
     }
 
-    asyncResp->res.jsonValue["TemperatureReadingsCelsius"] =
-        nlohmann::json::array_t();
-    asyncResp->res.jsonValue["TemperatureReadingsCelsius@odata.count"] = 0;
-
-    for (const auto& [service, sensorPath] : sensorsServiceAndPath)
-    {
-        dbus::utility::getAllProperties(
-            *crow::connections::systemBus, service, sensorPath,
-            "xyz.openbmc_project.Sensor.Value",
-            [asyncResp, chassisId,
-             sensorPath](const boost::system::error_code& ec1,
-                         const dbus::utility::DBusPropertiesMap& properties) {
-                afterGetTemperatureValue(asyncResp, chassisId, sensorPath, ec1,
-                                         properties);
-            });
-    }
+    // Read all sensors of a service at once, rather than one call per sensor
+    sensor_utils::getSensorPropertiesByService(
+        sensorsServiceAndPath, "xyz.openbmc_project.Sensor.Value",
+        std::bind_front(afterGetTemperatureValues, asyncResp, chassisId));
 }
 
 inline void getTemperatureReadingsCelsius(
@@ -12,6 +12,7 @@
 #include "error_messages.hpp"
 #include "generated/enums/resource.hpp"
 #include "generated/enums/update_service.hpp"
+#include "http_body.hpp"
 #include "http_request.hpp"
 #include "http_response.hpp"
 #include "io_context_singleton.hpp"
@@ -21,6 +22,7 @@
 #include "query.hpp"
 #include "registries/privilege_registry.hpp"
 #include "str_utility.hpp"
+#include "streamed_image.hpp"
 #include "task.hpp"
 #include "task_messages.hpp"
 #include "utility.hpp"
@@ -44,7 +46,6 @@
 #include <boost/url/url.hpp>
 #include <boost/url/url_view.hpp>
 #include <boost/url/url_view_base.hpp>
-#include <sdbusplus/asio/property.hpp>
 #include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/message.hpp>
 #include <sdbusplus/message/native_types.hpp>
@@ -86,41 +87,6 @@ static std::unique_ptr<boost::asio::steady_timer> fwAvailableTimer;
 /* @brief String that indicates the Software Update D-Bus interface */
 constexpr const char* updateInterface = "xyz.openbmc_project.Software.Update";
 
-struct MemoryFileDescriptor
-{
-    int fd = -1;
-
-    explicit MemoryFileDescriptor(const std::string& filename) :
-        fd(memfd_create(filename.c_str(), 0))
-    {}
-
-    MemoryFileDescriptor(const MemoryFileDescriptor&) = default;
-    MemoryFileDescriptor(MemoryFileDescriptor&& other) noexcept : fd(other.fd)
-    {
-        other.fd = -1;
-    }
-    MemoryFileDescriptor& operator=(const MemoryFileDescriptor&) = delete;
-    MemoryFileDescriptor& operator=(MemoryFileDescriptor&&) = default;
-
-    ~MemoryFileDescriptor()
-    {
-        if (fd != -1)
-        {
-            close(fd);
-        }
-    }
-
-    bool rewind() const
-    {
-        if (lseek(fd, 0, SEEK_SET) == -1)
-        {
-            BMCWEB_LOG_ERROR("Failed to seek to beginning of image memfd");
-            return false;
-        }
-        return true;
-    }
-};
-
 inline void cleanUp()
 {
     fwUpdateInProgress = false;
@@ -132,7 +98,7 @@ inline void activateImage(const std::string& objPath,
                           const std::string& service)
 {
     BMCWEB_LOG_DEBUG("Activate image for {} {}", objPath, service);
-    sdbusplus::asio::setProperty(
+    dbus::utility::setProperty(
         *crow::connections::systemBus, service, objPath,
         "xyz.openbmc_project.Software.Activation", "RequestedActivation",
         "xyz.openbmc_project.Software.Activation.RequestedActivations.Active",
@@ -251,10 +217,7 @@ inline void createTask(const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
                        const sdbusplus::message::object_path& objPath)
 {
     std::shared_ptr<task::TaskData> task = task::TaskData::createTask(
-        std::bind_front(handleCreateTask),
-        "type='signal',interface='org.freedesktop.DBus.Properties',"
-        "member='PropertiesChanged',path='" +
-            objPath.str + "'");
+        std::bind_front(handleCreateTask), task::propertiesChangedOf(objPath));
     task->startTimer(std::chrono::minutes(5));
     task->payload.emplace(std::move(payload));
     task->populateResp(asyncResp->res);
@@ -626,20 +589,14 @@ inline void handleUpdateServiceSimpleUpdateAction(
     BMCWEB_LOG_DEBUG("Exit UpdateService.SimpleUpdate doPost");
 }
 
-inline void uploadImageFile(crow::Response& res, std::string_view body)
+// Copies an image that was streamed into a memfd, in the kernel
+inline void uploadImageFile(crow::Response& res,
+                            const bmcweb::StreamedImage& image)
 {
-    std::filesystem::path filepath("/tmp/images/" + bmcweb::getRandomUUID());
-
-    BMCWEB_LOG_DEBUG("Writing file to {}", filepath.string());
-    std::ofstream out(filepath, std::ofstream::out | std::ofstream::binary |
-                                    std::ofstream::trunc);
-    // set the permission of the file to 640
-    std::filesystem::perms permission =
-        std::filesystem::perms::owner_read | std::filesystem::perms::group_read;
-    std::filesystem::permissions(filepath, permission);
-    out << body;
+    std::string filepath = "/tmp/images/" + bmcweb::getRandomUUID();
 
-    if (out.bad())
+    BMCWEB_LOG_DEBUG("Writing file to {}", filepath);
+    if (!image.copyTo(filepath))
     {
         messages::internalError(res);
         cleanUp();
@@ -689,7 +646,6 @@ inline void setApplyTime(const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
 
 struct MultiPartUpdate
 {
-    std::string uploadData;
     struct UpdateParameters
     {
         std::optional<std::string> applyTime;
@@ -744,6 +700,114 @@ inline std::optional<std::string> parseFormPartName(
     return std::nullopt;
 }
 
+// Parses a multipart update as the body is read.  The UpdateFile part is
+// streamed into the image memfd, so the image is never held in memory by
+// bmcweb.  The other parts are small, and are
+// kept in the parser for extractMultipartUpdateParameters().
+class MultipartUpdateSink : public bmcweb::BodySink
+{
+  public:
+    // Limit on the parts other than the image, UpdateParameters being a
+    // short JSON object
+    static constexpr size_t maxPartSize = 64UL * 1024UL;
+
+    explicit MultipartUpdateSink(std::string_view contentType)
+    {
+        status = parser.begin(contentType);
+        if (image.failed)
+        {
+            status = ParserError::ERROR_PART_REJECTED;
+        }
+        parser.setPartDataHandler(
+            std::bind_front(&MultipartUpdateSink::addPartData, this));
+    }
+
+    void put(std::string_view data) override
+    {
+        if (status != ParserError::PARSER_SUCCESS)
+        {
+            return;
+        }
+        status = parser.feed(data);
+    }
+
+    void finish() override
+    {
+        if (status != ParserError::PARSER_SUCCESS)
+        {
+            return;
+        }
+        status = parser.finish();
+        if (status != ParserError::PARSER_SUCCESS || image.size == 0)
+        {
+            return;
+        }
+        if (!image.finish())
+        {
+            status = ParserError::ERROR_PART_REJECTED;
+        }
+    }
+
+    ParserError status = ParserError::PARSER_SUCCESS;
+    MultipartParser parser;
+    bmcweb::StreamedImage image;
+
+  private:
+    static bool isUpdateFile(const FormPart& part)
+    {
+        boost::beast::http::fields::const_iterator it =
+            part.fields.find("Content-Disposition");
+        if (it == part.fields.end())
+        {
+            return false;
+        }
+        return parseFormPartName(it) == "UpdateFile";
+    }
+
+    bool addPartData(FormPart& part, std::string_view data)
+    {
+        size_t partIndex = parser.mime_fields.size();
+        if (partIndex != currentPart)
+        {
+            currentPart = partIndex;
+            currentIsImage = isUpdateFile(part);
+            if (currentIsImage && image.size != 0)
+            {
+                BMCWEB_LOG_ERROR("More than one UpdateFile part");
+                return false;
+            }
+        }
+        if (!currentIsImage)
+        {
+            if (part.content.size() + data.size() > maxPartSize)
+            {
+                BMCWEB_LOG_ERROR("Multipart form part too large");
+                return false;
+            }
+            part.content += data;
+            return true;
+        }
+
+        return image.write(data);
+    }
+
+    // One past the index of the part being received, 0 before the first
+    size_t currentPart = 0;
+    bool currentIsImage = false;
+};
+
+inline std::shared_ptr<bmcweb::BodySink> makeMultipartUpdateSink(
+    const boost::beast::http::fields& headers)
+{
+    boost::beast::http::fields::const_iterator it =
+        headers.find(boost::beast::http::field::content_type);
+    if (it == headers.end() || !it->value().starts_with("multipart/form-data"))
+    {
+        return nullptr;
+    }
+    return std::make_shared<MultipartUpdateSink>(it->value());
+}
+
 inline std::optional<MultiPartUpdate::UpdateParameters> processUpdateParameters(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
     std::string_view content)
@@ -800,10 +864,11 @@ inline std::optional<MultiPartUpdate::UpdateParameters> processUpdateParameters(
 }
 
 inline std::optional<MultiPartUpdate> extractMultipartUpdateParameters(
-    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp, MultipartParser parser)
+    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+    const MultipartUpdateSink& upload)
 {
     MultiPartUpdate multiRet;
-    for (FormPart& formpart : parser.mime_fields)
+    for (const FormPart& formpart : upload.parser.mime_fields)
     {
         boost::beast::http::fields::const_iterator it =
             formpart.fields.find("Content-Disposition");
@@ -832,13 +897,10 @@ inline std::optional<MultiPartUpdate> extractMultipartUpdateParameters(
             }
             multiRet.params = std::move(*params);
         }
-        else if (formFieldName == "UpdateFile")
-        {
-            multiRet.uploadData = std::move(formpart.content);
-        }
     }
 
-    if (multiRet.uploadData.empty())
+    // The UpdateFile part was streamed into the image memfd
+    if (upload.image.size == 0)
     {
         BMCWEB_LOG_ERROR("Upload data is NULL");
         messages::propertyMissing(asyncResp->res, "UpdateFile");
@@ -868,7 +930,7 @@ inline void handleStartUpdate(
 
 inline void startUpdate(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp, task::Payload payload,
-    const MemoryFileDescriptor& memfd, const std::string& applyTime,
+    const bmcweb::MemoryFileDescriptor& memfd, const std::string& applyTime,
     const std::string& objectPath, const std::string& serviceName)
 {
     dbus::utility::async_method_call(
@@ -884,7 +946,8 @@ inline void startUpdate(
 }
 
 inline void getSwInfo(const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-                      task::Payload payload, const MemoryFileDescriptor& memfd,
+                      task::Payload payload,
+                      const bmcweb::MemoryFileDescriptor& memfd,
                       const std::string& applyTime, const std::string& target,
                       const boost::system::error_code& ec,
                       const dbus::utility::MapperGetSubTreeResponse& subtree)
@@ -926,7 +989,7 @@ inline void getSwInfo(const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
 
 inline void handleBMCUpdate(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp, task::Payload payload,
-    const MemoryFileDescriptor& memfd, const std::string& applyTime,
+    const bmcweb::MemoryFileDescriptor& memfd, const std::string& applyTime,
     const boost::system::error_code& ec,
     const dbus::utility::MapperEndPoints& functionalSoftware)
 {
@@ -951,7 +1014,7 @@ inline void handleBMCUpdate(
 
 inline void handleMultipartManagerUpdate(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp, task::Payload payload,
-    const MemoryFileDescriptor& memfd, const std::string& applyTime,
+    const bmcweb::MemoryFileDescriptor& memfd, const std::string& applyTime,
     const boost::system::error_code& ec,
     const dbus::utility::MapperGetSubTreeResponse& subtree)
 {
@@ -987,31 +1050,12 @@ inline void handleMultipartManagerUpdate(
     messages::internalError(asyncResp->res);
 }
 
-inline void processUpdateRequest(
+// Starts the update from an image memfd positioned at its start
+inline void processUpdateImage(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-    task::Payload&& payload, std::string_view body,
+    task::Payload&& payload, bmcweb::MemoryFileDescriptor&& memfd,
     const std::string& applyTime, const std::vector<std::string>& targets)
 {
-    MemoryFileDescriptor memfd("update-image");
-    if (memfd.fd == -1)
-    {
-        BMCWEB_LOG_ERROR("Failed to create image memfd");
-        messages::internalError(asyncResp->res);
-        return;
-    }
-    if (write(memfd.fd, body.data(), body.length()) !=
-        static_cast<ssize_t>(body.length()))
-    {
-        BMCWEB_LOG_ERROR("Failed to write to image memfd");
-        messages::internalError(asyncResp->res);
-        return;
-    }
-    if (!memfd.rewind())
-    {
-        messages::internalError(asyncResp->res);
-        return;
-    }
-
     if (targets.empty())
     {
         constexpr std::array<std::string_view, 1> interfaces = {
@@ -1058,14 +1102,16 @@ inline void processUpdateRequest(
 
 inline void updateMultipartContext(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-    const crow::Request& req, MultipartParser&& parser)
+    const crow::Request& req, MultipartUpdateSink& upload)
 {
     std::optional<MultiPartUpdate> multipart =
-        extractMultipartUpdateParameters(asyncResp, std::move(parser));
+        extractMultipartUpdateParameters(asyncResp, upload);
     if (!multipart)
     {
         return;
     }
+    BMCWEB_LOG_INFO("Received {} byte update image, SHA-256 {}",
+                    upload.image.size, upload.image.digest);
     if (!multipart->params.applyTime)
     {
         multipart->params.applyTime = "OnReset";
@@ -1081,8 +1127,8 @@ inline void updateMultipartContext(
         }
         task::Payload payload(req);
 
-        processUpdateRequest(
-            asyncResp, std::move(payload), multipart->uploadData,
+        processUpdateImage(
+            asyncResp, std::move(payload), std::move(upload.image.memfd),
             applyTimeNewVal,
             multipart->params.targets.value_or(std::vector<std::string>{}));
     }
@@ -1094,12 +1140,12 @@ inline void updateMultipartContext(
         monitorForSoftwareAvailable(asyncResp, req,
                                     "/redfish/v1/UpdateService");
 
-        uploadImageFile(asyncResp->res, multipart->uploadData);
+        uploadImageFile(asyncResp->res, upload.image);
     }
 }
 
 inline void doHTTPUpdate(const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-                         const crow::Request& req)
+                         const crow::Request& req, bmcweb::StreamedImage& image)
 {
     if constexpr (BMCWEB_REDFISH_UPDATESERVICE_USE_DBUS)
     {
@@ -1110,8 +1156,8 @@ inline void doHTTPUpdate(const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
         std::vector<std::string> targets;
         targets.emplace_back(BMCWEB_REDFISH_MANAGER_URI_NAME);
 
-        processUpdateRequest(
-            asyncResp, std::move(payload), req.body(),
+        processUpdateImage(
+            asyncResp, std::move(payload), std::move(image.memfd),
             "xyz.openbmc_project.Software.ApplyTime.RequestedApplyTimes.Immediate",
             targets);
     }
@@ -1121,8 +1167,21 @@ inline void doHTTPUpdate(const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
         monitorForSoftwareAvailable(asyncResp, req,
                                     "/redfish/v1/UpdateService");
 
-        uploadImageFile(asyncResp->res, req.body());
+        uploadImageFile(asyncResp->res, image);
+    }
+}
+
+inline std::shared_ptr<bmcweb::BodySink> makeUpdateSink(
+    const boost::beast::http::fields& headers)
+{
+    boost::beast::http::fields::const_iterator it =
+        headers.find(boost::beast::http::field::content_type);
+    if (it == headers.end() ||
+        !bmcweb::asciiIEquals(it->value(), "application/octet-stream"))
+    {
+        return nullptr;
     }
+    return bmcweb::makeImageBodySink(headers);
 }
 
 inline void handleUpdateServicePost(
@@ -1140,7 +1199,24 @@ inline void handleUpdateServicePost(
     // Make sure that content type is application/octet-stream
     if (bmcweb::asciiIEquals(contentType, "application/octet-stream"))
     {
-        doHTTPUpdate(asyncResp, req);
+        // The route only streams octet-stream bodies into this sink
+        std::shared_ptr<bmcweb::ImageBodySink> upload =
+            std::static_pointer_cast<bmcweb::ImageBodySink>(req.bodySink());
+        if (upload == nullptr)
+        {
+            // Buffered, for example over HTTP/2
+            upload = std::make_shared<bmcweb::ImageBodySink>();
+            upload->put(req.body());
+            upload->finish();
+        }
+        if (upload->image.failed)
+        {
+            messages::internalError(asyncResp->res);
+            return;
+        }
+        BMCWEB_LOG_INFO("Received {} byte update image, SHA-256 {}",
+                        upload->image.size, upload->image.digest);
+        doHTTPUpdate(asyncResp, req, upload->image);
     }
     else
     {
@@ -1162,19 +1238,27 @@ inline void handleUpdateServiceMultipartUpdatePost(
     // Make sure that content type is multipart/form-data
     if (contentType.starts_with("multipart/form-data"))
     {
-        MultipartParser parser;
+        // The route only streams multipart bodies into this sink
+        std::shared_ptr<MultipartUpdateSink> upload =
+            std::static_pointer_cast<MultipartUpdateSink>(req.bodySink());
+        if (upload == nullptr)
+        {
+            // Buffered, for example over HTTP/2
+            upload = std::make_shared<MultipartUpdateSink>(contentType);
+            upload->put(req.body());
+            upload->finish();
+        }
 
-        ParserError ec = parser.parse(req);
-        if (ec != ParserError::PARSER_SUCCESS)
+        if (upload->status != ParserError::PARSER_SUCCESS)
         {
             // handle error
             BMCWEB_LOG_ERROR("MIME parse failed, ec : {}",
-                             static_cast<int>(ec));
+                             static_cast<int>(upload->status));
             messages::internalError(asyncResp->res);
             return;
         }
 
-        updateMultipartContext(asyncResp, req, std::move(parser));
+        updateMultipartContext(asyncResp, req, *upload);
     }
     else
     {
@@ -1451,11 +1535,13 @@ inline void requestRoutesUpdateService(App& app)
 
     BMCWEB_ROUTE(app, "/redfish/v1/UpdateService/update/")
         .privileges(redfish::privileges::postUpdateService)
+        .streamBody(makeUpdateSink)
         .methods(boost::beast::http::verb::post)(
             std::bind_front(handleUpdateServicePost, std::ref(app)));
 
     BMCWEB_ROUTE(app, "/redfish/v1/UpdateService/update-multipart/")
         .privileges(redfish::privileges::postUpdateService)
+        .streamBody(makeMultipartUpdateSink)
         .methods(boost::beast::http::verb::post)(std::bind_front(
             handleUpdateServiceMultipartUpdatePost, std::ref(app)));
 
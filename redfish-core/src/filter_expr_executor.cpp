@@ -5,7 +5,7 @@
 #include "filter_expr_parser_ast.hpp"
 #include "human_sort.hpp"
 #include "logging.hpp"
-#include "utils/json_utils.hpp"
+#include "str_utility.hpp"
 #include "utils/time_utils.hpp"
 
 #include <nlohmann/json.hpp>
@@ -16,10 +16,12 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <list>
 #include <optional>
 #include <string>
 #include <string_view>
-#include <variant>
+#include <utility>
+#include <vector>
 
 namespace redfish
 {
@@ -27,130 +29,170 @@ namespace redfish
 namespace
 {
 
-// A value that has been parsed as a time string per Edm.DateTimeOffset
-struct DateTimeString
+// The following is created by dumping all key names of type
+// Edm.DateTimeOffset.  While imperfect that it's a hardcoded list, these
+// keys don't change that often
+constexpr auto timeKeys = std::to_array<std::string_view>(
+    {"AccountExpiration",
+     "CalibrationTime",
+     "CoefficientUpdateTime",
+     "Created",
+     "CreatedDate",
+     "CreatedTime",
+     "CreateTime",
+     "DateTime",
+     "EndDateTime",
+     "EndTime",
+     "EventTimestamp",
+     "ExpirationDate",
+     "FirstOverflowTimestamp",
+     "InitialStartTime",
+     "InstallDate",
+     "LastOverflowTimestamp",
+     "LastResetTime",
+     "LastStateTime",
+     "LastUpdated",
+     "LifetimeStartDateTime",
+     "LowestReadingTime",
+     "MaintenanceWindowStartTime",
+     "Modified",
+     "PasswordExpiration",
+     "PeakReadingTime",
+     "PresentedPublicHostKeyTimestamp",
+     "ProductionDate",
+     "ReadingTime",
+     "ReleaseDate",
+     "ReservationTime",
+     "SensorResetTime",
+     "ServicedDate",
+     "SetPointUpdateTime",
+     "StartDateTime",
+     "StartTime",
+     "Time",
+     "Timestamp",
+     "ValidNotAfter",
+     "ValidNotBefore"});
+
+bool isDateTimeKey(std::string_view key)
 {
-    time_utils::usSinceEpoch value = time_utils::usSinceEpoch::zero();
-
-    // The following is created by dumping all key names of type
-    // Edm.DateTimeOffset.  While imperfect that it's a hardcoded list, these
-    // keys don't change that often
-    static constexpr auto timeKeys = std::to_array<std::string_view>(
-        {"AccountExpiration",
-         "CalibrationTime",
-         "CoefficientUpdateTime",
-         "Created",
-         "CreatedDate",
-         "CreatedTime",
-         "CreateTime",
-         "DateTime",
-         "EndDateTime",
-         "EndTime",
-         "EventTimestamp",
-         "ExpirationDate",
-         "FirstOverflowTimestamp",
-         "InitialStartTime",
-         "InstallDate",
-         "LastOverflowTimestamp",
-         "LastResetTime",
-         "LastStateTime",
-         "LastUpdated",
-         "LifetimeStartDateTime",
-         "LowestReadingTime",
-         "MaintenanceWindowStartTime",
-         "Modified",
-         "PasswordExpiration",
-         "PeakReadingTime",
-         "PresentedPublicHostKeyTimestamp",
-         "ProductionDate",
-         "ReadingTime",
-         "ReleaseDate",
-         "ReservationTime",
-         "SensorResetTime",
-         "ServicedDate",
-         "SetPointUpdateTime",
-         "StartDateTime",
-         "StartTime",
-         "Time",
-         "Timestamp",
-         "ValidNotAfter",
-         "ValidNotBefore"});
-
-    explicit DateTimeString(std::string_view strvalue)
-    {
-        std::optional<time_utils::usSinceEpoch> out =
-            time_utils::dateStringToEpoch(strvalue);
-        if (!out)
-        {
-            BMCWEB_LOG_ERROR(
-                "Internal datetime value didn't parse as datetime?");
-        }
-        else
-        {
-            value = *out;
-        }
-    }
+    auto out = std::equal_range(timeKeys.begin(), timeKeys.end(), key);
+    return out.first != out.second;
+}
 
-    static bool isDateTimeKey(std::string_view key)
+// Parses a string per Edm.DateTimeOffset, in microseconds since epoch
+int64_t parseDateTime(std::string_view strvalue)
+{
+    std::optional<time_utils::usSinceEpoch> out =
+        time_utils::dateStringToEpoch(strvalue);
+    if (!out)
     {
-        auto out = std::equal_range(timeKeys.begin(), timeKeys.end(), key);
-        return out.first != out.second;
+        BMCWEB_LOG_ERROR("Internal datetime value didn't parse as datetime?");
+        return 0;
     }
-};
+    return out->count();
+}
 
-// Class that can convert an arbitrary AST type into a structured value
-// Pulling from the json pointer when required
-struct ValueVisitor
+// A single side of a comparison, resolved against a member.  Strings refer
+// into either the member or the compiled filter, so nothing is copied.
+struct FilterValue
 {
-    using result_type = std::variant<std::monostate, double, int64_t,
-                                     std::string, DateTimeString>;
-    const nlohmann::json& body;
-    result_type operator()(double n);
-    result_type operator()(int64_t x);
-    result_type operator()(const filter_ast::UnquotedString& x);
-    result_type operator()(const filter_ast::QuotedString& x);
+    enum class Type
+    {
+        None,
+        Double,
+        Int,
+        String,
+        DateTime,
+    };
+    Type type = Type::None;
+    double doubleValue = 0.0;
+    // Holds the microseconds since epoch for DateTime
+    int64_t intValue = 0;
+    std::string_view stringValue;
+    // Set when stringValue is a literal whose date form was parsed ahead of
+    // time
+    const int64_t* preparsedDate = nullptr;
+
+    void toDateTime()
+    {
+        type = Type::DateTime;
+        if (preparsedDate != nullptr)
+        {
+            intValue = *preparsedDate;
+            return;
+        }
+        intValue = parseDateTime(stringValue);
+    }
 };
 
-ValueVisitor::result_type ValueVisitor::operator()(double n)
-{
-    return {n};
-}
-
-ValueVisitor::result_type ValueVisitor::operator()(int64_t x)
+const nlohmann::json* findKey(const std::vector<std::string>& path,
+                              const nlohmann::json::object_t& member)
 {
-    return {x};
+    const nlohmann::json::object_t* obj = &member;
+    const nlohmann::json* value = nullptr;
+    for (const std::string& part : path)
+    {
+        if (obj == nullptr || obj->empty())
+        {
+            return nullptr;
+        }
+        nlohmann::json::object_t::const_iterator it = obj->find(part);
+        if (it == obj->end())
+        {
+            return nullptr;
+        }
+        value = &it->second;
+        obj = value->get_ptr<const nlohmann::json::object_t*>();
+    }
+    return value;
 }
 
-ValueVisitor::result_type ValueVisitor::operator()(
-    const filter_ast::QuotedString& x)
+FilterValue resolve(const CompiledFilter::Operand& operand,
+                    const nlohmann::json::object_t& member)
 {
-    return {x};
-}
+    using Kind = CompiledFilter::Operand::Kind;
+    FilterValue out;
+    switch (operand.kind)
+    {
+        case Kind::Int:
+            out.type = FilterValue::Type::Int;
+            out.intValue = operand.intValue;
+            return out;
+        case Kind::Double:
+            out.type = FilterValue::Type::Double;
+            out.doubleValue = operand.doubleValue;
+            return out;
+        case Kind::String:
+            out.type = FilterValue::Type::String;
+            out.stringValue = operand.stringValue;
+            out.preparsedDate = &operand.dateValue;
+            return out;
+        case Kind::Key:
+            break;
+    }
 
-ValueVisitor::result_type ValueVisitor::operator()(
-    const filter_ast::UnquotedString& x)
-{
-    // find key including paths with / in them
-    const nlohmann::json* it =
-        json_util::findNestedKey(static_cast<std::string_view>(x), body);
+    const nlohmann::json* it = findKey(operand.path, member);
     if (it == nullptr)
     {
         BMCWEB_LOG_ERROR("Key {} doesn't exist in output, cannot filter",
-                         static_cast<std::string>(x));
-        BMCWEB_LOG_DEBUG("Output {}", body.dump());
-        return {};
+                         operand.stringValue);
+        return out;
     }
 
     const nlohmann::json& entry = *it;
     const double* dValue = entry.get_ptr<const double*>();
     if (dValue != nullptr)
     {
-        return {*dValue};
+        out.type = FilterValue::Type::Double;
+        out.doubleValue = *dValue;
+        return out;
     }
     const int64_t* iValue = entry.get_ptr<const int64_t*>();
     if (iValue != nullptr)
     {
-        return {*iValue};
+        out.type = FilterValue::Type::Int;
+        out.intValue = *iValue;
+        return out;
     }
     const uint64_t* uValue = entry.get_ptr<const uint64_t*>();
     if (uValue != nullptr)
@@ -159,51 +201,229 @@ ValueVisitor::result_type ValueVisitor::operator()(
         if (*uValue > std::numeric_limits<int64_t>::max())
         {
             BMCWEB_LOG_WARNING("Parsed uint is outside limits");
-            return {};
+            return out;
         }
-        return {static_cast<int64_t>(*uValue)};
+        out.type = FilterValue::Type::Int;
+        out.intValue = static_cast<int64_t>(*uValue);
+        return out;
     }
     const std::string* strValue = entry.get_ptr<const std::string*>();
     if (strValue != nullptr)
     {
-        if (DateTimeString::isDateTimeKey(x))
+        out.type = FilterValue::Type::String;
+        out.stringValue = *strValue;
+        if (operand.isDateTimeKey)
         {
-            return DateTimeString(*strValue);
+            out.toDateTime();
         }
-        return {*strValue};
+        return out;
     }
 
     BMCWEB_LOG_ERROR(
         "Type for key {} was {} which does not have a comparison operator",
-        static_cast<std::string>(x), static_cast<int>(entry.type()));
-    return {};
+        operand.stringValue, static_cast<int>(entry.type()));
+    return out;
 }
 
-struct ApplyFilter
+// Converts an AST argument into an operand with everything that doesn't
+// depend on the member already resolved
+struct OperandCompiler
 {
-    const nlohmann::json& body;
-    const filter_ast::LogicalAnd& filter;
-    using result_type = bool;
-    bool operator()(const filter_ast::LogicalNot& x);
-    bool operator()(const filter_ast::LogicalOr& x);
-    bool operator()(const filter_ast::LogicalAnd& x);
-    bool operator()(const filter_ast::Comparison& x);
-    bool operator()(const filter_ast::BooleanOp& x);
-
-  public:
-    bool matches();
+    using result_type = CompiledFilter::Operand;
+    using Kind = CompiledFilter::Operand::Kind;
+
+    CompiledFilter::Operand operator()(int64_t x) const
+    {
+        CompiledFilter::Operand out;
+        out.kind = Kind::Int;
+        out.intValue = x;
+        return out;
+    }
+
+    CompiledFilter::Operand operator()(double x) const
+    {
+        CompiledFilter::Operand out;
+        out.kind = Kind::Double;
+        out.doubleValue = x;
+        return out;
+    }
+
+    CompiledFilter::Operand operator()(const filter_ast::QuotedString& x) const
+    {
+        CompiledFilter::Operand out;
+        out.kind = Kind::String;
+        out.stringValue = x;
+        std::optional<time_utils::usSinceEpoch> date =
+            time_utils::dateStringToEpoch(out.stringValue);
+        if (date)
+        {
+            out.dateValue = date->count();
+        }
+        return out;
+    }
+
+    CompiledFilter::Operand operator()(
+        const filter_ast::UnquotedString& x) const
+    {
+        CompiledFilter::Operand out;
+        out.kind = Kind::Key;
+        // Keep the whole key for logging
+        out.stringValue = x;
+        out.isDateTimeKey = isDateTimeKey(x);
+        bmcweb::split(out.path, x, '/');
+        return out;
+    }
 };
 
-bool ApplyFilter::operator()(const filter_ast::LogicalNot& x)
+// Rough relative cost of evaluating an expression, used to order the
+// operands of and/or so that cheap checks can short circuit expensive ones
+struct CostVisitor
 {
-    bool subValue = (*this)(x.operand);
-    if (x.isLogicalNot)
+    using result_type = size_t;
+
+    size_t operator()(int64_t /*x*/) const
+    {
+        return 0;
+    }
+
+    size_t operator()(double /*x*/) const
+    {
+        return 0;
+    }
+
+    size_t operator()(const filter_ast::QuotedString& /*x*/) const
+    {
+        // String comparisons may need a natural sort compare
+        return 2;
+    }
+
+    size_t operator()(const filter_ast::UnquotedString& x) const
+    {
+        size_t cost = 1 + static_cast<size_t>(std::ranges::count(x, '/'));
+        if (isDateTimeKey(x))
+        {
+            cost += 4;
+        }
+        return cost;
+    }
+
+    size_t operator()(const filter_ast::Comparison& x) const
+    {
+        return boost::apply_visitor(*this, x.left) +
+               boost::apply_visitor(*this, x.right);
+    }
+
+    size_t operator()(const filter_ast::LogicalNot& x) const
     {
-        return !subValue;
+        return boost::apply_visitor(*this, x.operand);
     }
-    return subValue;
+
+    size_t operator()(const filter_ast::LogicalOr& x) const
+    {
+        size_t cost = (*this)(x.first);
+        for (const filter_ast::LogicalNot& sub : x.rest)
+        {
+            cost += (*this)(sub);
+        }
+        return cost;
+    }
+
+    size_t operator()(const filter_ast::LogicalAnd& x) const
+    {
+        size_t cost = (*this)(x.first);
+        for (const filter_ast::LogicalOr& sub : x.rest)
+        {
+            cost += (*this)(sub);
+        }
+        return cost;
+    }
+};
+
+// Returns the operands of an and/or, cheapest first
+template <typename Node>
+std::vector<const Node*> orderByCost(const Node& first,
+                                     const std::list<Node>& rest)
+{
+    std::vector<std::pair<size_t, const Node*>> nodes;
+    nodes.reserve(rest.size() + 1);
+    CostVisitor cost;
+    nodes.emplace_back(cost(first), &first);
+    for (const Node& node : rest)
+    {
+        nodes.emplace_back(cost(node), &node);
+    }
+    std::ranges::stable_sort(nodes, {}, &std::pair<size_t, const Node*>::first);
+
+    std::vector<const Node*> out;
+    out.reserve(nodes.size());
+    for (const std::pair<size_t, const Node*>& node : nodes)
+    {
+        out.emplace_back(node.second);
+    }
+    return out;
 }
 
+// Flattens the AST into a program.  and/or become conditional jumps past
+// the remaining operands once the result is known.
+struct FilterCompiler
+{
+    using result_type = void;
+    using OpCode = CompiledFilter::OpCode;
+
+    std::vector<CompiledFilter::Comparison> comparisons;
+    std::vector<CompiledFilter::Instruction> program;
+
+    void operator()(const filter_ast::Comparison& x)
+    {
+        OperandCompiler operand;
+        program.emplace_back(OpCode::Compare, comparisons.size());
+        comparisons.emplace_back(boost::apply_visitor(operand, x.left),
+                                 x.token,
+                                 boost::apply_visitor(operand, x.right));
+    }
+
+    void operator()(const filter_ast::LogicalNot& x)
+    {
+        boost::apply_visitor(*this, x.operand);
+        if (x.isLogicalNot)
+        {
+            program.emplace_back(OpCode::Not, 0);
+        }
+    }
+
+    template <typename Node>
+    void emitShortCircuit(const Node& first, const std::list<Node>& rest,
+                          OpCode jumpOp)
+    {
+        std::vector<size_t> jumps;
+        bool firstNode = true;
+        for (const Node* node : orderByCost(first, rest))
+        {
+            if (!firstNode)
+            {
+                jumps.emplace_back(program.size());
+                program.emplace_back(jumpOp, 0);
+            }
+            firstNode = false;
+            (*this)(*node);
+        }
+        for (size_t jump : jumps)
+        {
+            program[jump].arg = program.size();
+        }
+    }
+
+    void operator()(const filter_ast::LogicalOr& x)
+    {
+        emitShortCircuit(x.first, x.rest, OpCode::JumpIfTrue);
+    }
+
+    void operator()(const filter_ast::LogicalAnd& x)
+    {
+        emitShortCircuit(x.first, x.rest, OpCode::JumpIfFalse);
+    }
+};
+
 // Helper function to reduce the number of permutations of a single comparison
 // For all possible types.
 bool doDoubleComparison(double left, filter_ast::ComparisonOpEnum comparator,
@@ -289,122 +509,131 @@ bool doStringComparison(std::string_view left,
     }
 }
 
-bool ApplyFilter::operator()(const filter_ast::Comparison& x)
+} // namespace
+
+CompiledFilter::CompiledFilter(const filter_ast::LogicalAnd& filter)
 {
-    ValueVisitor numeric(body);
-    std::variant<std::monostate, double, int64_t, std::string, DateTimeString>
-        left = boost::apply_visitor(numeric, x.left);
-    std::variant<std::monostate, double, int64_t, std::string, DateTimeString>
-        right = boost::apply_visitor(numeric, x.right);
+    FilterCompiler compiler;
+    compiler(filter);
+    comparisons = std::move(compiler.comparisons);
+    program = std::move(compiler.program);
+}
 
-    // Numeric comparisons
-    const double* lDoubleValue = std::get_if<double>(&left);
-    const double* rDoubleValue = std::get_if<double>(&right);
-    const int64_t* lIntValue = std::get_if<int64_t>(&left);
-    const int64_t* rIntValue = std::get_if<int64_t>(&right);
+bool CompiledFilter::compare(const Comparison& cmp,
+                             const nlohmann::json::object_t& member) const
+{
+    FilterValue left = resolve(cmp.left, member);
+    FilterValue right = resolve(cmp.right, member);
+    using Type = FilterValue::Type;
 
-    if (lDoubleValue != nullptr)
+    // Numeric comparisons
+    if (left.type == Type::Double)
     {
-        if (rDoubleValue != nullptr)
+        if (right.type == Type::Double)
         {
             // Both sides are doubles, do the comparison as doubles
-            return doDoubleComparison(*lDoubleValue, x.token, *rDoubleValue);
+            return doDoubleComparison(left.doubleValue, cmp.token,
+                                      right.doubleValue);
         }
-        if (rIntValue != nullptr)
+        if (right.type == Type::Int)
         {
             // If right arg is int, promote right arg to double
-            return doDoubleComparison(*lDoubleValue, x.token,
-                                      static_cast<double>(*rIntValue));
+            return doDoubleComparison(left.doubleValue, cmp.token,
+                                      static_cast<double>(right.intValue));
         }
     }
-    if (lIntValue != nullptr)
+    if (left.type == Type::Int)
     {
-        if (rIntValue != nullptr)
+        if (right.type == Type::Int)
         {
             // Both sides are ints, do the comparison as ints
-            return doIntComparison(*lIntValue, x.token, *rIntValue);
+            return doIntComparison(left.intValue, cmp.token, right.intValue);
         }
-
-        if (rDoubleValue != nullptr)
+        if (right.type == Type::Double)
         {
             // Left arg is int, promote left arg to double
-            return doDoubleComparison(static_cast<double>(*lIntValue), x.token,
-                                      *rDoubleValue);
+            return doDoubleComparison(static_cast<double>(left.intValue),
+                                      cmp.token, right.doubleValue);
         }
     }
 
-    // String comparisons
-    const std::string* lStrValue = std::get_if<std::string>(&left);
-    const std::string* rStrValue = std::get_if<std::string>(&right);
-
-    const DateTimeString* lDateValue = std::get_if<DateTimeString>(&left);
-    const DateTimeString* rDateValue = std::get_if<DateTimeString>(&right);
-
-    // If we're trying to compare a date string to a string, construct a
-    // datestring from the string
-    if (lDateValue != nullptr && rStrValue != nullptr)
+    // If we're trying to compare a date string to a string, convert the
+    // string to a date
+    if (left.type == Type::DateTime && right.type == Type::String)
     {
-        rDateValue = &right.emplace<DateTimeString>(std::string(*rStrValue));
+        right.toDateTime();
     }
-    if (lStrValue != nullptr && rDateValue != nullptr)
+    if (left.type == Type::String && right.type == Type::DateTime)
     {
-        lDateValue = &left.emplace<DateTimeString>(std::string(*lStrValue));
+        left.toDateTime();
     }
 
-    if (lDateValue != nullptr && rDateValue != nullptr)
+    if (left.type == Type::DateTime && right.type == Type::DateTime)
     {
-        return doIntComparison(lDateValue->value.count(), x.token,
-                               rDateValue->value.count());
+        return doIntComparison(left.intValue, cmp.token, right.intValue);
     }
 
-    if (lStrValue != nullptr && rStrValue != nullptr)
+    if (left.type == Type::String && right.type == Type::String)
     {
-        return doStringComparison(*lStrValue, x.token, *rStrValue);
+        return doStringComparison(left.stringValue, cmp.token,
+                                  right.stringValue);
     }
 
     BMCWEB_LOG_ERROR(
         "Fell through.  Should never happen.  Attempt to compare type {} to type {}",
-        static_cast<int>(left.index()), static_cast<int>(right.index()));
+        static_cast<int>(left.type), static_cast<int>(right.type));
     return true;
 }
 
-bool ApplyFilter::operator()(const filter_ast::BooleanOp& x)
-{
-    return boost::apply_visitor(*this, x);
-}
-
-bool ApplyFilter::operator()(const filter_ast::LogicalOr& x)
+bool CompiledFilter::matches(const nlohmann::json::object_t& member) const
 {
-    bool value = (*this)(x.first);
-    for (const filter_ast::LogicalNot& bOp : x.rest)
+    bool result = true;
+    size_t pc = 0;
+    while (pc < program.size())
     {
-        value = value || (*this)(bOp);
+        const Instruction& instruction = program[pc];
+        pc++;
+        switch (instruction.op)
+        {
+            case OpCode::Compare:
+                result = compare(comparisons[instruction.arg], member);
+                break;
+            case OpCode::Not:
+                result = !result;
+                break;
+            case OpCode::JumpIfFalse:
+                if (!result)
+                {
+                    pc = instruction.arg;
+                }
+                break;
+            case OpCode::JumpIfTrue:
+                if (result)
+                {
+                    pc = instruction.arg;
+                }
+                break;
+        }
     }
-    return value;
+    return result;
 }
 
-bool ApplyFilter::operator()(const filter_ast::LogicalAnd& x)
+bool CompiledFilter::matches(const nlohmann::json& member) const
 {
-    bool value = (*this)(x.first);
-    for (const filter_ast::LogicalOr& bOp : x.rest)
+    const nlohmann::json::object_t* obj =
+        member.get_ptr<const nlohmann::json::object_t*>();
+    if (obj == nullptr)
     {
-        value = value && (*this)(bOp);
+        static const nlohmann::json::object_t empty;
+        return matches(empty);
     }
-    return value;
-}
-
-bool ApplyFilter::matches()
-{
-    return (*this)(filter);
+    return matches(*obj);
 }
 
-} // namespace
-
 bool memberMatches(const nlohmann::json& member,
                    const filter_ast::LogicalAnd& filterParam)
 {
-    ApplyFilter filterApplier(member, filterParam);
-    return filterApplier.matches();
+    return CompiledFilter(filterParam).matches(member);
 }
 
 // Applies a filter expression to a member array
@@ -432,11 +661,13 @@ bool applyFilterToCollection(nlohmann::json& body,
         return false;
     }
 
+    CompiledFilter filter(filterParam);
+
     json::array_t::iterator it = memberArr->begin();
     size_t index = 0;
     while (it != memberArr->end())
     {
-        if (!memberMatches(*it, filterParam))
+        if (!filter.matches(*it))
         {
             BMCWEB_LOG_DEBUG("Removing item at index {}", index);
             it = memberArr->erase(it);
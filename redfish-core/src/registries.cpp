@@ -6,29 +6,26 @@
 // registration hooks run.
 // NOLINTNEXTLINE(misc-include-cleaner)
 #include "registries_selector.hpp"
-#include "str_utility.hpp"
 
 #include <algorithm>
-#include <cstring>
+#include <cstddef>
 #include <functional>
 #include <map>
 #include <optional>
-#include <ranges>
 #include <span>
 #include <string>
 #include <string_view>
-#include <vector>
 
 namespace redfish::registries
 {
 
-auto allRegistries() -> std::map<std::string, RegistryEntry>&
+auto allRegistries() -> std::map<std::string, RegistryEntry, std::less<>>&
 {
-    static std::map<std::string, RegistryEntry> registries;
+    static std::map<std::string, RegistryEntry, std::less<>> registries;
     return registries;
 }
 
-auto getRegistryFromPrefix(const std::string& registryName)
+auto getRegistryFromPrefix(std::string_view registryName)
     -> std::optional<RegistryEntryRef>
 {
     auto& registries = allRegistries();
@@ -40,7 +37,7 @@ auto getRegistryFromPrefix(const std::string& registryName)
     return std::nullopt;
 }
 
-auto getRegistryMessagesFromPrefix(const std::string& registryName)
+auto getRegistryMessagesFromPrefix(std::string_view registryName)
     -> MessageEntries
 {
     auto registry = getRegistryFromPrefix(registryName);
@@ -52,14 +49,16 @@ auto getRegistryMessagesFromPrefix(const std::string& registryName)
     return registry->get().entries;
 }
 
-const Message* getMessageFromRegistry(const std::string& messageKey,
+const Message* getMessageFromRegistry(std::string_view messageKey,
                                       std::span<const MessageEntry> registry)
 {
-    std::span<const MessageEntry>::iterator messageIt = std::ranges::find_if(
-        registry, [&messageKey](const MessageEntry& messageEntry) {
-            return std::strcmp(messageEntry.first, messageKey.c_str()) == 0;
-        });
-    if (messageIt != registry.end())
+    // Registries are sorted by key, see registerRegistry()
+    auto key = [](const MessageEntry& messageEntry) {
+        return std::string_view(messageEntry.first);
+    };
+    std::span<const MessageEntry>::iterator messageIt =
+        std::ranges::lower_bound(registry, messageKey, {}, key);
+    if (messageIt != registry.end() && messageIt->first == messageKey)
     {
         return &messageIt->second;
     }
@@ -72,16 +71,15 @@ const Message* getMessage(std::string_view messageID)
     // Redfish MessageIds are in the form
     // RegistryName.MajorVersion.MinorVersion.MessageKey, so parse it to find
     // the right Message
-    std::vector<std::string> fields;
-    fields.reserve(4);
-    bmcweb::split(fields, messageID, '.');
-    if (fields.size() != 4)
+    if (std::ranges::count(messageID, '.') != 3)
     {
         return nullptr;
     }
+    size_t registryEnd = messageID.find('.');
+    size_t keyStart = messageID.rfind('.') + 1;
 
-    const std::string& registryName = fields[0];
-    const std::string& messageKey = fields[3];
+    std::string_view registryName = messageID.substr(0, registryEnd);
+    std::string_view messageKey = messageID.substr(keyStart);
 
     // Find the right registry and check it for the MessageKey
     return getMessageFromRegistry(messageKey,
@@ -197,6 +197,33 @@ bool Subscription::sendEventToSubscriber(uint64_t eventId, std::string&& msg)
     return true;
 }
 
+bool Subscription::sendSharedEventToSubscriber(
+    uint64_t eventId, const std::string& msg, crow::sse_socket::SseFrame& frame)
+{
+    if (sseConn == nullptr)
+    {
+        return sendEventToSubscriber(eventId, std::string(msg));
+    }
+
+    persistent_data::EventServiceConfig eventServiceConfig =
+        persistent_data::EventServiceStore::getInstance()
+            .getEventServiceConfig();
+    if (!eventServiceConfig.enabled)
+    {
+        return false;
+    }
+    if (msg.empty())
+    {
+        return true;
+    }
+    if (frame == nullptr)
+    {
+        frame = crow::sse_socket::makeSseFrame(std::to_string(eventId), msg);
+    }
+    sseConn->sendSseFrame(frame);
+    return true;
+}
+
 void Subscription::filterAndSendEventLogs(
     uint64_t eventId, const std::vector<EventLogObjectsType>& eventRecords)
 {
@@ -226,7 +253,7 @@ void Subscription::filterAndSendEventLogs(
 
         if (filter)
         {
-            if (!memberMatches(bmcLogEntry, *filter))
+            if (!filter->matches(bmcLogEntry))
             {
                 BMCWEB_LOG_DEBUG("Filter didn't match");
                 continue;
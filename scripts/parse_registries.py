@@ -128,6 +128,8 @@ def update_registries(files: t.List[RegistryInfo]) -> None:
                 )
             )
 
+            # Entries must be sorted by key; lookups binary search the array,
+            # and registerRegistry() checks the order at compile time.
             messages_sorted = sorted(json_dict["Messages"].items())
             for messageId, message in messages_sorted:
                 registry.write(
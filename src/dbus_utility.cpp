@@ -4,7 +4,10 @@
 #include "dbus_utility.hpp"
 
 #include "boost_formatters.hpp"
+#include "dbus_coalescer.hpp"
+#include "dbus_round_trips.hpp"
 #include "dbus_singleton.hpp"
+#include "io_context_singleton.hpp"
 #include "logging.hpp"
 
 #include <boost/system/error_code.hpp>
@@ -14,6 +17,7 @@
 
 #include <array>
 #include <cstdint>
+#include <format>
 #include <functional>
 #include <regex>
 #include <span>
@@ -41,13 +45,84 @@ void logError(const boost::system::error_code& ec)
     }
 }
 
+RoundTripStats& getRoundTripStats()
+{
+    static RoundTripStats stats;
+    return stats;
+}
+
+void beforeWrite()
+{
+    getPropertyReadCoalescer().flush();
+    countRoundTrips(getRoundTripStats(), &RoundTripStats::writes);
+}
+
+void beforeMethodCall(std::string_view interface, std::string_view method)
+{
+    if (!isReadOnlyMethod(interface, method))
+    {
+        beforeWrite();
+        return;
+    }
+    countRoundTrips(getRoundTripStats(), &RoundTripStats::requested);
+    countRoundTrips(getRoundTripStats(), &RoundTripStats::roundTrips);
+}
+
+PropertyReadCoalescer<DbusVariantType>& getPropertyReadCoalescer()
+{
+    using Coalescer = PropertyReadCoalescer<DbusVariantType>;
+    static Coalescer coalescer(
+        getIoContext(), getRoundTripStats(),
+        [](const std::string& service, const std::string& objectPath,
+           const std::string& interface, const std::string& propertyName,
+           Coalescer::GetCallback&& callback) {
+            crow::connections::systemBus->async_method_call(
+                [callback = std::move(callback)](
+                    const boost::system::error_code& ec,
+                    const DbusVariantType& value) { callback(ec, value); },
+                service, objectPath, "org.freedesktop.DBus.Properties", "Get",
+                interface, propertyName);
+        },
+        [](const std::string& service, const std::string& objectPath,
+           const std::string& interface, Coalescer::GetAllCallback&& callback) {
+            sdbusplus::asio::getAllProperties(*crow::connections::systemBus,
+                                              service, objectPath, interface,
+                                              std::move(callback));
+        });
+    return coalescer;
+}
+
+namespace
+{
+
+template <typename Response>
+SingleFlight<Response>& getReadFlight()
+{
+    static SingleFlight<Response> flight(getRoundTripStats());
+    return flight;
+}
+
+std::string makeMapperKey(std::string_view method, std::string_view path,
+                          int32_t depth,
+                          std::span<const std::string_view> interfaces)
+{
+    std::string key = std::format("{} {} {}", method, path, depth);
+    for (std::string_view interface : interfaces)
+    {
+        key += ' ';
+        key += interface;
+    }
+    return key;
+}
+
+} // namespace
+
 void getAllProperties(const std::string& service, const std::string& objectPath,
                       const std::string& interface,
                       std::function<void(const boost::system::error_code&,
                                          const DBusPropertiesMap&)>&& callback)
 {
-    sdbusplus::asio::getAllProperties(*crow::connections::systemBus, service,
-                                      objectPath, interface,
+    getPropertyReadCoalescer().getAll(service, objectPath, interface,
                                       std::move(callback));
 }
 
@@ -63,7 +138,7 @@ void getAllProperties(sdbusplus::asio::connection& /*conn*/,
 void checkDbusPathExists(const std::string& path,
                          std::function<void(bool)>&& callback)
 {
-    dbus::utility::async_method_call(
+    crow::connections::systemBus->async_method_call(
         [callback = std::move(callback)](const boost::system::error_code& ec,
                                          const MapperGetObject& objectNames) {
             callback(!ec && !objectNames.empty());
@@ -79,14 +154,24 @@ void getSubTree(const std::string& path, int32_t depth,
                 std::function<void(const boost::system::error_code&,
                                    const MapperGetSubTreeResponse&)>&& callback)
 {
-    dbus::utility::async_method_call(
-        [callback = std::move(callback)](
-            const boost::system::error_code& ec,
-            const MapperGetSubTreeResponse& subtree) { callback(ec, subtree); },
-        "xyz.openbmc_project.ObjectMapper",
-        "/xyz/openbmc_project/object_mapper",
-        "xyz.openbmc_project.ObjectMapper", "GetSubTree", path, depth,
-        interfaces);
+    countRoundTrips(getRoundTripStats(), &RoundTripStats::requested);
+    getReadFlight<MapperGetSubTreeResponse>().call(
+        makeMapperKey("GetSubTree", path, depth, interfaces),
+        keepRequestScope(std::move(callback)),
+        [&path, depth, interfaces](
+            std::function<void(const boost::system::error_code&,
+                               const MapperGetSubTreeResponse&)>&& done) {
+            crow::connections::systemBus->async_method_call(
+                [done = std::move(done)](
+                    const boost::system::error_code& ec,
+                    const MapperGetSubTreeResponse& subtree) {
+                    done(ec, subtree);
+                },
+                "xyz.openbmc_project.ObjectMapper",
+                "/xyz/openbmc_project/object_mapper",
+                "xyz.openbmc_project.ObjectMapper", "GetSubTree", path, depth,
+                interfaces);
+        });
 }
 
 void getSubTreePaths(
@@ -95,16 +180,24 @@ void getSubTreePaths(
     std::function<void(const boost::system::error_code&,
                        const MapperGetSubTreePathsResponse&)>&& callback)
 {
-    dbus::utility::async_method_call(
-        [callback = std::move(callback)](
-            const boost::system::error_code& ec,
-            const MapperGetSubTreePathsResponse& subtreePaths) {
-            callback(ec, subtreePaths);
-        },
-        "xyz.openbmc_project.ObjectMapper",
-        "/xyz/openbmc_project/object_mapper",
-        "xyz.openbmc_project.ObjectMapper", "GetSubTreePaths", path, depth,
-        interfaces);
+    countRoundTrips(getRoundTripStats(), &RoundTripStats::requested);
+    getReadFlight<MapperGetSubTreePathsResponse>().call(
+        makeMapperKey("GetSubTreePaths", path, depth, interfaces),
+        keepRequestScope(std::move(callback)),
+        [&path, depth, interfaces](
+            std::function<void(const boost::system::error_code&,
+                               const MapperGetSubTreePathsResponse&)>&& done) {
+            crow::connections::systemBus->async_method_call(
+                [done = std::move(done)](
+                    const boost::system::error_code& ec,
+                    const MapperGetSubTreePathsResponse& subtreePaths) {
+                    done(ec, subtreePaths);
+                },
+                "xyz.openbmc_project.ObjectMapper",
+                "/xyz/openbmc_project/object_mapper",
+                "xyz.openbmc_project.ObjectMapper", "GetSubTreePaths", path,
+                depth, interfaces);
+        });
 }
 
 void getAssociatedSubTree(
@@ -114,7 +207,7 @@ void getAssociatedSubTree(
     std::function<void(const boost::system::error_code&,
                        const MapperGetSubTreeResponse&)>&& callback)
 {
-    dbus::utility::async_method_call(
+    crow::connections::systemBus->async_method_call(
         [callback = std::move(callback)](
             const boost::system::error_code& ec,
             const MapperGetSubTreeResponse& subtree) { callback(ec, subtree); },
@@ -131,7 +224,7 @@ void getAssociatedSubTreePaths(
     std::function<void(const boost::system::error_code&,
                        const MapperGetSubTreePathsResponse&)>&& callback)
 {
-    dbus::utility::async_method_call(
+    crow::connections::systemBus->async_method_call(
         [callback = std::move(callback)](
             const boost::system::error_code& ec,
             const MapperGetSubTreePathsResponse& subtreePaths) {
@@ -151,7 +244,7 @@ void getAssociatedSubTreeById(
     std::function<void(const boost::system::error_code&,
                        const MapperGetSubTreeResponse&)>&& callback)
 {
-    dbus::utility::async_method_call(
+    crow::connections::systemBus->async_method_call(
         [callback = std::move(callback)](
             const boost::system::error_code& ec,
             const MapperGetSubTreeResponse& subtree) { callback(ec, subtree); },
@@ -169,7 +262,7 @@ void getAssociatedSubTreePathsById(
     std::function<void(const boost::system::error_code&,
                        const MapperGetSubTreePathsResponse&)>&& callback)
 {
-    dbus::utility::async_method_call(
+    crow::connections::systemBus->async_method_call(
         [callback = std::move(callback)](
             const boost::system::error_code& ec,
             const MapperGetSubTreePathsResponse& subtreePaths) {
@@ -186,14 +279,23 @@ void getDbusObject(const std::string& path,
                    std::function<void(const boost::system::error_code&,
                                       const MapperGetObject&)>&& callback)
 {
-    dbus::utility::async_method_call(
-        [callback = std::move(callback)](const boost::system::error_code& ec,
+    countRoundTrips(getRoundTripStats(), &RoundTripStats::requested);
+    getReadFlight<MapperGetObject>().call(
+        makeMapperKey("GetObject", path, 0, interfaces),
+        keepRequestScope(std::move(callback)),
+        [&path, interfaces](
+            std::function<void(const boost::system::error_code&,
+                               const MapperGetObject&)>&& done) {
+            crow::connections::systemBus->async_method_call(
+                [done = std::move(done)](const boost::system::error_code& ec,
                                          const MapperGetObject& object) {
-            callback(ec, object);
-        },
-        "xyz.openbmc_project.ObjectMapper",
-        "/xyz/openbmc_project/object_mapper",
-        "xyz.openbmc_project.ObjectMapper", "GetObject", path, interfaces);
+                    done(ec, object);
+                },
+                "xyz.openbmc_project.ObjectMapper",
+                "/xyz/openbmc_project/object_mapper",
+                "xyz.openbmc_project.ObjectMapper", "GetObject", path,
+                interfaces);
+        });
 }
 
 void getAssociationEndPoints(
@@ -211,13 +313,21 @@ void getManagedObjects(const std::string& service,
                        std::function<void(const boost::system::error_code&,
                                           const ManagedObjectType&)>&& callback)
 {
-    dbus::utility::async_method_call(
-        [callback = std::move(callback)](const boost::system::error_code& ec,
+    countRoundTrips(getRoundTripStats(), &RoundTripStats::requested);
+    getReadFlight<ManagedObjectType>().call(
+        std::format("GetManagedObjects {} {}", service, path.str),
+        keepRequestScope(std::move(callback)),
+        [&service, &path](
+            std::function<void(const boost::system::error_code&,
+                               const ManagedObjectType&)>&& done) {
+            crow::connections::systemBus->async_method_call(
+                [done = std::move(done)](const boost::system::error_code& ec,
                                          const ManagedObjectType& objects) {
-            callback(ec, objects);
-        },
-        service, path, "org.freedesktop.DBus.ObjectManager",
-        "GetManagedObjects");
+                    done(ec, objects);
+                },
+                service, path, "org.freedesktop.DBus.ObjectManager",
+                "GetManagedObjects");
+        });
 }
 
 } // namespace utility
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "directory_watcher.hpp"
+
+#include "logging.hpp"
+
+#include <sys/inotify.h>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <utility>
+
+namespace bmcweb
+{
+
+// How long to wait before looking for a directory that was removed again
+constexpr std::chrono::seconds rearmInterval(1);
+
+DirectoryWatcher::DirectoryWatcher(boost::asio::io_context& ioc,
+                                   const std::filesystem::path& directoryIn,
+                                   std::function<void()>&& onChangeIn) :
+    directory(directoryIn), onChange(std::move(onChangeIn)), rearmTimer(ioc),
+    inotifyConn(ioc)
+{
+    int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0)
+    {
+        BMCWEB_LOG_ERROR("inotify_init1 failed.");
+        return;
+    }
+    boost::system::error_code ec;
+    inotifyConn.assign(inotifyFd, ec);
+    if (ec)
+    {
+        BMCWEB_LOG_ERROR("Failed to assign fd {}", ec.message());
+        return;
+    }
+
+    if (!addWatch())
+    {
+        return;
+    }
+    readEvents();
+}
+
+bool DirectoryWatcher::addWatch()
+{
+    watchDesc = inotify_add_watch(
+        inotifyConn.native_handle(), directory.c_str(),
+        IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE |
+            IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+    if (watchDesc < 0)
+    {
+        BMCWEB_LOG_ERROR("inotify_add_watch failed for {}", directory.string());
+        return false;
+    }
+    return true;
+}
+
+// The watch follows the inode, so once the directory is removed or moved
+// away, nothing at the path is watched any more.  Drop the old watch and
+// watch the path again, retrying until something is there.
+void DirectoryWatcher::rearmWatch()
+{
+    if (watchDesc >= 0)
+    {
+        // Fails harmlessly if the kernel already dropped it
+        inotify_rm_watch(inotifyConn.native_handle(), watchDesc);
+        watchDesc = -1;
+    }
+    if (addWatch())
+    {
+        BMCWEB_LOG_INFO("Watching {} again", directory.string());
+        return;
+    }
+    rearmTimer.expires_after(rearmInterval);
+    rearmTimer.async_wait(
+        std::bind_front(&DirectoryWatcher::onRearmTimer, this));
+}
+
+void DirectoryWatcher::onRearmTimer(const boost::system::error_code& ec)
+{
+    if (ec)
+    {
+        // Canceled on shutdown
+        return;
+    }
+    rearmWatch();
+    if (isWatching())
+    {
+        // The directory came back, and its files may not be the ones that
+        // were there before
+        onChange();
+    }
+}
+
+void DirectoryWatcher::readEvents()
+{
+    inotifyConn.async_read_some(
+        boost::asio::buffer(readBuffer),
+        std::bind_front(&DirectoryWatcher::onINotify, this));
+}
+
+void DirectoryWatcher::onINotify(const boost::system::error_code& ec,
+                                 std::size_t bytesTransferred)
+{
+    if (ec == boost::asio::error::operation_aborted)
+    {
+        BMCWEB_LOG_DEBUG("Inotify was canceled (shutdown?)");
+        return;
+    }
+    if (ec)
+    {
+        BMCWEB_LOG_ERROR("Callback Error: {}", ec.message());
+        return;
+    }
+    BMCWEB_LOG_DEBUG("Directory changed, read {} bytes of events",
+                     bytesTransferred);
+    // Callers rebuild whatever they cache from scratch, so the individual
+    // events don't matter, only that something changed, and whether the
+    // directory itself went away.
+    bool lost = false;
+    size_t offset = 0;
+    while (offset + sizeof(inotify_event) <= bytesTransferred)
+    {
+        inotify_event event{};
+        std::memcpy(&event, &readBuffer[offset], sizeof(event));
+        // Events from a watch that was already replaced don't count
+        if (event.wd == watchDesc &&
+            (event.mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) != 0)
+        {
+            lost = true;
+        }
+        offset += sizeof(inotify_event) + event.len;
+    }
+    onChange();
+    if (lost)
+    {
+        BMCWEB_LOG_INFO("{} was removed or replaced", directory.string());
+        rearmWatch();
+    }
+    readEvents();
+}
+
+} // namespace bmcweb
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace bmcweb::benchmark
+{
+
+// Number of times each benchmark body is run.  The fastest run is reported,
+// which filters out most of the noise from the rest of the system.
+constexpr size_t benchmarkRuns = 5;
+
+// Runs func benchmarkRuns times, and returns the fastest run divided by the
+// number of iterations func performs internally.
+template <typename Func>
+double nsPerIteration(size_t iterations, Func&& func)
+{
+    using Clock = std::chrono::steady_clock;
+    Clock::duration best = Clock::duration::max();
+    for (size_t run = 0; run < benchmarkRuns; run++)
+    {
+        Clock::time_point start = Clock::now();
+        func();
+        Clock::duration elapsed = Clock::now() - start;
+        best = std::min(best, elapsed);
+    }
+    std::chrono::duration<double, std::nano> ns = best;
+    if (iterations == 0)
+    {
+        return ns.count();
+    }
+    return ns.count() / static_cast<double>(iterations);
+}
+
+// Prints a result, and records it in the gtest xml output so it can be
+// tracked over time.
+inline void report(std::string_view name, double nsPerIter)
+{
+    std::cout << std::format("{:<40} {:>12.1f} ns/iter\n", name, nsPerIter);
+    ::testing::Test::RecordProperty(std::string(name),
+                                    std::format("{:.1f}", nsPerIter));
+}
+
+} // namespace bmcweb::benchmark
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "compression.hpp"
+
+#include <zlib.h>
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace bmcweb
+{
+namespace
+{
+
+std::string gunzip(std::string_view data)
+{
+    z_stream stream{};
+    // Accept only the gzip format
+    constexpr int gzipWindowBits = 15 + 16;
+    EXPECT_EQ(inflateInit2(&stream, gzipWindowBits), Z_OK);
+
+    std::string out;
+    std::array<char, 4096> buf{};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    stream.next_in = const_cast<Bytef*>(
+        reinterpret_cast<const Bytef*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    int ret = Z_OK;
+    while (ret == Z_OK)
+    {
+        stream.next_out = reinterpret_cast<Bytef*>(buf.data());
+        stream.avail_out = static_cast<uInt>(buf.size());
+        ret = inflate(&stream, Z_NO_FLUSH);
+        out.append(buf.data(), buf.size() - stream.avail_out);
+    }
+    EXPECT_EQ(ret, Z_STREAM_END);
+    inflateEnd(&stream);
+    return out;
+}
+
+TEST(Compression, GzipRoundTrip)
+{
+    std::string payload;
+    for (size_t i = 0; i < 1000; i++)
+    {
+        payload += "<edmx:Include Namespace=\"Chassis.v1_0_0\"/>\n";
+    }
+    std::optional<std::string> compressed = gzipCompress(payload);
+    ASSERT_TRUE(compressed);
+    EXPECT_LT(compressed->size(), payload.size());
+    // gzip magic
+    ASSERT_GE(compressed->size(), 2U);
+    EXPECT_EQ(static_cast<unsigned char>((*compressed)[0]), 0x1fU);
+    EXPECT_EQ(static_cast<unsigned char>((*compressed)[1]), 0x8bU);
+    EXPECT_EQ(gunzip(*compressed), payload);
+}
+
+TEST(Compression, GzipEmpty)
+{
+    std::optional<std::string> compressed = gzipCompress("");
+    ASSERT_TRUE(compressed);
+    EXPECT_EQ(gunzip(*compressed), "");
+}
+
+} // namespace
+} // namespace bmcweb
@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "connection_admission.hpp"
+#include "io_context_singleton.hpp"
+
+#include <boost/asio/ip/address.hpp>
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace crow
+{
+namespace
+{
+
+using ::testing::ElementsAre;
+
+const boost::asio::ip::address clientA =
+    boost::asio::ip::make_address("10.0.0.1");
+const boost::asio::ip::address clientB =
+    boost::asio::ip::make_address("10.0.0.2");
+
+void runPosted()
+{
+    getIoContext().restart();
+    getIoContext().poll();
+}
+
+TEST(ConnectionAdmission, GlobalLimit)
+{
+    ConnectionAdmission admission(
+        {.connections = 2, .connectionsPerClient = 2});
+
+    std::optional<ConnectionTicket> first = admission.admitConnection(clientA);
+    std::optional<ConnectionTicket> second =
+        admission.admitConnection(clientB);
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_TRUE(admission.isSaturated());
+
+    EXPECT_FALSE(admission.admitConnection(clientB));
+    EXPECT_EQ(admission.getStats().rejectedConnectionsGlobal, 1U);
+
+    first.reset();
+    EXPECT_FALSE(admission.isSaturated());
+    EXPECT_EQ(admission.getStats().activeConnections, 1U);
+    EXPECT_TRUE(admission.admitConnection(clientB));
+}
+
+TEST(ConnectionAdmission, PerClientLimit)
+{
+    ConnectionAdmission admission(
+        {.connections = 10, .connectionsPerClient = 1});
+
+    std::optional<ConnectionTicket> first = admission.admitConnection(clientA);
+    ASSERT_TRUE(first);
+    EXPECT_FALSE(admission.admitConnection(clientA));
+    EXPECT_EQ(admission.getStats().rejectedConnectionsPerClient, 1U);
+
+    // Other clients are unaffected
+    std::optional<ConnectionTicket> other = admission.admitConnection(clientB);
+    EXPECT_TRUE(other);
+
+    // Moving the ticket keeps the slot held
+    ConnectionTicket moved = std::move(*first);
+    first.reset();
+    EXPECT_FALSE(admission.admitConnection(clientA));
+
+    moved.release();
+    EXPECT_TRUE(admission.admitConnection(clientA));
+}
+
+TEST(ConnectionAdmission, ResumeAcceptAfterRelease)
+{
+    ConnectionAdmission admission({.connections = 1});
+
+    std::optional<ConnectionTicket> ticket = admission.admitConnection(clientA);
+    ASSERT_TRUE(ticket);
+    ASSERT_TRUE(admission.isSaturated());
+
+    bool resumed = false;
+    admission.pauseAccept([&resumed]() { resumed = true; });
+    EXPECT_EQ(admission.getStats().acceptPauses, 1U);
+
+    ticket.reset();
+    runPosted();
+    EXPECT_TRUE(resumed);
+}
+
+TEST(ConnectionAdmission, RequestsAreQueuedRoundRobin)
+{
+    ConnectionAdmission admission(
+        {.inFlightRequests = 1, .queuedRequestsPerClient = 8});
+
+    std::vector<std::string> order;
+    std::vector<RequestSlot> slots;
+    auto makeHandler = [&order, &slots](std::string name) {
+        return [&order, &slots, name](RequestSlot&& slot) {
+            order.emplace_back(name);
+            slots.emplace_back(std::move(slot));
+        };
+    };
+
+    // Client A floods the server with requests, client B sends one
+    EXPECT_TRUE(admission.submitRequest(clientA, makeHandler("A1")));
+    EXPECT_TRUE(admission.submitRequest(clientA, makeHandler("A2")));
+    EXPECT_TRUE(admission.submitRequest(clientA, makeHandler("A3")));
+    EXPECT_TRUE(admission.submitRequest(clientB, makeHandler("B1")));
+    EXPECT_EQ(admission.getStats().inFlightRequests, 1U);
+    EXPECT_EQ(admission.getStats().queuedRequests, 3U);
+
+    while (!slots.empty())
+    {
+        RequestSlot done = std::move(slots.front());
+        slots.erase(slots.begin());
+        done.release();
+        runPosted();
+    }
+
+    // B is not stuck behind all of A's requests
+    EXPECT_THAT(order, ElementsAre("A1", "A2", "B1", "A3"));
+    EXPECT_EQ(admission.getStats().inFlightRequests, 0U);
+    EXPECT_EQ(admission.getStats().queuedRequests, 0U);
+    EXPECT_EQ(admission.getStats().queuedRequestsTotal, 3U);
+}
+
+TEST(ConnectionAdmission, RequestQueueLimit)
+{
+    ConnectionAdmission admission(
+        {.inFlightRequests = 1, .queuedRequestsPerClient = 1});
+
+    std::vector<RequestSlot> slots;
+    auto keep = [&slots](RequestSlot&& slot) {
+        slots.emplace_back(std::move(slot));
+    };
+    EXPECT_TRUE(admission.submitRequest(clientA, keep));
+    EXPECT_TRUE(admission.submitRequest(clientA, keep));
+    EXPECT_FALSE(admission.submitRequest(clientA, keep));
+    EXPECT_EQ(admission.getStats().rejectedRequests, 1U);
+
+    // Another client still has its own queue
+    EXPECT_TRUE(admission.submitRequest(clientB, keep));
+}
+
+TEST(ConnectionAdmission, StatsAreLoggedAtMostOncePerInterval)
+{
+    ConnectionAdmission admission;
+    std::chrono::steady_clock::time_point start{};
+
+    EXPECT_TRUE(admission.logStatsIfDue(start));
+    EXPECT_FALSE(admission.logStatsIfDue(start + std::chrono::seconds(59)));
+    EXPECT_TRUE(admission.logStatsIfDue(start + admissionStatsLogInterval));
+    EXPECT_FALSE(admission.logStatsIfDue(start + admissionStatsLogInterval));
+}
+
+} // namespace
+} // namespace crow
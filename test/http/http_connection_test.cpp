@@ -1,24 +1,45 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #include "async_resp.hpp"
+#include "http/http_body.hpp"
 #include "http/http_connection.hpp"
 #include "http/http_request.hpp"
 #include "http/http_response.hpp"
 #include "http_connect_types.hpp"
+#include "sessions.hpp"
 #include "test_stream.hpp"
 
+#include <malloc.h>
+
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/address_v4.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/ssl/context.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
 #include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/http/field.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/status.hpp>
+#include <boost/beast/http/string_body.hpp>
 #include <boost/beast/http/verb.hpp>
+#include <boost/system/error_code.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "gtest/gtest.h"
@@ -37,6 +58,22 @@ struct FakeHandler
         EXPECT_FALSE(true);
     }
 
+    static std::optional<uint64_t> getBodyStreamLimit(
+        const boost::beast::http::request_header<>& /*header*/)
+    {
+        return std::nullopt;
+    }
+
+    static void startBodyStream(
+        const std::shared_ptr<Request>& /*req*/,
+        const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
+        std::move_only_function<void(std::shared_ptr<bmcweb::BodySink>)>&&
+        /*start*/)
+    {
+        // Only called for routes that stream their body
+        EXPECT_FALSE(true);
+    }
+
     void handle(const std::shared_ptr<Request>& req,
                 const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/)
     {
@@ -92,14 +129,275 @@ TEST(http_connection, RequestPropogates)
     std::string expected =
         "HTTP/1.1 200 OK\r\n"
         "Connection: close\r\n"
+        "Content-Length: 0\r\n"
         "Strict-Transport-Security: max-age=31536000; includeSubdomains\r\n"
         "Pragma: no-cache\r\n"
         "Cache-Control: no-store, max-age=0\r\n"
         "X-Content-Type-Options: nosniff\r\n"
-        "Date: TestTime\r\n"
-        "Content-Length: 0\r\n\r\n";
+        "Date: TestTime\r\n\r\n";
     EXPECT_EQ(outStr, expected);
     EXPECT_TRUE(clock.wascalled);
 }
 
+// Counts the body, and pauses every megabyte like a slow disk would
+class CountingSink : public bmcweb::BodySink
+{
+  public:
+    explicit CountingSink(boost::asio::io_context& ioIn) : io(ioIn) {}
+
+    void put(std::string_view data) override
+    {
+        constexpr size_t pauseEvery = 1024UL * 1024UL;
+        size_t before = received;
+        received += data.size();
+        peakHeap = std::max(peakHeap, mallinfo2().uordblks);
+        if (before / pauseEvery != received / pauseEvery)
+        {
+            pause();
+            boost::asio::post(io, [this]() {
+                pauses++;
+                resume();
+            });
+        }
+    }
+
+    void finish() override
+    {
+        finished = true;
+    }
+
+    boost::asio::io_context& io;
+    size_t received = 0;
+    size_t pauses = 0;
+    size_t peakHeap = 0;
+    bool finished = false;
+};
+
+struct StreamingHandler
+{
+    explicit StreamingHandler(boost::asio::io_context& ioIn) : io(ioIn) {}
+
+    template <typename Adaptor>
+    static void handleUpgrade(
+        const std::shared_ptr<Request>& /*req*/,
+        const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
+        Adaptor&& /*adaptor*/)
+    {
+        EXPECT_FALSE(true);
+    }
+
+    static std::optional<uint64_t> getBodyStreamLimit(
+        const boost::beast::http::request_header<>& /*header*/)
+    {
+        return 512UL * 1024UL * 1024UL;
+    }
+
+    void startBodyStream(
+        const std::shared_ptr<Request>& /*req*/,
+        const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
+        std::move_only_function<void(std::shared_ptr<bmcweb::BodySink>)>&&
+            start)
+    {
+        sink = std::make_shared<CountingSink>(io);
+        start(sink);
+    }
+
+    void handle(const std::shared_ptr<Request>& req,
+                const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/)
+    {
+        EXPECT_EQ(req->bodySink(), sink);
+        EXPECT_TRUE(req->body().empty());
+        called = true;
+    }
+
+    boost::asio::io_context& io;
+    std::shared_ptr<CountingSink> sink;
+    bool called = false;
+};
+
+TEST(http_connection, StreamedBodyIsNotBuffered)
+{
+    constexpr size_t bodySize = 256UL * 1024UL * 1024UL;
+    boost::asio::io_context io;
+    ClockFake clock;
+    TestStream stream(io);
+    TestStream out(io);
+    stream.connect(out);
+
+    StreamingHandler handler(io);
+    boost::asio::steady_timer timer(io);
+    std::function<std::string()> date(
+        std::bind_front(&ClockFake::getDateStr, &clock));
+    boost::asio::ssl::context context{boost::asio::ssl::context::tls};
+    auto conn = std::make_shared<Connection<TestStream, StreamingHandler>>(
+        &handler, HttpType::HTTP, std::move(timer), date,
+        boost::asio::ssl::stream<TestStream>(std::move(stream), context));
+    conn->disableAuth();
+    conn->start();
+
+    size_t baseHeap = mallinfo2().uordblks;
+    out.write_some(boost::asio::buffer(std::string(
+        "POST /upload HTTP/1.1\r\nHost: openbmc_project.xyz\r\n"
+        "Connection: close\r\nContent-Length: " +
+        std::to_string(bodySize) + "\r\n\r\n")));
+    io.poll();
+
+    // Feed the body a chunk at a time, as a client on a socket would
+    const std::string chunk(64UL * 1024UL, 'x');
+    for (size_t sent = 0; sent < bodySize; sent += chunk.size())
+    {
+        out.write_some(boost::asio::buffer(chunk));
+        io.restart();
+        io.poll();
+    }
+    io.restart();
+    io.run_for(std::chrono::seconds(10));
+
+    ASSERT_NE(handler.sink, nullptr);
+    EXPECT_TRUE(handler.called);
+    EXPECT_TRUE(handler.sink->finished);
+    EXPECT_EQ(handler.sink->received, bodySize);
+    EXPECT_EQ(handler.sink->pauses, 256U);
+    // The body went through a few buffers, rather than into memory
+    EXPECT_LT(handler.sink->peakHeap, baseHeap + 4UL * 1024UL * 1024UL);
+    EXPECT_TRUE(out.str().starts_with("HTTP/1.1 200 OK\r\n"));
+}
+
+TEST(http_connection, UnauthenticatedUploadIsRefusedUnread)
+{
+    boost::asio::io_context io;
+    ClockFake clock;
+    TestStream stream(io);
+    TestStream out(io);
+    stream.connect(out);
+
+    out.write_some(boost::asio::buffer(
+        "POST /upload HTTP/1.1\r\nHost: openbmc_project.xyz\r\n"
+        "Content-Length: 1048576\r\n\r\n"));
+    StreamingHandler handler(io);
+    boost::asio::steady_timer timer(io);
+    std::function<std::string()> date(
+        std::bind_front(&ClockFake::getDateStr, &clock));
+    boost::asio::ssl::context context{boost::asio::ssl::context::tls};
+    auto conn = std::make_shared<Connection<TestStream, StreamingHandler>>(
+        &handler, HttpType::HTTP, std::move(timer), date,
+        boost::asio::ssl::stream<TestStream>(std::move(stream), context));
+    conn->start();
+    io.run_for(std::chrono::seconds(10));
+
+    // Refused without asking the route for a sink, or reading the body
+    EXPECT_EQ(handler.sink, nullptr);
+    EXPECT_FALSE(handler.called);
+    std::string outStr = out.str();
+    EXPECT_TRUE(outStr.starts_with("HTTP/1.1 401 Unauthorized\r\n"));
+    // Completed like any other response
+    if (persistent_data::SessionStore::getInstance()
+            .getAuthMethodsConfig()
+            .basic)
+    {
+        EXPECT_NE(outStr.find("WWW-Authenticate: Basic\r\n"),
+                  std::string::npos);
+    }
+    EXPECT_NE(outStr.find("X-Content-Type-Options: nosniff\r\n"),
+              std::string::npos);
+    EXPECT_NE(outStr.find("Date: TestTime\r\n"), std::string::npos);
+    EXPECT_NE(outStr.find("Connection: close\r\n"), std::string::npos);
+}
+
+struct FileHandler
+{
+    template <typename Adaptor>
+    static void handleUpgrade(
+        const std::shared_ptr<Request>& /*req*/,
+        const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
+        Adaptor&& /*adaptor*/)
+    {
+        EXPECT_FALSE(true);
+    }
+
+    static std::optional<uint64_t> getBodyStreamLimit(
+        const boost::beast::http::request_header<>& /*header*/)
+    {
+        return std::nullopt;
+    }
+
+    static void startBodyStream(
+        const std::shared_ptr<Request>& /*req*/,
+        const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
+        std::move_only_function<void(std::shared_ptr<bmcweb::BodySink>)>&&
+        /*start*/)
+    {
+        EXPECT_FALSE(true);
+    }
+
+    void handle(const std::shared_ptr<Request>& /*req*/,
+                const std::shared_ptr<bmcweb::AsyncResp>& asyncResp) const
+    {
+        EXPECT_EQ(asyncResp->res.openFile(path), OpenCode::Success);
+    }
+
+    std::filesystem::path path;
+};
+
+TEST(http_connection, RawFileIsSentOverSocket)
+{
+    std::string content;
+    for (size_t i = 0; content.size() < 4UL * 1024UL * 1024UL; i++)
+    {
+        content += std::to_string(i);
+    }
+    FileHandler handler;
+    handler.path = std::filesystem::temp_directory_path() /
+                   "bmcweb_http_connection_sendfile";
+    {
+        std::ofstream file(handler.path, std::ios::binary);
+        file << content;
+    }
+
+    // sendfile(2) needs a real socket
+    boost::asio::io_context io;
+    boost::asio::ip::tcp::acceptor acceptor(
+        io, boost::asio::ip::tcp::endpoint(
+                boost::asio::ip::address_v4::loopback(), 0));
+    boost::asio::ip::tcp::socket client(io);
+    client.connect(acceptor.local_endpoint());
+    boost::asio::ip::tcp::socket server = acceptor.accept();
+
+    ClockFake clock;
+    boost::asio::steady_timer timer(io);
+    std::function<std::string()> date(
+        std::bind_front(&ClockFake::getDateStr, &clock));
+    boost::asio::ssl::context context{boost::asio::ssl::context::tls};
+    auto conn = std::make_shared<
+        Connection<boost::asio::ip::tcp::socket, FileHandler>>(
+        &handler, HttpType::HTTP, std::move(timer), date,
+        boost::asio::ssl::stream<boost::asio::ip::tcp::socket>(
+            std::move(server), context));
+    conn->disableAuth();
+    conn->start();
+
+    boost::asio::write(
+        client, boost::asio::buffer(std::string_view(
+                    "GET /file HTTP/1.1\r\nHost: openbmc_project.xyz\r\n"
+                    "Connection: close\r\n\r\n")));
+    boost::beast::flat_buffer readBuf;
+    boost::beast::http::response<boost::beast::http::string_body> response;
+    boost::system::error_code readEc;
+    boost::beast::http::async_read(
+        client, readBuf, response,
+        [&readEc](const boost::system::error_code& ec, size_t /*read*/) {
+            readEc = ec;
+        });
+    io.run_for(std::chrono::seconds(10));
+
+    EXPECT_FALSE(readEc);
+    EXPECT_EQ(response.result(), boost::beast::http::status::ok);
+    EXPECT_EQ(response[boost::beast::http::field::content_length],
+              std::to_string(content.size()));
+    EXPECT_EQ(response.body(), content);
+    // All of the body went by sendfile, none through the serializer
+    EXPECT_EQ(conn->getSendfileBytes(), content.size());
+    std::filesystem::remove(handler.path);
+}
+
 } // namespace crow
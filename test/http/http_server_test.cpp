@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "async_resp.hpp"
+#include "http/http_body.hpp"
+#include "http/http_request.hpp"
+#include "http/http_server.hpp"
+#include "http_connect_types.hpp"
+#include "io_context_singleton.hpp"
+
+#include <boost/asio/ip/address_v4.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/http/message.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace crow
+{
+namespace
+{
+
+// No connections are accepted, so none of these are called
+struct NullHandler
+{
+    template <typename Adaptor>
+    static void handleUpgrade(
+        const std::shared_ptr<Request>& /*req*/,
+        const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
+        Adaptor&& /*adaptor*/)
+    {
+        EXPECT_FALSE(true);
+    }
+
+    static std::optional<uint64_t> getBodyStreamLimit(
+        const boost::beast::http::request_header<>& /*header*/)
+    {
+        return std::nullopt;
+    }
+
+    static void startBodyStream(
+        const std::shared_ptr<Request>& /*req*/,
+        const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
+        std::move_only_function<void(std::shared_ptr<bmcweb::BodySink>)>&&
+        /*start*/)
+    {
+        EXPECT_FALSE(true);
+    }
+
+    static void handle(const std::shared_ptr<Request>& /*req*/,
+                       const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/)
+    {
+        EXPECT_FALSE(true);
+    }
+};
+
+Acceptor makeAcceptor()
+{
+    return Acceptor{
+        boost::asio::ip::tcp::acceptor(
+            getIoContext(),
+            boost::asio::ip::tcp::endpoint(
+                boost::asio::ip::address_v4::loopback(), 0)),
+        HttpType::HTTP};
+}
+
+TEST(Server, DelayedAcceptorsAreAllResumed)
+{
+    NullHandler handler;
+    Server<NullHandler> server(&handler, {});
+    Acceptor first = makeAcceptor();
+    Acceptor second = makeAcceptor();
+
+    // Both run out of descriptors, one while the other is backing off
+    server.delayAccept(first);
+    server.delayAccept(second);
+    EXPECT_EQ(server.pausedAcceptorCount(), 2U);
+
+    getIoContext().restart();
+    getIoContext().run_one_for(std::chrono::seconds(5));
+    EXPECT_EQ(server.pausedAcceptorCount(), 0U);
+
+    // Cancels the accepts that were re-armed
+    first.acceptor.close();
+    second.acceptor.close();
+    getIoContext().restart();
+    getIoContext().poll();
+}
+
+} // namespace
+} // namespace crow
@@ -2,10 +2,13 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #include "mutual_tls.hpp"
 
+#include "mutual_tls_identity_cache.hpp"
 #include "mutual_tls_private.hpp"
 #include "sessions.hpp"
 
+#include <chrono>
 #include <cstring>
+#include <optional>
 #include <string>
 
 extern "C"
@@ -73,6 +76,11 @@ class OSSLX509
         EVP_PKEY_free(pkey);
     }
 
+    void setNotAfter(long seconds)
+    {
+        X509_gmtime_adj(X509_getm_notAfter(ptr), seconds);
+    }
+
     X509* get()
     {
         return ptr;
@@ -165,6 +173,29 @@ TEST(MutualTLS, MissingKeyUsage)
     }
 }
 
+TEST(MutualTLS, ReconnectWithSameCert)
+{
+    OSSLX509 x509;
+    x509.setSubjectName();
+    x509.setNotAfter(3600);
+    x509.sign();
+
+    OSSLX509StoreCTX x509Store;
+    X509_STORE_CTX_set_current_cert(x509Store.get(), x509.get());
+
+    boost::asio::ip::address ip;
+    for (int connection = 0; connection < 2; connection++)
+    {
+        boost::asio::ssl::verify_context ctx(x509Store.get());
+        std::shared_ptr<persistent_data::UserSession> session =
+            verifyMtlsUser(ip, ctx);
+        ASSERT_THAT(session, NotNull());
+        EXPECT_EQ(session->username, "user");
+        persistent_data::SessionStore::getInstance().removeSession(session);
+    }
+    clearMtlsIdentityCache();
+}
+
 TEST(MutualTLS, MissingCert)
 {
     OSSLX509StoreCTX x509Store;
@@ -332,6 +363,71 @@ TEST(GetUPNFromCert, ValidUPN)
     sk_GENERAL_NAME_pop_free(gens, GENERAL_NAME_free);
 }
 
+TEST(GetFingerprintFromCert, Sha256OfCert)
+{
+    OSSLX509 first;
+    first.setSubjectName();
+    first.sign();
+    OSSLX509 second;
+    second.setSubjectName();
+    second.sign();
+
+    std::string fingerprint = getFingerprintFromCert(first.get());
+    EXPECT_EQ(fingerprint.size(), 32U);
+    EXPECT_EQ(fingerprint, getFingerprintFromCert(first.get()));
+    EXPECT_NE(fingerprint, getFingerprintFromCert(second.get()));
+}
+
+TEST(GetNotAfterFromCert, ValidUntil)
+{
+    OSSLX509 x509;
+    x509.setNotAfter(3600);
+    std::optional<std::chrono::system_clock::time_point> notAfter =
+        getNotAfterFromCert(x509.get());
+    ASSERT_TRUE(notAfter);
+    std::chrono::system_clock::duration remaining =
+        *notAfter - std::chrono::system_clock::now();
+    EXPECT_GT(remaining, std::chrono::minutes(59));
+    EXPECT_LE(remaining, std::chrono::minutes(60));
+}
+
+TEST(MtlsIdentityCache, EvictsLeastRecentlyUsed)
+{
+    using Clock = MtlsIdentityCache::Clock;
+    Clock::time_point now = Clock::now();
+    Clock::time_point later = now + std::chrono::hours(1);
+
+    MtlsIdentityCache cache(2);
+    cache.insert("a", "alice", "", later);
+    cache.insert("b", "bob", "", later);
+    EXPECT_EQ(cache.find("a", "", now), "alice");
+    cache.insert("c", "carol", "", later);
+    EXPECT_EQ(cache.size(), 2U);
+    EXPECT_EQ(cache.find("b", "", now), std::nullopt);
+    EXPECT_EQ(cache.find("a", "", now), "alice");
+    EXPECT_EQ(cache.find("c", "", now), "carol");
+
+    cache.clear();
+    EXPECT_EQ(cache.find("a", "", now), std::nullopt);
+}
+
+TEST(MtlsIdentityCache, ForgetsExpiredAndOtherHosts)
+{
+    using Clock = MtlsIdentityCache::Clock;
+    Clock::time_point now = Clock::now();
+
+    MtlsIdentityCache cache(4);
+    cache.insert("a", "alice", "", now + std::chrono::seconds(1));
+    EXPECT_EQ(cache.find("a", "", now), "alice");
+    EXPECT_EQ(cache.find("a", "", now + std::chrono::seconds(1)),
+              std::nullopt);
+    EXPECT_EQ(cache.size(), 0U);
+
+    cache.insert("b", "bob", "bmc.domain.com", now + std::chrono::hours(1));
+    EXPECT_EQ(cache.find("b", "bmc.domain.org", now), std::nullopt);
+    EXPECT_EQ(cache.size(), 0U);
+}
+
 TEST(IsUPNMatch, MultipleCases)
 {
     EXPECT_FALSE(isUPNMatch("user", "hostname.domain.com"));
@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "benchmark_utils.hpp"
+#include "http_body.hpp"
+#include "http_response.hpp"
+#include "response_header.hpp"
+#include "security_headers.hpp"
+
+#include <boost/asio/buffer.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/field.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/status.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// Allocations made by the process, counted by the replaced operator new
+size_t allocations = 0;
+} // namespace
+
+void* operator new(size_t size)
+{
+    allocations++;
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+namespace crow
+{
+namespace
+{
+
+constexpr size_t iterations = 10000;
+constexpr std::string_view date = "Thu, 15 Oct 2026 12:00:00 GMT";
+constexpr std::string_view body = R"({"@odata.id":"/redfish/v1"})";
+
+// A typical JSON response, as completeRequest() hands it to doWrite()
+void fillResponse(Response& res)
+{
+    res.result(boost::beast::http::status::ok);
+    res.keepAlive(true);
+    res.addHeader(boost::beast::http::field::content_type,
+                  "application/json");
+    res.addHeader(boost::beast::http::field::etag, "\"1234ABCD\"");
+    res.write(std::string(body));
+    res.response.content_length(body.size());
+}
+
+// Serializes the header as doWrite() did before the templates: the
+// security headers and Date are added to the fields, and beast renders them
+size_t writeWithSerializer(Response& res)
+{
+    addSecurityHeaders(res);
+    res.addHeader(boost::beast::http::field::date, date);
+    boost::beast::http::response_serializer<bmcweb::HttpBody> serializer(
+        res.response);
+    size_t headerSize = 0;
+    boost::beast::error_code ec;
+    serializer.split(true);
+    serializer.next(ec, [&headerSize](boost::beast::error_code&,
+                                      const auto& buffers) {
+        headerSize = boost::asio::buffer_size(buffers);
+    });
+    return headerSize;
+}
+
+size_t writeWithTemplate(Response& res, std::string& headerBuffer)
+{
+    std::string_view common = getSecurityHeaderTemplate(res);
+    renderResponseHeader(res, common, date, headerBuffer);
+    return headerBuffer.size();
+}
+
+// Counts the allocations made by iterations calls of func, on top of the
+// ones made to build the response itself
+template <typename Func>
+double allocationsPerIteration(Func&& func)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < iterations; i++)
+    {
+        Response res;
+        fillResponse(res);
+        size_t before = allocations;
+        func(res);
+        total += allocations - before;
+    }
+    return static_cast<double>(total) / static_cast<double>(iterations);
+}
+
+TEST(ResponseHeaderBenchmark, RendersTheSameFields)
+{
+    Response legacy;
+    fillResponse(legacy);
+    addSecurityHeaders(legacy);
+    legacy.addHeader(boost::beast::http::field::date, date);
+
+    Response res;
+    fillResponse(res);
+    std::string header;
+    writeWithTemplate(res, header);
+
+    EXPECT_TRUE(header.starts_with("HTTP/1.1 200 OK\r\n"));
+    EXPECT_TRUE(header.ends_with("\r\n\r\n"));
+    size_t fields = 0;
+    for (const auto& field : legacy.response)
+    {
+        std::string line = std::format(
+            "\r\n{}: {}\r\n", std::string_view(field.name_string()),
+            std::string_view(field.value()));
+        EXPECT_NE(header.find(line), std::string::npos) << line;
+        fields++;
+    }
+    EXPECT_EQ(header.size(), writeWithSerializer(res));
+    EXPECT_GT(fields, 5U);
+}
+
+TEST(ResponseHeaderBenchmark, JsonResponseHeader)
+{
+    double serializerAllocs = allocationsPerIteration(
+        [](Response& res) { writeWithSerializer(res); });
+    std::string headerBuffer;
+    double templateAllocs = allocationsPerIteration(
+        [&headerBuffer](Response& res) {
+            writeWithTemplate(res, headerBuffer);
+        });
+    std::cout << std::format("{:<40} {:>12.1f} allocs/iter\n",
+                             "header, serializer", serializerAllocs);
+    std::cout << std::format("{:<40} {:>12.1f} allocs/iter\n",
+                             "header, template", templateAllocs);
+    EXPECT_LT(templateAllocs, serializerAllocs);
+
+    bmcweb::benchmark::report(
+        "header, serializer",
+        bmcweb::benchmark::nsPerIteration(iterations, []() {
+            for (size_t i = 0; i < iterations; i++)
+            {
+                Response res;
+                fillResponse(res);
+                writeWithSerializer(res);
+            }
+        }));
+    bmcweb::benchmark::report(
+        "header, template",
+        bmcweb::benchmark::nsPerIteration(iterations, [&headerBuffer]() {
+            for (size_t i = 0; i < iterations; i++)
+            {
+                Response res;
+                fillResponse(res);
+                writeWithTemplate(res, headerBuffer);
+            }
+        }));
+}
+
+} // namespace
+} // namespace crow
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #include "async_resp.hpp"
+#include "dbus_round_trips.hpp"
 #include "http_request.hpp"
 #include "routing.hpp"
 #include "utility.hpp"
@@ -156,5 +157,33 @@ TEST(Router, 405)
     }
     EXPECT_TRUE(called);
 }
+TEST(Router, DbusCallsAreCountedInTheResponse)
+{
+    dbus::utility::RoundTripStats total;
+    auto readingCallback =
+        [&total](const Request&, const std::shared_ptr<bmcweb::AsyncResp>&) {
+            dbus::utility::countRoundTrips(
+                total, &dbus::utility::RoundTripStats::requested, 2);
+        };
+
+    Router router;
+    std::error_code ec;
+
+    constexpr std::string_view url = "/foo";
+
+    auto req = std::make_shared<Request>(
+        Request::Body{boost::beast::http::verb::get, url, 11}, ec);
+
+    router.newRuleTagged<getParameterTag(url)>(std::string(url))(
+        readingCallback);
+    router.validate();
+
+    std::shared_ptr<bmcweb::AsyncResp> asyncResp =
+        std::make_shared<bmcweb::AsyncResp>();
+    router.handle(req, asyncResp);
+    EXPECT_EQ(asyncResp->res.dbusStats.requested, 2U);
+    EXPECT_EQ(total.requested, 2U);
+    EXPECT_TRUE(dbus::utility::RequestStatsScope::current().expired());
+}
 } // namespace
 } // namespace crow
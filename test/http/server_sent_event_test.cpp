@@ -10,6 +10,7 @@
 #include <boost/asio/read.hpp>
 
 #include <chrono>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -115,6 +116,53 @@ TEST(ServerSentEvent, SseWorks)
         }
     }
 }
+
+TEST(ServerSentEvent, FrameFormat)
+{
+    SseFrame frame = makeSseFrame("1", "a\nb");
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(*frame, "id: 1\ndata: a\ndata: b\n\n");
+
+    SseFrame noId = makeSseFrame("", "content");
+    ASSERT_NE(noId, nullptr);
+    EXPECT_EQ(*noId, "data: content\n\n");
+}
+
+TEST(ServerSentEvent, SlowClientDisconnected)
+{
+    boost::asio::io_context io;
+    TestStream stream(io);
+    TestStream out(io);
+    stream.connect(out);
+
+    bool closeCalled = false;
+    auto closeHandler = [&closeCalled](Connection&) { closeCalled = true; };
+
+    std::shared_ptr<ConnectionImpl<TestStream>> conn =
+        std::make_shared<ConnectionImpl<TestStream>>(
+            std::move(stream), [](Connection&, const Request&) {},
+            closeHandler);
+
+    // The io context is never run, so the first write never completes and
+    // every following frame is queued behind it.
+    SseFrame frame = makeSseFrame("1", "TestEventContent");
+    for (size_t i = 0; i < maxQueuedFrames; i++)
+    {
+        conn->sendSseFrame(frame);
+        ASSERT_FALSE(closeCalled);
+    }
+    // Frames are shared, not copied, between queue entries
+    EXPECT_EQ(frame.use_count(), static_cast<long>(maxQueuedFrames) + 1);
+
+    conn->sendSseFrame(frame);
+    while (!closeCalled)
+    {
+        io.run_for(std::chrono::milliseconds(1));
+    }
+    // Only the frames of the outstanding write are still referenced
+    EXPECT_LE(frame.use_count(), static_cast<long>(maxFramesPerWrite) + 1);
+}
+
 } // namespace
 
 } // namespace sse_socket
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "atomic_file_writer.hpp"
+
+#include <sys/stat.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+
+#include <gtest/gtest.h>
+
+namespace bmcweb
+{
+namespace
+{
+
+class AtomicFileWriterTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        dir = std::filesystem::temp_directory_path() /
+              "bmcweb_atomic_file_writer_test";
+        std::filesystem::create_directories(dir);
+        path = (dir / "data.json").string();
+    }
+
+    void TearDown() override
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+    }
+
+    std::string contents() const
+    {
+        std::ifstream in(path);
+        return {std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>()};
+    }
+
+    std::filesystem::path dir;
+    std::string path;
+};
+
+TEST_F(AtomicFileWriterTest, ReplacesFile)
+{
+    ASSERT_TRUE(writeFileAtomically(path, "first", S_IRUSR | S_IWUSR));
+    ASSERT_TRUE(writeFileAtomically(path, "second", S_IRUSR | S_IWUSR));
+    EXPECT_EQ(contents(), "second");
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    std::filesystem::perms perms = std::filesystem::status(path).permissions();
+    EXPECT_EQ(perms, std::filesystem::perms::owner_read |
+                         std::filesystem::perms::owner_write);
+}
+
+TEST_F(AtomicFileWriterTest, FailureKeepsOldFile)
+{
+    ASSERT_TRUE(writeFileAtomically(path, "old", S_IRUSR | S_IWUSR));
+    // A directory in the way of the temporary file
+    std::filesystem::create_directory(path + ".tmp");
+    EXPECT_FALSE(writeFileAtomically(path, "new", S_IRUSR | S_IWUSR));
+    EXPECT_EQ(contents(), "old");
+}
+
+TEST_F(AtomicFileWriterTest, WritesNewestContents)
+{
+    AtomicFileWriter writer(path, S_IRUSR | S_IWUSR);
+    constexpr size_t updates = 1000;
+    for (size_t i = 0; i < updates; i++)
+    {
+        writer.write(std::format("update {}", i));
+    }
+    writer.flush();
+    EXPECT_EQ(contents(), "update 999");
+    // Updates queued while a write is running replace each other, so there
+    // are at most as many writes as updates
+    EXPECT_GE(writer.writes(), 1U);
+    EXPECT_LE(writer.writes(), updates);
+}
+
+} // namespace
+} // namespace bmcweb
@@ -0,0 +1,368 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "dbus_coalescer.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/system/errc.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace dbus::utility
+{
+namespace
+{
+
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
+
+using Variant = std::variant<std::string, uint32_t, bool>;
+using Coalescer = PropertyReadCoalescer<Variant>;
+
+// Records the calls the coalescer sends, and lets the test answer them
+struct FakeBus
+{
+    std::vector<std::string> sent;
+    std::vector<Coalescer::GetCallback> gets;
+    std::vector<Coalescer::GetAllCallback> getAlls;
+
+    Coalescer makeCoalescer(boost::asio::io_context& ioc,
+                            RoundTripStats& stats)
+    {
+        return {ioc, stats,
+                [this](const std::string& service, const std::string& path,
+                       const std::string& interface,
+                       const std::string& property,
+                       Coalescer::GetCallback&& callback) {
+                    sent.emplace_back("Get " + service + " " + path + " " +
+                                      interface + " " + property);
+                    gets.emplace_back(std::move(callback));
+                },
+                [this](const std::string& service, const std::string& path,
+                       const std::string& interface,
+                       Coalescer::GetAllCallback&& callback) {
+                    sent.emplace_back(
+                        "GetAll " + service + " " + path + " " + interface);
+                    getAlls.emplace_back(std::move(callback));
+                }};
+    }
+};
+
+const Coalescer::PropertiesMap bootProperties{
+    {"BootSource", Variant("Network")},
+    {"BootMode", Variant("Regular")},
+    {"BootType", Variant("Legacy")},
+    {"Enabled", Variant(true)},
+};
+
+TEST(PropertyReadCoalescer, BatchesReadsOfOneObject)
+{
+    boost::asio::io_context ioc;
+    RoundTripStats stats;
+    FakeBus bus;
+    Coalescer coalescer = bus.makeCoalescer(ioc, stats);
+
+    std::vector<std::string> results;
+    auto record = [&results](const boost::system::error_code& ec,
+                             const Variant& value) {
+        ASSERT_FALSE(ec);
+        if (const std::string* str = std::get_if<std::string>(&value))
+        {
+            results.emplace_back(*str);
+        }
+        else
+        {
+            results.emplace_back(std::get<bool>(value) ? "true" : "false");
+        }
+    };
+    coalescer.get("svc", "/boot", "Boot.Source", "BootSource", record);
+    coalescer.get("svc", "/boot", "Boot.Source", "BootMode", record);
+    coalescer.get("svc", "/boot", "Boot.Source", "BootType", record);
+    coalescer.get("svc", "/boot", "Boot.Source", "Enabled", record);
+    coalescer.get("svc", "/power", "Power.State", "State", record);
+
+    // Nothing is sent until the current turn finishes
+    EXPECT_TRUE(bus.sent.empty());
+    ioc.poll();
+    EXPECT_THAT(bus.sent,
+                UnorderedElementsAre("GetAll svc /boot Boot.Source",
+                                     "Get svc /power Power.State State"));
+
+    ASSERT_EQ(bus.getAlls.size(), 1U);
+    bus.getAlls[0]({}, bootProperties);
+    EXPECT_THAT(results, ElementsAre("Network", "Regular", "Legacy", "true"));
+
+    ASSERT_EQ(bus.gets.size(), 1U);
+    bus.gets[0]({}, Variant("On"));
+    EXPECT_EQ(results.back(), "On");
+
+    EXPECT_EQ(stats.requested, 5U);
+    EXPECT_EQ(stats.roundTrips, 2U);
+    EXPECT_EQ(stats.batched, 4U);
+}
+
+TEST(PropertyReadCoalescer, IdenticalReadsShareOneCall)
+{
+    boost::asio::io_context ioc;
+    RoundTripStats stats;
+    FakeBus bus;
+    Coalescer coalescer = bus.makeCoalescer(ioc, stats);
+
+    int calls = 0;
+    auto count = [&calls](const boost::system::error_code& ec,
+                          const Variant& value) {
+        EXPECT_FALSE(ec);
+        EXPECT_EQ(std::get<uint32_t>(value), 42U);
+        calls++;
+    };
+    coalescer.get("svc", "/obj", "Iface", "Prop", count);
+    coalescer.get("svc", "/obj", "Iface", "Prop", count);
+    ioc.poll();
+    ASSERT_EQ(bus.gets.size(), 1U);
+
+    // A read issued while the first is still in flight joins it
+    coalescer.get("svc", "/obj", "Iface", "Prop", count);
+    ioc.restart();
+    ioc.poll();
+    ASSERT_EQ(bus.gets.size(), 1U);
+
+    bus.gets[0]({}, Variant(uint32_t{42}));
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(stats.requested, 3U);
+    EXPECT_EQ(stats.roundTrips, 1U);
+    EXPECT_EQ(stats.coalesced, 2U);
+
+    // Once complete, the next read goes to the bus again
+    coalescer.get("svc", "/obj", "Iface", "Prop", count);
+    ioc.restart();
+    ioc.poll();
+    EXPECT_EQ(bus.gets.size(), 2U);
+}
+
+TEST(PropertyReadCoalescer, FailedGetAllFallsBackToGet)
+{
+    boost::asio::io_context ioc;
+    RoundTripStats stats;
+    FakeBus bus;
+    Coalescer coalescer = bus.makeCoalescer(ioc, stats);
+
+    std::vector<boost::system::error_code> errors;
+    auto record = [&errors](const boost::system::error_code& ec,
+                            const Variant& /*value*/) {
+        errors.emplace_back(ec);
+    };
+    int getAllCalls = 0;
+    coalescer.getAll("svc", "/obj", "Iface",
+                     [&getAllCalls](const boost::system::error_code& ec,
+                                    const Coalescer::PropertiesMap& props) {
+                         EXPECT_TRUE(ec);
+                         EXPECT_TRUE(props.empty());
+                         getAllCalls++;
+                     });
+    coalescer.get("svc", "/obj", "Iface", "A", record);
+    coalescer.get("svc", "/obj", "Iface", "B", record);
+    ioc.poll();
+    ASSERT_EQ(bus.getAlls.size(), 1U);
+
+    bus.getAlls[0](boost::system::errc::make_error_code(
+                       boost::system::errc::invalid_argument),
+                   {});
+    EXPECT_EQ(getAllCalls, 1);
+    EXPECT_TRUE(errors.empty());
+    EXPECT_THAT(bus.sent, ElementsAre("GetAll svc /obj Iface",
+                                      "Get svc /obj Iface A",
+                                      "Get svc /obj Iface B"));
+
+    // Each read gets the answer of its own Get
+    bus.gets[0]({}, Variant("a"));
+    bus.gets[1](boost::system::errc::make_error_code(
+                    boost::system::errc::no_such_file_or_directory),
+                Variant());
+    ASSERT_EQ(errors.size(), 2U);
+    EXPECT_FALSE(errors[0]);
+    EXPECT_EQ(errors[1], boost::system::errc::no_such_file_or_directory);
+}
+
+TEST(PropertyReadCoalescer, MissingPropertyIsReadAlone)
+{
+    boost::asio::io_context ioc;
+    RoundTripStats stats;
+    FakeBus bus;
+    Coalescer coalescer = bus.makeCoalescer(ioc, stats);
+
+    std::vector<std::string> results;
+    auto record = [&results](const boost::system::error_code& ec,
+                             const Variant& value) {
+        results.emplace_back(ec ? "error" : std::get<std::string>(value));
+    };
+    coalescer.get("svc", "/boot", "Boot.Source", "BootSource", record);
+    coalescer.get("svc", "/boot", "Boot.Source", "Missing", record);
+    ioc.poll();
+    ASSERT_EQ(bus.getAlls.size(), 1U);
+    bus.getAlls[0]({}, bootProperties);
+    EXPECT_THAT(results, ElementsAre("Network"));
+
+    ASSERT_EQ(bus.gets.size(), 1U);
+    EXPECT_EQ(bus.sent.back(), "Get svc /boot Boot.Source Missing");
+    bus.gets[0](boost::system::errc::make_error_code(
+                    boost::system::errc::invalid_argument),
+                Variant());
+    EXPECT_THAT(results, ElementsAre("Network", "error"));
+}
+
+TEST(PropertyReadCoalescer, FlushSendsQueuedReadsBeforeAWrite)
+{
+    boost::asio::io_context ioc;
+    RoundTripStats stats;
+    FakeBus bus;
+    Coalescer coalescer = bus.makeCoalescer(ioc, stats);
+
+    int calls = 0;
+    auto count = [&calls](const boost::system::error_code& /*ec*/,
+                          const Variant& /*value*/) { calls++; };
+    coalescer.get("svc", "/obj", "Iface", "Prop", count);
+    coalescer.flush();
+    EXPECT_THAT(bus.sent, ElementsAre("Get svc /obj Iface Prop"));
+
+    // The flush already posted for the turn has nothing left to send
+    ioc.poll();
+    EXPECT_EQ(bus.sent.size(), 1U);
+    bus.gets[0]({}, Variant(uint32_t{1}));
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(SingleFlight, ReadsAfterAWriteAreSentAgain)
+{
+    RoundTripStats stats;
+    SingleFlight<int> flight(stats);
+    std::vector<SingleFlight<int>::Callback> sent;
+    auto send = [&sent](SingleFlight<int>::Callback&& done) {
+        sent.emplace_back(std::move(done));
+    };
+
+    std::vector<int> results;
+    auto record = [&results](const boost::system::error_code& /*ec*/,
+                             const int& value) { results.emplace_back(value); };
+    flight.call("key", record, send);
+    flight.call("key", record, send);
+    ASSERT_EQ(sent.size(), 1U);
+
+    // The value read before the write must not be handed to a later read
+    stats.writes++;
+    flight.call("key", record, send);
+    ASSERT_EQ(sent.size(), 2U);
+    flight.call("key", record, send);
+    EXPECT_EQ(sent.size(), 2U);
+
+    sent[0]({}, 1);
+    EXPECT_THAT(results, ElementsAre(1, 1));
+    // Completing the old call leaves the newer one in flight
+    EXPECT_EQ(flight.inFlightCount(), 1U);
+    flight.call("key", record, send);
+    EXPECT_EQ(sent.size(), 2U);
+
+    sent[1]({}, 2);
+    EXPECT_THAT(results, ElementsAre(1, 1, 2, 2, 2));
+    EXPECT_EQ(flight.inFlightCount(), 0U);
+    EXPECT_EQ(stats.roundTrips, 2U);
+    EXPECT_EQ(stats.coalesced, 3U);
+}
+
+TEST(PropertyReadCoalescer, ReadsAreCountedAgainstTheirRequest)
+{
+    boost::asio::io_context ioc;
+    RoundTripStats stats;
+    FakeBus bus;
+    Coalescer coalescer = bus.makeCoalescer(ioc, stats);
+
+    std::shared_ptr<RoundTripStats> request =
+        std::make_shared<RoundTripStats>();
+    auto ignore = [](const boost::system::error_code& /*ec*/,
+                     const Variant& /*value*/) {};
+    {
+        RequestStatsScope scope(request);
+        coalescer.get("svc", "/boot", "Boot.Source", "BootSource",
+                      [&coalescer,
+                       ignore](const boost::system::error_code& /*ec*/,
+                               const Variant& /*value*/) {
+                          // Made from the callback, so still the request's
+                          coalescer.get("svc", "/power", "Power.State",
+                                        "State", ignore);
+                      });
+        coalescer.get("svc", "/boot", "Boot.Source", "BootMode", ignore);
+    }
+    // Another request's read, joining the same GetAll
+    coalescer.get("svc", "/boot", "Boot.Source", "BootType", ignore);
+    ioc.poll();
+    ASSERT_EQ(bus.getAlls.size(), 1U);
+    EXPECT_EQ(request->requested, 2U);
+    EXPECT_EQ(request->batched, 2U);
+    EXPECT_EQ(request->roundTrips, 1U);
+
+    bus.getAlls[0]({}, bootProperties);
+    ioc.restart();
+    ioc.poll();
+    ASSERT_EQ(bus.gets.size(), 1U);
+    EXPECT_EQ(request->requested, 3U);
+    EXPECT_EQ(request->roundTrips, 2U);
+    EXPECT_EQ(stats.requested, 4U);
+    EXPECT_EQ(stats.batched, 3U);
+    EXPECT_TRUE(RequestStatsScope::current().expired());
+}
+
+TEST(IsReadOnlyMethod, OnlyKnownReadsAreReads)
+{
+    EXPECT_TRUE(isReadOnlyMethod("org.freedesktop.DBus.Properties", "GetAll"));
+    EXPECT_TRUE(isReadOnlyMethod("xyz.openbmc_project.State.Boot.PostCode",
+                                 "GetPostCodesWithTimeStamp"));
+    EXPECT_FALSE(isReadOnlyMethod("org.freedesktop.DBus.Properties", "Set"));
+    EXPECT_FALSE(isReadOnlyMethod("xyz.openbmc_project.Object.Delete",
+                                  "Delete"));
+    // The same name on another interface may well change something
+    EXPECT_FALSE(isReadOnlyMethod("xyz.openbmc_project.Example", "Get"));
+}
+
+TEST(SingleFlight, CallbacksCanStartTheSameCall)
+{
+    RoundTripStats stats;
+    SingleFlight<int> flight(stats);
+    std::vector<SingleFlight<int>::Callback> sent;
+    auto send = [&sent](SingleFlight<int>::Callback&& done) {
+        sent.emplace_back(std::move(done));
+    };
+
+    std::vector<int> results;
+    flight.call(
+        "key",
+        [&](const boost::system::error_code& /*ec*/, const int& value) {
+            results.emplace_back(value);
+            flight.call(
+                "key",
+                [&results](const boost::system::error_code& /*ec*/,
+                           const int& next) { results.emplace_back(next); },
+                send);
+        },
+        send);
+    EXPECT_EQ(flight.inFlightCount(), 1U);
+
+    SingleFlight<int>::Callback first = std::move(sent[0]);
+    first({}, 1);
+    // The call started from the callback was sent, not dropped
+    ASSERT_EQ(sent.size(), 2U);
+    EXPECT_EQ(flight.inFlightCount(), 1U);
+    sent[1]({}, 2);
+    EXPECT_THAT(results, ElementsAre(1, 2));
+    EXPECT_EQ(stats.roundTrips, 2U);
+    EXPECT_EQ(flight.inFlightCount(), 0U);
+}
+
+} // namespace
+} // namespace dbus::utility
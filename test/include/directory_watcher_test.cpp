@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "directory_watcher.hpp"
+#include "file_test_utilities.hpp"
+
+#include <boost/asio/io_context.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+namespace bmcweb
+{
+namespace
+{
+
+TEST(DirectoryWatcher, NotifiesOnChange)
+{
+    TemporaryDirectoryHandle dir;
+    boost::asio::io_context ioc;
+    int changes = 0;
+    DirectoryWatcher watcher(ioc, dir.path, [&changes]() { changes++; });
+    ASSERT_TRUE(watcher.isWatching());
+
+    {
+        std::ofstream file(dir.path / "Chassis_v1.xml");
+        file << "<edmx:Edmx/>";
+    }
+    ioc.run_one_for(std::chrono::seconds(1));
+    EXPECT_GE(changes, 1);
+
+    int before = changes;
+    std::filesystem::remove(dir.path / "Chassis_v1.xml");
+    ioc.restart();
+    ioc.run_one_for(std::chrono::seconds(1));
+    EXPECT_GT(changes, before);
+}
+
+TEST(DirectoryWatcher, WatchesReplacedDirectory)
+{
+    TemporaryDirectoryHandle dir;
+    std::filesystem::path schema = dir.path / "schema";
+    std::filesystem::create_directory(schema);
+    boost::asio::io_context ioc;
+    int changes = 0;
+    DirectoryWatcher watcher(ioc, schema, [&changes]() { changes++; });
+    ASSERT_TRUE(watcher.isWatching());
+
+    std::filesystem::remove(schema);
+    ioc.run_one_for(std::chrono::seconds(1));
+    EXPECT_FALSE(watcher.isWatching());
+
+    std::filesystem::create_directory(schema);
+    int before = changes;
+    ioc.restart();
+    ioc.run_one_for(std::chrono::seconds(3));
+    EXPECT_TRUE(watcher.isWatching());
+    EXPECT_GT(changes, before);
+
+    before = changes;
+    {
+        std::ofstream file(schema / "Chassis_v1.xml");
+        file << "<edmx:Edmx/>";
+    }
+    ioc.restart();
+    ioc.run_one_for(std::chrono::seconds(1));
+    EXPECT_GT(changes, before);
+}
+
+TEST(DirectoryWatcher, MissingDirectory)
+{
+    boost::asio::io_context ioc;
+    DirectoryWatcher watcher(ioc, "/this/directory/does/not/exist", []() {});
+    EXPECT_FALSE(watcher.isWatching());
+}
+
+} // namespace
+} // namespace bmcweb
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "benchmark_utils.hpp"
+#include "human_sort.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+constexpr size_t sensorCount = 500;
+constexpr size_t sortCount = 20;
+
+// The text either side of the sensor number
+constexpr std::array<std::array<std::string_view, 2>, 5> sensorKinds = {{
+    {"CPU", " Temp"},
+    {"DIMM", " Temp"},
+    {"Fan", ""},
+    {"PSU", " Input Voltage"},
+    {"P", "V_AUX"},
+}};
+
+// Sensor names as a large system has them, in the order they're found
+std::vector<std::string> makeNames()
+{
+    std::vector<std::string> names;
+    names.reserve(sensorCount);
+    for (size_t i = 0; i < sensorCount; i++)
+    {
+        size_t n = (i * 7919) % sensorCount;
+        const std::array<std::string_view, 2>& kind =
+            sensorKinds[n % sensorKinds.size()];
+        names.emplace_back(std::format("{}{}{}", kind[0], n, kind[1]));
+    }
+    return names;
+}
+
+nlohmann::json::array_t makeSensors(const std::vector<std::string>& names)
+{
+    nlohmann::json::array_t sensors;
+    sensors.reserve(names.size());
+    for (const std::string& name : names)
+    {
+        nlohmann::json::object_t sensor;
+        sensor["@odata.id"] =
+            "/redfish/v1/Chassis/chassis/Thermal#/Temperatures/" + name;
+        sensor["Name"] = name;
+        sensor["ReadingCelsius"] = 40.5;
+        sensor["Status"]["State"] = "Enabled";
+        sensor["Status"]["Health"] = "OK";
+        sensor["UpperThresholdCritical"] = 95.0;
+        sensors.emplace_back(std::move(sensor));
+    }
+    return sensors;
+}
+
+TEST(HumanSortBenchmark, FiveHundredSensorNames)
+{
+    const std::vector<std::string> names = makeNames();
+
+    std::vector<std::string> compared;
+    double comparedNs = bmcweb::benchmark::nsPerIteration(sortCount, [&]() {
+        for (size_t i = 0; i < sortCount; i++)
+        {
+            compared = names;
+            std::ranges::sort(compared, AlphanumLess<std::string>());
+        }
+    });
+
+    std::vector<std::string> keyed;
+    double keyedNs = bmcweb::benchmark::nsPerIteration(sortCount, [&]() {
+        for (size_t i = 0; i < sortCount; i++)
+        {
+            keyed = names;
+            naturalSort(keyed);
+        }
+    });
+
+    EXPECT_EQ(compared, keyed);
+    bmcweb::benchmark::report("AlphanumLess sort (500 names)", comparedNs);
+    bmcweb::benchmark::report("sort key sort (500 names)", keyedNs);
+    EXPECT_LT(keyedNs, comparedNs);
+}
+
+TEST(HumanSortBenchmark, FiveHundredSensorObjects)
+{
+    const nlohmann::json::array_t sensors = makeSensors(makeNames());
+
+    // Each sort starts from a copy; that part is the same for both
+    nlohmann::json::array_t copied;
+    double copyNs = bmcweb::benchmark::nsPerIteration(sortCount, [&]() {
+        for (size_t i = 0; i < sortCount; i++)
+        {
+            copied = sensors;
+        }
+    });
+
+    nlohmann::json::array_t compared;
+    double comparedNs = bmcweb::benchmark::nsPerIteration(sortCount, [&]() {
+        for (size_t i = 0; i < sortCount; i++)
+        {
+            compared = sensors;
+            std::ranges::sort(compared, [](const nlohmann::json& left,
+                                           const nlohmann::json& right) {
+                return alphanumComp(
+                           left["Name"].get_ref<const std::string&>(),
+                           right["Name"].get_ref<const std::string&>()) < 0;
+            });
+        }
+    });
+
+    nlohmann::json::array_t keyed;
+    double keyedNs = bmcweb::benchmark::nsPerIteration(sortCount, [&]() {
+        for (size_t i = 0; i < sortCount; i++)
+        {
+            keyed = sensors;
+            sortByKey(keyed, [](std::string& key,
+                                const nlohmann::json& sensor) {
+                const nlohmann::json& name = sensor["Name"];
+                appendNaturalSortKey(key, name.get_ref<const std::string&>());
+            });
+        }
+    });
+
+    EXPECT_EQ(compared, keyed);
+    bmcweb::benchmark::report("AlphanumLess sort (500 objects)",
+                              comparedNs - copyNs);
+    bmcweb::benchmark::report("sort key sort (500 objects)", keyedNs - copyNs);
+    EXPECT_LT(keyedNs, comparedNs);
+}
+
+} // namespace
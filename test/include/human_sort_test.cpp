@@ -2,8 +2,12 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #include "human_sort.hpp"
 
+#include <cstddef>
 #include <set>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -52,4 +56,69 @@ TEST(AlphaNum, LessTest)
         "Alpha 10", "Alpha 2"};
     EXPECT_THAT(sorted, ElementsAreArray({"Alpha 2", "Alpha 10"}));
 }
+
+int sign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+TEST(NaturalSortKey, OrdersAsAlphanumComp)
+{
+    // Every string of up to three characters from a set that covers digit
+    // runs, leading zeros, and characters either side of the digits
+    constexpr std::string_view chars("a 0195Z~\xe9");
+    std::vector<std::string> strings{""};
+    for (size_t begin = 0, length = 0; length < 3; length++)
+    {
+        size_t end = strings.size();
+        for (size_t i = begin; i < end; i++)
+        {
+            for (char c : chars)
+            {
+                strings.emplace_back(strings[i] + c);
+            }
+        }
+        begin = end;
+    }
+
+    std::vector<std::string> keys;
+    keys.reserve(strings.size());
+    for (const std::string& str : strings)
+    {
+        keys.emplace_back(naturalSortKey(str));
+    }
+    for (size_t i = 0; i < strings.size(); i++)
+    {
+        for (size_t j = 0; j < strings.size(); j++)
+        {
+            ASSERT_EQ(sign(keys[i].compare(keys[j])),
+                      sign(alphanumComp(strings[i], strings[j])))
+                << '"' << strings[i] << "\" \"" << strings[j] << '"';
+        }
+    }
+}
+
+TEST(NaturalSortKey, LongNumbersCompareByValue)
+{
+    EXPECT_LT(naturalSortKey("a99999999999"), naturalSortKey("a100000000000"));
+    EXPECT_EQ(naturalSortKey("a007"), naturalSortKey("a7"));
+}
+
+TEST(NaturalSort, SortsStableByKey)
+{
+    std::vector<std::string> names{"Alpha 10", "Alpha 2", "Alpha 02",
+                                   "Alpha 1"};
+    naturalSort(names);
+    EXPECT_THAT(names, ElementsAreArray({"Alpha 1", "Alpha 2", "Alpha 02",
+                                         "Alpha 10"}));
+
+    std::vector<std::pair<std::string, int>> pairs{
+        {"b", 1}, {"a", 2}, {"b", 3}, {"a", 4}};
+    sortByKey(pairs, [](std::string& key,
+                        const std::pair<std::string, int>& item) {
+        appendNaturalSortKey(key, item.first);
+    });
+    EXPECT_EQ(pairs, (std::vector<std::pair<std::string, int>>{
+                         {"a", 2}, {"a", 4}, {"b", 1}, {"b", 3}}));
+}
 } // namespace
@@ -3,7 +3,9 @@
 #include "http_request.hpp"
 #include "multipart_parser.hpp"
 
+#include <cstddef>
 #include <iterator>
+#include <string>
 #include <string_view>
 #include <system_error>
 #include <vector>
@@ -447,4 +449,98 @@ TEST_F(MultipartTest, TestFinalBoundaryIsCorrectlyRecognized)
               "StillData1");
 }
 
+TEST_F(MultipartTest, TestIncrementalParseMatchesWholeBody)
+{
+    std::string_view body =
+        "-----------------------------d74496d66958873e\r\n"
+        "Content-Disposition: form-data; name=\"Test1\"\r\n\r\n"
+        "111111111111111111111111112222222222222222222222222222222\r\n"
+        "-----------------------------d74496d66958873e\r\n"
+        "Content-Disposition: form-data; name=\"Test2\"\r\n"
+        "Content-Type: application/octet-stream\r\n\r\n"
+        "{\r\n-----------------------------d74496d66958873e123456\r\n"
+        "-----------------------------d74496d66958873e\r\n"
+        "Content-Disposition: form-data; name=\"Test3\"\r\n\r\n"
+        "{\r\n--------d74496d6695887}\r\n"
+        "-----------------------------d74496d66958873e--\r\n";
+    std::string_view contentType =
+        "multipart/form-data; "
+        "boundary=---------------------------d74496d66958873e";
+
+    // Every split of the body, including ones inside headers and boundaries
+    for (size_t chunkSize = 1; chunkSize <= body.size(); chunkSize++)
+    {
+        MultipartParser chunked;
+        ASSERT_EQ(chunked.begin(contentType), ParserError::PARSER_SUCCESS);
+        for (size_t pos = 0; pos < body.size(); pos += chunkSize)
+        {
+            ASSERT_EQ(chunked.feed(body.substr(pos, chunkSize)),
+                      ParserError::PARSER_SUCCESS);
+        }
+        ASSERT_EQ(chunked.finish(), ParserError::PARSER_SUCCESS);
+
+        ASSERT_EQ(chunked.mime_fields.size(), 3) << chunkSize;
+        EXPECT_EQ(chunked.mime_fields[0].fields.at("Content-Disposition"),
+                  "form-data; name=\"Test1\"");
+        EXPECT_EQ(chunked.mime_fields[0].content,
+                  "111111111111111111111111112222222222222222222222222222222");
+        EXPECT_EQ(chunked.mime_fields[1].fields.at("Content-Type"),
+                  "application/octet-stream");
+        EXPECT_EQ(chunked.mime_fields[1].content,
+                  "{\r\n-----------------------------d74496d66958873e123456");
+        EXPECT_EQ(chunked.mime_fields[2].content,
+                  "{\r\n--------d74496d6695887}");
+    }
+}
+
+TEST_F(MultipartTest, TestPartDataHandlerReceivesContent)
+{
+    std::string_view body =
+        "----XX\r\n"
+        "Content-Disposition: form-data; name=\"Small\"\r\n\r\n"
+        "Data1\r\n"
+        "----XX\r\n"
+        "Content-Disposition: form-data; name=\"Large\"\r\n\r\n"
+        "0123456789\r\n--X0123456789\r\n"
+        "----XX--\r\n";
+
+    std::vector<std::string> received(2);
+    ASSERT_EQ(parser.begin("multipart/form-data; boundary=--XX"),
+              ParserError::PARSER_SUCCESS);
+    parser.setPartDataHandler(
+        [this, &received](FormPart& part, std::string_view data) {
+            EXPECT_EQ(&part, &parser.mime_fields.back());
+            received[parser.mime_fields.size() - 1] += data;
+            return true;
+        });
+    for (size_t pos = 0; pos < body.size(); pos += 7)
+    {
+        ASSERT_EQ(parser.feed(body.substr(pos, 7)),
+                  ParserError::PARSER_SUCCESS);
+    }
+    ASSERT_EQ(parser.finish(), ParserError::PARSER_SUCCESS);
+
+    ASSERT_EQ(parser.mime_fields.size(), 2);
+    EXPECT_EQ(received[0], "Data1");
+    EXPECT_EQ(received[1], "0123456789\r\n--X0123456789");
+    // The content went to the handler only
+    EXPECT_TRUE(parser.mime_fields[0].content.empty());
+    EXPECT_TRUE(parser.mime_fields[1].content.empty());
+}
+
+TEST_F(MultipartTest, TestPartDataHandlerCanReject)
+{
+    std::string_view body =
+        "----XX\r\n"
+        "Content-Disposition: form-data; name=\"Test1\"\r\n\r\n"
+        "Data1\r\n"
+        "----XX--\r\n";
+
+    ASSERT_EQ(parser.begin("multipart/form-data; boundary=--XX"),
+              ParserError::PARSER_SUCCESS);
+    parser.setPartDataHandler(
+        [](FormPart& /*part*/, std::string_view /*data*/) { return false; });
+    EXPECT_EQ(parser.feed(body), ParserError::ERROR_PART_REJECTED);
+}
+
 } // namespace
@@ -54,4 +54,20 @@ TEST(AuthConfigMethods, FromJsonMTLSCommonNameParseModeOutOfRange)
     EXPECT_EQ(methods.xtoken, true);
     EXPECT_EQ(methods.mTLSCommonNameParsingMode, prevValue);
 }
+
+TEST(SessionStore, WrittenStateIsClean)
+{
+    persistent_data::SessionStore& store =
+        persistent_data::SessionStore::getInstance();
+    int writes = 0;
+    store.setWriteHandler([&writes]() { writes++; });
+
+    store.markNeedsWrite();
+    EXPECT_TRUE(store.needsWrite());
+    EXPECT_EQ(writes, 1);
+
+    store.markWritten();
+    EXPECT_FALSE(store.needsWrite());
+    store.setWriteHandler(nullptr);
+}
 } // namespace
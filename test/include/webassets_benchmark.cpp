@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "async_resp.hpp"
+#include "benchmark_utils.hpp"
+#include "http_body.hpp"
+#include "http_request.hpp"
+#include "http_response.hpp"
+#include "webassets.hpp"
+
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/verb.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace crow::webassets
+{
+namespace
+{
+
+// Roughly the shape of a web UI build: a few large bundles, and many small
+// chunks, fonts and images
+constexpr size_t assetCount = 100;
+
+size_t assetSize(size_t index)
+{
+    if (index % 25 == 0)
+    {
+        return 200UL * 1024UL;
+    }
+    return 2048UL + (index * 997UL) % (24UL * 1024UL);
+}
+
+class WebAssetsBenchmark : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        root = std::filesystem::temp_directory_path() /
+               "bmcweb_webassets_benchmark";
+        std::filesystem::create_directories(root);
+        for (size_t i = 0; i < assetCount; i++)
+        {
+            StaticFile file;
+            file.absolutePath = root / std::format("chunk-{}.0123abcd.js", i);
+            file.contentType = "application/javascript;charset=UTF-8";
+            file.etag = "\"0123abcd\"";
+            std::ofstream out(file.absolutePath, std::ios::binary);
+            out << std::string(assetSize(i), static_cast<char>('a' + i % 26));
+            files.emplace_back(std::move(file));
+        }
+    }
+
+    void TearDown() override
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(root, ec);
+    }
+
+    // Serves every asset once, as a browser with an empty cache would, and
+    // returns the number of body bytes produced
+    size_t loadWebUi() const
+    {
+        size_t total = 0;
+        for (const StaticFile& file : files)
+        {
+            std::error_code ec;
+            crow::Request req(
+                boost::beast::http::request<bmcweb::HttpBody>(
+                    boost::beast::http::verb::get, "/chunk.js", 11),
+                ec);
+            auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+            handleStaticAsset(req, asyncResp, file);
+
+            boost::beast::http::response<bmcweb::HttpBody>& response =
+                asyncResp->res.response;
+            bmcweb::HttpBody::writer writer(response.base(), response.body());
+            boost::beast::error_code writeEc;
+            writer.init(writeEc);
+            while (true)
+            {
+                auto chunk = writer.get(writeEc);
+                if (!chunk || writeEc)
+                {
+                    break;
+                }
+                total += chunk->first.size();
+                if (!chunk->second)
+                {
+                    break;
+                }
+            }
+        }
+        return total;
+    }
+
+    std::filesystem::path root;
+    std::vector<StaticFile> files;
+};
+
+TEST_F(WebAssetsBenchmark, ColdWebUiLoad)
+{
+    size_t expected = 0;
+    for (size_t i = 0; i < assetCount; i++)
+    {
+        expected += assetSize(i);
+    }
+
+    // The files are in the page cache here, so this understates what the
+    // cache saves on a BMC, where every open and read can wait on eMMC
+    ASSERT_EQ(loadWebUi(), expected);
+    bmcweb::benchmark::report(
+        "webui load, from disk",
+        bmcweb::benchmark::nsPerIteration(1, [this]() { loadWebUi(); }));
+
+    StaticAssetCache cache(64UL * 1024UL * 1024UL);
+    for (StaticFile& file : files)
+    {
+        file.mapped = cache.load(file.absolutePath);
+        ASSERT_NE(file.mapped, nullptr);
+    }
+    EXPECT_EQ(cache.size(), expected);
+    ASSERT_EQ(loadWebUi(), expected);
+    bmcweb::benchmark::report(
+        "webui load, from cache",
+        bmcweb::benchmark::nsPerIteration(1, [this]() { loadWebUi(); }));
+}
+
+TEST_F(WebAssetsBenchmark, CacheStopsAtCapacity)
+{
+    StaticAssetCache cache(512UL * 1024UL);
+    size_t cached = 0;
+    for (StaticFile& file : files)
+    {
+        file.mapped = cache.load(file.absolutePath);
+        if (file.mapped != nullptr)
+        {
+            cached++;
+        }
+    }
+    EXPECT_LE(cache.size(), 512UL * 1024UL);
+    EXPECT_GT(cached, 0U);
+    EXPECT_LT(cached, assetCount);
+    // Files that didn't fit are still served, from disk
+    size_t expected = 0;
+    for (size_t i = 0; i < assetCount; i++)
+    {
+        expected += assetSize(i);
+    }
+    EXPECT_EQ(loadWebUi(), expected);
+}
+
+} // namespace
+} // namespace crow::webassets
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "certificate_cache.hpp"
+#include "dbus_utility.hpp"
+
+#include <boost/system/errc.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace
+{
+
+using dbus::utility::DBusInterfacesMap;
+using dbus::utility::DbusVariantType;
+
+const std::string https = "/xyz/openbmc_project/certs/server/https/1";
+const std::string ldap = "/xyz/openbmc_project/certs/client/ldap/1";
+
+DBusInterfacesMap certificateInterfaces(const std::string& subject)
+{
+    return {{"xyz.openbmc_project.Certs.Certificate",
+             {{"Subject", DbusVariantType(subject)},
+              {"ValidNotAfter",
+               DbusVariantType(static_cast<uint64_t>(1700000000))}}}};
+}
+
+std::set<std::string> cachedPaths(CertificateCache& cache)
+{
+    std::set<std::string> out;
+    cache.getPaths([&out](const boost::system::error_code& ec,
+                          const std::set<std::string>& paths) {
+        EXPECT_FALSE(ec);
+        out = paths;
+    });
+    return out;
+}
+
+TEST(CertificateProperties, ReadFromProperties)
+{
+    CertificateProperties certificate;
+    ASSERT_TRUE(readCertificateProperties(
+        {{"CertificateString", DbusVariantType(std::string("PEM"))},
+         {"KeyUsage", DbusVariantType(std::vector<std::string>{"ServerAuth"})},
+         {"Issuer", DbusVariantType(std::string("CN=ca"))},
+         {"ValidNotBefore", DbusVariantType(static_cast<uint64_t>(1))}},
+        certificate));
+    EXPECT_EQ(certificate.certificateString, "PEM");
+    EXPECT_EQ(certificate.keyUsage, std::vector<std::string>{"ServerAuth"});
+    EXPECT_EQ(certificate.issuer, "CN=ca");
+    EXPECT_EQ(certificate.subject, std::nullopt);
+    EXPECT_EQ(certificate.validNotBefore, 1U);
+    EXPECT_EQ(certificate.validNotAfter, std::nullopt);
+
+    EXPECT_FALSE(readCertificateProperties(
+        {{"Issuer", DbusVariantType(static_cast<uint64_t>(1))}}, certificate));
+}
+
+TEST(CertificateCache, PathsFollowSignals)
+{
+    CertificateCache cache;
+    cache.afterGetPaths(boost::system::error_code(), {https});
+    EXPECT_EQ(cachedPaths(cache), std::set<std::string>{https});
+
+    cache.onInterfacesAdded(ldap, certificateInterfaces("CN=ldap"));
+    cache.onInterfacesAdded("/xyz/openbmc_project/certs/csr/1",
+                            {{"xyz.openbmc_project.Certs.CSR", {}}});
+    EXPECT_EQ(cachedPaths(cache), (std::set<std::string>{ldap, https}));
+
+    std::vector<std::string> removed{"xyz.openbmc_project.Certs.Certificate"};
+    cache.onInterfacesRemoved(https, removed);
+    EXPECT_EQ(cachedPaths(cache), std::set<std::string>{ldap});
+}
+
+TEST(CertificateCache, NoCertificatesLoadsEmpty)
+{
+    CertificateCache cache;
+    cache.afterGetPaths(
+        boost::system::errc::make_error_code(boost::system::errc::io_error),
+        {});
+    EXPECT_TRUE(cachedPaths(cache).empty());
+}
+
+TEST(CertificateCache, PropertiesFromSignalsUntilChanged)
+{
+    CertificateCache cache;
+    cache.onInterfacesAdded(https, certificateInterfaces("CN=bmc"));
+    ASSERT_TRUE(cache.hasProperties(https));
+
+    bool called = false;
+    cache.getProperties(
+        "xyz.openbmc_project.Certs.Manager.Server.Https", https,
+        [&called](const boost::system::error_code& ec,
+                  const CertificateProperties& certificate) {
+            called = true;
+            EXPECT_FALSE(ec);
+            EXPECT_EQ(certificate.subject, "CN=bmc");
+            EXPECT_EQ(certificate.validNotAfter, 1700000000U);
+        });
+    EXPECT_TRUE(called);
+
+    // Other interfaces of the certificate don't change it
+    cache.onPropertiesChanged(https, "xyz.openbmc_project.Object.Delete");
+    EXPECT_TRUE(cache.hasProperties(https));
+    cache.onPropertiesChanged(https, "xyz.openbmc_project.Certs.Certificate");
+    EXPECT_FALSE(cache.hasProperties(https));
+
+    cache.onInterfacesAdded(https, certificateInterfaces("CN=bmc"));
+    cache.invalidate(https);
+    EXPECT_FALSE(cache.hasProperties(https));
+}
+
+TEST(CertificateCache, ResetForgetsEverything)
+{
+    CertificateCache cache;
+    cache.afterGetPaths(boost::system::error_code(), {https});
+    cache.onInterfacesAdded(https, certificateInterfaces("CN=bmc"));
+    cache.reset();
+    EXPECT_FALSE(cache.hasProperties(https));
+    cache.afterGetPaths(boost::system::error_code(), {ldap});
+    EXPECT_EQ(cachedPaths(cache), std::set<std::string>{ldap});
+}
+
+} // namespace
+} // namespace redfish
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "dbus_utility.hpp"
+#include "dump_entry_cache.hpp"
+#include "generated/enums/log_entry.hpp"
+
+#include <sdbusplus/message/native_types.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace
+{
+
+using dbus::utility::DBusInterfacesMap;
+using dbus::utility::DbusVariantType;
+using dbus::utility::ManagedObjectType;
+
+constexpr const char* completed =
+    "xyz.openbmc_project.Common.Progress.OperationStatus.Completed";
+constexpr const char* inProgress =
+    "xyz.openbmc_project.Common.Progress.OperationStatus.InProgress";
+
+DBusInterfacesMap entryInterfaces(const std::string& status, uint64_t size)
+{
+    return {
+        {"xyz.openbmc_project.Common.Progress",
+         {{"Status", DbusVariantType(status)}}},
+        {"xyz.openbmc_project.Dump.Entry", {{"Size", DbusVariantType(size)}}},
+        {"xyz.openbmc_project.Time.EpochTime",
+         {{"Elapsed", DbusVariantType(static_cast<uint64_t>(1000))}}},
+    };
+}
+
+std::vector<std::string> ids(const DumpEntryCache::Entries& entries)
+{
+    std::vector<std::string> out;
+    for (const auto* entry : DumpEntryCache::sorted(entries))
+    {
+        out.emplace_back(entry->first);
+    }
+    return out;
+}
+
+TEST(DumpEntry, UpdateFromProperties)
+{
+    DumpEntry entry;
+    updateDumpEntry(
+        {{"Status", DbusVariantType(std::string(completed))},
+         {"Size", DbusVariantType(static_cast<uint64_t>(4096))},
+         {"Elapsed", DbusVariantType(static_cast<uint64_t>(1234))},
+         {"OriginatorId", DbusVariantType(std::string("admin"))},
+         {"OriginatorType",
+          DbusVariantType(std::string(
+              "xyz.openbmc_project.Common.OriginatedBy.OriginatorTypes.Client"))},
+         {"Offloaded", DbusVariantType(false)}},
+        entry);
+    EXPECT_TRUE(entry.completed());
+    EXPECT_FALSE(entry.malformed);
+    EXPECT_EQ(entry.size, 4096U);
+    EXPECT_EQ(entry.timestampUs, 1234U);
+    EXPECT_EQ(entry.originatorId, "admin");
+    EXPECT_EQ(entry.originatorType, log_entry::OriginatorTypes::Client);
+
+    updateDumpEntry({{"Size", DbusVariantType(std::string("big"))}}, entry);
+    EXPECT_TRUE(entry.malformed);
+    EXPECT_EQ(entry.size, 4096U);
+}
+
+TEST(DumpEntryCache, KeepsEntriesOfItsTypeInOrder)
+{
+    DumpEntryCache cache("/xyz/openbmc_project/dump/bmc/entry");
+    ManagedObjectType objects;
+    for (const char* path : {"/xyz/openbmc_project/dump/bmc/entry/10",
+                             "/xyz/openbmc_project/dump/bmc/entry/9",
+                             "/xyz/openbmc_project/dump/system/entry/1",
+                             "/xyz/openbmc_project/dump/bmc/entry/2",
+                             "/xyz/openbmc_project/dump/bmc/entry/02"})
+    {
+        objects.emplace_back(sdbusplus::message::object_path(path),
+                             entryInterfaces(completed, 1));
+    }
+    cache.load(objects);
+
+    bool called = false;
+    cache.get([&called](const boost::system::error_code& ec,
+                        const DumpEntryCache::Entries& entries) {
+        called = true;
+        EXPECT_FALSE(ec);
+        // "02" and "2" sort the same, but are different entries
+        EXPECT_EQ(ids(entries),
+                  (std::vector<std::string>{"02", "2", "9", "10"}));
+    });
+    EXPECT_TRUE(called);
+}
+
+TEST(DumpEntryCache, FollowsSignals)
+{
+    DumpEntryCache cache("/xyz/openbmc_project/dump/bmc/entry");
+    cache.load({});
+
+    sdbusplus::message::object_path entry(
+        "/xyz/openbmc_project/dump/bmc/entry/3");
+    cache.onInterfacesAdded(entry, entryInterfaces(inProgress, 0));
+    cache.onInterfacesAdded(
+        sdbusplus::message::object_path(
+            "/xyz/openbmc_project/dump/faultlog/entry/4"),
+        entryInterfaces(completed, 0));
+
+    cache.onPropertiesChanged(
+        entry, "xyz.openbmc_project.Common.Progress",
+        {{"Status", DbusVariantType(std::string(completed))}});
+    cache.onPropertiesChanged(
+        entry, "xyz.openbmc_project.Dump.Entry",
+        {{"Size", DbusVariantType(static_cast<uint64_t>(512))}});
+
+    cache.get([](const boost::system::error_code& /*ec*/,
+                 const DumpEntryCache::Entries& entries) {
+        ASSERT_EQ(ids(entries), (std::vector<std::string>{"3"}));
+        EXPECT_TRUE(entries.at("3").completed());
+        EXPECT_EQ(entries.at("3").size, 512U);
+    });
+
+    // Removing an interface the entry keeps doesn't remove it
+    cache.onInterfacesRemoved(entry, {"xyz.openbmc_project.Object.Delete"});
+    cache.get([](const boost::system::error_code& /*ec*/,
+                 const DumpEntryCache::Entries& entries) {
+        EXPECT_EQ(entries.size(), 1U);
+    });
+
+    cache.onInterfacesRemoved(entry, {"xyz.openbmc_project.Dump.Entry",
+                                      "xyz.openbmc_project.Common.Progress"});
+    cache.get([](const boost::system::error_code& /*ec*/,
+                 const DumpEntryCache::Entries& entries) {
+        EXPECT_TRUE(entries.empty());
+    });
+}
+
+} // namespace
+} // namespace redfish
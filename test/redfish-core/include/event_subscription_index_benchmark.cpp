@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "benchmark_utils.hpp"
+#include "event_matches_filter.hpp"
+#include "event_service_store.hpp"
+#include "event_subscription_index.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <cstddef>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace
+{
+
+constexpr size_t subscriptionCount = 500;
+constexpr size_t eventCount = 1000;
+
+constexpr std::array<std::string_view, 4> registries = {"OpenBMC", "Task",
+                                                        "Base", "Update"};
+constexpr std::array<std::string_view, 4> resourceTypes = {
+    "Event", "Task", "Chassis", "Systems"};
+
+// A mix of the filters clients use in practice: a few subscriptions with no
+// filters, and the rest split between message ids, origins, resource types
+// and registry prefixes, some combining more than one.
+std::vector<persistent_data::UserSubscription> makeSubscriptions()
+{
+    std::vector<persistent_data::UserSubscription> subs(subscriptionCount);
+    for (size_t i = 0; i < subs.size(); i++)
+    {
+        persistent_data::UserSubscription& sub = subs[i];
+        std::string_view registry = registries[i % registries.size()];
+        switch (i % 6)
+        {
+            case 0:
+                if (i % 60 == 0)
+                {
+                    // No filters
+                    break;
+                }
+                sub.registryMsgIds.emplace_back(
+                    std::format("{}.Message{}", registry, i % 50));
+                break;
+            case 1:
+                sub.originResources.emplace_back(
+                    std::format("/redfish/v1/Chassis/chassis{}", i % 100));
+                break;
+            case 2:
+                sub.resourceTypes.emplace_back(
+                    resourceTypes[i % resourceTypes.size()]);
+                sub.registryPrefixes.emplace_back(registry);
+                break;
+            case 3:
+                sub.registryPrefixes.emplace_back(registry);
+                sub.originResources.emplace_back(
+                    std::format("/redfish/v1/Chassis/chassis{}", i % 100));
+                break;
+            case 4:
+                sub.registryMsgIds.emplace_back(
+                    std::format("{}.Message{}", registry, i % 50));
+                sub.registryMsgIds.emplace_back(
+                    std::format("{}.Message{}", registry, (i + 1) % 50));
+                break;
+            default:
+                sub.registryPrefixes.emplace_back(registry);
+                break;
+        }
+    }
+    return subs;
+}
+
+std::vector<nlohmann::json::object_t> makeEvents()
+{
+    std::vector<nlohmann::json::object_t> events(eventCount);
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        events[i]["MessageId"] = std::format(
+            "{}.1.0.Message{}", registries[i % registries.size()], i % 50);
+        events[i]["OriginOfCondition"] =
+            std::format("/redfish/v1/Chassis/chassis{}", i % 100);
+    }
+    return events;
+}
+
+TEST(EventSubscriptionIndexBenchmark, FiveHundredSubscriptions)
+{
+    std::vector<persistent_data::UserSubscription> subs = makeSubscriptions();
+    std::vector<nlohmann::json::object_t> events = makeEvents();
+
+    EventSubscriptionIndex index;
+    double rebuildNs = bmcweb::benchmark::nsPerIteration(1, [&]() {
+        index.clear();
+        for (const persistent_data::UserSubscription& sub : subs)
+        {
+            index.add(sub);
+        }
+    });
+
+    size_t linearMatches = 0;
+    double linearNs = bmcweb::benchmark::nsPerIteration(events.size(), [&]() {
+        linearMatches = 0;
+        for (const nlohmann::json::object_t& event : events)
+        {
+            for (const persistent_data::UserSubscription& sub : subs)
+            {
+                if (eventMatchesFilter(sub, event, "Event"))
+                {
+                    linearMatches++;
+                }
+            }
+        }
+    });
+
+    size_t indexedMatches = 0;
+    std::vector<size_t> slots;
+    double indexedNs = bmcweb::benchmark::nsPerIteration(events.size(), [&]() {
+        indexedMatches = 0;
+        for (const nlohmann::json::object_t& event : events)
+        {
+            index.match(event, "Event", slots);
+            indexedMatches += slots.size();
+        }
+    });
+
+    EXPECT_EQ(linearMatches, indexedMatches);
+    EXPECT_GT(indexedMatches, 0U);
+
+    bmcweb::benchmark::report("index rebuild (500 subscriptions)", rebuildNs);
+    bmcweb::benchmark::report("linear filter per event", linearNs);
+    bmcweb::benchmark::report("indexed filter per event", indexedNs);
+    EXPECT_LT(indexedNs, linearNs);
+}
+
+} // namespace
+} // namespace redfish
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "event_matches_filter.hpp"
+#include "event_service_store.hpp"
+#include "event_subscription_index.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace
+{
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+std::vector<persistent_data::UserSubscription> makeSubscriptions()
+{
+    std::vector<persistent_data::UserSubscription> subs(7);
+    // 0: no filters
+    // 1: single message id
+    subs[1].registryMsgIds.emplace_back("OpenBMC.PostComplete");
+    // 2: registry prefix and resource type
+    subs[2].registryPrefixes.emplace_back("OpenBMC");
+    subs[2].resourceTypes.emplace_back("Task");
+    // 3: origin, with a duplicate entry
+    subs[3].originResources.emplace_back("/redfish/v1/Managers/bmc");
+    subs[3].originResources.emplace_back("/redfish/v1/Managers/bmc");
+    // 4: message id and origin
+    subs[4].registryMsgIds.emplace_back("Task.TaskStarted");
+    subs[4].originResources.emplace_back("/redfish/v1/TaskService/Tasks/0");
+    // 5: resource types only
+    subs[5].resourceTypes.emplace_back("Event");
+    subs[5].resourceTypes.emplace_back("Task");
+    // 6: registry prefixes only
+    subs[6].registryPrefixes.emplace_back("Task");
+    subs[6].registryPrefixes.emplace_back("Base");
+    return subs;
+}
+
+std::vector<size_t> bruteForce(
+    const std::vector<persistent_data::UserSubscription>& subs,
+    const nlohmann::json::object_t& event, std::string_view resType)
+{
+    std::vector<size_t> out;
+    for (size_t slot = 0; slot < subs.size(); slot++)
+    {
+        if (eventMatchesFilter(subs[slot], event, resType))
+        {
+            out.emplace_back(slot);
+        }
+    }
+    return out;
+}
+
+TEST(EventSubscriptionIndex, MatchesEventMatchesFilter)
+{
+    std::vector<persistent_data::UserSubscription> subs = makeSubscriptions();
+    EventSubscriptionIndex index;
+    for (const persistent_data::UserSubscription& sub : subs)
+    {
+        index.add(sub);
+    }
+    EXPECT_EQ(index.size(), subs.size());
+
+    std::vector<nlohmann::json::object_t> events(6);
+    events[1]["MessageId"] = "OpenBMC.0.1.PostComplete";
+    events[2]["MessageId"] = "Task.1.0.TaskStarted";
+    events[2]["OriginOfCondition"] = "/redfish/v1/TaskService/Tasks/0";
+    events[3]["OriginOfCondition"] = "/redfish/v1/Managers/bmc";
+    events[4]["MessageId"] = "Base.1.13.Success";
+    events[4]["OriginOfCondition"] = "/redfish/v1/Managers/bmc";
+    // Malformed and non string values
+    events[5]["MessageId"] = 5;
+    events[5]["OriginOfCondition"] = "NotAUri";
+
+    std::vector<size_t> slots;
+    for (const nlohmann::json::object_t& event : events)
+    {
+        for (std::string_view resType : {"", "Event", "Task", "Chassis"})
+        {
+            index.match(event, resType, slots);
+            EXPECT_EQ(slots, bruteForce(subs, event, resType))
+                << nlohmann::json(event).dump() << " " << resType;
+        }
+    }
+
+    index.match(events[2], "Task", slots);
+    EXPECT_THAT(slots, ElementsAre(0, 4, 5, 6));
+}
+
+TEST(EventSubscriptionIndex, MetricReports)
+{
+    EventSubscriptionIndex index;
+    persistent_data::UserSubscription all;
+    persistent_data::UserSubscription one;
+    one.metricReportDefinitions.emplace_back(
+        "/redfish/v1/TelemetryService/MetricReportDefinitions/Power");
+    index.add(one);
+    index.add(all);
+
+    std::vector<size_t> slots;
+    index.matchMetricReport(
+        "/redfish/v1/TelemetryService/MetricReportDefinitions/Power", slots);
+    EXPECT_THAT(slots, ElementsAre(0, 1));
+    index.matchMetricReport(
+        "/redfish/v1/TelemetryService/MetricReportDefinitions/Thermal", slots);
+    EXPECT_THAT(slots, ElementsAre(1));
+
+    index.clear();
+    index.matchMetricReport(
+        "/redfish/v1/TelemetryService/MetricReportDefinitions/Power", slots);
+    EXPECT_THAT(slots, IsEmpty());
+}
+
+} // namespace
+} // namespace redfish
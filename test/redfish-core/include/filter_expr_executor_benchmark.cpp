@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "benchmark_utils.hpp"
+#include "filter_expr_executor.hpp"
+#include "filter_expr_parser_ast.hpp"
+#include "filter_expr_printer.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <format>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace
+{
+
+constexpr size_t entryCount = 10000;
+
+nlohmann::json::array_t makeLogEntries()
+{
+    nlohmann::json::array_t entries;
+    entries.reserve(entryCount);
+    for (size_t i = 0; i < entryCount; i++)
+    {
+        nlohmann::json::object_t entry;
+        entry["Id"] = i;
+        entry["Severity"] = (i % 3 == 0) ? "Critical" : "OK";
+        entry["Created"] =
+            std::format("20{:02}-06-01T12:00:00+00:00", 15 + (i % 10));
+        entry["MessageId"] = std::format("OpenBMC.0.1.Message{}", i % 7);
+        entry["Oem"]["Count"] = i % 5;
+        entries.emplace_back(std::move(entry));
+    }
+    return entries;
+}
+
+TEST(FilterExprExecutorBenchmark, FiveClauseFilter)
+{
+    std::optional<filter_ast::LogicalAnd> ast = parseFilter(
+        "Severity eq 'Critical' and Id gt 100 and "
+        "Created gt '2020-01-01T00:00:00+00:00' and "
+        "(MessageId eq 'OpenBMC.0.1.Message3' or Oem/Count ge 3)");
+    ASSERT_TRUE(ast);
+
+    const nlohmann::json::array_t entries = makeLogEntries();
+
+    size_t astMatches = 0;
+    double astNs = bmcweb::benchmark::nsPerIteration(entries.size(), [&]() {
+        astMatches = 0;
+        for (const nlohmann::json& entry : entries)
+        {
+            if (memberMatches(entry, *ast))
+            {
+                astMatches++;
+            }
+        }
+    });
+
+    size_t compiledMatches = 0;
+    double compiledNs =
+        bmcweb::benchmark::nsPerIteration(entries.size(), [&]() {
+            CompiledFilter filter(*ast);
+            compiledMatches = 0;
+            for (const nlohmann::json& entry : entries)
+            {
+                if (filter.matches(entry))
+                {
+                    compiledMatches++;
+                }
+            }
+        });
+
+    EXPECT_EQ(astMatches, compiledMatches);
+    EXPECT_GT(compiledMatches, 0U);
+
+    bmcweb::benchmark::report("compile per member", astNs);
+    bmcweb::benchmark::report("compile once", compiledNs);
+    EXPECT_LT(compiledNs, astNs);
+}
+
+} // namespace
+} // namespace redfish
@@ -268,4 +268,49 @@ TEST(FilterParser, NestedProperty)
     filterFalse("Oem/OEM/ErrorId ne 'SWITCH_EC_STRAP_MISMATCH'", members);
 }
 
+static bool compiledMatches(std::string_view filterExpr,
+                            const nlohmann::json& member)
+{
+    std::optional<filter_ast::LogicalAnd> ast = parseFilter(filterExpr);
+    EXPECT_TRUE(ast);
+    if (!ast)
+    {
+        return false;
+    }
+    CompiledFilter filter(*ast);
+    return filter.matches(member);
+}
+
+TEST(CompiledFilter, AndOr)
+{
+    const nlohmann::json member =
+        R"({"Id": 5, "Name": "Fan", "Oem": {"Count": 3}})"_json;
+    EXPECT_TRUE(compiledMatches("Id eq 5 and Name eq 'Fan'", member));
+    EXPECT_FALSE(compiledMatches("Id eq 5 and Name eq 'Pump'", member));
+    EXPECT_TRUE(compiledMatches("Id eq 6 or Name eq 'Fan'", member));
+    EXPECT_FALSE(compiledMatches("Id eq 6 or Name eq 'Pump'", member));
+    EXPECT_TRUE(compiledMatches(
+        "Id gt 1 and (Name eq 'Pump' or Oem/Count ge 3)", member));
+    EXPECT_FALSE(compiledMatches(
+        "Id gt 1 and (Name eq 'Pump' or Oem/Count ge 4)", member));
+    EXPECT_TRUE(compiledMatches("not (Id eq 6) and not Name eq 'Pump'",
+                                member));
+    EXPECT_FALSE(compiledMatches("not (Id eq 5 or Name eq 'Pump')", member));
+}
+
+TEST(CompiledFilter, ReusedAcrossMembers)
+{
+    std::optional<filter_ast::LogicalAnd> ast =
+        parseFilter("Created gt '2021-01-01T00:00:00Z' and Oem/Count ge 2");
+    ASSERT_TRUE(ast);
+    CompiledFilter filter(*ast);
+
+    EXPECT_TRUE(filter.matches(
+        R"({"Created": "2022-01-01T00:00:00Z", "Oem": {"Count": 2}})"_json));
+    EXPECT_FALSE(filter.matches(
+        R"({"Created": "2020-01-01T00:00:00Z", "Oem": {"Count": 2}})"_json));
+    EXPECT_FALSE(filter.matches(
+        R"({"Created": "2022-01-01T00:00:00Z", "Oem": {"Count": 1}})"_json));
+}
+
 } // namespace redfish
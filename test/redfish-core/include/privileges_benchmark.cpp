@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "benchmark_utils.hpp"
+#include "privileges.hpp"
+#include "registries/privilege_registry.hpp"
+#include "sessions.hpp"
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace
+{
+
+constexpr size_t requestCount = 100000;
+
+// What the routes hold before they're validated: the sets from the registry
+std::vector<std::vector<Privileges>> makeRoutePrivileges()
+{
+    std::vector<std::vector<Privileges>> routes;
+    auto add = [&routes](std::span<const Privileges> sets) {
+        routes.emplace_back(sets.begin(), sets.end());
+    };
+    add(privileges::privilegeSetLogin);
+    add(privileges::privilegeSetConfigureComponents);
+    add(privileges::privilegeSetConfigureUsers);
+    add(privileges::privilegeSetConfigureManager);
+    add(privileges::privilegeSetConfigureManagerOrConfigureComponents);
+    add(privileges::privilegeSetConfigureManagerOrConfigureSelf);
+    add(privileges::
+            privilegeSetConfigureManagerOrConfigureUsersOrConfigureSelf);
+    add(privileges::privilegeSetLoginOrNoAuth);
+    return routes;
+}
+
+std::vector<persistent_data::UserSession> makeSessions()
+{
+    std::vector<persistent_data::UserSession> sessions(4);
+    sessions[0].userRole = "priv-admin";
+    sessions[0].userGroups = {"ipmi", "redfish", "ssh", "hostconsole"};
+    sessions[1].userRole = "priv-operator";
+    sessions[1].userGroups = {"redfish", "hostconsole"};
+    sessions[2].userRole = "priv-user";
+    sessions[2].userGroups = {"redfish"};
+    sessions[3].userRole = "priv-admin";
+    sessions[3].userGroups = {"redfish"};
+    sessions[3].isConfigureSelfOnly = true;
+    for (persistent_data::UserSession& session : sessions)
+    {
+        setUserPrivileges(session);
+    }
+    return sessions;
+}
+
+// What every request used to do: work out the privileges from the role, then
+// check them against each of the route's sets
+bool isAllowedFromRole(const persistent_data::UserSession& session,
+                       const std::vector<Privileges>& privilegesSet)
+{
+    Privileges userPrivileges =
+        getRolePrivileges(session.userRole, session.userGroups);
+    if (session.isConfigureSelfOnly)
+    {
+        userPrivileges =
+            userPrivileges.intersection(Privileges{"ConfigureSelf"});
+    }
+    return isOperationAllowedWithPrivileges(privilegesSet, userPrivileges);
+}
+
+bool isAllowedPrecomputed(const persistent_data::UserSession& session,
+                          const RequiredPrivileges& required)
+{
+    Privileges userPrivileges = getUserPrivileges(session);
+    if (session.isConfigureSelfOnly)
+    {
+        userPrivileges =
+            userPrivileges.intersection(Privileges{"ConfigureSelf"});
+    }
+    return required.isAllowed(userPrivileges);
+}
+
+TEST(PrivilegesBenchmark, AuthorizeRequests)
+{
+    const std::vector<std::vector<Privileges>> routes = makeRoutePrivileges();
+    const std::vector<persistent_data::UserSession> sessions = makeSessions();
+
+    std::vector<RequiredPrivileges> required;
+    required.reserve(routes.size());
+    for (const std::vector<Privileges>& route : routes)
+    {
+        required.emplace_back(route);
+    }
+
+    size_t fromRoleAllowed = 0;
+    double fromRoleNs = bmcweb::benchmark::nsPerIteration(requestCount, [&]() {
+        fromRoleAllowed = 0;
+        for (size_t i = 0; i < requestCount; i++)
+        {
+            if (isAllowedFromRole(sessions[i % sessions.size()],
+                                  routes[i % routes.size()]))
+            {
+                fromRoleAllowed++;
+            }
+        }
+    });
+
+    size_t precomputedAllowed = 0;
+    double precomputedNs =
+        bmcweb::benchmark::nsPerIteration(requestCount, [&]() {
+            precomputedAllowed = 0;
+            for (size_t i = 0; i < requestCount; i++)
+            {
+                if (isAllowedPrecomputed(sessions[i % sessions.size()],
+                                         required[i % required.size()]))
+                {
+                    precomputedAllowed++;
+                }
+            }
+        });
+
+    EXPECT_EQ(fromRoleAllowed, precomputedAllowed);
+    bmcweb::benchmark::report("privileges from role", fromRoleNs);
+    bmcweb::benchmark::report("precomputed privileges", precomputedNs);
+    EXPECT_LT(precomputedNs, fromRoleNs);
+}
+
+} // namespace
+} // namespace redfish
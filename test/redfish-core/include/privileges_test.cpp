@@ -1,10 +1,13 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #include "privileges.hpp"
+#include "sessions.hpp"
 
 #include <boost/beast/http/verb.hpp>
 
 #include <array>
+#include <string>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -139,5 +142,48 @@ TEST(PrivilegeTest, PrivilegeHostConsoleConstructor)
                 UnorderedElementsAre("OpenBMCHostConsole"));
 }
 
+TEST(PrivilegeTest, RequiredPrivilegesWithNoSetsAllowEveryone)
+{
+    RequiredPrivileges required(std::vector<Privileges>{});
+
+    EXPECT_TRUE(required.isAllowed(Privileges{}));
+    EXPECT_FALSE(RequiredPrivileges().isAllowed(Privileges{"Login"}));
+}
+
+TEST(PrivilegeTest, RequiredPrivilegesAllowAnyOneSet)
+{
+    std::array<Privileges, 3> sets{{{"Login", "ConfigureManager"},
+                                    {"ConfigureComponents"},
+                                    {"Login", "ConfigureComponents"}}};
+    RequiredPrivileges required(sets);
+
+    EXPECT_TRUE(required.isAllowed(Privileges{"Login", "ConfigureManager"}));
+    EXPECT_TRUE(required.isAllowed(Privileges{"ConfigureComponents"}));
+    EXPECT_FALSE(required.isAllowed(Privileges{"ConfigureManager"}));
+    EXPECT_FALSE(required.isAllowed(Privileges{"Login", "ConfigureSelf"}));
+
+    // An empty set allows everyone, whatever the other sets are
+    std::array<Privileges, 2> loginOrNoAuth{{{"Login"}, {}}};
+    EXPECT_TRUE(RequiredPrivileges(loginOrNoAuth).isAllowed(Privileges{}));
+}
+
+TEST(PrivilegeTest, SessionPrivilegesFollowRoleAndGroups)
+{
+    persistent_data::UserSession session;
+    EXPECT_THAT(getUserPrivileges(session).getActivePrivilegeNames(
+                    PrivilegeType::BASE),
+                IsEmpty());
+
+    session.userRole = "priv-operator";
+    session.userGroups = {"redfish", "hostconsole"};
+    setUserPrivileges(session);
+    Privileges privileges = getUserPrivileges(session);
+    EXPECT_THAT(privileges.getActivePrivilegeNames(PrivilegeType::BASE),
+                UnorderedElementsAre("Login", "ConfigureSelf",
+                                     "ConfigureComponents"));
+    EXPECT_THAT(privileges.getActivePrivilegeNames(PrivilegeType::OEM),
+                UnorderedElementsAre("OpenBMCHostConsole"));
+}
+
 } // namespace
 } // namespace redfish
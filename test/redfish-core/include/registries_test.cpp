@@ -3,6 +3,9 @@
 #include "registries.hpp"
 #include "registries/openbmc_message_registry.hpp"
 
+#include <string>
+#include <string_view>
+
 #include <gtest/gtest.h>
 
 namespace redfish::registries
@@ -50,6 +53,30 @@ TEST(RedfishRegistries, GetMessage)
 
     msg = redfish::registries::getMessage("OpenBMC.1.0.ServiceStarted");
     ASSERT_NE(msg, nullptr);
+
+    // Wrong number of fields
+    EXPECT_EQ(redfish::registries::getMessage("OpenBMC.1.ServiceStarted"),
+              nullptr);
+    EXPECT_EQ(redfish::registries::getMessage("OpenBMC.1.0.0.ServiceStarted"),
+              nullptr);
+    EXPECT_EQ(redfish::registries::getMessage(""), nullptr);
+    // Unknown registry
+    EXPECT_EQ(redfish::registries::getMessage("NotARegistry.1.0.Success"),
+              nullptr);
+}
+
+TEST(RedfishRegistries, EveryEntryIsFound)
+{
+    for (const auto& [prefix, registry] : allRegistries())
+    {
+        EXPECT_TRUE(isSortedByKey(registry.entries)) << prefix;
+        for (const MessageEntry& entry : registry.entries)
+        {
+            EXPECT_EQ(getMessageFromRegistry(entry.first, registry.entries),
+                      &entry.second)
+                << prefix << "." << entry.first;
+        }
+    }
 }
 
 } // namespace
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "benchmark_utils.hpp"
+#include "http/utility.hpp"
+#include "human_sort.hpp"
+#include "utils/collection_cache.hpp"
+
+#include <boost/url/url.hpp>
+#include <nlohmann/json.hpp>
+#include <sdbusplus/message/native_types.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace redfish::collection_util
+{
+namespace
+{
+
+constexpr size_t memberCount = 2000;
+constexpr size_t requestCount = 100;
+
+constexpr std::array<std::string_view, 1> dimmInterfaces = {
+    "xyz.openbmc_project.Inventory.Item.Dimm"};
+
+// DIMMs spread over the CPUs of a large memory system, in the order the
+// mapper happens to return them
+std::vector<std::string> makePaths()
+{
+    std::vector<std::string> paths;
+    paths.reserve(memberCount);
+    for (size_t i = 0; i < memberCount; i++)
+    {
+        size_t dimm = (i * 7919) % memberCount;
+        paths.emplace_back(std::format(
+            "/xyz/openbmc_project/inventory/system/chassis/motherboard/"
+            "cpu{}/dimm{}",
+            dimm % 16, dimm));
+    }
+    return paths;
+}
+
+// What every collection GET used to do with the GetSubTreePaths reply
+nlohmann::json sortAndRender(const boost::urls::url& collectionPath,
+                             const std::vector<std::string>& paths)
+{
+    std::vector<std::string> pathNames;
+    for (const std::string& object : paths)
+    {
+        std::string leaf = sdbusplus::message::object_path(object).filename();
+        if (!leaf.empty())
+        {
+            pathNames.push_back(leaf);
+        }
+    }
+    std::ranges::sort(pathNames, AlphanumLess<std::string>());
+
+    nlohmann::json members = nlohmann::json::array();
+    for (const std::string& leaf : pathNames)
+    {
+        boost::urls::url url = collectionPath;
+        crow::utility::appendUrlPieces(url, leaf);
+        nlohmann::json::object_t member;
+        member["@odata.id"] = std::move(url);
+        members.emplace_back(std::move(member));
+    }
+    return members;
+}
+
+TEST(CollectionMembersBenchmark, TwoThousandDimms)
+{
+    boost::urls::url collectionPath("/redfish/v1/Systems/system/Memory");
+    std::vector<std::string> paths = makePaths();
+
+    nlohmann::json sorted;
+    double sortNs = bmcweb::benchmark::nsPerIteration(requestCount, [&]() {
+        for (size_t i = 0; i < requestCount; i++)
+        {
+            sorted = sortAndRender(collectionPath, paths);
+        }
+    });
+
+    CollectionMembers cache(collectionPath, "/xyz/openbmc_project/inventory",
+                            dimmInterfaces);
+    double loadNs = bmcweb::benchmark::nsPerIteration(1, [&]() {
+        cache.load(paths);
+        cache.members();
+    });
+
+    nlohmann::json cached;
+    double cachedNs = bmcweb::benchmark::nsPerIteration(requestCount, [&]() {
+        for (size_t i = 0; i < requestCount; i++)
+        {
+            cached = cache.members();
+        }
+    });
+
+    std::vector<std::string> interfaces{std::string(dimmInterfaces[0])};
+    const std::string& moved = paths[memberCount / 2];
+    double changeNs = bmcweb::benchmark::nsPerIteration(requestCount, [&]() {
+        for (size_t i = 0; i < requestCount; i++)
+        {
+            cache.onInterfacesRemoved(moved, interfaces);
+            cache.onInterfacesAdded(moved, interfaces);
+            cache.members();
+        }
+    });
+
+    EXPECT_EQ(sorted, cached);
+    ASSERT_EQ(cached.size(), memberCount);
+
+    bmcweb::benchmark::report("sort and render per GET (2000)", sortNs);
+    bmcweb::benchmark::report("cache load (2000)", loadNs);
+    bmcweb::benchmark::report("cached GET (2000)", cachedNs);
+    bmcweb::benchmark::report("member removed and added (2000)", changeNs);
+    EXPECT_LT(cachedNs, sortNs);
+}
+
+} // namespace
+} // namespace redfish::collection_util
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "utils/collection_cache.hpp"
+
+#include <boost/url/url.hpp>
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace redfish::collection_util
+{
+namespace
+{
+
+constexpr std::array<std::string_view, 1> dimmInterfaces = {
+    "xyz.openbmc_project.Inventory.Item.Dimm"};
+
+const std::string inventory = "/xyz/openbmc_project/inventory";
+
+std::vector<std::string> memberIds(CollectionMembers& cache)
+{
+    std::vector<std::string> ids;
+    for (const nlohmann::json& member : cache.members())
+    {
+        ids.emplace_back(member["@odata.id"]);
+    }
+    return ids;
+}
+
+TEST(CollectionMembers, ListsLeavesInNaturalOrder)
+{
+    CollectionMembers cache(
+        boost::urls::url("/redfish/v1/Systems/system/Memory"), inventory,
+        dimmInterfaces);
+    cache.load({inventory + "/system/dimm10", inventory + "/system/dimm2",
+                inventory + "/system/dimm1", inventory + "/other/dimm2",
+                inventory + "/system/dimm01"});
+    EXPECT_EQ(memberIds(cache), (std::vector<std::string>{
+                                    "/redfish/v1/Systems/system/Memory/dimm01",
+                                    "/redfish/v1/Systems/system/Memory/dimm1",
+                                    "/redfish/v1/Systems/system/Memory/dimm2",
+                                    "/redfish/v1/Systems/system/Memory/dimm10",
+                                }));
+}
+
+TEST(CollectionMembers, FollowsSignals)
+{
+    CollectionMembers cache(
+        boost::urls::url("/redfish/v1/Systems/system/Memory"), inventory,
+        dimmInterfaces);
+    cache.load({inventory + "/system/dimm3"});
+
+    std::vector<std::string> dimm{"xyz.openbmc_project.Inventory.Item.Dimm"};
+    std::vector<std::string> cpu{"xyz.openbmc_project.Inventory.Item.Cpu"};
+    cache.onInterfacesAdded(inventory + "/system/dimm1", dimm);
+    // Other interfaces, and objects outside the subtree, aren't members
+    cache.onInterfacesAdded(inventory + "/system/cpu0", cpu);
+    cache.onInterfacesAdded("/xyz/openbmc_project/inventoryx/dimm0", dimm);
+    EXPECT_EQ(memberIds(cache), (std::vector<std::string>{
+                                    "/redfish/v1/Systems/system/Memory/dimm1",
+                                    "/redfish/v1/Systems/system/Memory/dimm3",
+                                }));
+
+    // A leaf shared by two objects stays until both are gone
+    cache.onInterfacesAdded(inventory + "/other/dimm3", dimm);
+    cache.onInterfacesRemoved(inventory + "/system/dimm3", dimm);
+    EXPECT_EQ(cache.members().size(), 2U);
+    cache.onInterfacesRemoved(inventory + "/other/dimm3", dimm);
+    cache.onInterfacesRemoved(inventory + "/system/dimm1", cpu);
+    EXPECT_EQ(memberIds(cache), (std::vector<std::string>{
+                                    "/redfish/v1/Systems/system/Memory/dimm1",
+                                }));
+}
+
+TEST(CollectionMembers, IgnoresSignalsUntilRead)
+{
+    CollectionMembers cache(
+        boost::urls::url("/redfish/v1/Systems/system/Memory"), inventory,
+        dimmInterfaces);
+    cache.onInterfacesAdded(inventory + "/system/dimm1",
+                            std::vector<std::string>{std::string(
+                                dimmInterfaces[0])});
+    cache.load({});
+    EXPECT_TRUE(cache.members().empty());
+}
+
+} // namespace
+} // namespace redfish::collection_util
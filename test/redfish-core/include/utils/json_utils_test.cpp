@@ -13,6 +13,7 @@
 #include <functional>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <system_error>
 #include <variant>
 #include <vector>
@@ -236,6 +237,52 @@ TEST(ReadJson, MultipleJsonSubElementValueAreUnpackedCorrectly)
     EXPECT_THAT(res.jsonValue, IsEmpty());
 }
 
+TEST(ReadJson, SimilarlyNamedSubElementsAreUnpackedCorrectly)
+{
+    crow::Response res;
+    nlohmann::json jsonRequest = R"(
+        {
+            "json": {"integer": 42},
+            "json-2": {"integer": 43},
+            "jsonInteger": 44
+        }
+    )"_json;
+
+    int integer = 0;
+    int integer2 = 0;
+    int jsonInteger = 0;
+    ASSERT_TRUE(readJson(jsonRequest, res, "json-2/integer", integer2,
+                         "jsonInteger", jsonInteger, "json/integer", integer));
+    EXPECT_EQ(integer, 42);
+    EXPECT_EQ(integer2, 43);
+    EXPECT_EQ(jsonInteger, 44);
+    EXPECT_EQ(res.result(), boost::beast::http::status::ok);
+    EXPECT_THAT(res.jsonValue, IsEmpty());
+}
+
+TEST(ReadJson, SubElementErrorsNameTheSubElement)
+{
+    crow::Response res;
+    nlohmann::json jsonRequest = R"(
+        {
+            "json": {"other": 1},
+            "string": "foobar"
+        }
+    )"_json;
+
+    int integer = 0;
+    std::string str;
+    ASSERT_FALSE(readJson(jsonRequest, res, "json/integer", integer, "string",
+                          str));
+    EXPECT_EQ(res.result(), boost::beast::http::status::bad_request);
+    EXPECT_EQ(str, "foobar");
+
+    const nlohmann::json& unknown =
+        res.jsonValue["error"]["@Message.ExtendedInfo"][0];
+    EXPECT_EQ(unknown["MessageArgs"][0], "other");
+    EXPECT_TRUE(res.jsonValue.contains("integer@Message.ExtendedInfo"));
+}
+
 TEST(ReadJson, ExtraElement)
 {
     crow::Response res;
@@ -590,6 +637,38 @@ TEST(SortJsonArrayByKey, SortedByStringValueOnSuccessArrayIsSorted)
                     R"({"@odata.id": "/redfish/v1", "Name": "c"})"_json));
 }
 
+TEST(ObjectSortKey, OrdersAsObjectKeyCmp)
+{
+    std::vector<nlohmann::json> elements{
+        R"(42)"_json,
+        R"({})"_json,
+        R"({"@odata.id": 4, "Name": 4})"_json,
+        R"({"@odata.id": "", "Name": ""})"_json,
+        R"({"@odata.id": "/redfish/v1", "Name": "v1"})"_json,
+        R"({"@odata.id": "/redfish/v1/", "Name": "v1 "})"_json,
+        R"({"@odata.id": "/redfish/v1/1", "Name": "fan1"})"_json,
+        R"({"@odata.id": "/redfish/v1/10", "Name": "fan10"})"_json,
+        R"({"@odata.id": "/redfish/v1/p1/2", "Name": "fan 2"})"_json,
+        R"({"@odata.id": "/redfish/v1/p10/1", "Name": "fan 02"})"_json,
+        R"({"@odata.id": "/redfish/v1a", "Name": "Fan"})"_json,
+        R"({"@odata.id": "/redfish/v1%2F1", "Name": "fan_1"})"_json,
+    };
+    for (std::string_view key : {"@odata.id", "Name"})
+    {
+        for (const nlohmann::json& left : elements)
+        {
+            for (const nlohmann::json& right : elements)
+            {
+                int cmp = objectKeyCmp(key, left, right);
+                int keyCmp = objectSortKey(key, left)
+                                 .compare(objectSortKey(key, right));
+                EXPECT_EQ((cmp > 0) - (cmp < 0), (keyCmp > 0) - (keyCmp < 0))
+                    << key << ": " << left << " " << right;
+            }
+        }
+    }
+}
+
 TEST(GetEstimatedJsonSize, NumberIs8Bytpes)
 {
     EXPECT_EQ(getEstimatedJsonSize(nlohmann::json(123)), 8);
@@ -2,9 +2,18 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #include "file_test_utilities.hpp"
 #include "metadata.hpp"
+#include "webassets.hpp"
 
+#include <boost/asio/io_context.hpp>
+
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
 #include <format>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
 
 #include <gtest/gtest.h>
@@ -51,5 +60,92 @@ TEST(MetadataGet, GetOneFile)
     EXPECT_EQ(getMetadataPieceForFile("DoesNotExist_v1.xml"), "");
 }
 
+void writeSchema(const std::filesystem::path& path)
+{
+    std::ofstream file(path);
+    file << content;
+}
+
+TEST(MetadataGet, BuildDocument)
+{
+    TemporaryDirectoryHandle dir;
+    writeSchema(dir.path / "B_v1.xml");
+    writeSchema(dir.path / "A_v1.xml");
+    // Not a versioned CSDL file, so ignored
+    writeSchema(dir.path / "A_v1_0_0.xml");
+
+    std::optional<std::string> xml = buildMetadataDocument(dir.path);
+    ASSERT_TRUE(xml);
+    size_t first = xml->find("/redfish/v1/schema/A_v1.xml");
+    size_t second = xml->find("/redfish/v1/schema/B_v1.xml");
+    EXPECT_NE(first, std::string::npos);
+    EXPECT_NE(second, std::string::npos);
+    EXPECT_LT(first, second);
+    EXPECT_EQ(xml->find("A_v1_0_0.xml"), std::string::npos);
+    EXPECT_TRUE(xml->starts_with("<?xml"));
+    EXPECT_TRUE(xml->ends_with("</edmx:Edmx>\n"));
+
+    EXPECT_FALSE(buildMetadataDocument(dir.path / "DoesNotExist"));
+}
+
+using PayloadPtr = std::shared_ptr<const crow::webassets::StaticPayload>;
+
+// Returns what the cache passes to its callback, running the io_context
+// until it has been called
+PayloadPtr getPayload(boost::asio::io_context& ioc, MetadataCache& cache)
+{
+    std::optional<PayloadPtr> result;
+    cache.get([&result](const PayloadPtr& payload) { result = payload; });
+    for (int tries = 0; !result && tries < 10; tries++)
+    {
+        ioc.restart();
+        ioc.run_one_for(std::chrono::seconds(1));
+    }
+    EXPECT_TRUE(result);
+    return result.value_or(nullptr);
+}
+
+TEST(MetadataGet, CacheIsReusedUntilInvalidated)
+{
+    TemporaryDirectoryHandle dir;
+    writeSchema(dir.path / "A_v1.xml");
+
+    boost::asio::io_context ioc;
+    MetadataCache cache(ioc, dir.path);
+    PayloadPtr first = getPayload(ioc, cache);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(getPayload(ioc, cache), first);
+    EXPECT_EQ(first->contentType, "application/xml");
+    // A quoted SHA-256
+    EXPECT_EQ(first->identity.etag.size(), 66U);
+    EXPECT_TRUE(first->identity.etag.starts_with("\""));
+    ASSERT_TRUE(first->gzip);
+    EXPECT_NE(first->gzip->etag, first->identity.etag);
+    EXPECT_LT(first->gzip->body.size(), first->identity.body.size());
+
+    writeSchema(dir.path / "B_v1.xml");
+    cache.invalidate();
+    // The stale document is served while the new one is built
+    EXPECT_EQ(getPayload(ioc, cache), first);
+    PayloadPtr second = first;
+    for (int tries = 0; second == first && tries < 10; tries++)
+    {
+        ioc.restart();
+        ioc.run_one_for(std::chrono::seconds(1));
+        second = getPayload(ioc, cache);
+    }
+    ASSERT_NE(second, nullptr);
+    EXPECT_NE(second, first);
+    EXPECT_NE(second->identity.etag, first->identity.etag);
+}
+
+TEST(MetadataGet, MissingSchemaDirectory)
+{
+    TemporaryDirectoryHandle dir;
+    boost::asio::io_context ioc;
+    MetadataCache cache(ioc, dir.path / "DoesNotExist");
+    EXPECT_EQ(getPayload(ioc, cache), nullptr);
+}
+
 } // namespace
 } // namespace redfish
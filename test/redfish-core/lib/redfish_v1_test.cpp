@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "file_test_utilities.hpp"
+#include "redfish_v1.hpp"
+#include "webassets.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace
+{
+
+void writeFile(const std::filesystem::path& path, std::string_view content)
+{
+    std::ofstream file(path);
+    file << content;
+}
+
+TEST(JsonSchemaIndex, MembersAreSortedAndUnique)
+{
+    TemporaryDirectoryHandle dir;
+    writeFile(dir.path / "Chassis.v1_2_0.json", "{}");
+    writeFile(dir.path / "Chassis.json", "{}");
+    writeFile(dir.path / "AccountService.json", "{}");
+    writeFile(dir.path / "Memory10.json", "{}");
+    writeFile(dir.path / "Memory9.json", "{}");
+    std::filesystem::create_directory(dir.path / "Directory");
+
+    JsonSchemaIndex index(dir.path);
+    const nlohmann::json::array_t* members = index.getMembers();
+    ASSERT_NE(members, nullptr);
+    ASSERT_EQ(members->size(), 4U);
+    EXPECT_EQ((*members)[0]["@odata.id"],
+              "/redfish/v1/JsonSchemas/AccountService");
+    EXPECT_EQ((*members)[1]["@odata.id"], "/redfish/v1/JsonSchemas/Chassis");
+    EXPECT_EQ((*members)[2]["@odata.id"], "/redfish/v1/JsonSchemas/Memory9");
+    EXPECT_EQ((*members)[3]["@odata.id"], "/redfish/v1/JsonSchemas/Memory10");
+
+    const std::string* file = index.findSchemaFile("Chassis");
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(*file, "Chassis.json");
+    EXPECT_EQ(index.findSchemaFile("Directory"), nullptr);
+    EXPECT_EQ(index.findSchemaFile("Missing"), nullptr);
+
+    EXPECT_TRUE(index.hasFile("Chassis.v1_2_0.json"));
+    EXPECT_FALSE(index.hasFile("../Chassis.json"));
+
+    JsonSchemaIndex missing(dir.path / "DoesNotExist");
+    EXPECT_EQ(missing.getMembers(), nullptr);
+}
+
+TEST(JsonSchemaIndex, FileIsReusedUntilChanged)
+{
+    TemporaryDirectoryHandle dir;
+    std::string content(4096, ' ');
+    content.front() = '{';
+    content.back() = '}';
+    writeFile(dir.path / "Chassis.json", content);
+
+    JsonSchemaIndex index(dir.path);
+    EXPECT_EQ(index.getFile("Missing.json"), nullptr);
+
+    std::shared_ptr<const crow::webassets::StaticPayload> first =
+        index.getFile("Chassis.json");
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(index.getFile("Chassis.json"), first);
+    EXPECT_EQ(first->contentType, "application/json");
+    EXPECT_EQ(first->identity.body, content);
+    ASSERT_TRUE(first->gzip);
+    EXPECT_NE(first->gzip->etag, first->identity.etag);
+
+    // A rebuild keeps files that haven't changed
+    writeFile(dir.path / "Thermal.json", "{}");
+    index.invalidate();
+    EXPECT_EQ(index.getFile("Chassis.json"), first);
+    EXPECT_NE(index.findSchemaFile("Thermal"), nullptr);
+
+    writeFile(dir.path / "Chassis.json", "{}");
+    index.invalidate();
+    std::shared_ptr<const crow::webassets::StaticPayload> second =
+        index.getFile("Chassis.json");
+    ASSERT_NE(second, nullptr);
+    EXPECT_NE(second, first);
+    EXPECT_EQ(second->identity.body, "{}");
+    EXPECT_NE(second->identity.etag, first->identity.etag);
+}
+
+TEST(JsonSchemaIndex, LeastRecentlyUsedFileIsEvicted)
+{
+    TemporaryDirectoryHandle dir;
+    std::string content(4096, ' ');
+    content.front() = '{';
+    content.back() = '}';
+    writeFile(dir.path / "Chassis.json", content);
+    writeFile(dir.path / "Power.json", content);
+    writeFile(dir.path / "Thermal.json", content);
+
+    JsonSchemaIndex sizing(dir.path);
+    ASSERT_NE(sizing.getFile("Chassis.json"), nullptr);
+    size_t fileSize = sizing.size();
+    ASSERT_GT(fileSize, content.size());
+
+    JsonSchemaIndex index(dir.path, fileSize * 2);
+    std::shared_ptr<const crow::webassets::StaticPayload> chassis =
+        index.getFile("Chassis.json");
+    std::shared_ptr<const crow::webassets::StaticPayload> thermal =
+        index.getFile("Thermal.json");
+    EXPECT_EQ(index.size(), fileSize * 2);
+
+    // Using Chassis again leaves Thermal as the least recently used
+    EXPECT_EQ(index.getFile("Chassis.json"), chassis);
+    EXPECT_NE(index.getFile("Power.json"), nullptr);
+    EXPECT_EQ(index.size(), fileSize * 2);
+    EXPECT_EQ(index.getFile("Chassis.json"), chassis);
+    std::shared_ptr<const crow::webassets::StaticPayload> reloaded =
+        index.getFile("Thermal.json");
+    ASSERT_NE(reloaded, nullptr);
+    EXPECT_NE(reloaded, thermal);
+    EXPECT_EQ(reloaded->identity.body, content);
+
+    // Files larger than the whole cache are served, but not kept
+    JsonSchemaIndex tiny(dir.path, 16);
+    EXPECT_NE(tiny.getFile("Chassis.json"), nullptr);
+    EXPECT_EQ(tiny.size(), 0U);
+}
+
+} // namespace
+} // namespace redfish
@@ -1,9 +1,19 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 
+#include "async_resp.hpp"
+#include "http_response.hpp"
 #include "systems_logservices_postcodes.hpp"
 
+#include <boost/beast/http/status.hpp>
+#include <boost/system/errc.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -41,5 +51,86 @@ TEST(LogServicesPostCodeParse, PostCodeParse)
     EXPECT_FALSE(parsePostCode("B-1--2", currentValue, index));
 }
 
+TEST(LogServicesPostCodePage, BootsInPage)
+{
+    // Boot cycles 1 to 4, with the current one first
+    std::vector<uint64_t> counts{0, 10, 0, 5, 20};
+    EXPECT_EQ(getPostCodeBootsInPage(counts, 0, 10),
+              (std::vector<uint16_t>{1}));
+    EXPECT_EQ(getPostCodeBootsInPage(counts, 5, 10),
+              (std::vector<uint16_t>{1, 3}));
+    EXPECT_EQ(getPostCodeBootsInPage(counts, 10, 5),
+              (std::vector<uint16_t>{3}));
+    EXPECT_EQ(getPostCodeBootsInPage(counts, 14, 100),
+              (std::vector<uint16_t>{3, 4}));
+    EXPECT_TRUE(getPostCodeBootsInPage(counts, 35, 100).empty());
+    EXPECT_TRUE(getPostCodeBootsInPage(counts, 0, 0).empty());
+}
+
+TEST(LogServicesPostCodePage, CountCacheIsPerBoot)
+{
+    PostCodeCountCache cache;
+    cache.validate(3, 1000);
+    ASSERT_EQ(cache.counts.size(), 4U);
+    cache.counts[2] = 7;
+
+    // Same boot
+    cache.validate(3, 1000);
+    EXPECT_EQ(cache.counts[2], 7U);
+
+    // A new boot, once the retained cycles are at their limit
+    cache.validate(3, 2000);
+    ASSERT_EQ(cache.counts.size(), 4U);
+    EXPECT_FALSE(cache.counts[2]);
+
+    // A new boot, that has no POST codes yet
+    cache.counts[2] = 7;
+    cache.validate(4, 0);
+    EXPECT_TRUE(cache.counts.empty());
+}
+
+TEST(LogServicesPostCodePage, FailedReadCompletesTheResponse)
+{
+    std::vector<PostCodePageReader::PostCodesCallback> reads;
+    auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+    bool completed = false;
+    asyncResp->res.setCompleteRequestHandler(
+        [&completed](crow::Response& res) {
+            EXPECT_EQ(res.result(),
+                      boost::beast::http::status::internal_server_error);
+            completed = true;
+        });
+    std::weak_ptr<PostCodePageReader> reader;
+    {
+        auto started = std::make_shared<PostCodePageReader>(
+            asyncResp, 3, 0, 10,
+            [&reads](uint16_t /*bootIndex*/,
+                     PostCodePageReader::PostCodesCallback&& callback) {
+                reads.emplace_back(std::move(callback));
+            });
+        reader = started;
+        started->start();
+    }
+    // Only the reader holds the response from here on
+    asyncResp.reset();
+
+    // The current boot has no codes yet, so the others are all counted
+    ASSERT_EQ(reads.size(), 1U);
+    std::exchange(reads, {})[0]({}, PostCodes{});
+    ASSERT_EQ(reads.size(), 2U);
+
+    std::vector<PostCodePageReader::PostCodesCallback> inFlight =
+        std::exchange(reads, {});
+    std::exchange(inFlight[0], nullptr)(
+        boost::system::errc::make_error_code(boost::system::errc::io_error),
+        PostCodes{});
+    EXPECT_FALSE(completed);
+    std::exchange(inFlight[1], nullptr)({}, PostCodes{});
+
+    EXPECT_TRUE(reads.empty());
+    EXPECT_TRUE(reader.expired());
+    EXPECT_TRUE(completed);
+}
+
 } // namespace
 } // namespace redfish
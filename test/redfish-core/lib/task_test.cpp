@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "task.hpp"
+
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/message/native_types.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace task
+{
+namespace
+{
+
+TEST(TaskMatch, RuleIsPerNamespace)
+{
+    TaskMatch match = propertiesChangedOf(
+        sdbusplus::message::object_path("/xyz/openbmc_project/software/1234"));
+    EXPECT_EQ(match.pathNamespace, "/xyz/openbmc_project/software");
+    EXPECT_EQ(match.path, "/xyz/openbmc_project/software/1234");
+    EXPECT_EQ(
+        taskMatchRule(match),
+        "type='signal',interface='org.freedesktop.DBus.Properties',"
+        "member='PropertiesChanged',path_namespace='/xyz/openbmc_project/software'");
+
+    EXPECT_EQ(
+        taskMatchRule({"/", "", "com.intel.crashdump"}),
+        "type='signal',interface='org.freedesktop.DBus.Properties',"
+        "member='PropertiesChanged',path_namespace='/',"
+        "arg0namespace='com.intel.crashdump'");
+}
+
+TEST(TaskIndex, OnlyCanonicalIds)
+{
+    EXPECT_EQ(parseTaskIndex("0"), 0U);
+    EXPECT_EQ(parseTaskIndex("42"), 42U);
+    EXPECT_EQ(parseTaskIndex("01"), std::nullopt);
+    EXPECT_EQ(parseTaskIndex(""), std::nullopt);
+    EXPECT_EQ(parseTaskIndex("-1"), std::nullopt);
+    EXPECT_EQ(parseTaskIndex("1a"), std::nullopt);
+    EXPECT_EQ(parseTaskIndex("99999999999999999999999"), std::nullopt);
+}
+
+class TaskMatchDispatcherTest : public ::testing::Test
+{
+  protected:
+    std::vector<std::string> installed;
+    TaskMatchDispatcher dispatcher{
+        [this](const std::string& rule, TaskMatchDispatcher::Handler&&) {
+            installed.emplace_back(rule);
+            return std::unique_ptr<sdbusplus::bus::match_t>();
+        }};
+};
+
+TEST_F(TaskMatchDispatcherTest, SharesMatchesAcrossTasks)
+{
+    std::vector<size_t> ids;
+    std::vector<std::string> calls;
+    for (size_t i = 0; i < 300; i++)
+    {
+        std::string path =
+            "/xyz/openbmc_project/software/" + std::to_string(i);
+        ids.emplace_back(dispatcher.add(
+            {"/xyz/openbmc_project/software", path, ""},
+            [&calls, path](sdbusplus::message_t&) {
+                calls.emplace_back(path);
+            }));
+    }
+    EXPECT_EQ(installed.size(), 1U);
+    EXPECT_EQ(dispatcher.matchCount(), 1U);
+
+    sdbusplus::message_t msg;
+    std::string rule = installed.front();
+    dispatcher.dispatch(rule, "/xyz/openbmc_project/software/7", msg);
+    EXPECT_EQ(calls,
+              (std::vector<std::string>{"/xyz/openbmc_project/software/7"}));
+
+    // Signals of objects no task follows go nowhere
+    dispatcher.dispatch(rule, "/xyz/openbmc_project/software/bmc", msg);
+    EXPECT_EQ(calls.size(), 1U);
+
+    for (size_t id : ids)
+    {
+        dispatcher.remove(id);
+    }
+    EXPECT_EQ(dispatcher.matchCount(), 0U);
+}
+
+TEST_F(TaskMatchDispatcherTest, HandlersCanRemoveThemselves)
+{
+    size_t calls = 0;
+    std::optional<size_t> first;
+    first = dispatcher.add({"/", "", "com.intel.crashdump"},
+                           [this, &first, &calls](sdbusplus::message_t&) {
+                               calls++;
+                               dispatcher.remove(*first);
+                           });
+    dispatcher.add({"/", "", "com.intel.crashdump"},
+                   [&calls](sdbusplus::message_t&) { calls++; });
+    ASSERT_EQ(installed.size(), 1U);
+
+    sdbusplus::message_t msg;
+    dispatcher.dispatch(installed.front(), "/com/intel/crashdump", msg);
+    EXPECT_EQ(calls, 2U);
+    dispatcher.dispatch(installed.front(), "/com/intel/crashdump", msg);
+    EXPECT_EQ(calls, 3U);
+    EXPECT_EQ(dispatcher.matchCount(), 1U);
+}
+
+TEST_F(TaskMatchDispatcherTest, LastRemovalDuringDispatchDropsMatch)
+{
+    std::optional<size_t> id;
+    id = dispatcher.add(
+        {"/xyz/openbmc_project/dump/bmc/entry",
+         "/xyz/openbmc_project/dump/bmc/entry/1", ""},
+        [this, &id](sdbusplus::message_t&) { dispatcher.remove(*id); });
+    sdbusplus::message_t msg;
+    dispatcher.dispatch(installed.front(),
+                        "/xyz/openbmc_project/dump/bmc/entry/1", msg);
+    EXPECT_EQ(dispatcher.matchCount(), 0U);
+}
+
+} // namespace
+} // namespace task
+} // namespace redfish
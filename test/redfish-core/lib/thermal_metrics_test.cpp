@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "async_resp.hpp"
+#include "dbus_utility.hpp"
+#include "thermal_metrics.hpp"
+#include "utils/sensor_utils.hpp"
+
+#include <asm-generic/errno.h>
+
+#include <boost/beast/http/status.hpp>
+#include <boost/container/flat_map.hpp>
+#include <boost/system/errc.hpp>
+#include <boost/system/error_code.hpp>
+#include <nlohmann/json.hpp>
+#include <sdbusplus/message/native_types.hpp>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace
+{
+
+using ::testing::ElementsAre;
+
+dbus::utility::DBusInterfacesMap makeSensor(double value)
+{
+    dbus::utility::DBusPropertiesMap properties;
+    properties.emplace_back("Value", value);
+    dbus::utility::DBusInterfacesMap interfaces;
+    interfaces.emplace_back("xyz.openbmc_project.Sensor.Value",
+                            std::move(properties));
+    return interfaces;
+}
+
+// Two sensor daemons, each owning some of the chassis temperature sensors,
+// plus sensors that belong to other chassis or aren't temperatures.
+const dbus::utility::ManagedObjectType hwmonObjects{
+    {sdbusplus::message::object_path(
+         "/xyz/openbmc_project/sensors/temperature/cpu1"),
+     makeSensor(51.0)},
+    {sdbusplus::message::object_path(
+         "/xyz/openbmc_project/sensors/temperature/cpu0"),
+     makeSensor(50.0)},
+    {sdbusplus::message::object_path(
+         "/xyz/openbmc_project/sensors/voltage/p12v"),
+     makeSensor(12.1)},
+};
+
+const dbus::utility::ManagedObjectType adcObjects{
+    {sdbusplus::message::object_path(
+         "/xyz/openbmc_project/sensors/temperature/inlet"),
+     makeSensor(24.0)},
+    {sdbusplus::message::object_path(
+         "/xyz/openbmc_project/sensors/temperature/other_chassis"),
+     makeSensor(30.0)},
+};
+
+const sensor_utils::SensorServicePathList chassisSensors{
+    {"xyz.openbmc_project.HwmonTempSensor",
+     "/xyz/openbmc_project/sensors/temperature/cpu0"},
+    {"xyz.openbmc_project.ADCSensor",
+     "/xyz/openbmc_project/sensors/temperature/inlet"},
+    {"xyz.openbmc_project.HwmonTempSensor",
+     "/xyz/openbmc_project/sensors/temperature/cpu1"},
+    {"xyz.openbmc_project.ADCSensor",
+     "/xyz/openbmc_project/sensors/temperature/outlet"},
+};
+
+TEST(ThermalMetrics, SensorsAreReadOncePerService)
+{
+    boost::container::flat_map<std::string, std::vector<std::string>>
+        byService = sensor_utils::groupSensorsByService(chassisSensors);
+    ASSERT_EQ(byService.size(), 2U);
+    EXPECT_THAT(byService["xyz.openbmc_project.HwmonTempSensor"],
+                ElementsAre("/xyz/openbmc_project/sensors/temperature/cpu0",
+                            "/xyz/openbmc_project/sensors/temperature/cpu1"));
+    EXPECT_THAT(byService["xyz.openbmc_project.ADCSensor"],
+                ElementsAre("/xyz/openbmc_project/sensors/temperature/inlet",
+                            "/xyz/openbmc_project/sensors/temperature/outlet"));
+
+    sensor_utils::SensorPropertiesList sensorProperties;
+    std::vector<std::string> missing;
+    sensor_utils::extractSensorProperties(
+        hwmonObjects, "xyz.openbmc_project.HwmonTempSensor",
+        byService["xyz.openbmc_project.HwmonTempSensor"],
+        "xyz.openbmc_project.Sensor.Value", sensorProperties, missing);
+    sensor_utils::extractSensorProperties(
+        adcObjects, "xyz.openbmc_project.ADCSensor",
+        byService["xyz.openbmc_project.ADCSensor"],
+        "xyz.openbmc_project.Sensor.Value", sensorProperties, missing);
+
+    // Sensors of other chassis and types are ignored, and sensors missing
+    // from the object manager are left to be read individually
+    ASSERT_EQ(sensorProperties.size(), 3U);
+    EXPECT_EQ(sensorProperties[0].service,
+              "xyz.openbmc_project.HwmonTempSensor");
+    EXPECT_EQ(sensorProperties[2].path,
+              "/xyz/openbmc_project/sensors/temperature/inlet");
+    EXPECT_THAT(missing,
+                ElementsAre("/xyz/openbmc_project/sensors/temperature/outlet"));
+
+    auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+    afterGetTemperatureValues(asyncResp, "chassis", {}, sensorProperties);
+
+    nlohmann::json& json = asyncResp->res.jsonValue;
+    EXPECT_EQ(json["TemperatureReadingsCelsius@odata.count"], 3);
+    nlohmann::json& readings = json["TemperatureReadingsCelsius"];
+    ASSERT_EQ(readings.size(), 3U);
+    EXPECT_EQ(readings[0]["DataSourceUri"],
+              "/redfish/v1/Chassis/chassis/Sensors/temperature_cpu0");
+    EXPECT_EQ(readings[0]["Reading"], 50.0);
+    EXPECT_EQ(readings[1]["DataSourceUri"],
+              "/redfish/v1/Chassis/chassis/Sensors/temperature_cpu1");
+    EXPECT_EQ(readings[2]["DataSourceUri"],
+              "/redfish/v1/Chassis/chassis/Sensors/temperature_inlet");
+    EXPECT_EQ(readings[2]["Reading"], 24.0);
+}
+
+TEST(ThermalMetrics, MissingSensorIsNotAnError)
+{
+    sensor_utils::SensorPropertiesList sensorProperties;
+    auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+    afterGetTemperatureValues(
+        asyncResp, "chassis",
+        boost::system::error_code(EBADR, boost::system::system_category()),
+        sensorProperties);
+    nlohmann::json& json = asyncResp->res.jsonValue;
+    EXPECT_EQ(json["TemperatureReadingsCelsius@odata.count"], 0);
+
+    auto failed = std::make_shared<bmcweb::AsyncResp>();
+    afterGetTemperatureValues(failed, "chassis",
+                              boost::system::errc::make_error_code(
+                                  boost::system::errc::io_error),
+                              sensorProperties);
+    EXPECT_EQ(failed->res.result(),
+              boost::beast::http::status::internal_server_error);
+}
+
+} // namespace
+} // namespace redfish
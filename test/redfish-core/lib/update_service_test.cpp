@@ -1,12 +1,24 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 
+#include "async_resp.hpp"
 #include "http_response.hpp"
+#include "multipart_parser.hpp"
 #include "update_service.hpp"
 
+#include <openssl/evp.h>
+#include <unistd.h>
+
 #include <boost/url/url.hpp>
 
+#include <array>
+#include <cstddef>
+#include <format>
+#include <memory>
 #include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 
 #include <gtest/gtest.h>
 
@@ -138,5 +150,96 @@ TEST(UpdateService, ParseHTTPSNegative)
     // No host
     ASSERT_EQ(parseSimpleUpdateUrl("/path", "HTTPS", res), std::nullopt);
 }
+std::string makeMultipartUpdate(std::string_view image)
+{
+    std::string body =
+        "--XX\r\n"
+        "Content-Disposition: form-data; name=\"UpdateParameters\"\r\n"
+        "Content-Type: application/json\r\n\r\n"
+        "{\"@Redfish.OperationApplyTime\": \"Immediate\"}\r\n"
+        "--XX\r\n"
+        "Content-Disposition: form-data; name=\"UpdateFile\"; "
+        "filename=\"image.tar\"\r\n"
+        "Content-Type: application/octet-stream\r\n\r\n";
+    body += image;
+    body += "\r\n--XX--\r\n";
+    return body;
+}
+
+TEST(UpdateService, MultipartImageIsStreamedToMemfd)
+{
+    // Image data that keeps almost matching the boundary
+    std::string image;
+    for (size_t i = 0; image.size() < 1024UL * 1024UL; i++)
+    {
+        image += std::format("\r\n--X{}\r\n-", i);
+    }
+    std::string body = makeMultipartUpdate(image);
+
+    MultipartUpdateSink upload("multipart/form-data; boundary=XX");
+    for (size_t pos = 0; pos < body.size(); pos += 4093)
+    {
+        upload.put(std::string_view(body).substr(pos, 4093));
+    }
+    upload.finish();
+    ASSERT_EQ(upload.status, ParserError::PARSER_SUCCESS);
+
+    // Only the parameters were kept in memory
+    ASSERT_EQ(upload.parser.mime_fields.size(), 2U);
+    EXPECT_EQ(upload.parser.mime_fields[0].content,
+              "{\"@Redfish.OperationApplyTime\": \"Immediate\"}");
+    EXPECT_TRUE(upload.parser.mime_fields[1].content.empty());
+
+    ASSERT_EQ(upload.image.size, image.size());
+    std::string written(image.size(), '\0');
+    ASSERT_EQ(pread(upload.image.memfd.fd, written.data(), written.size(), 0),
+              static_cast<ssize_t>(image.size()));
+    EXPECT_EQ(written, image);
+
+    std::array<unsigned char, EVP_MAX_MD_SIZE> hash{};
+    unsigned int hashSize = 0;
+    ASSERT_EQ(EVP_Digest(image.data(), image.size(), hash.data(), &hashSize,
+                         EVP_sha256(), nullptr),
+              1);
+    std::string expected;
+    for (unsigned char byte : std::span(hash.data(), hashSize))
+    {
+        expected += std::format("{:02x}", byte);
+    }
+    EXPECT_EQ(upload.image.digest, expected);
+
+    auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+    std::optional<MultiPartUpdate> multipart =
+        extractMultipartUpdateParameters(asyncResp, upload);
+    ASSERT_TRUE(multipart);
+    EXPECT_EQ(multipart->params.applyTime, "Immediate");
+}
+
+TEST(UpdateService, MultipartWithoutImageIsRejected)
+{
+    std::string body = makeMultipartUpdate("");
+    MultipartUpdateSink upload("multipart/form-data; boundary=XX");
+    upload.put(body);
+    upload.finish();
+    ASSERT_EQ(upload.status, ParserError::PARSER_SUCCESS);
+
+    auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+    EXPECT_FALSE(extractMultipartUpdateParameters(asyncResp, upload));
+}
+
+TEST(UpdateService, MultipartLargeParametersAreRejected)
+{
+    std::string body =
+        "--XX\r\n"
+        "Content-Disposition: form-data; name=\"UpdateParameters\"\r\n\r\n";
+    body += std::string(MultipartUpdateSink::maxPartSize + 1, 'a');
+    body += "\r\n--XX--\r\n";
+
+    MultipartUpdateSink upload("multipart/form-data; boundary=XX");
+    upload.put(body);
+    upload.finish();
+    EXPECT_EQ(upload.status, ParserError::ERROR_PART_REJECTED);
+}
+
 } // namespace
 } // namespace redfish